@@ -11,15 +11,24 @@
 //						const double interestRate, int months)
 //					void SaveTable(const double loanSize, double paymentSize,
 //						const double interestRate, int months)
+//					void WhatIfTable(const double loanSize, const double
+//					   paymentSize, const double interestRate, const int months)
 //					void PrintResults(const double loanSize, const double
 //					   paymentSize, const double interestRate, const int months)
 //					double getPaymentAmount(const int months, const double 
 //						principal, const double interestRate)
 //					double getLoanAmount(const double payment, const int months,
 //						const double interestRate)
+//					double getMonthsNeeded(const double payment, const double
+//					    principal, const double interestRate)
 //					int getNumberOfMonths(const double payment, const double 
 //					    principal, const double interestRate)
 //					double roundInterest(double interest, const int fraction)
+//					double solveInterestRate(const int months, const double 
+//						principal, const double payment, 
+//						const double tolerance, int* iterations)
+//					double findInterestRate(const int months, const double 
+//						principal, const double payment, int* iterations)
 //					double getInterestRate(const int months, const double 
 //						principal, const double payment)
 //					double ReadInterestRate()
@@ -28,7 +37,14 @@
 //					int ReadMonths()
 //----------------------------------------------------------------------------
 
+#include <string.h>
 #include "amort.h"
+#include "amort_annuity.h"
+#include "amort_columnar.h"
+#include "amort_metrics.h"
+#include "amort_schedule.h"
+#include "amort_whatif.h"
+#include "amort_writer.h"
 
 void safeReadInt(int* number_ptr, const char* prompt)
 {
@@ -75,7 +91,10 @@ void cleanBuffer()
 //							  C++.Net 2015 
 //        
 // Called By:      main() 
+// Calls:          GetAnnuityFactors()
 // History Log:    11/04/2016  JR completed version 1.0
+//				   10/17/2026  rates on the 1/8th grid look the factor up
+//							   instead of calling pow()
 //----------------------------------------------------------------------------
 double getPaymentAmount(const int months, const double principal, 
 	const double interestRate)
@@ -83,10 +102,15 @@ double getPaymentAmount(const int months, const double principal,
 	double payment = 0;
 	double interestExp = 0;
 	double monthlyInterest = interestRate / MONTHLY_DIVISOR;
+	const double* factors = NULL;
 	if (interestRate == 0)
 	{
 		payment = principal / months;
 	}
+	else if ((factors = GetAnnuityFactors(interestRate, months)) != NULL)
+	{
+		payment = factors[0] * principal * monthlyInterest;
+	}
 	else
 	{
 		interestExp = pow(monthlyInterest + ONE, (double)months);
@@ -117,20 +141,29 @@ double getPaymentAmount(const int months, const double principal,
 //							 C++.Net 2015 
 //        
 // Called By:      main() 
+// Calls:          GetAnnuityFactors()
 // History Log:    11/04/2016  JR completed version 1.0
+//				   10/17/2026  rates on the 1/8th grid look the factor up
+//							   instead of calling pow()
 //----------------------------------------------------------------------------
 double getLoanAmount(const double payment, const int months, 
 	const double interestRate)
 {
 	double principal = 0;
 	double monthlyInterest = interestRate / MONTHLY_DIVISOR;
-	double interestExp = pow(monthlyInterest + ONE, (double)months);
+	double interestExp = 0;
+	const double* factors = NULL;
 	if (interestRate == 0)
 	{
 		principal = payment * months;
 	}
+	else if ((factors = GetAnnuityFactors(interestRate, months)) != NULL)
+	{
+		principal = factors[1] * payment;
+	}
 	else
 	{
+		interestExp = pow(monthlyInterest + ONE, (double)months);
 		principal = 
 			((interestExp - 1) / (monthlyInterest * interestExp)) * payment;
 	}
@@ -138,6 +171,36 @@ double getLoanAmount(const double payment, const int months,
 	return principal;
 }
 //----------------------------------------------------------------------------
+// Function:	   double getMonthsNeeded(const double payment, const double
+//				       principal, const double interestRate)
+//
+// Description:	   Works out the whole number of months needed to repay a
+//				   loan, as a double so a caller can check the range before
+//				   it casts. A payment that never repays the loan gives
+//				   inf or nan.
+//
+// Parameters:	   const (double) payment		  Amount of monthly payment
+//				   const (double) principal       Amount of loan
+//				   const (double) interestRate    Annual interest rate
+//
+// Returns:		   (double) months   Whole number of months, not yet cast
+// Date:           10/17/2026
+// Called By:      getNumberOfMonths(), PriceLoanRecord()
+// History Log:    10/17/2026  taken out of getNumberOfMonths() so batch
+//							   records can reject terms an int cannot hold
+//----------------------------------------------------------------------------
+double getMonthsNeeded(const double payment, const double principal,
+	const double interestRate)
+{
+	double monthlyInterest = interestRate / MONTHLY_DIVISOR;
+	double numberOfMonths = 0;
+
+	numberOfMonths = (interestRate == 0) ? principal / payment 
+		: (log(payment) - log(payment - (principal * monthlyInterest)))
+		/ log(1 + monthlyInterest);
+	return ceil(numberOfMonths);
+}
+//----------------------------------------------------------------------------
 // Function: int getNumberOfMonths(const double payment, const double principal,
 //								   const double interestRate)
 //
@@ -157,19 +220,16 @@ double getLoanAmount(const double payment, const int months,
 //						     C++.Net 2015 
 //        
 // Called By:      main() 
+// Calls:		   getMonthsNeeded()
 // History Log:    11/04/2016  JR completed version 1.0
+//				   10/17/2026  formula moved to getMonthsNeeded()
 //----------------------------------------------------------------------------
 int getNumberOfMonths(const double payment, const double principal, 
 	const double interestRate)
 {
-	double monthlyInterest = interestRate / MONTHLY_DIVISOR;
-	double numberOfMonths = 0;
 	int monthsRounded = 0;
 
-	numberOfMonths = (interestRate == 0) ? principal / payment 
-		: (log(payment) - log(payment - (principal * monthlyInterest)))
-		/ log(1 + monthlyInterest);
-	monthsRounded = (int)ceil(numberOfMonths);
+	monthsRounded = (int)getMonthsNeeded(payment, principal, interestRate);
 	return monthsRounded;
 }
 //----------------------------------------------------------------------------
@@ -201,19 +261,127 @@ double roundInterest(double interest, const int fraction)
 	interest = round(interest * fraction) / fraction;
 	return interest;
 }
+// Returns P * r * x / (x - 1), the payment formula of getPaymentAmount()
+// without rounding, and its derivative with respect to the monthly rate r.
+static double annuityPayment(const int months, const double principal,
+	const double rate, double* slope)
+{
+	double growth = 0;            // x - 1 = (1 + r)^n - 1
+	double factor = 0;            // x / (x - 1)
+
+	if (rate == 0)
+	{
+		*slope = principal * (months + ONE) / (2.0 * months);
+		return principal / months;
+	}
+	growth = expm1(months * log1p(rate));
+	factor = (growth + ONE) / growth;
+	*slope = principal * (factor - 
+		rate * months * factor / ((ONE + rate) * growth));
+	return principal * rate * factor;
+}
 //----------------------------------------------------------------------------
-// Function:	  double getInterestRate(const int months, const double 
-//						                principal, const double payment)
+// Function:	  double solveInterestRate(const int months, const double 
+//						principal, const double payment, 
+//						const double tolerance, int* iterations)
 //
-// Description:	  Calculates and returns the interest rate rounded to 1/8th 
-//				  percent. Loop increments a test number & checks for a match
-//				  of monthly payment size in the getPaymentAmount() formula.
+// Description:	  Solves the getPaymentAmount() formula for the interest 
+//				  rate. Newton steps are taken inside a bracket that always
+//				  holds the answer: the monthly rate lies between 0 and 
+//				  payment / principal. A step that would leave the bracket 
+//				  is replaced by bisection, so the search always converges.
+//
+// Parameters:	    const (int) months:		    Number of months or payments
+//					const (double) principal:   Amount of loan 				   
+//					const (double) payment:	    Amount of monthly payment
+//					const (double) tolerance:   Accuracy of the annual rate
+//												(in percent) to stop at
+//					(int*) iterations:			Receives the number of
+//												iterations (may be NULL)
+//				   
+// Returns:		   (double) interestRate  Annual interest rate or NO_RATE if
+//										  payment * months is less than 
+//										  principal (no rate fits)
+// Date:           10/17/2026
+// Called By:      findInterestRate()
+// Calls:		   CountMetric()
+// History Log:    10/17/2026  replaces the scanning search of version 1.0
+//				   10/17/2026  counts calls, iterations and failures
+//----------------------------------------------------------------------------
+double solveInterestRate(const int months, const double principal, 
+	const double payment, const double tolerance, int* iterations)
+{
+	double low = 0;                              // Monthly rate bracket
+	double high = 0;
+	double rate = 0;
+	double step = 0;
+	double slope = 0;
+	double error = 0;
+	double monthlyTolerance = tolerance / MONTHLY_DIVISOR;
+	int count = 0;
+	int converged = 0;
+
+	if (iterations != NULL)
+		*iterations = 0;
+	CountMetric(METRIC_SOLVER_CALLS, 1);
+	if ((months <= 0) || (principal <= 0) || (payment <= 0) ||
+		(payment * months < principal))
+	{
+		CountMetric(METRIC_SOLVER_FAILURES, 1);
+		return NO_RATE;
+	}
+	if (payment * months == principal)
+		return 0;
+
+	high = payment / principal;
+	//Starting guess from the first order expansion of the formula
+	rate = 2.0 * (payment * months - principal) / (principal * (months + ONE));
+	if ((rate <= low) || (rate >= high))
+		rate = (low + high) / 2;
+	while (count < MAX_RATE_ITERATIONS)
+	{
+		count++;
+		error = annuityPayment(months, principal, rate, &slope) - payment;
+		if (error > 0)
+			high = rate;
+		else
+			low = rate;
+		step = (slope > 0) ? error / slope : 0;
+		if ((error != 0) && ((slope <= 0) || (rate - step <= low) ||
+			(rate - step >= high)))
+		{
+			step = rate - (low + high) / 2;            // Bisect instead
+		}
+		rate -= step;
+		if ((fabs(step) <= monthlyTolerance) || 
+			(high - low <= monthlyTolerance) || (error == 0))
+		{
+			converged = 1;
+			break;
+		}
+	}
+	CountMetric(METRIC_SOLVER_ITERATIONS, count);
+	if (!converged)
+		CountMetric(METRIC_SOLVER_FAILURES, 1);
+	if (iterations != NULL)
+		*iterations = count;
+	return rate * MONTHLY_DIVISOR;
+}
+//----------------------------------------------------------------------------
+// Function:	  double findInterestRate(const int months, const double 
+//						principal, const double payment, int* iterations)
+//
+// Description:	  Calculates and returns the interest rate with 
+//				  solveInterestRate() at the default RATE_TOLERANCE. Prints
+//				  nothing, so it is safe to call from batch threads.
 //
 // Parameters:	    const (int) months:		    Number of months or payments
 //					const (double) principal:   Amount of loan 				   
 //					const (double) payment:	    Amound of monthly payment
+//					(int*) iterations:			Receives the number of solver
+//												iterations (may be NULL)
 //				   
-// Returns:		   (double) interestRate  Annual interest rate 
+// Returns:		   (double) interestRate  Annual interest rate or NO_RATE
 // Programmer:	   Jeremiah Robinson
 //                  
 // Date:           11/04/2016  
@@ -222,53 +390,40 @@ double roundInterest(double interest, const int fraction)
 //                 Software: MS Windows 10. Compiles under Microsoft Visual 
 //							 C++.Net 2015 
 //       
+// Called By:      getInterestRate(), RunBatch()
+// Calls:          solveInterestRate()
+// History Log:    11/04/2016  JR completed version 1.0
+//				   10/17/2026  split out of getInterestRate() for batch mode
+//				   10/17/2026  scanning loop replaced by solveInterestRate()
+//----------------------------------------------------------------------------
+double findInterestRate(const int months, const double principal, 
+	const double payment, int* iterations)
+{
+	return solveInterestRate(months, principal, payment, RATE_TOLERANCE,
+		iterations);
+}
+//----------------------------------------------------------------------------
+// Function:	  double getInterestRate(const int months, const double 
+//						                principal, const double payment)
+//
+// Description:	  Calculates and returns the interest rate that makes the 
+//				  getPaymentAmount() formula match the monthly payment.
+//
+// Parameters:	    const (int) months:		    Number of months or payments
+//					const (double) principal:   Amount of loan 				   
+//					const (double) payment:	    Amound of monthly payment
+//				   
+// Returns:		   (double) interestRate  Annual interest rate 
+// Date:           10/17/2026
 // Called By:      main()
+// Calls:          findInterestRate()
 // History Log:    11/04/2016  JR completed version 1.0
+//				   10/17/2026  search moved to findInterestRate()
 //----------------------------------------------------------------------------
 double getInterestRate(const int months, const double principal, 
 	const double payment)
 {
-	double interestRate = 0;
-	long double testNumber = 0;
-	double range = .01; 
-	long long depth = 100;
-	int counter = 0;
-	const double MAX_PAYMENT = 1.01;   // Set break point for payment loop > 1.
-	double rangeInterval = 0;          // 
-	const int DEPTH_INTERVAL = 10;     // Expand test numbers.
-
-	rangeInterval = (principal > BILLION) ? HUNDRED :
-		(principal > MILLION) ? 10 : .001;
-	while (interestRate == 0)
-	{
-		for (long long j = 1; j <= LONG_MAX; j++)
-		{
-			long double monthlyInterest = 0;
-			long double interestExp = 0;
-
-			//Use formula in getPaymentAmount() to setup test number 
-			monthlyInterest = (long double)j / depth;
-			interestExp = (long double)pow(monthlyInterest + ONE, months);
-			testNumber = (long double)(interestExp / (interestExp - ONE)) 
-				* principal * monthlyInterest;
-			//Check matching of test number & monthly payment
-			if ((testNumber <= (payment + range)) && 
-				(testNumber >= (payment - range)))
-			{   
-				interestRate = monthlyInterest * MONTHLY_DIVISOR;
-				break;
-			}
-			//Check if test number was skipped over, and restart
-			if (testNumber > (payment * MAX_PAYMENT)) 
-				break;
-		}
-		counter++;						     //Number was skipped over
-		printf("Scan number: %d \n", counter);
-		range += rangeInterval;		         //Increase matching range 
-		depth *= DEPTH_INTERVAL;	         // and shift decimal 
-										
-	} 
-	return interestRate;
+	return findInterestRate(months, principal, payment, NULL);
 }
 //----------------------------------------------------------------------------
 // Function: double ReadInterestRate()
@@ -458,34 +613,28 @@ int ReadMonths()
 // Input:          None
 // Output:         Amortization table is displayed to screen
 // Called By:      main()
-// Calls:          RoundInterest()
+// Calls:          RoundInterest(), GetSchedule(), AttachScheduleWriter(),
+//				   WriteSchedule()
 // History Log:    11/04/2016  JR completed version 1.0
+//				   10/17/2026  rows written through ScheduleWriter
+//				   10/17/2026  rows built by GetSchedule()
 //----------------------------------------------------------------------------
 void DisplayTable(const double loanSize, double paymentSize, 
 	              const double interestRate, const int months)
 {
-	double interestPaid = 0;
-	double principalPaid = 0;
-	double loanBalance = loanSize;
+	ScheduleWriter writer;
 	double roundedInterest = roundInterest(interestRate, 8);
+	const Schedule* schedule = 
+		GetSchedule(loanSize, paymentSize, interestRate, months);
+
 	printf("Amortization Table for a: $%.2lf loan at: ", loanSize);
 	printf("%.3lf%c interest for %d months\n\n", 
 		roundedInterest, PERCENT, months);
 	printf(HEAD HEAD2 "\n");
-	for (size_t i = 1; i <= months; i++)
-	{
-		interestPaid = loanBalance * (roundedInterest / MONTHLY_DIVISOR);
-		interestPaid = floor(interestPaid * HUNDRED + HALF) / HUNDRED;
-		principalPaid = paymentSize - interestPaid;
-		loanBalance -= principalPaid;
-		if ((i == months) && (loanBalance != 0))
-		{
-			paymentSize += loanBalance;
-			principalPaid += loanBalance;
-			loanBalance -= loanBalance;
-		}
-		printf(FORMAT, i, paymentSize, principalPaid, interestPaid, loanBalance);
-	}
+	if ((schedule == NULL) || !AttachScheduleWriter(&writer, stdout))
+		return;
+	WriteSchedule(&writer, schedule);
+	CloseScheduleWriter(&writer);
 }
 //----------------------------------------------------------------------------
 // Function: void SaveTable(const double loanSize, double paymentSize, 
@@ -494,7 +643,8 @@ void DisplayTable(const double loanSize, double paymentSize,
 // Description:  Saves amortization table to txt file.  Monthly payment is 
 //				 broken down into separate payments for interest and principal.
 //				 Each row represents one month of payments subtracted from the
-//				 running loan balance.
+//				 running loan balance. A filename ending in COLUMN_EXTENSION
+//				 gets a columnar file instead, see amort_columnar.h.
 //			     			
 // Parameters:	 const double  loanSize			 Total size of loan
 //				       double  paymentSize       Monthly payment amount
@@ -513,47 +663,184 @@ void DisplayTable(const double loanSize, double paymentSize,
 // Input:          When prompted, user enters a filename for the table
 // Output:         Amortization table is saved to program's root directory
 // Called By:      main()
-// Calls:		   RoundInterest()
+// Calls:		   GetSchedule(), OpenScheduleWriter(), WriteScheduleHeading(),
+//				   WriteSchedule(), SaveScheduleColumns(),
+//				   StartMetricTimer(), StopMetricTimer()
 // History Log:    11/04/2016  JR completed version 1.0
+//				   10/17/2026  rows written through ScheduleWriter
+//				   10/17/2026  rows built by GetSchedule()
+//				   10/17/2026  heading written by WriteScheduleHeading()
+//				   10/17/2026  timed as TIMER_SAVE
+//				   10/17/2026  .col names saved as columnar files
 //----------------------------------------------------------------------------
 void SaveTable(const double loanSize, double paymentSize, 
 			   const double interestRate, const int months)
 {
-	FILE *fp = NULL;
-	double interestPaid = 0;
-	double principalPaid = 0;
-	double loanBalance = loanSize;
+	ScheduleWriter writer;
 	char filename[FILENAME_MAX] = "";
-	double roundedInterest = roundInterest(interestRate, 8);
+	char format[16] = "";
+	double start = 0;
+	size_t length = 0;
+	int closed = 0;
+	const Schedule* schedule = 
+		GetSchedule(loanSize, paymentSize, interestRate, months);
 
-	printf("Please enter a filename (no spaces) : \n");
-	scanf_s("%s", filename, FILENAME_MAX);
-	system("cls");
-	fp = fopen(filename, "w");
-	fprintf(fp, "Amortization Table for a: $%.2lf loan at: ", loanSize);
-	fprintf(fp, "%.3lf%c interest for %d months\n\n", 
-		roundedInterest, PERCENT, months);
-	fprintf(fp, HEAD HEAD2 "\n");
-	for (size_t i = 1; i <= months; i++)
+	printf("Please enter a filename (no spaces, " COLUMN_EXTENSION
+		" for a columnar file) : \n");
+	snprintf(format, sizeof(format), "%%%ds", FILENAME_MAX - 1);
+	scanf(format, filename);
+	system(CLEAR_SCREEN);
+	if (schedule == NULL)
 	{
-		interestPaid = loanBalance * (roundedInterest / MONTHLY_DIVISOR);
-		interestPaid = floor(interestPaid * HUNDRED + HALF) / HUNDRED;
-		principalPaid = paymentSize - interestPaid;
-		loanBalance -= principalPaid;
-		if ((i == months) && (loanBalance != 0))   //adjust last months payment
+		printf("Out of memory\n");
+		return;
+	}
+	start = StartMetricTimer(TIMER_SAVE);
+	length = strlen(filename);
+	if ((length > strlen(COLUMN_EXTENSION)) && (strcmp(filename + length -
+		strlen(COLUMN_EXTENSION), COLUMN_EXTENSION) == 0))
+	{
+		closed = (SaveScheduleColumns(filename, schedule, 1) ==
+			schedule->months);
+		StopMetricTimer(TIMER_SAVE, start);
+		if (!closed)
 		{
-			paymentSize += loanBalance;
-			principalPaid += loanBalance;
-			loanBalance -= loanBalance;
+			printf("Could not write columnar file: %s \n", filename);
+			return;
 		}
-		fprintf(fp, FORMAT,
-			i, paymentSize, principalPaid, interestPaid, loanBalance);
+		printf("Table has been saved by columns to file: %s \n", filename);
+		printf("It is located in the root directory of the program\n");
+		return;
+	}
+	if (!OpenScheduleWriter(&writer, filename, WRITER_DIRECT))
+	{
+		StopMetricTimer(TIMER_SAVE, start);
+		printf("Cannot create file: %s \n", filename);
+		return;
+	}
+	WriteScheduleHeading(&writer, loanSize, interestRate, months);
+	WriteSchedule(&writer, schedule);
+	closed = CloseScheduleWriter(&writer);
+	StopMetricTimer(TIMER_SAVE, start);
+	if (!closed)
+	{
+		printf("Could not write all of file: %s \n", filename);
+		return;
 	}
-	fclose(fp);
 	printf("Table has been printed to file: %s \n", filename);
 	printf("It is located in the root directory of the program\n");
 }
 //----------------------------------------------------------------------------
+// Function: void WhatIfTable(const double loanSize, const double paymentSize,
+//							  const double interestRate, const int months)
+//
+// Description:  Lets the user change one value of the loan, the payment or
+//				 rate from a chosen month on, the number of payments or the
+//				 loan size, and shows only the table rows that changed
+//				 with the new totals. Changes pile up: each one starts from
+//				 the table the last one left, until a different loan is
+//				 given. Only rows the change reaches are worked out again,
+//				 see amort_whatif.h.
+//			     			
+// Parameters:	 const double  loanSize			 Total size of loan
+//				 const double  paymentSize       Monthly payment amount
+//				 const double  interestRate      Annual interest rate
+//               const    int  months            Number of monthly payments
+//
+// Returns:      none
+// Date:         10/17/2026
+//
+// Input:          Letter of the value to change, the new value and for
+//				   the payment or rate the first month it applies to
+// Output:         Changed rows, marked was/now/new/removed, and totals
+// Called By:      main()
+// Calls:		   StartWhatIf(), ChangeWhatIf(), WriteWhatIfChanges(),
+//				   ReadPaymentSize(), ReadInterestRate(), ReadMonths(),
+//				   ReadLoanSize(), safeReadInt(), PrintCommas(),
+//				   cleanBuffer()
+// History Log:    10/17/2026  added for incremental what-if tables
+//				   10/17/2026  input cleared when the table cannot be built
+//----------------------------------------------------------------------------
+void WhatIfTable(const double loanSize, const double paymentSize,
+	const double interestRate, const int months)
+{
+	static WhatIfSchedule whatIf;
+	static double base[3] = { 0 };      // Loan the what-if table started from
+	static int baseMonths = 0;
+	ScheduleWriter writer;
+	double amount = 0;
+	int from = 1;
+	int value = 0;
+
+	if ((baseMonths != months) || (base[0] != loanSize) ||
+		(base[1] != paymentSize) || (base[2] != interestRate))
+	{
+		FreeWhatIf(&whatIf);
+		baseMonths = 0;
+		if (!StartWhatIf(&whatIf, loanSize, paymentSize, interestRate,
+			months))
+		{
+			cleanBuffer();
+			puts("Could not build the table");
+			return;
+		}
+		base[0] = loanSize;
+		base[1] = paymentSize;
+		base[2] = interestRate;
+		baseMonths = months;
+	}
+
+	cleanBuffer();
+	puts("Change [P]ayment, [I]nterest rate, [N]umber of payments or "
+		"[L]oan size:");
+	value = toupper(getchar());
+	cleanBuffer();
+	switch (value)
+	{
+	case WHATIF_PAYMENT:
+		amount = ReadPaymentSize();
+		break;
+	case WHATIF_RATE:
+		amount = ReadInterestRate();
+		break;
+	case WHATIF_TERM:
+		amount = ReadMonths();
+		break;
+	case WHATIF_LOAN:
+		amount = ReadLoanSize();
+		break;
+	default:
+		puts("No change made");
+		return;
+	}
+	if ((value == WHATIF_PAYMENT) || (value == WHATIF_RATE))
+	{
+		puts("Enter the first month it applies to:");
+		safeReadInt(&from, "Enter the first month it applies to:");
+	}
+	if (ChangeWhatIf(&whatIf, (char)value, amount, from) < 0)
+	{
+		puts("No change made");
+		return;
+	}
+
+	printf("\n%d rows worked out again from month %d, %d rows differ\n\n",
+		whatIf.recomputed, whatIf.firstMonth, whatIf.changeCount);
+	printf(HEAD HEAD2 "\n");
+	if (AttachScheduleWriter(&writer, stdout))
+	{
+		WriteWhatIfChanges(&writer, &whatIf);
+		CloseScheduleWriter(&writer);
+	}
+	printf("\n\nNumber of monthly payments: %d\n", whatIf.schedule.months);
+	printf("Final payment size        : ");
+	PrintCommas(whatIf.schedule.rows[whatIf.schedule.months - 1].payment);
+	printf("Total payments            : ");
+	PrintCommas(whatIf.schedule.totalPaid);
+	printf("Total interest            : ");
+	PrintCommas(whatIf.schedule.totalInterest);
+}
+//----------------------------------------------------------------------------
 // Function: void PrintResults(const double loanSize, const double paymentSize,
 //							   const double interestRate, const int months)
 //							  
@@ -579,8 +866,13 @@ void SaveTable(const double loanSize, double paymentSize,
 // Input:          When prompted, user enters a filename for the table
 // Output:         Amortization table is saved to program's root directory
 // Called By:      main()
-// Calls:          RoundInterest()
+// Calls:          RoundInterest(), GetScheduleTotals()
 // History Log:    11/04/2016  JR completed version 1.0
+//				   10/17/2026  total payments read from GetSchedule(), so the
+//							   adjusted last payment is counted
+//				   10/17/2026  totals from GetScheduleTotals(), without the
+//							   table's rows; total interest and final
+//							   payment shown
 //----------------------------------------------------------------------------
 void PrintResults(const double loanSize, const double paymentSize,
 	const double interestRate, const int months)
@@ -589,14 +881,15 @@ void PrintResults(const double loanSize, const double paymentSize,
 	int topEighth = 0;
 	int floorInterest = 0;
 	double roundedInterest = roundInterest(interestRate, EIGHT);
-	double totalPayments = paymentSize * months;
+	ScheduleTotals totals;
 	int years = (int)floor(months / MONTHS_PER_YEAR);
 	int remainingMonths = months % MONTHS_PER_YEAR;
 
+	GetScheduleTotals(&totals, loanSize, paymentSize, interestRate, months);
 	floorInterest = (int)floor(roundedInterest);
 	topEighth = (int)((roundedInterest - floorInterest) * EIGHT);
 	
-	system("cls");
+	system(CLEAR_SCREEN);
 	puts("\n\n\n");
 	puts(LINE "\n");
 	printf("Loan amount               : ");
@@ -606,8 +899,12 @@ void PrintResults(const double loanSize, const double paymentSize,
 	printf("Number of monthly payments: %d (%d Years, %d Months)	\n",
 		months, years, remainingMonths);
 	puts(LINE);
+	printf("Final payment size        : ");
+	PrintCommas(totals.finalPayment);
 	printf("Total payments            : ");
-	PrintCommas(totalPayments);
+	PrintCommas(totals.totalPaid);
+	printf("Total interest            : ");
+	PrintCommas(totals.totalInterest);
 	printf("\n\n\tThe interest rate is:       %.3lf%c \n",
 		interestRate, PERCENT);
 	printf("\n\t(%d %d/%d)%% rounded to nearest 1/8th%%\n"
@@ -616,8 +913,8 @@ void PrintResults(const double loanSize, const double paymentSize,
 //----------------------------------------------------------------------------
 // Function:     void PrintCommas(const double amount)
 //												  
-// Description:  Prints larger numbers between 999 and 999 billion to screen 
-//				 with added comma separators so people can read them easier.
+// Description:  Prints an amount to screen as dollars and cents with added
+//				 comma separators so people can read them easier.
 //				 		 			 				  	     			
 // Parameters:	  const (double) amount	  The number to print out
 //		
@@ -635,68 +932,16 @@ void PrintResults(const double loanSize, const double paymentSize,
 // Called By:      ReadPaymentSize()
 //				   PrintResults()
 //				   ReadLoanSize()
-// Calls:          
+// Calls:          FormatCurrency()
 // History Log:    11/14/2016  JR completed version 1.0
+//				   10/17/2026  formats through FormatCurrency(), which groups
+//							   any amount (trillions included) and rounds
+//							   999.999 up to $1,000.00
 //----------------------------------------------------------------------------
 void PrintCommas(const double amount)
 {
-	int commas = 0;
-	int hundreds = 0;					//the hundreds place
-	int thousands = 0;                  //the thousands place
-	int intRemainder = 0;
-	long int millions = 0;              //the millions place
-	long long int billions = 0;			//the billions place
-	long long int balance = 0;
-	long int divisor = 0;
-	long long int intAmount = (long long int)floor(amount);
-	
-	double tempDouble = round((amount - intAmount) * HUNDRED) / HUNDRED;
-	intRemainder = (int)(round(tempDouble * 100));
-	
-	if (amount < THOUSAND)              //For number with 0 commas
-	{
-		printf("$%lld.%02d\n", intAmount, intRemainder);
-		return;
-	}
-	balance = intAmount;               //Figure out how many commas it needs
-	commas = ((amount >= THOUSAND) && (amount < MILLION)) ? 1 :
-		     ((amount >= MILLION) && (amount < BILLION)) ? 2 :
-		     ((amount >= BILLION) && (amount < TRILLION)) ? 3 : 4;
-	divisor = (commas == 1) ? THOUSAND :
-		      (commas == 2) ? MILLION : 
-		      (commas == 3) ? BILLION : TRILLION;
-	if (commas == 1)                     //Number in the thousands
-	{
-		thousands = (int)floor(intAmount / divisor);
-		printf("$%d,", thousands);
-		balance -= (long long)thousands * divisor;
-		printf("%03lld.%02d\n", balance, intRemainder);
-	}
-	if (commas == 2)                   // Number in the millions
-	{
-		millions = (long)balance / divisor;
-		printf("$%ld,", millions);
-		balance -= (long long)(millions * divisor);
-		thousands = (int)(balance / THOUSAND);
-		printf("%03d,", thousands);
-		balance -= thousands * THOUSAND;
-		printf("%03lld.%02d\n", balance, intRemainder);
-	}
-	if (commas == 3)                   // Number in the billions
-	{
-		billions = (long long)floor(intAmount / divisor);
-		printf("$%lld,", billions);
-		balance -= (long long)(billions * divisor);
-		millions = (long)(balance / MILLION);
-		printf("%03ld,", millions);
-		balance -= (long long)(millions * MILLION);
-		thousands = (int)balance / THOUSAND;
-		printf("%03d,", thousands);
-		balance -= thousands * THOUSAND;
-		printf("%03lld.%02d\n", balance, intRemainder);
-	}
-	if (commas >= 4)                  // Number in trillions or more
-		printf("$%.2lf\n", amount);
-}
-
+	char text[CURRENCY_TEXT_MAX];
 
+	FormatCurrency(text, sizeof(text), amount);
+	puts(text);
+}
@@ -8,6 +8,9 @@
 //
 //
 // History Log:    11/04/2016  JR completed version 1.0
+//				   10/17/2026  builds outside MSVC (CLEAR_SCREEN)
+//				   10/17/2026  added WhatIfTable()
+//				   10/17/2026  added getMonthsNeeded()
 //----------------------------------------------------------------------------
 
 #ifndef AMORT_H
@@ -16,7 +19,9 @@
 #include <stdlib.h>
 #include <math.h>
 #include <ctype.h>
+#ifdef _MSC_VER
 #pragma warning(disable: 4996)
+#endif
 
 #define LINE "__________________________________________________________________"
 #define HEAD "|  Month     | Payments | Principal Paid |"
@@ -30,6 +35,11 @@
 #define MONTHS_PROMPT "Enter number of payments (between 1 and 6000): \n"
 #define PAYMENT_PROMPT "\nEnter amount of monthly payment (greater than 0):\n "
 #define PERCENT '%'
+#ifdef _WIN32
+#define CLEAR_SCREEN "cls"
+#else
+#define CLEAR_SCREEN "clear"
+#endif
 #define ONE_CENT .01
 #define MONTHLY_DIVISOR 1200
 #define TOTAL_ROWS 40
@@ -46,6 +56,9 @@
 #define BILLION 1000000000
 #define TRILLION 1000000000000
 #define THOUSAND 1000
+#define RATE_TOLERANCE 1e-9         // Annual percent, see solveInterestRate()
+#define MAX_RATE_ITERATIONS 100
+#define NO_RATE -1
 
 
 void cleanBuffer();
@@ -58,6 +71,8 @@ void SaveTable(const double loanSize, double paymentSize,
 	const double interestRate, int months);
 void PrintResults(const double loanSize, const double paymentSize,
 	const double interestRate, const int months);
+void WhatIfTable(const double loanSize, const double paymentSize,
+	const double interestRate, const int months);
 void PrintCommas(const double amount);
 
 double ReadInterestRate();
@@ -70,7 +85,13 @@ double getLoanAmount(const double payment, const int numberOfPayments,
 	const double interestRate);
 double getInterestRate(const int months, const double principal, 
 	const double payment);
+double findInterestRate(const int months, const double principal, 
+	const double payment, int* iterations);
+double solveInterestRate(const int months, const double principal, 
+	const double payment, const double tolerance, int* iterations);
 int ReadMonths();
+double getMonthsNeeded(const double payment, const double principal,
+	const double interestRate);
 int getNumberOfMonths(const double payment, const double principal, 
 	const double interestRate);
 
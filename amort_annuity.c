@@ -0,0 +1,293 @@
+//----------------------------------------------------------------------------
+// File:			amort_annuity.c
+//
+// Description      Annuity factor tables for the Amort library. For a grid
+//					rate r (monthly) and term n, with x = (1 + r)^n, a row
+//					holds x / (x - 1), which getPaymentAmount() multiplies by
+//					principal * r, and (x - 1) / (r * x), which
+//					getLoanAmount() multiplies by the payment. Both are
+//					worked out with the same expressions as those functions,
+//					so a lookup gives the same result, bit for bit, as
+//					calling pow().
+//
+//					Rows are built on first use, under a lock, and published
+//					with StoreShared(); later lookups only read. Rows past
+//					the budget are not built and the callers use pow().
+//
+// Functions:	    const double* GetAnnuityFactors(const double
+//						interestRate, const int months)
+//					size_t SetAnnuityBudget(const size_t bytes)
+//					size_t GetAnnuityBytes(void)
+//					void ClearAnnuityTable(void)
+//					int SaveAnnuityTable(const char* filename)
+//					int LoadAnnuityTable(const char* filename)
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include "amort.h"
+#include "amort_annuity.h"
+#include "amort_platform.h"
+
+#define ANNUITY_MAGIC "AMORTANN"
+#define ANNUITY_MAGIC_LENGTH 8
+
+static void* volatile rows[ANNUITY_MAX_EIGHTHS + 1];
+static double noRow;                // Marks rows refused by the budget
+static size_t budget = ANNUITY_DEFAULT_BUDGET;
+static size_t rowBytes = 0;         // Bytes of the rows built
+static AmortLock tableLock = AMORT_LOCK_INIT;
+
+// Fills the factors of every term for a rate of eighths/8 percent.
+static void fillRow(double* row, const int eighths)
+{
+	const double monthlyInterest = (eighths / 8.0) / MONTHLY_DIVISOR;
+
+	for (int months = 1; months <= FIVE_HUNDRED_YEARS; months++)
+	{
+		double interestExp = pow(monthlyInterest + ONE, (double)months);
+
+		row[0] = interestExp / (interestExp - ONE);
+		row[1] = (interestExp - 1) / (monthlyInterest * interestExp);
+		row += ANNUITY_FACTORS;
+	}
+}
+
+// Returns a new row for the rate, or NULL past the budget. Call locked.
+static double* newRow(void)
+{
+	double* row = NULL;
+
+	if (rowBytes + ANNUITY_ROW_BYTES > budget)
+		return NULL;
+	row = (double*)malloc(ANNUITY_ROW_BYTES);
+	if (row != NULL)
+		rowBytes += ANNUITY_ROW_BYTES;
+	return row;
+}
+//----------------------------------------------------------------------------
+// Function:	    const double* GetAnnuityFactors(const double interestRate,
+//						const int months)
+//
+// Description:		Looks up the annuity factors of a grid rate and term,
+//					building the row of the rate on first use. factors[0] is
+//					x / (x - 1) and factors[1] is (x - 1) / (r * x), with r
+//					the monthly rate and x = (1 + r)^months.
+//
+// Parameters:	    const (double) interestRate   Annual rate, a whole
+//												  number of 1/8ths percent
+//				    const (int)    months         Number of payments
+//
+// Returns:		    (const double*) factors   The two factors, or NULL if the
+//											  rate or term is off the grid
+//											  or the row is over budget
+// Date:            10/17/2026
+// Called By:       getPaymentAmount(), getLoanAmount()
+// Calls:		    LoadShared(), StoreShared(), AcquireLock(),
+//					ReleaseLock()
+// History Log:     10/17/2026  added for the annuity factor tables
+//----------------------------------------------------------------------------
+const double* GetAnnuityFactors(const double interestRate, const int months)
+{
+	const double scaled = interestRate * 8;
+	double* row = NULL;
+	int eighths = 0;
+
+	if ((months < 1) || (months > FIVE_HUNDRED_YEARS) || !(scaled >= 1) ||
+		(scaled > ANNUITY_MAX_EIGHTHS) || (scaled != floor(scaled)))
+		return NULL;
+	eighths = (int)scaled;
+	row = (double*)LoadShared(&rows[eighths]);
+	if (row == NULL)
+	{
+		AcquireLock(&tableLock);
+		row = (double*)rows[eighths];
+		if (row == NULL)
+		{
+			row = newRow();
+			if (row != NULL)
+				fillRow(row, eighths);
+			else
+				row = &noRow;
+			StoreShared(&rows[eighths], row);
+		}
+		ReleaseLock(&tableLock);
+	}
+	if (row == &noRow)
+		return NULL;
+	return row + (size_t)(months - 1) * ANNUITY_FACTORS;
+}
+//----------------------------------------------------------------------------
+// Function:	    size_t SetAnnuityBudget(const size_t bytes)
+//
+// Description:		Sets how much memory the rows may take. Each rate row is
+//					ANNUITY_ROW_BYTES; 0 turns the table off for rates not
+//					yet built. Rates refused by the old budget are tried
+//					again. Rows already built are kept, see
+//					ClearAnnuityTable().
+//
+// Parameters:	    const (size_t) bytes   New budget in bytes
+//
+// Returns:		    (size_t) previous   The budget before the call
+// Date:            10/17/2026
+// History Log:     10/17/2026  added for the annuity factor tables
+//----------------------------------------------------------------------------
+size_t SetAnnuityBudget(const size_t bytes)
+{
+	size_t previous = 0;
+
+	AcquireLock(&tableLock);
+	previous = budget;
+	budget = bytes;
+	for (int e = 0; e <= ANNUITY_MAX_EIGHTHS; e++)
+		if (rows[e] == &noRow)
+			StoreShared(&rows[e], NULL);
+	ReleaseLock(&tableLock);
+	return previous;
+}
+//----------------------------------------------------------------------------
+// Function:	    size_t GetAnnuityBytes(void)
+//
+// Description:		Returns the memory taken by the rows built so far.
+//
+// Parameters:	    none
+//
+// Returns:		    (size_t) bytes   Bytes held by rows
+// Date:            10/17/2026
+// History Log:     10/17/2026  added for the annuity factor tables
+//----------------------------------------------------------------------------
+size_t GetAnnuityBytes(void)
+{
+	size_t bytes = 0;
+
+	AcquireLock(&tableLock);
+	bytes = rowBytes;
+	ReleaseLock(&tableLock);
+	return bytes;
+}
+//----------------------------------------------------------------------------
+// Function:	    void ClearAnnuityTable(void)
+//
+// Description:		Frees every row. No other thread may be using factors
+//					from the table.
+//
+// Parameters:	    none
+//
+// Returns:		    none
+// Date:            10/17/2026
+// History Log:     10/17/2026  added for the annuity factor tables
+//----------------------------------------------------------------------------
+void ClearAnnuityTable(void)
+{
+	AcquireLock(&tableLock);
+	for (int e = 0; e <= ANNUITY_MAX_EIGHTHS; e++)
+	{
+		if (rows[e] != &noRow)
+			free(rows[e]);
+		StoreShared(&rows[e], NULL);
+	}
+	rowBytes = 0;
+	ReleaseLock(&tableLock);
+}
+//----------------------------------------------------------------------------
+// Function:	    int SaveAnnuityTable(const char* filename)
+//
+// Description:		Writes the rows built so far to a file: the magic text
+//					ANNUITY_MAGIC, the number of terms and of rows (ints),
+//					then each row as its rate in 1/8ths (int) followed by its
+//					factors. Numbers are in the byte order of this machine.
+//
+// Parameters:	    const (char*) filename   File to create
+//
+// Returns:		    (int) count   Rows written, -1 if the file could not be
+//								  written
+// Date:            10/17/2026
+// History Log:     10/17/2026  added for the annuity factor tables
+//----------------------------------------------------------------------------
+int SaveAnnuityTable(const char* filename)
+{
+	FILE* fp = fopen(filename, "wb");
+	int terms = FIVE_HUNDRED_YEARS;
+	int count = 0;
+	int ok = (fp != NULL);
+
+	if (!ok)
+		return -1;
+	AcquireLock(&tableLock);
+	for (int e = 1; e <= ANNUITY_MAX_EIGHTHS; e++)
+		count += (rows[e] != NULL) && (rows[e] != &noRow);
+	ok = (fwrite(ANNUITY_MAGIC, 1, ANNUITY_MAGIC_LENGTH, fp) ==
+		ANNUITY_MAGIC_LENGTH) && (fwrite(&terms, sizeof(int), 1, fp) == 1) &&
+		(fwrite(&count, sizeof(int), 1, fp) == 1);
+	for (int e = 1; ok && (e <= ANNUITY_MAX_EIGHTHS); e++)
+		if ((rows[e] != NULL) && (rows[e] != &noRow))
+			ok = (fwrite(&e, sizeof(int), 1, fp) == 1) &&
+				(fwrite(rows[e], ANNUITY_ROW_BYTES, 1, fp) == 1);
+	ReleaseLock(&tableLock);
+	if (fclose(fp) != 0)
+		ok = 0;
+	return ok ? count : -1;
+}
+//----------------------------------------------------------------------------
+// Function:	    int LoadAnnuityTable(const char* filename)
+//
+// Description:		Reads rows written by SaveAnnuityTable(), as far as the
+//					budget allows, in place of building them. Rates already
+//					built keep their rows. The file must come from a build
+//					whose pow() gives the same results, or lookups will no
+//					longer match pow() bit for bit.
+//
+// Parameters:	    const (char*) filename   File to read
+//
+// Returns:		    (int) count   Rows loaded, -1 if the file is missing or
+//								  not an annuity table
+// Date:            10/17/2026
+// History Log:     10/17/2026  added for the annuity factor tables
+//----------------------------------------------------------------------------
+int LoadAnnuityTable(const char* filename)
+{
+	FILE* fp = fopen(filename, "rb");
+	char magic[ANNUITY_MAGIC_LENGTH];
+	int terms = 0;
+	int count = 0;
+	int loaded = 0;
+
+	if (fp == NULL)
+		return -1;
+	if ((fread(magic, 1, ANNUITY_MAGIC_LENGTH, fp) != ANNUITY_MAGIC_LENGTH) ||
+		(memcmp(magic, ANNUITY_MAGIC, ANNUITY_MAGIC_LENGTH) != 0) ||
+		(fread(&terms, sizeof(int), 1, fp) != 1) ||
+		(terms != FIVE_HUNDRED_YEARS) ||
+		(fread(&count, sizeof(int), 1, fp) != 1))
+	{
+		fclose(fp);
+		return -1;
+	}
+	AcquireLock(&tableLock);
+	for (int r = 0; r < count; r++)
+	{
+		int eighths = 0;
+		double* row = NULL;
+
+		if ((fread(&eighths, sizeof(int), 1, fp) != 1) || (eighths < 1) ||
+			(eighths > ANNUITY_MAX_EIGHTHS))
+			break;
+		if (((rows[eighths] != NULL) && (rows[eighths] != &noRow)) ||
+			((row = newRow()) == NULL))
+		{
+			if (fseek(fp, (long)ANNUITY_ROW_BYTES, SEEK_CUR) != 0)
+				break;
+			continue;
+		}
+		if (fread(row, ANNUITY_ROW_BYTES, 1, fp) != 1)
+		{
+			free(row);
+			rowBytes -= ANNUITY_ROW_BYTES;
+			break;
+		}
+		StoreShared(&rows[eighths], row);
+		loaded++;
+	}
+	ReleaseLock(&tableLock);
+	fclose(fp);
+	return loaded;
+}
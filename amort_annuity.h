@@ -0,0 +1,33 @@
+//----------------------------------------------------------------------------
+// File:			amort_annuity.h
+//
+// Description:     Header file for the annuity factor tables
+//					(amort_annuity.c). Rates are snapped to 1/8th percent and
+//					terms are at most FIVE_HUNDRED_YEARS, so the factors
+//					getPaymentAmount() and getLoanAmount() need come from a
+//					finite grid. One row holds both factors for every term
+//					of one grid rate; rows are built the first time their
+//					rate is asked for, up to a memory budget, and can be
+//					saved to and loaded from a file.
+//
+// History Log:    10/17/2026  added for the annuity factor tables
+//----------------------------------------------------------------------------
+
+#ifndef AMORT_ANNUITY_H
+#define AMORT_ANNUITY_H
+#include <stddef.h>
+
+#define ANNUITY_MAX_EIGHTHS 400     // Grid runs 1/8 to 50 percent
+#define ANNUITY_FACTORS 2           // Payment factor, loan factor
+#define ANNUITY_ROW_BYTES \
+	(FIVE_HUNDRED_YEARS * ANNUITY_FACTORS * sizeof(double))
+#define ANNUITY_DEFAULT_BUDGET (64 * ANNUITY_ROW_BYTES)   // About 6 MB
+
+const double* GetAnnuityFactors(const double interestRate, const int months);
+size_t SetAnnuityBudget(const size_t bytes);
+size_t GetAnnuityBytes(void);
+void ClearAnnuityTable(void);
+int SaveAnnuityTable(const char* filename);
+int LoadAnnuityTable(const char* filename);
+
+#endif
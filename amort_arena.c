@@ -0,0 +1,98 @@
+//----------------------------------------------------------------------------
+// File:			amort_arena.c
+//
+// Description      Bump arena for the Amort library. Allocation moves a
+//					pointer forward; ResetArena() gives everything back.
+//
+// Functions:	    int InitArena(ScheduleArena* arena, size_t size)
+//					void* ArenaAlloc(ScheduleArena* arena, size_t size)
+//					void ResetArena(ScheduleArena* arena)
+//					void FreeArena(ScheduleArena* arena)
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include "amort_arena.h"
+#include "amort_platform.h"
+
+//----------------------------------------------------------------------------
+// Function:	    int InitArena(ScheduleArena* arena, size_t size)
+//
+// Description:		Allocates an empty arena of size bytes.
+//
+// Parameters:	    (ScheduleArena*) arena   Arena to set up
+//				    (size_t)         size    Bytes it can hand out
+//
+// Returns:		    (int) 1 on success, 0 when out of memory
+// Date:            10/17/2026
+// Called By:       GetSchedule()
+// Calls:		    AlignedAlloc()
+// History Log:     10/17/2026  added for the shared schedule generator
+//----------------------------------------------------------------------------
+int InitArena(ScheduleArena* arena, size_t size)
+{
+	size = (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+	arena->base = (char*)AlignedAlloc(size, ARENA_ALIGNMENT);
+	arena->size = (arena->base == NULL) ? 0 : size;
+	arena->used = 0;
+	return arena->base != NULL;
+}
+//----------------------------------------------------------------------------
+// Function:	    void* ArenaAlloc(ScheduleArena* arena, size_t size)
+//
+// Description:		Hands out the next size bytes of the arena, aligned to
+//					ARENA_ALIGNMENT.
+//
+// Parameters:	    (ScheduleArena*) arena   Arena to allocate from
+//				    (size_t)         size    Bytes wanted
+//
+// Returns:		    (void*) block   The bytes, or NULL if the arena is full
+// Date:            10/17/2026
+// Called By:       BuildSchedule()
+// History Log:     10/17/2026  added for the shared schedule generator
+//----------------------------------------------------------------------------
+void* ArenaAlloc(ScheduleArena* arena, size_t size)
+{
+	void* block = NULL;
+
+	size = (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+	if ((arena->base == NULL) || (size > arena->size - arena->used))
+		return NULL;
+	block = arena->base + arena->used;
+	arena->used += size;
+	return block;
+}
+//----------------------------------------------------------------------------
+// Function:	    void ResetArena(ScheduleArena* arena)
+//
+// Description:		Gives back everything allocated from the arena. The block
+//					itself is kept for the next use.
+//
+// Parameters:	    (ScheduleArena*) arena   Arena to empty
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       GetSchedule()
+// History Log:     10/17/2026  added for the shared schedule generator
+//----------------------------------------------------------------------------
+void ResetArena(ScheduleArena* arena)
+{
+	arena->used = 0;
+}
+//----------------------------------------------------------------------------
+// Function:	    void FreeArena(ScheduleArena* arena)
+//
+// Description:		Releases the arena's block.
+//
+// Parameters:	    (ScheduleArena*) arena   Arena to release
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       GetSchedule()
+// Calls:		    AlignedFree()
+// History Log:     10/17/2026  added for the shared schedule generator
+//----------------------------------------------------------------------------
+void FreeArena(ScheduleArena* arena)
+{
+	AlignedFree(arena->base);
+	memset(arena, 0, sizeof(ScheduleArena));
+}
@@ -0,0 +1,30 @@
+//----------------------------------------------------------------------------
+// File:			amort_arena.h
+//
+// Description:     Header file for the bump arena (amort_arena.c). An arena
+//					is one aligned block handed out front to back and
+//					released all at once, so building a schedule costs no
+//					malloc() per row and no free() afterwards.
+//
+// History Log:    10/17/2026  added for the shared schedule generator
+//----------------------------------------------------------------------------
+
+#ifndef AMORT_ARENA_H
+#define AMORT_ARENA_H
+#include <stddef.h>
+
+#define ARENA_ALIGNMENT 64          // Every allocation starts a cache line
+
+typedef struct
+{
+	char* base;                     // Start of the block
+	size_t size;                    // Bytes in the block
+	size_t used;                    // Bytes handed out so far
+} ScheduleArena;
+
+int InitArena(ScheduleArena* arena, size_t size);
+void* ArenaAlloc(ScheduleArena* arena, size_t size);
+void ResetArena(ScheduleArena* arena);
+void FreeArena(ScheduleArena* arena);
+
+#endif
@@ -0,0 +1,346 @@
+//----------------------------------------------------------------------------
+// File:			amort_arm.c
+//
+// Description      Adjustable rate engine for the Amort library. Between
+//					two resets the rate and the payment are fixed, so
+//					PriceArm() takes each segment in one step with
+//					ClosedFormBalance(): a 30 year loan that resets every
+//					year costs 30 steps, not 360 months. At each reset the
+//					rate is held to the caps and floor and the payment is
+//					worked out again with getPaymentAmount() on the balance
+//					and months left. The closed form does not round the
+//					interest to the cent each month, so its balance at a
+//					reset can be a few cents from the table's and the new
+//					payment now and then a cent apart; FillArmRows() gives
+//					the table itself. PriceArmBook() prices a book of loans
+//					on several threads.
+//
+// Functions:	    double LimitArmRate(const RateLimits* limits,
+//						const double previous, const double asked)
+//					int PriceArm(ArmResult* result, ArmSegment* segments,
+//						const ArmLoan* loan)
+//					int FillArmRows(ScheduleRow* rows, const ArmLoan* loan)
+//					size_t PriceArmBook(ArmResult* results,
+//						const ArmLoan* loans, const size_t count,
+//						int threads)
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include "amort.h"
+#include "amort_arm.h"
+#include "amort_platform.h"
+#include "amort_prepay.h"
+
+typedef struct
+{
+	const ArmLoan* loans;
+	ArmResult* results;
+	size_t count;
+	size_t priced;                  // Loans that passed validArm()
+} ArmSlice;
+
+// Returns 1 if the loan is one the engine can price. A loan of zero has
+// no payoff month, so it is refused like the batch records refuse it.
+static int validArm(const ArmLoan* loan)
+{
+	if (!(loan->loanSize > 0) || !isfinite(loan->loanSize) ||
+		!(loan->interestRate >= 0) || !isfinite(loan->interestRate) ||
+		(loan->months < 1) || (loan->months > FIVE_HUNDRED_YEARS) ||
+		(loan->count < 0) || ((loan->count > 0) && (loan->resets == NULL)))
+		return 0;
+	for (int i = 0; i < loan->count; i++)
+	{
+		if ((loan->resets[i].month < 2) || !(loan->resets[i].rate >= 0) ||
+			!isfinite(loan->resets[i].rate) || ((i > 0) &&
+			(loan->resets[i].month <= loan->resets[i - 1].month)))
+			return 0;
+	}
+	return 1;
+}
+
+// Prices the loans of one slice.
+static void priceSlice(void* arg)
+{
+	ArmSlice* slice = (ArmSlice*)arg;
+
+	for (size_t i = 0; i < slice->count; i++)
+		slice->priced += PriceArm(&slice->results[i], NULL, &slice->loans[i]);
+}
+//----------------------------------------------------------------------------
+// Function:	    double LimitArmRate(const RateLimits* limits,
+//						const double previous, const double asked)
+//
+// Description:		Holds the rate asked for at a reset to the periodic cap
+//					around the previous rate, then to the lifetime cap, then
+//					to the floor. A cap of 0 is no cap.
+//
+// Parameters:	    const (RateLimits*)  limits     Caps and floor
+//				    const (double)       previous   Rate before the reset
+//				    const (double)       asked      Index + margin
+//
+// Returns:		    (double) rate   Annual rate of the new segment
+// Date:            10/17/2026
+// Called By:       PriceArm(), FillArmRows()
+// History Log:     10/17/2026  added for the adjustable rate engine
+//----------------------------------------------------------------------------
+double LimitArmRate(const RateLimits* limits, const double previous,
+	const double asked)
+{
+	double rate = asked;
+
+	if (limits->periodicCap > 0)
+		rate = fmin(fmax(rate, previous - limits->periodicCap),
+			previous + limits->periodicCap);
+	if (limits->lifetimeCap > 0)
+		rate = fmin(rate, limits->lifetimeCap);
+	return fmax(rate, limits->floor);
+}
+//----------------------------------------------------------------------------
+// Function:	    int PriceArm(ArmResult* result, ArmSegment* segments,
+//						const ArmLoan* loan)
+//
+// Description:		Works out the payoff month, interest and total paid of
+//					an ARM one rate segment at a time. Each segment's
+//					payment comes from getPaymentAmount() on the balance
+//					and months left, and its end balance from
+//					ClosedFormBalance(); a segment in which the balance
+//					reaches zero ends the loan there, and the payment of
+//					the last month takes what is left, as in
+//					DisplayTable(). Resets after the last month are not
+//					used. Totals are rounded to the cent.
+//
+// Parameters:	    (ArmResult*)      result     Receives the totals
+//				    (ArmSegment*)     segments   Receives each segment, room
+//												 for count + 1, or NULL
+//				    const (ArmLoan*)  loan       The loan and its resets
+//
+// Returns:		    (int) 1 on success, 0 if the loan or a reset is not
+//					valid
+// Date:            10/17/2026
+// Called By:       PriceArmBook(), main() of bench_arm
+// Calls:		    LimitArmRate(), getPaymentAmount(), roundInterest(),
+//					ClosedFormBalance(), ClosedFormPayoff(), RoundCents()
+// History Log:     10/17/2026  added for the adjustable rate engine
+//				    10/17/2026  totals rounded by the shared RoundCents()
+//----------------------------------------------------------------------------
+int PriceArm(ArmResult* result, ArmSegment* segments, const ArmLoan* loan)
+{
+	double balance = loan->loanSize;
+	double rate = loan->interestRate;
+	double interest = 0;
+	double paid = 0;
+	int month = 1;
+
+	memset(result, 0, sizeof(ArmResult));
+	if (!validArm(loan))
+		return 0;
+	for (int s = 0; (s <= loan->count) && (month <= loan->months); s++)
+	{
+		const int end = ((s < loan->count) &&
+			(loan->resets[s].month <= loan->months)) ?
+			loan->resets[s].month - 1 : loan->months;
+		const int k = end - month + 1;
+		ArmSegment segment;
+		double monthly = 0;
+		double after = 0;
+
+		if (s > 0)
+			rate = LimitArmRate(&loan->limits, rate, loan->resets[s - 1].rate);
+		monthly = roundInterest(rate, 8) / MONTHLY_DIVISOR;
+		segment.month = month;
+		segment.rate = rate;
+		segment.payment = getPaymentAmount(loan->months - month + 1, balance,
+			rate);
+		after = ClosedFormBalance(balance, segment.payment, monthly, k);
+		if (after <= 0)                 // Paid off in this segment
+		{
+			const int n = ClosedFormPayoff(balance, segment.payment, monthly,
+				k);
+			double before = ClosedFormBalance(balance, segment.payment,
+				monthly, n - 1);
+
+			segment.length = n;
+			segment.interest = (n - 1) * segment.payment -
+				(balance - before) + before * monthly;
+			result->finalPayment = before * (ONE + monthly);
+			paid += (n - 1) * segment.payment + result->finalPayment;
+			balance = 0;
+		}
+		else
+		{
+			segment.length = k;
+			segment.interest = k * segment.payment - (balance - after);
+			paid += k * segment.payment;
+			balance = after;
+			if (end == loan->months)    // Last payment takes the rest
+			{
+				result->finalPayment = segment.payment + balance;
+				paid += balance;
+				balance = 0;
+			}
+		}
+		segment.balance = balance;
+		interest += segment.interest;
+		month += segment.length;
+		if (segments != NULL)
+			segments[result->segments] = segment;
+		result->segments++;
+		if (balance == 0)
+			break;
+	}
+	result->payoffMonth = month - 1;
+	result->totalInterest = RoundCents(interest);
+	result->totalPaid = RoundCents(paid);
+	result->finalPayment = RoundCents(result->finalPayment);
+	return 1;
+}
+//----------------------------------------------------------------------------
+// Function:	    int FillArmRows(ScheduleRow* rows, const ArmLoan* loan)
+//
+// Description:		Works out the amortization table of an ARM month by
+//					month, with the interest of each month rounded to the
+//					cent as in FillScheduleRows(). At each reset the rate
+//					is held to the limits and the payment is worked out
+//					again on the table's balance. With no resets the rows
+//					are those of FillScheduleRows() up to the month the
+//					balance reaches zero, where the table stops.
+//
+// Parameters:	    (ScheduleRow*)    rows   Receives the rows, room for
+//											 months
+//				    const (ArmLoan*)  loan   The loan and its resets
+//
+// Returns:		    (int) rows   Rows written (the payoff month), 0 if the
+//								 loan or a reset is not valid
+// Date:            10/17/2026
+// Called By:       main() of bench_arm
+// Calls:		    LimitArmRate(), getPaymentAmount(), roundInterest(),
+//					MonthInterest()
+// History Log:     10/17/2026  added for the adjustable rate engine
+//				    10/17/2026  interest from the shared MonthInterest()
+//----------------------------------------------------------------------------
+int FillArmRows(ScheduleRow* rows, const ArmLoan* loan)
+{
+	double loanBalance = loan->loanSize;
+	double rate = loan->interestRate;
+	double roundedInterest = roundInterest(rate, 8);
+	double paymentSize = 0;
+	double interestToDate = 0;
+	int next = 0;
+
+	if (!validArm(loan))
+		return 0;
+	paymentSize = getPaymentAmount(loan->months, loanBalance, rate);
+	for (int i = 1; i <= loan->months; i++)
+	{
+		double payment = 0;
+		double interestPaid = 0;
+		double principalPaid = 0;
+		ScheduleRow* row = &rows[i - 1];
+
+		if ((next < loan->count) && (loan->resets[next].month == i))
+		{
+			rate = LimitArmRate(&loan->limits, rate, loan->resets[next].rate);
+			roundedInterest = roundInterest(rate, 8);
+			paymentSize = getPaymentAmount(loan->months - i + 1, loanBalance,
+				rate);
+			next++;
+		}
+		payment = paymentSize;
+		interestPaid = MonthInterest(loanBalance, roundedInterest);
+		principalPaid = payment - interestPaid;
+		loanBalance -= principalPaid;
+		if (((i == loan->months) || (loanBalance < 0)) && (loanBalance != 0))
+		{
+			payment += loanBalance;             //adjust the last payment
+			principalPaid += loanBalance;
+			loanBalance -= loanBalance;
+		}
+		row->month = i;
+		row->payment = payment;
+		row->principal = principalPaid;
+		row->interest = interestPaid;
+		row->balance = loanBalance;
+		interestToDate += interestPaid;
+		row->interestToDate = interestToDate;
+		if ((loanBalance == 0) && (payment != 0))
+			return i;
+	}
+	return loan->months;
+}
+//----------------------------------------------------------------------------
+// Function:	    size_t PriceArmBook(ArmResult* results,
+//						const ArmLoan* loans, const size_t count,
+//						int threads)
+//
+// Description:		Prices a book of ARMs with PriceArm(). The book is cut
+//					into one slice per thread holding about the same number
+//					of rate segments; every loan writes only its own
+//					result, so the results are the same for any number of
+//					threads.
+//
+// Parameters:	    (ArmResult*)      results   Receives one result per loan
+//				    const (ArmLoan*)  loans     The book
+//				    const (size_t)    count     Number of loans
+//				    (int)             threads   Worker threads, 0 for one
+//												per CPU
+//
+// Returns:		    (size_t) priced   Loans that were valid
+// Date:            10/17/2026
+// Called By:       main() of bench_arm
+// Calls:		    PriceArm(), StartThread(), JoinThread(), GetCpuCount()
+// History Log:     10/17/2026  added for the adjustable rate engine
+//----------------------------------------------------------------------------
+size_t PriceArmBook(ArmResult* results, const ArmLoan* loans,
+	const size_t count, int threads)
+{
+	AmortThread handles[ARM_MAX_THREADS];
+	int launched[ARM_MAX_THREADS] = { 0 };
+	ArmSlice slices[ARM_MAX_THREADS];
+	long long steps = 0;
+	long long taken = 0;
+	size_t first = 0;
+	size_t priced = 0;
+	int used = 0;
+
+	if (threads <= 0)
+		threads = GetCpuCount();
+	if (threads > ARM_MAX_THREADS)
+		threads = ARM_MAX_THREADS;
+	if ((size_t)threads > count)
+		threads = (count > 0) ? (int)count : 1;
+
+	for (size_t i = 0; i < count; i++)
+		steps += (loans[i].count > 0) ? loans[i].count + 1 : 1;
+	for (used = 0; (used < threads) && (first < count); used++)
+	{
+		long long target = steps * (used + 1) / threads;
+		size_t last = first;
+
+		while ((last < count) && ((taken < target) || (last == first) ||
+			(used == threads - 1)))
+		{
+			taken += (loans[last].count > 0) ? loans[last].count + 1 : 1;
+			last++;
+		}
+		slices[used].loans = loans + first;
+		slices[used].results = results + first;
+		slices[used].count = last - first;
+		slices[used].priced = 0;
+		first = last;
+	}
+
+	for (int t = 1; t < used; t++)         // Slice 0 runs on this thread
+		launched[t] = StartThread(&handles[t], priceSlice, &slices[t]);
+	if (used > 0)
+		priceSlice(&slices[0]);
+	for (int t = 1; t < used; t++)
+	{
+		if (launched[t])
+			JoinThread(handles[t]);
+		else
+			priceSlice(&slices[t]);
+	}
+	for (int t = 0; t < used; t++)
+		priced += slices[t].priced;
+	return priced;
+}
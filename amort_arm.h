@@ -0,0 +1,72 @@
+//----------------------------------------------------------------------------
+// File:			amort_arm.h
+//
+// Description:     Header file for the adjustable rate engine (amort_arm.c).
+//					An ARM starts at one rate and resets to a new one at
+//					given months; each new rate is held to the loan's
+//					periodic cap, lifetime cap and floor, and at each reset
+//					the payment is worked out again, as getPaymentAmount()
+//					does, on the balance and months left. PriceArm() takes
+//					each segment in one closed form step, FillArmRows()
+//					works out the table month by month with cent rounding.
+//
+// History Log:    10/17/2026  added for the adjustable rate engine
+//----------------------------------------------------------------------------
+
+#ifndef AMORT_ARM_H
+#define AMORT_ARM_H
+#include <stddef.h>
+#include "amort_schedule.h"
+
+#define ARM_MAX_THREADS 256
+
+typedef struct
+{
+	int month;                      // First month at the new rate, 2 on
+	double rate;                    // Annual rate asked for, index + margin
+} RateReset;
+
+typedef struct
+{
+	double periodicCap;             // Most one reset moves the rate, 0 none
+	double lifetimeCap;             // Highest rate, 0 for none
+	double floor;                   // Lowest rate
+} RateLimits;
+
+typedef struct
+{
+	double loanSize;                // Total amount of loan
+	double interestRate;            // Annual rate until the first reset
+	int months;                     // Number of monthly payments
+	int count;                      // Number of resets
+	const RateReset* resets;        // In month order
+	RateLimits limits;
+} ArmLoan;
+
+typedef struct
+{
+	int month;                      // First month of the segment
+	int length;                     // Months paid in the segment
+	double rate;                    // Annual rate, after the limits
+	double payment;                 // Monthly payment of the segment
+	double interest;                // Interest paid in the segment
+	double balance;                 // Balance at the end of the segment
+} ArmSegment;
+
+typedef struct
+{
+	int payoffMonth;                // Month of the last payment
+	int segments;                   // Rate segments paid
+	double totalInterest;
+	double totalPaid;
+	double finalPayment;            // Last payment, with the adjustment
+} ArmResult;
+
+double LimitArmRate(const RateLimits* limits, const double previous,
+	const double asked);
+int PriceArm(ArmResult* result, ArmSegment* segments, const ArmLoan* loan);
+int FillArmRows(ScheduleRow* rows, const ArmLoan* loan);
+size_t PriceArmBook(ArmResult* results, const ArmLoan* loans,
+	const size_t count, int threads);
+
+#endif
@@ -0,0 +1,548 @@
+//----------------------------------------------------------------------------
+// File:			amort_batch.c
+//
+// Description      Headless batch pricing mode for the Amort library. Reads
+//					loan records from a file or stdin, solves the missing
+//					value of each record on all cores and writes one result
+//					row per record, in input order.
+//
+// Functions:	    int ParseLoanRecord(const char* line, LoanRecord* record)
+//					int ParseLoanText(const char* text, const size_t length,
+//						LoanRecord* record)
+//					void PriceLoanRecord(LoanRecord* record)
+//					int FormatLoanRecord(char* text, const size_t size,
+//						const LoanRecord* record)
+//					void WriteLoanRecord(FILE* fp, const LoanRecord* record)
+//					int NextLoanRecord(FILE* in, LoanRecord* record)
+//					long long RunBatch(FILE* in, FILE* out, int threads)
+//					long long RunBatchRecords(RecordFile* file, FILE* out,
+//						int threads, FILE* errors)
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include "amort.h"
+#include "amort_batch.h"
+#include "amort_metrics.h"
+#include "amort_platform.h"
+#include "amort_records.h"
+
+#define FIELD_COUNT 4
+#define EXACT_DIGITS 19             // Digits that fit an unsigned long long
+#define EXACT_MANTISSA (1ULL << 53) // Largest run of exact whole doubles
+#define EXACT_POWER 22              // Largest exact power of ten
+#define MAX_THREADS 256
+
+typedef struct
+{
+	LoanRecord* records;
+	size_t count;
+} BatchSlice;
+
+typedef struct
+{
+	RecordFile* file;
+	FILE* errors;                   // Bad records reported here, or NULL
+} MappedSource;
+
+typedef int (*RecordReader)(void* source, LoanRecord* record);
+
+// Powers of ten that doubles hold exactly.
+static const double EXACT_POWERS[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6,
+	1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18,
+	1e19, 1e20, 1e21, 1e22 };
+
+// Reads a number where it lies, as strtod() would, without needing a NUL
+// after it. A plain decimal of up to EXACT_DIGITS digits is worked out
+// here: its digits and the power of ten are both exact doubles, so the one
+// division rounds correctly. Anything else (an exponent, hex, inf, nan,
+// more digits) is copied out and given to strtod(). Returns the first
+// character after the number, or NULL if there is none.
+static const char* parseNumber(const char* text, const char* end,
+	double* value)
+{
+	char copy[BATCH_LINE_MAX] = "";
+	const char* cursor = text;
+	char* stop = NULL;
+	unsigned long long digits = 0;
+	int count = 0;
+	int scale = 0;
+	int negative = 0;
+	size_t length = 0;
+
+	if ((cursor < end) && ((*cursor == '-') || (*cursor == '+')))
+		negative = (*cursor++ == '-');
+	for (; (cursor < end) && (*cursor >= '0') && (*cursor <= '9'); cursor++)
+		digits = (count++ < EXACT_DIGITS) ? digits * 10 +
+			(unsigned long long)(*cursor - '0') : digits;
+	if ((cursor < end) && (*cursor == '.'))
+		for (cursor++; (cursor < end) && (*cursor >= '0') &&
+			(*cursor <= '9'); cursor++, scale++)
+			digits = (count++ < EXACT_DIGITS) ? digits * 10 +
+				(unsigned long long)(*cursor - '0') : digits;
+	if ((count > 0) && (count <= EXACT_DIGITS) &&
+		(digits <= EXACT_MANTISSA) && (scale <= EXACT_POWER) &&
+		((cursor == end) || ((*cursor != 'e') && (*cursor != 'E') &&
+		(*cursor != 'x') && (*cursor != 'X'))))
+	{
+		*value = (double)digits / EXACT_POWERS[scale];
+		*value = negative ? -*value : *value;
+		return cursor;
+	}
+
+	length = (size_t)(end - text);
+	length = (length < sizeof(copy) - 1) ? length : sizeof(copy) - 1;
+	memcpy(copy, text, length);
+	copy[length] = '\0';
+	*value = strtod(copy, &stop);
+	return (stop == copy) ? NULL : text + (stop - copy);
+}
+
+// Parses one field. Returns 1 for a number, 0 for a blank or '?' field and
+// -1 for text that is not a number. *stop is left on the field delimiter.
+static int parseField(const char* text, const char* end, double* value,
+	const char** stop)
+{
+	while ((text < end) && (*text == ' '))
+		text++;
+	if ((text == end) || (*text == ',') || (*text == '\t') ||
+		(*text == '\0') || (*text == '\n') || (*text == '\r') ||
+		(*text == '?'))
+	{
+		if ((text < end) && (*text == '?'))
+			text++;
+		while ((text < end) && (*text == ' '))
+			text++;
+		*stop = text;
+		return 0;
+	}
+	if ((text = parseNumber(text, end, value)) == NULL)
+		return -1;
+	while ((text < end) && (*text == ' '))
+		text++;
+	*stop = text;
+	return 1;
+}
+//----------------------------------------------------------------------------
+// Function:	    int ParseLoanRecord(const char* line, LoanRecord* record)
+//
+// Description:		Parses one NUL terminated input line, see
+//					ParseLoanText().
+//
+// Parameters:	    const (char*)  line     Text of one record
+//				    (LoanRecord*)  record   Receives the parsed record
+//
+// Returns:		    (int) 1 if the line holds a record (record->status tells
+//					whether it is valid), 0 for blank and '#' comment lines
+// Date:            10/17/2026
+// Called By:       NextLoanRecord(), RunCalcMode(), sendSchedule(),
+//					handleLines()
+// Calls:		    ParseLoanText()
+// History Log:     10/17/2026  added for batch pricing mode
+//				    10/17/2026  parsing moved to ParseLoanText()
+//----------------------------------------------------------------------------
+int ParseLoanRecord(const char* line, LoanRecord* record)
+{
+	return ParseLoanText(line, strlen(line), record);
+}
+//----------------------------------------------------------------------------
+// Function:	    int ParseLoanText(const char* text, const size_t length,
+//						LoanRecord* record)
+//
+// Description:		Splits one input line into a LoanRecord and applies the
+//					same rules as ReadLoanSize(), ReadPaymentSize(),
+//					ReadMonths() and ReadInterestRate(): amounts are rounded
+//					to the cent, the rate to the nearest 1/8th percent, the
+//					months must be a whole number from 1 to
+//					FIVE_HUNDRED_YEARS and the rate must not be negative.
+//					NaN, infinities and amounts too large to round to the
+//					cent make the record bad.
+//					The line is read where it lies and need not end in a
+//					NUL, so it may be part of a mapped file; numbers give
+//					the same values strtod() would.
+//
+// Parameters:	    const (char*)   text     First character of the line
+//				    const (size_t)  length   Characters in the line, not
+//											 counting any '\n'
+//				    (LoanRecord*)   record   Receives the parsed record
+//
+// Returns:		    (int) 1 if the line holds a record (record->status tells
+//					whether it is valid), 0 for blank and '#' comment lines
+// Date:            10/17/2026
+// Called By:       ParseLoanRecord(), NextMappedRecord()
+// Calls:		    parseField(), roundInterest()
+// History Log:     10/17/2026  added for batch pricing mode, as
+//								ParseLoanRecord()
+//				    10/17/2026  works on a length of text; numbers parsed in
+//								place
+//				    10/17/2026  rejects values that are not finite
+//----------------------------------------------------------------------------
+int ParseLoanText(const char* text, const size_t length, LoanRecord* record)
+{
+	const char* UNKNOWN_LETTERS = "LPNI";
+	const char* end = text + length;
+	double values[FIELD_COUNT] = { 0 };
+	int blanks = 0;
+	int found = 0;
+	const char* cursor = text;
+
+	while ((cursor < end) && ((*cursor == ' ') || (*cursor == '\t')))
+		cursor++;
+	if ((cursor == end) || (*cursor == '#') || (*cursor == '\0') ||
+		(*cursor == '\n') || (*cursor == '\r'))
+		return 0;
+
+	memset(record, 0, sizeof(LoanRecord));
+	record->status = BATCH_BAD_RECORD;
+	record->unknown = '?';
+	cursor = text;
+	for (int field = 0; field < FIELD_COUNT; field++)
+	{
+		found = parseField(cursor, end, &values[field], &cursor);
+		if ((found < 0) || !isfinite(values[field] * HUNDRED))
+			return 1;
+		if (found == 0)
+		{
+			blanks++;
+			record->unknown = UNKNOWN_LETTERS[field];
+		}
+		if (field < FIELD_COUNT - 1)
+		{
+			if ((cursor == end) || ((*cursor != ',') && (*cursor != '\t')))
+				return 1;
+			cursor++;
+		}
+	}
+	if ((cursor < end) && (*cursor != '\0') && (*cursor != '\n') &&
+		(*cursor != '\r'))
+		return 1;
+	if (blanks != 1)
+		return 1;
+
+	record->loanSize = floor(values[0] * HUNDRED + HALF) / HUNDRED;
+	record->paymentSize = floor(values[1] * HUNDRED + HALF) / HUNDRED;
+	record->interestRate = roundInterest(values[3], 8);
+	if ((record->unknown != 'L') && (record->loanSize <= 0))
+		return 1;
+	if ((record->unknown != 'P') && (record->paymentSize <= 0))
+		return 1;
+	if ((record->unknown != 'I') && (values[3] < 0))
+		return 1;
+	if (record->unknown != 'N')
+	{
+		if ((values[2] != floor(values[2])) || (values[2] < 1) ||
+			(values[2] > FIVE_HUNDRED_YEARS))
+			return 1;
+		record->months = (int)values[2];
+	}
+	record->status = BATCH_OK;
+	return 1;
+}
+//----------------------------------------------------------------------------
+// Function:	    void PriceLoanRecord(LoanRecord* record)
+//
+// Description:		Solves the unknown value of a parsed record with the same
+//					calls and limits main() uses for options 1 to 4.
+//
+// Parameters:	    (LoanRecord*) record   Parsed record, updated in place
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       priceSlice()
+// Calls:		    getPaymentAmount(), getLoanAmount(), getMonthsNeeded(),
+//					findInterestRate(), StartMetricTimer(),
+//					StopMetricTimer()
+// History Log:     10/17/2026  added for batch pricing mode
+//				    10/17/2026  timed by unknown as TIMER_PAYMENT, ...
+//				    10/17/2026  terms over FIVE_HUNDRED_YEARS have no
+//								solution
+//----------------------------------------------------------------------------
+void PriceLoanRecord(LoanRecord* record)
+{
+	double rate = 0;
+	double months = 0;
+	double start = 0;
+	int timer = TIMER_PAYMENT;
+
+	if (record->status != BATCH_OK)
+		return;
+	switch (record->unknown)
+	{
+	case 'P':
+		start = StartMetricTimer(timer = TIMER_PAYMENT);
+		record->paymentSize = getPaymentAmount(record->months,
+			record->loanSize, record->interestRate);
+		break;
+	case 'L':
+		start = StartMetricTimer(timer = TIMER_LOAN);
+		record->loanSize = getLoanAmount(record->paymentSize,
+			record->months, record->interestRate);
+		break;
+	case 'N':
+		start = StartMetricTimer(timer = TIMER_MONTHS);
+		if (record->paymentSize <=
+			record->loanSize * (record->interestRate / MONTHLY_DIVISOR))
+		{
+			record->status = BATCH_NO_SOLUTION;
+			break;
+		}
+		months = getMonthsNeeded(record->paymentSize, record->loanSize,
+			record->interestRate);
+		if ((months >= 1) && (months <= FIVE_HUNDRED_YEARS))
+			record->months = (int)months;
+		else
+			record->status = BATCH_NO_SOLUTION;
+		break;
+	case 'I':
+		start = StartMetricTimer(timer = TIMER_RATE);
+		rate = findInterestRate(record->months, record->loanSize,
+			record->paymentSize, NULL);
+		if (rate == NO_RATE)
+			record->status = BATCH_NO_SOLUTION;
+		else
+			record->interestRate = rate;
+		break;
+	}
+	StopMetricTimer(timer, start);
+}
+//----------------------------------------------------------------------------
+// Function:	    int FormatLoanRecord(char* text, const size_t size,
+//						const LoanRecord* record)
+//
+// Description:		Formats one result row: loan size, payment, months, rate
+//					and a status word (OK, BAD or NONE), ending in '\n'.
+//
+// Parameters:	    (char*)              text     Receives the row
+//				    const (size_t)       size     Room in text
+//				    const (LoanRecord*)  record   Priced record
+//
+// Returns:		    (int) length   As snprintf() returns it
+// Date:            10/17/2026
+// Called By:       WriteLoanRecord(), the calculation server
+// History Log:     10/17/2026  taken out of WriteLoanRecord() for the
+//							    calculation server
+//----------------------------------------------------------------------------
+int FormatLoanRecord(char* text, const size_t size, const LoanRecord* record)
+{
+	const char* status = (record->status == BATCH_OK) ? "OK" :
+		(record->status == BATCH_NO_SOLUTION) ? "NONE" : "BAD";
+
+	return snprintf(text, size, "%.2lf,%.2lf,%d,%.3lf,%s\n",
+		record->loanSize, record->paymentSize, record->months,
+		record->interestRate, status);
+}
+//----------------------------------------------------------------------------
+// Function:	    void WriteLoanRecord(FILE* fp, const LoanRecord* record)
+//
+// Description:		Writes one result row, see FormatLoanRecord().
+//
+// Parameters:	    (FILE*)              fp       Output stream
+//				    const (LoanRecord*)  record   Priced record
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       runChunks()
+// Calls:		    FormatLoanRecord()
+// History Log:     10/17/2026  added for batch pricing mode
+//				    10/17/2026  row formatted by FormatLoanRecord()
+//----------------------------------------------------------------------------
+void WriteLoanRecord(FILE* fp, const LoanRecord* record)
+{
+	char text[BATCH_REPLY_MAX];
+
+	FormatLoanRecord(text, sizeof(text), record);
+	fputs(text, fp);
+}
+
+//----------------------------------------------------------------------------
+// Function:	    int NextLoanRecord(FILE* in, LoanRecord* record)
+//
+// Description:		Reads lines until one holds a record and parses it.
+//					Blank and comment lines are skipped. A line longer than
+//					BATCH_LINE_MAX - 1 characters is cut there and the rest
+//					of it dropped; if its start holds a record, the record
+//					is bad.
+//
+// Parameters:	    (FILE*)        in       Stream of loan records
+//				    (LoanRecord*)  record   Receives the parsed record
+//
+// Returns:		    (int) 1 if a record was read, 0 at the end of the input
+// Date:            10/17/2026
+// Called By:       readStream(), parseBlock()
+// Calls:		    ParseLoanRecord()
+// History Log:     10/17/2026  split out of RunBatch() for the pipeline
+//				    10/17/2026  over-long lines are bad records
+//----------------------------------------------------------------------------
+int NextLoanRecord(FILE* in, LoanRecord* record)
+{
+	char line[BATCH_LINE_MAX] = "";
+
+	while (fgets(line, sizeof(line), in) != NULL)
+	{
+		size_t length = strlen(line);
+		int overLong = 0;
+
+		if ((length == sizeof(line) - 1) && (line[length - 1] != '\n'))
+		{
+			int ch = 0;                // Drop the rest of the line, if any
+			while (((ch = getc(in)) != '\n') && (ch != EOF))
+				overLong = 1;
+		}
+		if (ParseLoanRecord(line, record))
+		{
+			if (overLong)
+				record->status = BATCH_BAD_RECORD;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+static void priceSlice(void* arg)
+{
+	BatchSlice* slice = (BatchSlice*)arg;
+
+	for (size_t i = 0; i < slice->count; i++)
+		PriceLoanRecord(&slice->records[i]);
+}
+
+static int readStream(void* source, LoanRecord* record)
+{
+	return NextLoanRecord((FILE*)source, record);
+}
+
+static int readMapped(void* source, LoanRecord* record)
+{
+	MappedSource* mapped = (MappedSource*)source;
+
+	if (!NextMappedRecord(mapped->file, record))
+		return 0;
+	if ((record->status == BATCH_BAD_RECORD) && (mapped->errors != NULL))
+		ReportBadRecord(mapped->errors, mapped->file);
+	return 1;
+}
+
+// Reads records BATCH_CHUNK at a time with next(), prices each chunk on
+// 'threads' worker threads and writes the results in input order. Gives
+// up with -1 as soon as a chunk cannot be written to out.
+static long long runChunks(RecordReader next, void* source, FILE* out,
+	int threads)
+{
+	long long total = 0;
+	size_t count = 0;
+	int endOfInput = 0;
+	AmortThread handles[MAX_THREADS];
+	int launched[MAX_THREADS] = { 0 };
+	BatchSlice slices[MAX_THREADS];
+	LoanRecord* records = (LoanRecord*)malloc(BATCH_CHUNK * sizeof(LoanRecord));
+
+	if (records == NULL)
+		return -1;
+	if (threads <= 0)
+		threads = GetCpuCount();
+	if (threads > MAX_THREADS)
+		threads = MAX_THREADS;
+
+	while (!endOfInput)
+	{
+		size_t per = 0;
+		size_t first = 0;
+		int used = 0;
+
+		count = 0;
+		while ((count < BATCH_CHUNK) && !endOfInput)
+		{
+			if (next(source, &records[count]))
+				count++;
+			else
+				endOfInput = 1;
+		}
+
+		per = (count + threads - 1) / threads;
+		for (used = 0; (used < threads) && (first < count); used++)
+		{
+			slices[used].records = records + first;
+			slices[used].count = (count - first < per) ? count - first : per;
+			first += slices[used].count;
+		}
+		for (int t = 1; t < used; t++)     // Slice 0 runs on this thread
+			launched[t] = StartThread(&handles[t], priceSlice, &slices[t]);
+		if (used > 0)
+			priceSlice(&slices[0]);
+		for (int t = 1; t < used; t++)
+		{
+			if (launched[t])
+				JoinThread(handles[t]);
+			else
+				priceSlice(&slices[t]);
+		}
+
+		for (size_t i = 0; i < count; i++)
+			WriteLoanRecord(out, &records[i]);
+		if (ferror(out))
+		{
+			total = -1;
+			break;
+		}
+		total += (long long)count;
+	}
+	free(records);
+	return total;
+}
+//----------------------------------------------------------------------------
+// Function:	    long long RunBatch(FILE* in, FILE* out, int threads)
+//
+// Description:		Reads records BATCH_CHUNK at a time, prices each chunk on
+//					'threads' worker threads and writes the results in input
+//					order.
+//
+// Parameters:	    (FILE*) in        Stream of loan records
+//				    (FILE*) out       Stream for result rows
+//				    (int)   threads   Worker threads, 0 for one per CPU
+//
+// Returns:		    (long long) count   Number of records written, -1 if the
+//										record buffer could not be allocated
+//										or out could not be written
+// Date:            10/17/2026
+// Called By:       RunBatchMode()
+// Calls:		    runChunks(), NextLoanRecord()
+// History Log:     10/17/2026  added for batch pricing mode
+//				    10/17/2026  lines read by NextLoanRecord()
+//				    10/17/2026  chunk loop moved to runChunks()
+//				    10/17/2026  -1 when out could not be written
+//----------------------------------------------------------------------------
+long long RunBatch(FILE* in, FILE* out, int threads)
+{
+	return runChunks(readStream, in, out, threads);
+}
+//----------------------------------------------------------------------------
+// Function:	    long long RunBatchRecords(RecordFile* file, FILE* out,
+//						int threads, FILE* errors)
+//
+// Description:		Prices a mapped file of records as RunBatch() prices a
+//					stream, giving the same output, and reports each bad
+//					record with its byte offset and line number.
+//
+// Parameters:	    (RecordFile*) file      File from OpenRecordFile()
+//				    (FILE*)       out       Stream for result rows
+//				    (int)         threads   Worker threads, 0 for one per
+//											CPU
+//				    (FILE*)       errors    Stream for bad records, or NULL
+//
+// Returns:		    (long long) count   Number of records written, -1 if the
+//										record buffer could not be allocated
+//										or out could not be written
+// Date:            10/17/2026
+// Called By:       RunBatchMode(), main() of bench_records
+// Calls:		    runChunks(), NextMappedRecord(), ReportBadRecord()
+// History Log:     10/17/2026  added for the mapped record reader
+//				    10/17/2026  -1 when out could not be written
+//----------------------------------------------------------------------------
+long long RunBatchRecords(RecordFile* file, FILE* out, int threads,
+	FILE* errors)
+{
+	MappedSource source;
+
+	source.file = file;
+	source.errors = errors;
+	return runChunks(readMapped, &source, out, threads);
+}
@@ -0,0 +1,54 @@
+//----------------------------------------------------------------------------
+// File:			amort_batch.h
+//
+// Description:     Header file for the headless batch pricing mode
+//					(amort_batch.c). Each input record holds the loan size,
+//					monthly payment, number of months and annual interest rate
+//					separated by commas or tabs. Exactly one of the four fields
+//					is left blank (or '?') and is solved for with the Amort
+//					library functions.
+//
+//					Example records:  250000,,360,6.5     (solve payment)
+//									  ,1500,360,6.5       (solve loan size)
+//									  250000,2000,,6.5    (solve months)
+//									  250000,1580.17,360, (solve rate)
+//
+// History Log:    10/17/2026  added for batch pricing mode
+//				   10/17/2026  added FormatLoanRecord() for the calculation
+//							   server
+//				   10/17/2026  added NextLoanRecord() for the pipeline
+//				   10/17/2026  added ParseLoanText() for the mapped record
+//							   reader
+//----------------------------------------------------------------------------
+
+#ifndef AMORT_BATCH_H
+#define AMORT_BATCH_H
+#include <stdio.h>
+
+#define BATCH_CHUNK 65536           // Records priced per parallel pass
+#define BATCH_LINE_MAX 256
+#define BATCH_REPLY_MAX 1024        // Longest FormatLoanRecord() row
+#define BATCH_OK 0
+#define BATCH_BAD_RECORD 1          // Record failed the Read*() input rules
+#define BATCH_NO_SOLUTION 2         // Inputs cannot describe a loan
+
+typedef struct
+{
+	double loanSize;                // Total amount of loan
+	double paymentSize;             // Amount of one monthly payment
+	double interestRate;            // Annual interest rate
+	int months;                     // Number of monthly payments
+	char unknown;                   // Menu letter of value to solve: P L N I
+	char status;                    // BATCH_OK, BATCH_BAD_RECORD, ...
+} LoanRecord;
+
+int ParseLoanRecord(const char* line, LoanRecord* record);
+int ParseLoanText(const char* text, const size_t length, LoanRecord* record);
+void PriceLoanRecord(LoanRecord* record);
+int FormatLoanRecord(char* text, const size_t size,
+	const LoanRecord* record);
+void WriteLoanRecord(FILE* fp, const LoanRecord* record);
+int NextLoanRecord(FILE* in, LoanRecord* record);
+long long RunBatch(FILE* in, FILE* out, int threads);
+
+#endif
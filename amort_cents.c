@@ -0,0 +1,396 @@
+//----------------------------------------------------------------------------
+// File:			amort_cents.c
+//
+// Description      Integer cents engine for the Amort library. Every amount
+//					is a whole number of cents, so the running balance never
+//					drifts and the last payment adjustment only takes up the
+//					interest rounding, not floating point error. Products
+//					that could overflow 64 bits are formed in 128 bits, with
+//					__int128 where the compiler has it and 32-bit limbs
+//					everywhere else; both give the same answer.
+//
+// Functions:	    Cents ToCents(const double amount)
+//					int RateToEighths(const double interestRate)
+//					int CentsRateFits(const double interestRate)
+//					int CentsAmountFits(const double loanBalance,
+//						const double paymentSize)
+//					Cents GetCentsInterest(const Cents balance,
+//						const int rateEighths)
+//					int FillCentsRows(CentsRow* rows, Cents loanBalance,
+//						const Cents payment, const int rateEighths,
+//						const int months, const int first, const int count)
+//					int SumCentsRows(ScheduleTotals* totals,
+//						Cents* loanBalance, const Cents payment,
+//						const int rateEighths, const int months)
+//					long long CrossCheckRows(const ScheduleRow* rows,
+//						const int count, const double loanBalance,
+//						const double paymentSize, const double interestRate,
+//						const int months)
+//----------------------------------------------------------------------------
+
+#include <limits.h>
+#include "amort.h"
+#include "amort_cents.h"
+
+#define HALF_DIVISOR (EIGHTHS_PER_MONTH_RATE / 2)
+#define CENTS_LIMIT 9e18            // Below LLONG_MAX as a double
+
+#ifndef __SIZEOF_INT128__
+// floor((magnitude * factor + offset) / EIGHTHS_PER_MONTH_RATE) for a
+// 128-bit product, worked in 32-bit limbs.
+static unsigned long long wideDivide(unsigned long long magnitude,
+	unsigned int factor, unsigned int offset)
+{
+	unsigned long long low = (magnitude & 0xffffffffULL) * factor + offset;
+	unsigned long long high = (magnitude >> 32) * factor + (low >> 32);
+	unsigned long long limbs[3];
+	unsigned long long remainder = 0;
+	unsigned long long quotient = 0;
+
+	limbs[0] = high >> 32;
+	limbs[1] = high & 0xffffffffULL;
+	limbs[2] = low & 0xffffffffULL;
+	for (int i = 0; i < 3; i++)
+	{
+		unsigned long long part = (remainder << 32) | limbs[i];
+
+		quotient = (quotient << 32) | (part / EIGHTHS_PER_MONTH_RATE);
+		remainder = part % EIGHTHS_PER_MONTH_RATE;
+	}
+	return quotient;
+}
+#endif
+//----------------------------------------------------------------------------
+// Function:	    Cents ToCents(const double amount)
+//
+// Description:		Rounds a dollar amount to whole cents the way
+//					ReadLoanSize() and ReadPaymentSize() do. Amounts too
+//					large for a Cents give LLONG_MAX or -LLONG_MAX and NaN
+//					gives 0, rather than a conversion C leaves undefined;
+//					the engine itself only takes amounts CentsAmountFits()
+//					passes.
+//
+// Parameters:	    const (double) amount   Dollar amount
+//
+// Returns:		    (Cents) cents   Amount in cents
+// Date:            10/17/2026
+// Called By:       FillScheduleRows(), CrossCheckRows(),
+//					GetScheduleTotals(), recompute()
+// History Log:     10/17/2026  added for the integer cents engine
+//				    10/17/2026  out of range amounts clamped
+//----------------------------------------------------------------------------
+Cents ToCents(const double amount)
+{
+	double cents = floor(amount * HUNDRED + HALF);
+
+	if (isnan(cents))
+		return 0;
+	if (cents >= CENTS_LIMIT)
+		return LLONG_MAX;
+	if (cents <= -CENTS_LIMIT)
+		return -LLONG_MAX;
+	return (Cents)cents;
+}
+//----------------------------------------------------------------------------
+// Function:	    int RateToEighths(const double interestRate)
+//
+// Description:		Rounds an annual percentage rate to the nearest 1/8th,
+//					as roundInterest(rate, 8) does, and returns it as a
+//					count of eighths.
+//
+// Parameters:	    const (double) interestRate   Annual interest rate
+//
+// Returns:		    (int) eighths   Rate in 1/8ths of a percent
+// Date:            10/17/2026
+// Called By:       FillScheduleRows(), CrossCheckRows(),
+//					GetScheduleTotals()
+// Calls:		    roundInterest()
+// History Log:     10/17/2026  added for the integer cents engine
+//----------------------------------------------------------------------------
+int RateToEighths(const double interestRate)
+{
+	return (int)(roundInterest(interestRate, 8) * 8);
+}
+//----------------------------------------------------------------------------
+// Function:	    int CentsRateFits(const double interestRate)
+//
+// Description:		Tells whether the cents engine is exact at a rate: once
+//					rounded to the nearest 1/8th it must be at most
+//					MAX_CENTS_RATE percent, so a month's interest is never
+//					more than the balance and always fits 64 bits. Above it
+//					the schedule generator uses the double loop instead.
+//
+// Parameters:	    const (double) interestRate   Annual interest rate
+//
+// Returns:		    (int) 1 if the rate is within MAX_CENTS_RATE, else 0
+// Date:            10/17/2026
+// Called By:       FillScheduleRows(), GetScheduleTotals(), recompute()
+// Calls:		    roundInterest()
+// History Log:     10/17/2026  added so MAX_CENTS_RATE is enforced
+//----------------------------------------------------------------------------
+int CentsRateFits(const double interestRate)
+{
+	return roundInterest(interestRate, 8) <= MAX_CENTS_RATE;
+}
+//----------------------------------------------------------------------------
+// Function:	    int CentsAmountFits(const double loanBalance,
+//						const double paymentSize)
+//
+// Description:		Tells whether a balance and payment are within
+//					MAX_CENTS_AMOUNT cents, so that one month of the cents
+//					engine cannot overflow 64 bits: the interest is at
+//					most the balance below MAX_CENTS_RATE, and the new
+//					balance at most three times the limit. The engine
+//					checks its running balance the same way before every
+//					month and hands a loan that grows past the limit back
+//					to the double loop, as it does above MAX_CENTS_RATE.
+//
+// Parameters:	    const (double) loanBalance   Balance in dollars
+//				    const (double) paymentSize   Monthly payment amount
+//
+// Returns:		    (int) 1 if both fit, else 0 (also for NaN)
+// Date:            10/17/2026
+// Called By:       FillScheduleRows(), GetScheduleTotals(), recompute()
+// History Log:     10/17/2026  added so the cents engine cannot overflow
+//----------------------------------------------------------------------------
+int CentsAmountFits(const double loanBalance, const double paymentSize)
+{
+	return (fabs(loanBalance * HUNDRED) <= (double)MAX_CENTS_AMOUNT) &&
+		(fabs(paymentSize * HUNDRED) <= (double)MAX_CENTS_AMOUNT);
+}
+//----------------------------------------------------------------------------
+// Function:	    Cents GetCentsInterest(const Cents balance,
+//										   const int rateEighths)
+//
+// Description:		Returns one month's interest on balance, rounded half up
+//					to the cent like floor(x * HUNDRED + HALF) / HUNDRED:
+//					floor((balance * eighths + 4800) / 9600). Rates up to
+//					MAX_CENTS_RATE percent are exact for any balance; the
+//					schedule generator checks CentsRateFits() before it
+//					calls here.
+//
+// Parameters:	    const (Cents) balance       Loan balance in cents
+//				    const (int)   rateEighths   Annual rate in 1/8 percent
+//
+// Returns:		    (Cents) interest   Interest in cents
+// Date:            10/17/2026
+// Called By:       FillCentsRows()
+// History Log:     10/17/2026  added for the integer cents engine
+//----------------------------------------------------------------------------
+Cents GetCentsInterest(const Cents balance, const int rateEighths)
+{
+	Cents product = 0;
+	Cents interest = 0;
+
+	if (rateEighths <= 0)
+		return 0;
+	if ((balance < LLONG_MAX / rateEighths - HALF_DIVISOR) &&
+		(balance > LLONG_MIN / rateEighths + HALF_DIVISOR))
+	{
+		product = balance * rateEighths + HALF_DIVISOR;   // Fits 64 bits
+		interest = product / EIGHTHS_PER_MONTH_RATE;
+		if ((product % EIGHTHS_PER_MONTH_RATE) < 0)
+			interest--;
+		return interest;
+	}
+#ifdef __SIZEOF_INT128__
+	{
+		__int128 wide = (__int128)balance * rateEighths + HALF_DIVISOR;
+		__int128 quotient = wide / EIGHTHS_PER_MONTH_RATE;
+
+		if ((wide % EIGHTHS_PER_MONTH_RATE) < 0)
+			quotient--;
+		return (Cents)quotient;
+	}
+#else
+	if (balance >= 0)
+		return (Cents)wideDivide((unsigned long long)balance,
+			(unsigned int)rateEighths, HALF_DIVISOR);
+	// floor((-m * e + h) / d) = -ceil((m * e - h) / d)
+	//                         = -floor((m * e - h + d - 1) / d)
+	return -(Cents)wideDivide(0 - (unsigned long long)balance,
+		(unsigned int)rateEighths, EIGHTHS_PER_MONTH_RATE - 1 - HALF_DIVISOR);
+#endif
+}
+
+// Returns 1 if a month can be worked out from this balance and payment
+// without overflow, see CentsAmountFits().
+static inline int centsFit(const Cents loanBalance, const Cents payment)
+{
+	return (loanBalance <= MAX_CENTS_AMOUNT) &&
+		(loanBalance >= -MAX_CENTS_AMOUNT) &&
+		(payment <= MAX_CENTS_AMOUNT) && (payment >= -MAX_CENTS_AMOUNT);
+}
+
+// One month of the cents loop: the interest on loanBalance, the rest of the
+// payment off it and, in the last month, whatever balance is left added to
+// the payment. Fills row and returns the balance after it.
+static inline Cents stepCentsMonth(CentsRow* row, Cents loanBalance,
+	const Cents payment, const int rateEighths, const int month,
+	const int months)
+{
+	row->month = month;
+	row->payment = payment;
+	row->interest = GetCentsInterest(loanBalance, rateEighths);
+	row->principal = payment - row->interest;
+	loanBalance -= row->principal;
+	if ((month == months) && (loanBalance != 0))   //adjust last months payment
+	{
+		row->payment += loanBalance;
+		row->principal += loanBalance;
+		loanBalance = 0;
+	}
+	row->balance = loanBalance;
+	return loanBalance;
+}
+//----------------------------------------------------------------------------
+// Function:	    int FillCentsRows(CentsRow* rows, Cents loanBalance,
+//						const Cents payment, const int rateEighths,
+//						const int months, const int first, const int count)
+//
+// Description:		FillScheduleRows() in whole cents: works out rows first
+//					.. first + count - 1 (stopping after month 'months') of a
+//					loan whose balance before month 'first' is loanBalance.
+//					It also stops before a month whose balance or payment
+//					is beyond MAX_CENTS_AMOUNT, and writes nothing above
+//					MAX_CENTS_RATE, so its sums never overflow; the caller
+//					goes on with the double loop from the last row.
+//
+// Parameters:	    (CentsRow*)  rows          Receives the rows
+//				    (Cents)      loanBalance   Balance before month first
+//				    const Cents  payment       Monthly payment
+//				    const int    rateEighths   Annual rate in 1/8 percent
+//				    const int    months        Number of monthly payments
+//				    const int    first         First month to work out
+//				    const int    count         Number of rows wanted
+//
+// Returns:		    (int) rows   Number of rows written
+// Date:            10/17/2026
+// Called By:       FillScheduleRows(), CrossCheckRows()
+// Calls:		    stepCentsMonth(), centsFit()
+// History Log:     10/17/2026  added for the integer cents engine
+//				    10/17/2026  month worked out by stepCentsMonth()
+//				    10/17/2026  stops where the amounts could overflow
+//----------------------------------------------------------------------------
+int FillCentsRows(CentsRow* rows, Cents loanBalance, const Cents payment,
+	const int rateEighths, const int months, const int first,
+	const int count)
+{
+	int last = (count > months - first + 1) ? months : first + count - 1;
+	int i = first;
+
+	if (rateEighths > MAX_CENTS_RATE * 8)
+		return 0;
+	for (; (i <= last) && centsFit(loanBalance, payment); i++)
+		loanBalance = stepCentsMonth(&rows[i - first], loanBalance, payment,
+			rateEighths, i, months);
+	return i - first;
+}
+//----------------------------------------------------------------------------
+// Function:	    int SumCentsRows(ScheduleTotals* totals,
+//						Cents* loanBalance, const Cents payment,
+//						const int rateEighths, const int months)
+//
+// Description:		Adds the rows of FillCentsRows() for months 1 .. months
+//					into totals as dollars, in the order BuildSchedule()
+//					adds them, without keeping the rows. The adjusted last
+//					payment goes in finalPayment. Like FillCentsRows() it
+//					stops before a month whose amounts could overflow, and
+//					like FillScheduleRows() once the interest to date
+//					passes MAX_CENTS_TO_DATE.
+//
+// Parameters:	    (ScheduleTotals*) totals        Receives the sums
+//				    (Cents*)          loanBalance   Loan size; receives the
+//													balance after the last
+//													month summed
+//				    const Cents       payment       Monthly payment
+//				    const int         rateEighths   Annual rate in 1/8
+//													percent
+//				    const int         months        Number of payments
+//
+// Returns:		    (int) summed   Months added, months unless it stopped
+// Date:            10/17/2026
+// Called By:       GetScheduleTotals()
+// Calls:		    stepCentsMonth(), centsFit()
+// History Log:     10/17/2026  moved here from amort_schedule.c to share
+//								the month step with FillCentsRows()
+//				    10/17/2026  stops where the amounts could overflow
+//----------------------------------------------------------------------------
+int SumCentsRows(ScheduleTotals* totals, Cents* loanBalance,
+	const Cents payment, const int rateEighths, const int months)
+{
+	CentsRow row = { 0, payment, 0, 0, 0 };
+	Cents interestToDate = 0;
+	int i = 1;
+
+	if (rateEighths > MAX_CENTS_RATE * 8)
+		return 0;
+	for (; (i <= months) && centsFit(*loanBalance, payment) &&
+		(interestToDate <= MAX_CENTS_TO_DATE) &&
+		(interestToDate >= -MAX_CENTS_TO_DATE); i++)
+	{
+		*loanBalance = stepCentsMonth(&row, *loanBalance, payment,
+			rateEighths, i, months);
+		interestToDate += row.interest;
+		totals->totalPaid += (double)row.payment / HUNDRED;
+		totals->totalPrincipal += (double)row.principal / HUNDRED;
+		totals->totalInterest += (double)row.interest / HUNDRED;
+	}
+	totals->finalPayment = (double)row.payment / HUNDRED;
+	return i - 1;
+}
+//----------------------------------------------------------------------------
+// Function:	    long long CrossCheckRows(const ScheduleRow* rows,
+//						const int count, const double loanBalance,
+//						const double paymentSize, const double interestRate,
+//						const int months)
+//
+// Description:		Works out the same rows with FillCentsRows() and counts
+//					the rows of the double loop whose payment, principal,
+//					interest or balance does not round to the same cent.
+//					It stops at the first row the cents engine does not
+//					take, see FillCentsRows().
+//
+// Parameters:	    const (ScheduleRow*) rows          Rows of the double loop
+//				    const (int)          count         Number of rows
+//				    const (double)       loanBalance   Balance before rows[0]
+//				    const (double)       paymentSize   Monthly payment amount
+//				    const (double)       interestRate  Annual interest rate
+//				    const (int)          months        Number of payments
+//
+// Returns:		    (long long) mismatches   Rows that differ among those
+//					checked
+// Date:            10/17/2026
+// Called By:       FillScheduleRows()
+// Calls:		    FillCentsRows(), ToCents(), RateToEighths(),
+//					CentsRateFits()
+// History Log:     10/17/2026  added for the integer cents engine
+//				    10/17/2026  rows out of the engine's range not checked
+//----------------------------------------------------------------------------
+long long CrossCheckRows(const ScheduleRow* rows, const int count,
+	const double loanBalance, const double paymentSize,
+	const double interestRate, const int months)
+{
+	CentsRow exact;
+	Cents balance = ToCents(loanBalance);
+	Cents payment = ToCents(paymentSize);
+	int eighths = 0;
+	long long mismatches = 0;
+
+	if (!CentsRateFits(interestRate))
+		return 0;
+	eighths = RateToEighths(interestRate);
+	for (int i = 0; i < count; i++)
+	{
+		if (FillCentsRows(&exact, balance, payment, eighths, months,
+			rows[i].month, 1) == 0)
+			break;
+		balance = exact.balance;
+		if ((ToCents(rows[i].payment) != exact.payment) ||
+			(ToCents(rows[i].principal) != exact.principal) ||
+			(ToCents(rows[i].interest) != exact.interest) ||
+			(ToCents(rows[i].balance) != exact.balance))
+			mismatches++;
+	}
+	return mismatches;
+}
@@ -0,0 +1,53 @@
+//----------------------------------------------------------------------------
+// File:			amort_cents.h
+//
+// Description:     Header file for the integer cents engine (amort_cents.c).
+//					Amounts are whole cents in 64-bit integers and the rate
+//					is a whole number of 1/8ths of a percent, so the monthly
+//					interest is balance * eighths / 9600 rounded half up to
+//					the cent: exact, and the same on every compiler. The
+//					schedule generator can use it instead of the double
+//					loop, see SetScheduleEngine().
+//
+// History Log:    10/17/2026  added for the integer cents engine
+//				   10/17/2026  added CentsRateFits()
+//				   10/17/2026  added SumCentsRows()
+//				   10/17/2026  added CentsAmountFits()
+//----------------------------------------------------------------------------
+
+#ifndef AMORT_CENTS_H
+#define AMORT_CENTS_H
+#include <limits.h>
+#include "amort_schedule.h"
+
+#define EIGHTHS_PER_MONTH_RATE 9600 // MONTHLY_DIVISOR * 8
+#define MAX_CENTS_RATE 1200         // Annual percent; quotient fits 64 bits
+#define MAX_CENTS_AMOUNT 1000000000000000LL // Cents; doubles hold the cent
+#define MAX_CENTS_TO_DATE (LLONG_MAX / 2)   // Interest to date, in cents
+
+typedef long long Cents;
+
+typedef struct
+{
+	int month;                      // 1 based month number
+	Cents payment;                  // Payment made (last one adjusted)
+	Cents principal;                // Principal paid
+	Cents interest;                 // Interest paid
+	Cents balance;                  // Loan balance after the payment
+} CentsRow;
+
+Cents ToCents(const double amount);
+int RateToEighths(const double interestRate);
+int CentsRateFits(const double interestRate);
+int CentsAmountFits(const double loanBalance, const double paymentSize);
+Cents GetCentsInterest(const Cents balance, const int rateEighths);
+int FillCentsRows(CentsRow* rows, Cents loanBalance, const Cents payment,
+	const int rateEighths, const int months, const int first,
+	const int count);
+int SumCentsRows(ScheduleTotals* totals, Cents* loanBalance,
+	const Cents payment, const int rateEighths, const int months);
+long long CrossCheckRows(const ScheduleRow* rows, const int count,
+	const double loanBalance, const double paymentSize,
+	const double interestRate, const int months);
+
+#endif
@@ -0,0 +1,317 @@
+//----------------------------------------------------------------------------
+// File:			amort_columnar.c
+//
+// Description      Columnar schedule files for the Amort library.
+//					SaveScheduleColumns() writes the tables of any number of
+//					loans column by column through a small buffer;
+//					OpenColumnFile() maps a file, checks that every offset
+//					and every loan's rows lie inside it, and points straight
+//					at the columns, so nothing is parsed or copied. A loan's
+//					table can be turned back into the text of SaveTable()
+//					with WriteColumnText().
+//
+// Functions:	    long long SaveScheduleColumns(const char* filename,
+//						const Schedule* schedules, const size_t count)
+//					int OpenColumnFile(ColumnFile* file,
+//						const char* filename)
+//					void CloseColumnFile(ColumnFile* file)
+//					int WriteColumnText(ScheduleWriter* writer,
+//						const ColumnFile* file, const long long loan)
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include "amort.h"
+#include "amort_columnar.h"
+
+#define COLUMN_CHUNK 8192           // Values gathered per fwrite()
+
+// Rounds offset up to the next COLUMN_ALIGNMENT boundary.
+static int64_t alignOffset(const int64_t offset)
+{
+	return (offset + COLUMN_ALIGNMENT - 1) / COLUMN_ALIGNMENT *
+		COLUMN_ALIGNMENT;
+}
+
+// Bytes of one value of a column.
+static int64_t columnWidth(const int column)
+{
+	return (column == COLUMN_MONTH) ? (int64_t)sizeof(int32_t) :
+		(int64_t)sizeof(double);
+}
+
+// Writes zeros up to offset. Returns 1 on success.
+static int padTo(FILE* fp, int64_t* written, const int64_t offset)
+{
+	static const char zeros[COLUMN_ALIGNMENT] = { 0 };
+	size_t gap = (size_t)(offset - *written);
+
+	*written = offset;
+	return fwrite(zeros, 1, gap, fp) == gap;
+}
+
+// Writes one column of every schedule. Returns 1 on success.
+static int writeColumn(FILE* fp, const Schedule* schedules,
+	const size_t count, const int column)
+{
+	union
+	{
+		int32_t month[COLUMN_CHUNK];
+		double money[COLUMN_CHUNK];
+	} chunk;
+	const size_t width = (size_t)columnWidth(column);
+	size_t used = 0;
+	int ok = 1;
+
+	for (size_t s = 0; s < count; s++)
+	{
+		const ScheduleRow* row = schedules[s].rows;
+
+		for (int i = 0; i < schedules[s].months; i++, row++)
+		{
+			switch (column)
+			{
+			case COLUMN_MONTH:
+				chunk.month[used] = row->month;
+				break;
+			case COLUMN_PAYMENT:
+				chunk.money[used] = row->payment;
+				break;
+			case COLUMN_PRINCIPAL:
+				chunk.money[used] = row->principal;
+				break;
+			case COLUMN_INTEREST:
+				chunk.money[used] = row->interest;
+				break;
+			default:
+				chunk.money[used] = row->balance;
+				break;
+			}
+			if (++used == COLUMN_CHUNK)
+			{
+				ok = ok && (fwrite(&chunk, width, used, fp) == used);
+				used = 0;
+			}
+		}
+	}
+	return ok && (fwrite(&chunk, width, used, fp) == used);
+}
+
+// Returns 1 if count values of width bytes at offset lie inside the file,
+// on a COLUMN_ALIGNMENT boundary.
+static int insideFile(const ColumnHeader* header, const int64_t offset,
+	const int64_t count, const int64_t width)
+{
+	return (offset >= (int64_t)sizeof(ColumnHeader)) &&
+		(offset % COLUMN_ALIGNMENT == 0) && (offset <= header->fileSize) &&
+		(count <= (header->fileSize - offset) / width);
+}
+
+// Returns 1 if the mapped bytes hold a file this version can read.
+static int validHeader(const ColumnHeader* header, const size_t size)
+{
+	if ((size < sizeof(ColumnHeader)) ||
+		memcmp(header->magic, COLUMN_MAGIC, COLUMN_MAGIC_LENGTH) ||
+		(header->version != COLUMN_VERSION) ||
+		(header->headerSize != (int32_t)sizeof(ColumnHeader)) ||
+		(header->fileSize != (int64_t)size) || (header->loans < 0) ||
+		(header->rows < 0) || !insideFile(header, header->directory,
+		header->loans, (int64_t)sizeof(ColumnLoan)))
+		return 0;
+	for (int c = 0; c < COLUMN_COUNT; c++)
+		if (!insideFile(header, header->columns[c], header->rows,
+			columnWidth(c)))
+			return 0;
+	return 1;
+}
+//----------------------------------------------------------------------------
+// Function:	    long long SaveScheduleColumns(const char* filename,
+//						const Schedule* schedules, const size_t count)
+//
+// Description:		Writes the tables of count loans to a columnar file.
+//					The header comes first, then the directory of
+//					ColumnLoan entries, then the month, payment, principal,
+//					interest and balance columns, each padded with zeros to
+//					start on a COLUMN_ALIGNMENT boundary. A single table is
+//					a file with one loan; a book is a file with many.
+//
+// Parameters:	    const (char*)      filename    Name of the file
+//				    const (Schedule*)  schedules   Tables to write
+//				    const (size_t)     count       Number of tables
+//
+// Returns:		    (long long) rows   Rows written, or -1 on failure
+// Date:            10/17/2026
+// Called By:       SaveTable(), main() of bench_columnar
+// History Log:     10/17/2026  added for the columnar schedule files
+//----------------------------------------------------------------------------
+long long SaveScheduleColumns(const char* filename,
+	const Schedule* schedules, const size_t count)
+{
+	ColumnHeader header;
+	int64_t written = 0;
+	int64_t offset = 0;
+	FILE* fp = NULL;
+	int ok = 0;
+
+	memset(&header, 0, sizeof(ColumnHeader));
+	memcpy(header.magic, COLUMN_MAGIC, COLUMN_MAGIC_LENGTH);
+	header.version = COLUMN_VERSION;
+	header.headerSize = (int32_t)sizeof(ColumnHeader);
+	header.loans = (int64_t)count;
+	for (size_t s = 0; s < count; s++)
+	{
+		if ((schedules[s].months < 0) ||
+			((schedules[s].months > 0) && (schedules[s].rows == NULL)))
+			return -1;
+		header.rows += schedules[s].months;
+	}
+	header.directory = alignOffset((int64_t)sizeof(ColumnHeader));
+	offset = header.directory + header.loans * (int64_t)sizeof(ColumnLoan);
+	for (int c = 0; c < COLUMN_COUNT; c++)
+	{
+		header.columns[c] = alignOffset(offset);
+		offset = header.columns[c] + header.rows * columnWidth(c);
+	}
+	header.fileSize = offset;
+
+	if ((fp = fopen(filename, "wb")) == NULL)
+		return -1;
+	ok = (fwrite(&header, sizeof(ColumnHeader), 1, fp) == 1);
+	written = (int64_t)sizeof(ColumnHeader);
+	ok = ok && padTo(fp, &written, header.directory);
+	for (size_t s = 0, row = 0; ok && (s < count); s++)
+	{
+		ColumnLoan loan;
+
+		memset(&loan, 0, sizeof(ColumnLoan));
+		loan.loanSize = schedules[s].loanSize;
+		loan.paymentSize = schedules[s].paymentSize;
+		loan.interestRate = schedules[s].interestRate;
+		loan.months = schedules[s].months;
+		loan.firstRow = (int64_t)row;
+		loan.totalPaid = schedules[s].totalPaid;
+		loan.totalPrincipal = schedules[s].totalPrincipal;
+		loan.totalInterest = schedules[s].totalInterest;
+		ok = (fwrite(&loan, sizeof(ColumnLoan), 1, fp) == 1);
+		row += (size_t)schedules[s].months;
+	}
+	written += header.loans * (int64_t)sizeof(ColumnLoan);
+	for (int c = 0; ok && (c < COLUMN_COUNT); c++)
+	{
+		ok = padTo(fp, &written, header.columns[c]) &&
+			writeColumn(fp, schedules, count, c);
+		written += header.rows * columnWidth(c);
+	}
+	if (fclose(fp) != 0)
+		ok = 0;
+	return ok ? (long long)header.rows : -1;
+}
+//----------------------------------------------------------------------------
+// Function:	    int OpenColumnFile(ColumnFile* file, const char* filename)
+//
+// Description:		Maps a columnar file read only and points file's
+//					columns and directory into the mapping. The header, the
+//					directory and every column are checked to lie inside
+//					the file, and every loan's rows inside the columns,
+//					before anything is handed out. The pointers stay valid
+//					until CloseColumnFile().
+//
+// Parameters:	    (ColumnFile*)   file       Receives the mapped file
+//				    const (char*)   filename   Name of the file
+//
+// Returns:		    (int) 1 on success, 0 if the file cannot be mapped or
+//					is not a columnar file of this version
+// Date:            10/17/2026
+// Called By:       main() of columndump and of bench_columnar
+// Calls:		    MapFile(), UnmapFile()
+// History Log:     10/17/2026  added for the columnar schedule files
+//----------------------------------------------------------------------------
+int OpenColumnFile(ColumnFile* file, const char* filename)
+{
+	const char* base = NULL;
+
+	memset(file, 0, sizeof(ColumnFile));
+	if (!MapFile(&file->mapping, filename))
+		return 0;
+	base = (const char*)file->mapping.view;
+	file->header = (const ColumnHeader*)base;
+	if (!validHeader(file->header, file->mapping.size))
+	{
+		CloseColumnFile(file);
+		return 0;
+	}
+	file->loans = (const ColumnLoan*)(base + file->header->directory);
+	file->loanCount = (long long)file->header->loans;
+	file->rows = (long long)file->header->rows;
+	for (long long i = 0; i < file->loanCount; i++)
+	{
+		if ((file->loans[i].months < 0) || (file->loans[i].firstRow < 0) ||
+			(file->loans[i].firstRow > file->rows - file->loans[i].months))
+		{
+			CloseColumnFile(file);
+			return 0;
+		}
+	}
+	file->month = (const int32_t*)(base +
+		file->header->columns[COLUMN_MONTH]);
+	file->payment = (const double*)(base +
+		file->header->columns[COLUMN_PAYMENT]);
+	file->principal = (const double*)(base +
+		file->header->columns[COLUMN_PRINCIPAL]);
+	file->interest = (const double*)(base +
+		file->header->columns[COLUMN_INTEREST]);
+	file->balance = (const double*)(base +
+		file->header->columns[COLUMN_BALANCE]);
+	return 1;
+}
+//----------------------------------------------------------------------------
+// Function:	    void CloseColumnFile(ColumnFile* file)
+//
+// Description:		Unmaps a file opened by OpenColumnFile().
+//
+// Parameters:	    (ColumnFile*) file   File to close
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       OpenColumnFile(), main() of columndump
+// Calls:		    UnmapFile()
+// History Log:     10/17/2026  added for the columnar schedule files
+//----------------------------------------------------------------------------
+void CloseColumnFile(ColumnFile* file)
+{
+	UnmapFile(&file->mapping);
+	memset(file, 0, sizeof(ColumnFile));
+}
+//----------------------------------------------------------------------------
+// Function:	    int WriteColumnText(ScheduleWriter* writer,
+//						const ColumnFile* file, const long long loan)
+//
+// Description:		Writes one loan of a columnar file as the text
+//					SaveTable() writes: the heading, then one row per month
+//					read straight from the mapped columns.
+//
+// Parameters:	    (ScheduleWriter*)    writer   Open writer
+//				    const (ColumnFile*)  file     Open columnar file
+//				    const (long long)    loan     Directory entry, 0 based
+//
+// Returns:		    (int) 1 on success, 0 if there is no such loan
+// Date:            10/17/2026
+// Called By:       main() of columndump and of bench_columnar
+// Calls:		    WriteScheduleHeading(), WriteScheduleRow()
+// History Log:     10/17/2026  added for the columnar schedule files
+//----------------------------------------------------------------------------
+int WriteColumnText(ScheduleWriter* writer, const ColumnFile* file,
+	const long long loan)
+{
+	const ColumnLoan* entry = NULL;
+
+	if ((loan < 0) || (loan >= file->loanCount))
+		return 0;
+	entry = &file->loans[loan];
+	WriteScheduleHeading(writer, entry->loanSize, entry->interestRate,
+		entry->months);
+	for (int64_t r = entry->firstRow; r < entry->firstRow + entry->months;
+		r++)
+		WriteScheduleRow(writer, file->month[r], file->payment[r],
+			file->principal[r], file->interest[r], file->balance[r]);
+	return 1;
+}
@@ -0,0 +1,83 @@
+//----------------------------------------------------------------------------
+// File:			amort_columnar.h
+//
+// Description:     Header file for the columnar schedule files
+//					(amort_columnar.c). One file holds the tables of one
+//					loan or of a whole book: a header, a directory with the
+//					inputs and totals of each loan, then one fixed width
+//					column each for month, payment, principal, interest and
+//					balance, every part starting on a COLUMN_ALIGNMENT
+//					boundary. The rows of every loan follow each other in
+//					each column, so a reader maps the file and scans the
+//					columns in place. Numbers are in the byte order of the
+//					machine that wrote the file.
+//
+// History Log:    10/17/2026  added for the columnar schedule files
+//----------------------------------------------------------------------------
+
+#ifndef AMORT_COLUMNAR_H
+#define AMORT_COLUMNAR_H
+#include <stdint.h>
+#include "amort_platform.h"
+#include "amort_schedule.h"
+#include "amort_writer.h"
+
+#define COLUMN_MAGIC "AMORTCOL"
+#define COLUMN_EXTENSION ".col"     // SaveTable() writes these columnar
+#define COLUMN_MAGIC_LENGTH 8
+#define COLUMN_VERSION 1
+#define COLUMN_ALIGNMENT 64         // Cache line, and any SIMD load
+#define COLUMN_COUNT 5
+#define COLUMN_MONTH 0              // int32_t
+#define COLUMN_PAYMENT 1            // double, and the rest
+#define COLUMN_PRINCIPAL 2
+#define COLUMN_INTEREST 3
+#define COLUMN_BALANCE 4
+
+typedef struct
+{
+	char magic[COLUMN_MAGIC_LENGTH];    // COLUMN_MAGIC, no NUL
+	int32_t version;                // COLUMN_VERSION
+	int32_t headerSize;             // sizeof(ColumnHeader)
+	int64_t loans;                  // Entries in the directory
+	int64_t rows;                   // Rows of all loans
+	int64_t fileSize;               // Bytes in the file
+	int64_t directory;              // Offset of the ColumnLoan entries
+	int64_t columns[COLUMN_COUNT];  // Offset of each column
+} ColumnHeader;
+
+typedef struct
+{
+	double loanSize;                // Inputs the rows were built from
+	double paymentSize;
+	double interestRate;
+	int32_t months;                 // Rows of the loan
+	int32_t reserved;
+	int64_t firstRow;               // Its month 1 in the columns
+	double totalPaid;               // Sums of its columns
+	double totalPrincipal;
+	double totalInterest;
+} ColumnLoan;
+
+typedef struct
+{
+	AmortMapping mapping;
+	const ColumnHeader* header;
+	const ColumnLoan* loans;
+	long long loanCount;
+	long long rows;
+	const int32_t* month;           // The columns, rows entries each
+	const double* payment;
+	const double* principal;
+	const double* interest;
+	const double* balance;
+} ColumnFile;
+
+long long SaveScheduleColumns(const char* filename,
+	const Schedule* schedules, const size_t count);
+int OpenColumnFile(ColumnFile* file, const char* filename);
+void CloseColumnFile(ColumnFile* file);
+int WriteColumnText(ScheduleWriter* writer, const ColumnFile* file,
+	const long long loan);
+
+#endif
@@ -0,0 +1,356 @@
+//----------------------------------------------------------------------------
+// File:			amort_frequency.c
+//
+// Description      Payment frequency engines for the Amort library. The
+//					inline bodies below are the formulas and the schedule
+//					loop of amort.c and FillScheduleRows() with the 12 of
+//					monthly loans made a parameter. DEFINE_FREQUENCY stamps
+//					out one set of functions per frequency, passing the
+//					payments and compounding periods per year as constants,
+//					so the compiler folds them into each copy (the C form of
+//					a template). The Get*() functions pick a copy by FREQ_
+//					number, once per call, for callers that only know the
+//					frequency at run time.
+//
+//					The rate per payment is r / (100 * perYear) when interest
+//					compounds once per payment, else the equivalent rate
+//					(1 + r / (100 * compounds))^(compounds / perYear) - 1.
+//
+// Functions:	    double getPaymentAmount<name>(const int payments,
+//						const double principal, const double interestRate)
+//					double getLoanAmount<name>(const double payment,
+//						const int payments, const double interestRate)
+//					int getNumberOfPayments<name>(const double payment,
+//						const double principal, const double interestRate)
+//					int FillScheduleRows<name>(ScheduleRow* rows,
+//						double loanBalance, const double paymentSize,
+//						const double interestRate, const int payments)
+//						for each name of AMORT_FREQUENCIES
+//					const char* GetFrequencyName(const int frequency)
+//					int GetPaymentsPerYear(const int frequency)
+//					double GetFrequencyPayment(const int frequency,
+//						const int payments, const double principal,
+//						const double interestRate)
+//					double GetFrequencyLoanAmount(const int frequency,
+//						const double payment, const int payments,
+//						const double interestRate)
+//					int GetFrequencyPayments(const int frequency,
+//						const double payment, const double principal,
+//						const double interestRate)
+//					int FillFrequencyRows(const int frequency,
+//						ScheduleRow* rows, double loanBalance,
+//						const double paymentSize, const double interestRate,
+//						const int payments)
+//----------------------------------------------------------------------------
+
+#include "amort.h"
+#include "amort_frequency.h"
+
+#ifdef _MSC_VER
+#define ENGINE_INLINE static __forceinline
+#else
+#define ENGINE_INLINE static inline __attribute__((always_inline))
+#endif
+
+#define EXACT_INTEGERS 4503599627370496.0   // 2^52: larger doubles are whole
+
+static const char* FREQUENCY_NAMES[FREQUENCY_COUNT] =
+{
+	"monthly", "weekly", "bi-weekly", "semi-monthly", "quarterly",
+	"daily accrual"
+};
+
+// floor(x), without the library call floor() is unless the compiler may use
+// SSE4.1. The cent rounding of the loop only needs the cast.
+ENGINE_INLINE double floorValue(const double x)
+{
+	return ((x >= 0) && (x < EXACT_INTEGERS)) ? (double)(long long)x :
+		floor(x);
+}
+
+// Interest rate of one payment period.
+ENGINE_INLINE double periodRate(const double interestRate,
+	const int perYear, const int compounds)
+{
+	if (compounds == perYear)
+		return interestRate / (HUNDRED * perYear);
+	return expm1((double)compounds / perYear *
+		log1p(interestRate / (HUNDRED * compounds)));
+}
+
+// getPaymentAmount() for any frequency.
+ENGINE_INLINE double paymentAmount(const int payments,
+	const double principal, const double interestRate, const int perYear,
+	const int compounds)
+{
+	double payment = 0;
+	double interestExp = 0;
+	double rate = periodRate(interestRate, perYear, compounds);
+
+	if (interestRate == 0)
+		payment = principal / payments;
+	else
+	{
+		interestExp = pow(rate + ONE, (double)payments);
+		payment = (interestExp / (interestExp - ONE)) * principal * rate;
+	}
+	return ceil(payment * HUNDRED) / HUNDRED;
+}
+
+// getLoanAmount() for any frequency.
+ENGINE_INLINE double loanAmount(const double payment, const int payments,
+	const double interestRate, const int perYear, const int compounds)
+{
+	double principal = 0;
+	double interestExp = 0;
+	double rate = periodRate(interestRate, perYear, compounds);
+
+	if (interestRate == 0)
+		principal = payment * payments;
+	else
+	{
+		interestExp = pow(rate + ONE, (double)payments);
+		principal = ((interestExp - 1) / (rate * interestExp)) * payment;
+	}
+	return round(principal * HUNDRED) / HUNDRED;
+}
+
+// getNumberOfMonths() for any frequency.
+ENGINE_INLINE int numberOfPayments(const double payment,
+	const double principal, const double interestRate, const int perYear,
+	const int compounds)
+{
+	double rate = periodRate(interestRate, perYear, compounds);
+	double payments = (interestRate == 0) ? principal / payment :
+		(log(payment) - log(payment - (principal * rate))) / log(1 + rate);
+
+	return (int)ceil(payments);
+}
+
+// The double loop of FillScheduleRows() for any frequency, every row.
+ENGINE_INLINE int scheduleRows(ScheduleRow* rows, double loanBalance,
+	const double paymentSize, const double interestRate, const int payments,
+	const int perYear, const int compounds)
+{
+	const double rate =
+		periodRate(roundInterest(interestRate, 8), perYear, compounds);
+	double payment = paymentSize;
+	double interestPaid = 0;
+	double principalPaid = 0;
+	double interestToDate = 0;
+	ScheduleRow* row = rows;
+
+	for (int i = 1; i <= payments; i++, row++)
+	{
+		interestPaid = loanBalance * rate;
+		interestPaid = floorValue(interestPaid * HUNDRED + HALF) / HUNDRED;
+		principalPaid = payment - interestPaid;
+		loanBalance -= principalPaid;
+		if ((i == payments) && (loanBalance != 0))  //adjust last payment
+		{
+			payment += loanBalance;
+			principalPaid += loanBalance;
+			loanBalance -= loanBalance;
+		}
+		row->month = i;
+		row->payment = payment;
+		row->principal = principalPaid;
+		row->interest = interestPaid;
+		row->balance = loanBalance;
+		interestToDate += interestPaid;
+		row->interestToDate = interestToDate;
+	}
+	return (payments > 0) ? payments : 0;
+}
+
+#define DEFINE_FREQUENCY(name, perYear, compounds) \
+	double getPaymentAmount##name(const int payments, \
+		const double principal, const double interestRate) \
+	{ \
+		return paymentAmount(payments, principal, interestRate, perYear, \
+			compounds); \
+	} \
+	double getLoanAmount##name(const double payment, const int payments, \
+		const double interestRate) \
+	{ \
+		return loanAmount(payment, payments, interestRate, perYear, \
+			compounds); \
+	} \
+	int getNumberOfPayments##name(const double payment, \
+		const double principal, const double interestRate) \
+	{ \
+		return numberOfPayments(payment, principal, interestRate, perYear, \
+			compounds); \
+	} \
+	int FillScheduleRows##name(ScheduleRow* rows, double loanBalance, \
+		const double paymentSize, const double interestRate, \
+		const int payments) \
+	{ \
+		return scheduleRows(rows, loanBalance, paymentSize, interestRate, \
+			payments, perYear, compounds); \
+	}
+
+AMORT_FREQUENCIES(DEFINE_FREQUENCY)
+
+// Tables of the copies above, in FREQ_ order.
+#define PAYMENT_COPY(name, perYear, compounds) getPaymentAmount##name,
+#define LOAN_COPY(name, perYear, compounds) getLoanAmount##name,
+#define TERM_COPY(name, perYear, compounds) getNumberOfPayments##name,
+#define ROWS_COPY(name, perYear, compounds) FillScheduleRows##name,
+#define PER_YEAR(name, perYear, compounds) perYear,
+
+static double (* const PAYMENT_COPIES[FREQUENCY_COUNT])(const int,
+	const double, const double) = { AMORT_FREQUENCIES(PAYMENT_COPY) };
+static double (* const LOAN_COPIES[FREQUENCY_COUNT])(const double,
+	const int, const double) = { AMORT_FREQUENCIES(LOAN_COPY) };
+static int (* const TERM_COPIES[FREQUENCY_COUNT])(const double,
+	const double, const double) = { AMORT_FREQUENCIES(TERM_COPY) };
+static int (* const ROWS_COPIES[FREQUENCY_COUNT])(ScheduleRow*, double,
+	const double, const double, const int) =
+	{ AMORT_FREQUENCIES(ROWS_COPY) };
+static const int PAYMENTS_PER_YEAR[FREQUENCY_COUNT] =
+	{ AMORT_FREQUENCIES(PER_YEAR) };
+
+// 1 if frequency is a FREQ_ number.
+static int knownFrequency(const int frequency)
+{
+	return (frequency >= 0) && (frequency < FREQUENCY_COUNT);
+}
+//----------------------------------------------------------------------------
+// Function:	    const char* GetFrequencyName(const int frequency)
+//
+// Description:		Returns the name of a FREQ_ number, "" if unknown.
+//
+// Parameters:	    const (int) frequency   FREQ_MONTHLY, FREQ_WEEKLY, ...
+//
+// Returns:		    (const char*) name   Name for reports
+// Date:            10/17/2026
+// History Log:     10/17/2026  added for payment frequencies
+//----------------------------------------------------------------------------
+const char* GetFrequencyName(const int frequency)
+{
+	if (!knownFrequency(frequency))
+		return "";
+	return FREQUENCY_NAMES[frequency];
+}
+//----------------------------------------------------------------------------
+// Function:	    int GetPaymentsPerYear(const int frequency)
+//
+// Description:		Returns the payments per year of a FREQ_ number, 0 if
+//					unknown. MAX_TERM_YEARS times it is the longest term.
+//
+// Parameters:	    const (int) frequency   FREQ_MONTHLY, FREQ_WEEKLY, ...
+//
+// Returns:		    (int) payments   Payments per year
+// Date:            10/17/2026
+// History Log:     10/17/2026  added for payment frequencies
+//----------------------------------------------------------------------------
+int GetPaymentsPerYear(const int frequency)
+{
+	if (!knownFrequency(frequency))
+		return 0;
+	return PAYMENTS_PER_YEAR[frequency];
+}
+//----------------------------------------------------------------------------
+// Function:	    double GetFrequencyPayment(const int frequency,
+//						const int payments, const double principal,
+//						const double interestRate)
+//
+// Description:		getPaymentAmount<name>() of a FREQ_ number.
+//
+// Parameters:	    const (int)    frequency      FREQ_MONTHLY, FREQ_WEEKLY, ...
+//				    const (int)    payments       Number of payments
+//				    const (double) principal      Total amount of loan
+//				    const (double) interestRate   Annual interest rate
+//
+// Returns:		    (double) payment   Amount of one payment, rounded up to
+//									   the cent; 0 for an unknown frequency
+// Date:            10/17/2026
+// History Log:     10/17/2026  added for payment frequencies
+//----------------------------------------------------------------------------
+double GetFrequencyPayment(const int frequency, const int payments,
+	const double principal, const double interestRate)
+{
+	if (!knownFrequency(frequency))
+		return 0;
+	return PAYMENT_COPIES[frequency](payments, principal, interestRate);
+}
+//----------------------------------------------------------------------------
+// Function:	    double GetFrequencyLoanAmount(const int frequency,
+//						const double payment, const int payments,
+//						const double interestRate)
+//
+// Description:		getLoanAmount<name>() of a FREQ_ number.
+//
+// Parameters:	    const (int)    frequency      FREQ_MONTHLY, FREQ_WEEKLY, ...
+//				    const (double) payment        Amount of one payment
+//				    const (int)    payments       Number of payments
+//				    const (double) interestRate   Annual interest rate
+//
+// Returns:		    (double) principal   Amount of loan, rounded to the
+//										 cent; 0 for an unknown frequency
+// Date:            10/17/2026
+// History Log:     10/17/2026  added for payment frequencies
+//----------------------------------------------------------------------------
+double GetFrequencyLoanAmount(const int frequency, const double payment,
+	const int payments, const double interestRate)
+{
+	if (!knownFrequency(frequency))
+		return 0;
+	return LOAN_COPIES[frequency](payment, payments, interestRate);
+}
+//----------------------------------------------------------------------------
+// Function:	    int GetFrequencyPayments(const int frequency,
+//						const double payment, const double principal,
+//						const double interestRate)
+//
+// Description:		getNumberOfPayments<name>() of a FREQ_ number.
+//
+// Parameters:	    const (int)    frequency      FREQ_MONTHLY, FREQ_WEEKLY, ...
+//				    const (double) payment        Amount of one payment
+//				    const (double) principal      Amount of loan
+//				    const (double) interestRate   Annual interest rate
+//
+// Returns:		    (int) payments   Number of payments; 0 for an unknown
+//									 frequency
+// Date:            10/17/2026
+// History Log:     10/17/2026  added for payment frequencies
+//----------------------------------------------------------------------------
+int GetFrequencyPayments(const int frequency, const double payment,
+	const double principal, const double interestRate)
+{
+	if (!knownFrequency(frequency))
+		return 0;
+	return TERM_COPIES[frequency](payment, principal, interestRate);
+}
+//----------------------------------------------------------------------------
+// Function:	    int FillFrequencyRows(const int frequency,
+//						ScheduleRow* rows, double loanBalance,
+//						const double paymentSize, const double interestRate,
+//						const int payments)
+//
+// Description:		FillScheduleRows<name>() of a FREQ_ number: the whole
+//					table, one row per payment. The choice is made once;
+//					the loop is the copy compiled for that frequency.
+//					ScheduleRow.month holds the payment number.
+//
+// Parameters:	    const (int)    frequency      FREQ_MONTHLY, FREQ_WEEKLY, ...
+//				    (ScheduleRow*) rows           Receives payments rows
+//				    (double)       loanBalance    Total size of loan
+//				    const (double) paymentSize    Amount of one payment
+//				    const (double) interestRate   Annual interest rate
+//				    const (int)    payments       Number of payments
+//
+// Returns:		    (int) count   Number of rows written
+// Date:            10/17/2026
+// History Log:     10/17/2026  added for payment frequencies
+//----------------------------------------------------------------------------
+int FillFrequencyRows(const int frequency, ScheduleRow* rows,
+	double loanBalance, const double paymentSize, const double interestRate,
+	const int payments)
+{
+	if (!knownFrequency(frequency))
+		return 0;
+	return ROWS_COPIES[frequency](rows, loanBalance, paymentSize,
+		interestRate, payments);
+}
@@ -0,0 +1,66 @@
+//----------------------------------------------------------------------------
+// File:			amort_frequency.h
+//
+// Description:     Header file for the payment frequency engines
+//					(amort_frequency.c). The payment, loan size, term and
+//					schedule functions of amort.c assume monthly payments
+//					(MONTHLY_DIVISOR, MONTHS_PER_YEAR). Here each frequency
+//					of AMORT_FREQUENCIES gets its own copy of them, built
+//					from one inline body with the payments and compounding
+//					periods per year as constants, so each hot loop is
+//					compiled for its frequency with no run time branching.
+//					The Monthly copies give the same results, bit for bit,
+//					as the functions of amort.c.
+//
+// History Log:    10/17/2026  added for payment frequencies
+//----------------------------------------------------------------------------
+
+#ifndef AMORT_FREQUENCY_H
+#define AMORT_FREQUENCY_H
+#include "amort_schedule.h"
+
+#define FREQ_MONTHLY 0
+#define FREQ_WEEKLY 1
+#define FREQ_BIWEEKLY 2
+#define FREQ_SEMI_MONTHLY 3
+#define FREQ_QUARTERLY 4
+#define FREQ_DAILY_ACCRUAL 5        // Monthly payments, interest daily
+#define FREQUENCY_COUNT 6
+#define DAYS_PER_YEAR 365
+#define MAX_TERM_YEARS 500          // FIVE_HUNDRED_YEARS for any frequency
+
+// X(name, payments per year, compounding periods per year), in FREQ_ order.
+#define AMORT_FREQUENCIES(X) \
+	X(Monthly, 12, 12) \
+	X(Weekly, 52, 52) \
+	X(Biweekly, 26, 26) \
+	X(SemiMonthly, 24, 24) \
+	X(Quarterly, 4, 4) \
+	X(DailyAccrual, 12, DAYS_PER_YEAR)
+
+#define DECLARE_FREQUENCY(name, perYear, compounds) \
+	double getPaymentAmount##name(const int payments, \
+		const double principal, const double interestRate); \
+	double getLoanAmount##name(const double payment, const int payments, \
+		const double interestRate); \
+	int getNumberOfPayments##name(const double payment, \
+		const double principal, const double interestRate); \
+	int FillScheduleRows##name(ScheduleRow* rows, double loanBalance, \
+		const double paymentSize, const double interestRate, \
+		const int payments);
+
+AMORT_FREQUENCIES(DECLARE_FREQUENCY)
+
+const char* GetFrequencyName(const int frequency);
+int GetPaymentsPerYear(const int frequency);
+double GetFrequencyPayment(const int frequency, const int payments,
+	const double principal, const double interestRate);
+double GetFrequencyLoanAmount(const int frequency, const double payment,
+	const int payments, const double interestRate);
+int GetFrequencyPayments(const int frequency, const double payment,
+	const double principal, const double interestRate);
+int FillFrequencyRows(const int frequency, ScheduleRow* rows,
+	double loanBalance, const double paymentSize, const double interestRate,
+	const int payments);
+
+#endif
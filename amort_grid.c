@@ -0,0 +1,439 @@
+//----------------------------------------------------------------------------
+// File:			amort_grid.c
+//
+// Description      Rate by term grid for the Amort library. Along a row the
+//					power x = (1 + r)^n is carried from one term to the next
+//					with one multiplication instead of a pow() per cell. The
+//					running product is kept as an unevaluated sum of two
+//					doubles (Dekker's exact product), so after thousands of
+//					terms it still rounds to the correctly rounded power.
+//					Payments then match getPaymentAmount() except where the
+//					C library pow() is off in the last bit and that moves
+//					the payment across a cent (one cell in a million with
+//					glibc); there the two differ by one cent. GRID_ROW_BLOCK
+//					rows are carried side by side, and blocks of rows are
+//					shared out among threads.
+//
+//					The annuity factors stay in the grid: a new principal
+//					only needs one multiplication and one rounding per cell.
+//
+// Functions:	    int AllocRateGrid(RateGrid* grid, const int maxEighths,
+//						const int terms)
+//					void FreeRateGrid(RateGrid* grid)
+//					void FillRateGrid(RateGrid* grid, const double principal,
+//						int threads)
+//					void RescaleRateGrid(RateGrid* grid,
+//						const double principal, int threads)
+//					long long SaveRateGrid(const RateGrid* grid,
+//						const char* filename, const int format)
+//----------------------------------------------------------------------------
+
+// The exact product below needs every multiplication and addition rounded
+// on its own; contracting them into fused multiply-adds would break it.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC optimize("fp-contract=off")
+#elif defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#endif
+
+#include <string.h>
+#include "amort_annuity.h"
+#include "amort_grid.h"
+#include "amort_platform.h"
+#include "amort_simd.h"
+#include "amort_writer.h"
+
+#define GRID_ROW_BLOCK 4
+#define SPLITTER 134217729.0        // 2^27 + 1, splits a double in halves
+#define EXACT_CENTS 4503599627370496.0      // 2^52: larger doubles are whole
+#define GRID_MAGIC "AMORTGRD"
+#define GRID_MAGIC_LENGTH 8
+#define GRID_LINE_MAX 96
+
+typedef struct
+{
+	RateGrid* grid;
+	int firstRow;
+	int rowCount;
+	int factors;                    // 1 to build the factors as well
+} GridSlice;
+
+// ceil(amount) for amount >= 0, without the library call ceil() is unless
+// the compiler may use SSE4.1.
+static Cents ceilCents(const double amount)
+{
+	Cents cents = 0;
+
+	if (!(amount < EXACT_CENTS))
+		return (Cents)ceil(amount);
+	cents = (Cents)amount;
+	return cents + (cents < amount);
+}
+
+// Splits a into a high half and a low half whose products are exact.
+static void splitDouble(const double a, double* high, double* low)
+{
+	const double t = SPLITTER * a;
+
+	*high = t - (t - a);
+	*low = a - *high;
+}
+
+// Fills the factors of rows first .. first + count - 1, at most
+// GRID_ROW_BLOCK of them. Each row's power is held as high + low and
+// multiplied by 1 + r exactly, then rounded once. All GRID_ROW_BLOCK lanes
+// are always stepped, so the compiler can unroll and vectorize the block;
+// lanes past count and the 0% row write to spare.
+static void fillFactors(RateGrid* grid, const int first, const int count)
+{
+	double spare[FIVE_HUNDRED_YEARS];
+	double high[GRID_ROW_BLOCK];
+	double low[GRID_ROW_BLOCK];
+	double base[GRID_ROW_BLOCK];
+	double baseHigh[GRID_ROW_BLOCK];
+	double baseLow[GRID_ROW_BLOCK];
+	double* factor[GRID_ROW_BLOCK];
+
+	for (int k = 0; k < GRID_ROW_BLOCK; k++)
+	{
+		int row = first + k;
+
+		base[k] = ((row / 8.0) / MONTHLY_DIVISOR) + ONE;
+		splitDouble(base[k], &baseHigh[k], &baseLow[k]);
+		high[k] = ONE;
+		low[k] = 0;
+		factor[k] = ((k < count) && (row > 0)) ?
+			grid->factor + (size_t)row * grid->terms : spare;
+	}
+	for (int n = 0; n < grid->terms; n++)
+	{
+		for (int k = 0; k < GRID_ROW_BLOCK; k++)
+		{
+			double product = high[k] * base[k];
+			double partHigh = 0;
+			double partLow = 0;
+			double error = 0;
+			double sum = 0;
+
+			splitDouble(high[k], &partHigh, &partLow);
+			error = ((partHigh * baseHigh[k] - product) +
+				partHigh * baseLow[k] + partLow * baseHigh[k]) +
+				partLow * baseLow[k];
+			error += low[k] * base[k];
+			sum = product + error;
+			low[k] = error - (sum - product);
+			high[k] = sum;
+			factor[k][n] = high[k] / (high[k] - ONE);
+		}
+	}
+	if (first == 0)
+		memset(grid->factor, 0, grid->terms * sizeof(double));
+}
+
+// Works out the cents of one row from its factors, the same way as
+// getPaymentAmount().
+static void fillPayments(RateGrid* grid, const int row)
+{
+	const double principal = grid->principal;
+	const double monthlyInterest = (row / 8.0) / MONTHLY_DIVISOR;
+	const Cents principalCents = ToCents(principal);
+	const size_t first = (size_t)row * grid->terms;
+	const double* factor = grid->factor + first;
+	Cents* payment = grid->payment + first;
+	Cents* interest = grid->interest + first;
+
+	for (int n = 0; n < grid->terms; n++)
+	{
+		double amount = (row == 0) ? principal / (n + 1) :
+			factor[n] * principal * monthlyInterest;
+
+		payment[n] = ceilCents(amount * HUNDRED);
+		interest[n] = payment[n] * (n + 1) - principalCents;
+	}
+}
+
+// Thread body: the factors (if asked) and cents of a slice of rows.
+static void fillSlice(void* arg)
+{
+	GridSlice* slice = (GridSlice*)arg;
+	RateGrid* grid = slice->grid;
+	const int last = slice->firstRow + slice->rowCount;
+
+	for (int row = slice->firstRow; row < last; row += GRID_ROW_BLOCK)
+	{
+		int count = (last - row < GRID_ROW_BLOCK) ? last - row :
+			GRID_ROW_BLOCK;
+
+		if (slice->factors)
+			fillFactors(grid, row, count);
+		for (int k = row; (k < row + GRID_ROW_BLOCK) && (k < last); k++)
+			fillPayments(grid, k);
+	}
+}
+
+// Shares the rows out among threads in whole blocks and runs fillSlice().
+static void runSlices(RateGrid* grid, int threads, const int factors)
+{
+	AmortThread handles[GRID_MAX_THREADS];
+	int launched[GRID_MAX_THREADS] = { 0 };
+	GridSlice slices[GRID_MAX_THREADS];
+	const int blocks = (grid->rates + GRID_ROW_BLOCK - 1) / GRID_ROW_BLOCK;
+
+	if (threads <= 0)
+		threads = GetCpuCount();
+	if (threads > GRID_MAX_THREADS)
+		threads = GRID_MAX_THREADS;
+	if (threads > blocks)
+		threads = (blocks > 0) ? blocks : 1;
+	for (int t = 0; t < threads; t++)
+	{
+		int first = blocks * t / threads * GRID_ROW_BLOCK;
+		int last = blocks * (t + 1) / threads * GRID_ROW_BLOCK;
+
+		slices[t].grid = grid;
+		slices[t].firstRow = first;
+		slices[t].rowCount = ((last < grid->rates) ? last : grid->rates) -
+			first;
+		slices[t].factors = factors;
+	}
+	for (int t = 1; t < threads; t++)       // Slice 0 runs on this thread
+		launched[t] = StartThread(&handles[t], fillSlice, &slices[t]);
+	fillSlice(&slices[0]);
+	for (int t = 1; t < threads; t++)
+	{
+		if (launched[t])
+			JoinThread(handles[t]);
+		else
+			fillSlice(&slices[t]);
+	}
+}
+
+// Writes the digits of a count >= 0. Returns the characters written.
+static int formatCount(char* text, long long value)
+{
+	char digits[24];
+	int count = 0;
+
+	do
+	{
+		digits[count++] = (char)('0' + value % 10);
+		value /= 10;
+	} while (value > 0);
+	for (int i = 0; i < count; i++)
+		text[i] = digits[count - 1 - i];
+	return count;
+}
+
+// Writes cents as dollars with two decimals, "%.2lf" style. Returns the
+// characters written.
+static int formatCents(char* text, Cents cents)
+{
+	int length = 0;
+
+	if (cents < 0)
+	{
+		text[length++] = '-';
+		cents = -cents;
+	}
+	length += formatCount(text + length, cents / HUNDRED);
+	text[length++] = '.';
+	text[length++] = (char)('0' + cents % HUNDRED / 10);
+	text[length++] = (char)('0' + cents % 10);
+	return length;
+}
+
+// Writes the grid as CSV text. Returns the cells written or -1.
+static long long saveCsv(const RateGrid* grid, const char* filename)
+{
+	ScheduleWriter writer;
+	char line[GRID_LINE_MAX];
+
+	if (!OpenScheduleWriter(&writer, filename, WRITER_STDIO))
+		return -1;
+	WriteScheduleText(&writer, "rate,months,payment,interest\n");
+	for (int row = 0; row < grid->rates; row++)
+	{
+		const size_t first = (size_t)row * grid->terms;
+		char rate[16];
+
+		snprintf(rate, sizeof(rate), "%.3lf,", row / 8.0);
+		for (int n = 0; n < grid->terms; n++)
+		{
+			int length = (int)strlen(rate);
+
+			memcpy(line, rate, length);
+			length += formatCount(line + length, n + 1);
+			line[length++] = ',';
+			length += formatCents(line + length, grid->payment[first + n]);
+			line[length++] = ',';
+			length += formatCents(line + length, grid->interest[first + n]);
+			line[length++] = '\n';
+			line[length] = '\0';
+			WriteScheduleText(&writer, line);
+		}
+	}
+	if (!CloseScheduleWriter(&writer))
+		return -1;
+	return (long long)grid->rates * grid->terms;
+}
+
+// Writes the grid in binary, see SaveRateGrid(). Returns the cells written
+// or -1.
+static long long saveBinary(const RateGrid* grid, const char* filename)
+{
+	FILE* fp = fopen(filename, "wb");
+	const size_t cells = (size_t)grid->rates * grid->terms;
+	int ok = (fp != NULL);
+
+	if (!ok)
+		return -1;
+	ok = (fwrite(GRID_MAGIC, 1, GRID_MAGIC_LENGTH, fp) == GRID_MAGIC_LENGTH) &&
+		(fwrite(&grid->rates, sizeof(int), 1, fp) == 1) &&
+		(fwrite(&grid->terms, sizeof(int), 1, fp) == 1) &&
+		(fwrite(&grid->principal, sizeof(double), 1, fp) == 1) &&
+		(fwrite(grid->payment, sizeof(Cents), cells, fp) == cells) &&
+		(fwrite(grid->interest, sizeof(Cents), cells, fp) == cells);
+	if (fclose(fp) != 0)
+		ok = 0;
+	return ok ? (long long)cells : -1;
+}
+//----------------------------------------------------------------------------
+// Function:	    int AllocRateGrid(RateGrid* grid, const int maxEighths,
+//						const int terms)
+//
+// Description:		Allocates a grid for the rates 0 to maxEighths/8 percent
+//					and the terms 1 to 'terms' months. Fill it with
+//					FillRateGrid().
+//
+// Parameters:	    (RateGrid*)   grid         Grid to allocate
+//				    const (int)   maxEighths   Highest rate, in 1/8ths (at
+//											   most ANNUITY_MAX_EIGHTHS)
+//				    const (int)   terms        Longest term in months (at
+//											   most FIVE_HUNDRED_YEARS)
+//
+// Returns:		    (int) 1 on success, 0 when out of range or out of memory
+// Date:            10/17/2026
+// Calls:		    AlignedAlloc()
+// History Log:     10/17/2026  added for the rate by term grid
+//----------------------------------------------------------------------------
+int AllocRateGrid(RateGrid* grid, const int maxEighths, const int terms)
+{
+	size_t cells = 0;
+
+	memset(grid, 0, sizeof(RateGrid));
+	if ((maxEighths < 0) || (maxEighths > ANNUITY_MAX_EIGHTHS) ||
+		(terms < 1) || (terms > FIVE_HUNDRED_YEARS))
+		return 0;
+	grid->rates = maxEighths + 1;
+	grid->terms = terms;
+	cells = (size_t)grid->rates * terms;
+	grid->factor = (double*)AlignedAlloc(cells * sizeof(double),
+		SIMD_ALIGNMENT);
+	grid->payment = (Cents*)AlignedAlloc(cells * sizeof(Cents),
+		SIMD_ALIGNMENT);
+	grid->interest = (Cents*)AlignedAlloc(cells * sizeof(Cents),
+		SIMD_ALIGNMENT);
+	if ((grid->factor == NULL) || (grid->payment == NULL) ||
+		(grid->interest == NULL))
+	{
+		FreeRateGrid(grid);
+		return 0;
+	}
+	return 1;
+}
+//----------------------------------------------------------------------------
+// Function:	    void FreeRateGrid(RateGrid* grid)
+//
+// Description:		Releases a grid allocated by AllocRateGrid().
+//
+// Parameters:	    (RateGrid*) grid   Grid to release
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Calls:		    AlignedFree()
+// History Log:     10/17/2026  added for the rate by term grid
+//----------------------------------------------------------------------------
+void FreeRateGrid(RateGrid* grid)
+{
+	AlignedFree(grid->factor);
+	AlignedFree(grid->payment);
+	AlignedFree(grid->interest);
+	memset(grid, 0, sizeof(RateGrid));
+}
+//----------------------------------------------------------------------------
+// Function:	    void FillRateGrid(RateGrid* grid, const double principal,
+//						int threads)
+//
+// Description:		Works out the factors, payments and total interest of
+//					every cell for a loan of 'principal'. Cell (e, n), the
+//					rate e/8 percent over n months, is at [e * terms + n - 1]
+//					and its payment is getPaymentAmount(n, principal, e/8).
+//
+// Parameters:	    (RateGrid*)      grid        Grid from AllocRateGrid()
+//				    const (double)   principal   Amount of loan
+//				    (int)            threads     Worker threads, 0 for one
+//												 per CPU
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Calls:		    StartThread(), JoinThread(), GetCpuCount()
+// History Log:     10/17/2026  added for the rate by term grid
+//----------------------------------------------------------------------------
+void FillRateGrid(RateGrid* grid, const double principal, int threads)
+{
+	grid->principal = principal;
+	runSlices(grid, threads, 1);
+}
+//----------------------------------------------------------------------------
+// Function:	    void RescaleRateGrid(RateGrid* grid,
+//						const double principal, int threads)
+//
+// Description:		Changes the principal of a filled grid. The factors do
+//					not depend on it, so only the cents are worked out
+//					again, one multiplication and rounding per cell.
+//
+// Parameters:	    (RateGrid*)      grid        Grid from FillRateGrid()
+//				    const (double)   principal   New amount of loan
+//				    (int)            threads     Worker threads, 0 for one
+//												 per CPU
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Calls:		    StartThread(), JoinThread(), GetCpuCount()
+// History Log:     10/17/2026  added for the rate by term grid
+//----------------------------------------------------------------------------
+void RescaleRateGrid(RateGrid* grid, const double principal, int threads)
+{
+	grid->principal = principal;
+	runSlices(grid, threads, 0);
+}
+//----------------------------------------------------------------------------
+// Function:	    long long SaveRateGrid(const RateGrid* grid,
+//						const char* filename, const int format)
+//
+// Description:		Writes a filled grid to a file. GRID_CSV writes a header
+//					line and then "rate,months,payment,interest" for every
+//					cell, row by row. GRID_BINARY writes the magic text
+//					GRID_MAGIC, the number of rates and of terms (ints), the
+//					principal (double), then the payments and then the total
+//					interest of every cell in cents (64-bit ints), in cell
+//					order. Numbers are in the byte order of this machine.
+//
+// Parameters:	    const (RateGrid*) grid       Grid from FillRateGrid()
+//				    const (char*)     filename   File to create
+//				    const (int)       format     GRID_CSV or GRID_BINARY
+//
+// Returns:		    (long long) cells   Cells written, -1 if the file could
+//										not be written
+// Date:            10/17/2026
+// Calls:		    OpenScheduleWriter(), WriteScheduleText(),
+//					CloseScheduleWriter()
+// History Log:     10/17/2026  added for the rate by term grid
+//----------------------------------------------------------------------------
+long long SaveRateGrid(const RateGrid* grid, const char* filename,
+	const int format)
+{
+	if (format == GRID_BINARY)
+		return saveBinary(grid, filename);
+	return saveCsv(grid, filename);
+}
@@ -0,0 +1,46 @@
+//----------------------------------------------------------------------------
+// File:			amort_grid.h
+//
+// Description:     Header file for the rate by term grid (amort_grid.c).
+//					For one principal the grid holds the monthly payment and
+//					total interest of every 1/8th percent rate from 0 up to
+//					a limit against every term from 1 month up. Payments
+//					are worked out as getPaymentAmount() does, from the
+//					correctly rounded power, and kept in whole cents; the
+//					total interest is payment * months - principal,
+//					before the last payment adjustment of the table. The
+//					annuity factor of each cell is kept too, so a new
+//					principal only rescales the grid.
+//
+// History Log:    10/17/2026  added for the rate by term grid
+//----------------------------------------------------------------------------
+
+#ifndef AMORT_GRID_H
+#define AMORT_GRID_H
+#include "amort.h"
+#include "amort_cents.h"
+
+#define GRID_MAX_EIGHTHS 240        // 30 percent
+#define GRID_TERMS FIVE_HUNDRED_YEARS
+#define GRID_MAX_THREADS 256
+#define GRID_CSV 0                  // rate,months,payment,interest lines
+#define GRID_BINARY 1               // Header, then cents, see SaveRateGrid()
+
+typedef struct
+{
+	int rates;                      // Rows: 0, 1/8, ... (rates - 1)/8 percent
+	int terms;                      // Columns: 1 .. terms months
+	double principal;               // Loan size the cents are for
+	double* factor;                 // x / (x - 1), x = (1 + r)^months
+	Cents* payment;                 // Monthly payment of each cell
+	Cents* interest;                // payment * months - principal
+} RateGrid;
+
+int AllocRateGrid(RateGrid* grid, const int maxEighths, const int terms);
+void FreeRateGrid(RateGrid* grid);
+void FillRateGrid(RateGrid* grid, const double principal, int threads);
+void RescaleRateGrid(RateGrid* grid, const double principal, int threads);
+long long SaveRateGrid(const RateGrid* grid, const char* filename,
+	const int format);
+
+#endif
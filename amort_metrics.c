@@ -0,0 +1,401 @@
+//----------------------------------------------------------------------------
+// File:			amort_metrics.c
+//
+// Description      Hot path counters and timers for the Amort library. The
+//					first count a thread makes claims it a MetricBlock,
+//					reached from then on through a thread local pointer, so
+//					counting is one test, one add and one StoreCounter()
+//					that ReadMetrics() can load while it runs. Only the
+//					owning thread writes a block, so no read-modify-write
+//					atomic is needed. The blocks of running threads are
+//					kept on a list for ReadMetrics(); through the hook
+//					registered with SetThreadExitHook(), a thread started
+//					with StartThread() folds its block into the retired
+//					totals when it ends, and the block is used again by the
+//					next thread that needs one.
+//
+// Functions:	    void CountMetric(const int metric, const long long amount)
+//					double StartMetricTimer(const int timer)
+//					void StopMetricTimer(const int timer, const double start)
+//					void SetMetricsEnabled(const int enabled)
+//					int GetMetricsEnabled(void)
+//					void ReadMetrics(MetricValues* totals)
+//					void RetireThreadMetrics(void)
+//					int FormatMetrics(char* text, const size_t size,
+//						const int format)
+//					int WriteMetrics(FILE* fp, const int format)
+//----------------------------------------------------------------------------
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include "amort_metrics.h"
+#include "amort_platform.h"
+
+typedef struct MetricBlock
+{
+	volatile size_t counters[METRIC_COUNTERS];  // As in MetricValues
+	volatile size_t calls[METRIC_TIMERS];
+	volatile size_t timed[METRIC_TIMERS];
+	volatile size_t nanoseconds[METRIC_TIMERS];
+	struct MetricBlock* next;
+} MetricBlock;
+
+static const char* const COUNTER_NAMES[METRIC_COUNTERS] = {
+	"solver_calls", "solver_iterations", "solver_failures",
+	"schedule_rows", "writer_bytes_formatted", "writer_bytes_written" };
+static const char* const COUNTER_HELP[METRIC_COUNTERS] = {
+	"Interest rates searched for", "Steps of the interest rate searches",
+	"Interest rate searches with no answer", "Schedule rows generated",
+	"Table text formatted by the schedule writer",
+	"Table text written to files" };
+static const char* const TIMER_NAMES[METRIC_TIMERS] = { "payment", "loan",
+	"months", "rate", "schedule", "save" };
+
+static AmortLock metricsLock = AMORT_LOCK_INIT;
+static MetricBlock* liveBlocks = NULL;      // Claimed by running threads
+static MetricBlock* freeBlocks = NULL;      // Given back by ended threads
+static MetricValues retired;                // Counts of ended threads
+static volatile int metricsEnabled = 1;
+static AMORT_THREAD_LOCAL MetricBlock* threadBlock = NULL;
+
+// Returns the counters of this thread, claiming a block on first use, or
+// NULL if there is no memory for one. Claiming one also makes sure the
+// thread hands it back as it ends.
+static MetricBlock* threadValues(void)
+{
+	if (threadBlock == NULL)
+	{
+		MetricBlock* block = NULL;
+
+		AcquireLock(&metricsLock);
+		if (freeBlocks != NULL)
+		{
+			block = freeBlocks;
+			freeBlocks = block->next;
+		}
+		else
+			block = (MetricBlock*)calloc(1, sizeof(MetricBlock));
+		if (block != NULL)
+		{
+			block->next = liveBlocks;
+			liveBlocks = block;
+		}
+		ReleaseLock(&metricsLock);
+		if (block == NULL)
+			return NULL;
+		SetThreadExitHook(RetireThreadMetrics);
+		threadBlock = block;
+	}
+	return threadBlock;
+}
+
+// Adds amount to a count of this thread's block. Only this thread writes
+// it, so reading it plainly is safe; the store is what others load.
+static void addCount(volatile size_t* count, const size_t amount)
+{
+	StoreCounter(count, *count + amount);
+}
+
+// Adds the counts of a block, running or not, into a set of values.
+static void addValues(MetricValues* totals, MetricBlock* block)
+{
+	for (int m = 0; m < METRIC_COUNTERS; m++)
+		totals->counters[m] += (long long)LoadCounter(&block->counters[m]);
+	for (int t = 0; t < METRIC_TIMERS; t++)
+	{
+		totals->calls[t] += (long long)LoadCounter(&block->calls[t]);
+		totals->timed[t] += (long long)LoadCounter(&block->timed[t]);
+		totals->nanoseconds[t] +=
+			(long long)LoadCounter(&block->nanoseconds[t]);
+	}
+}
+
+// Estimated seconds spent in all calculations of a type: the mean of the
+// timed ones times the number made.
+static double timerSeconds(const MetricValues* totals, const int timer)
+{
+	return (totals->timed[timer] > 0) ? (double)totals->nanoseconds[timer] /
+		(double)totals->timed[timer] * (double)totals->calls[timer] / 1e9 : 0;
+}
+
+// snprintf() that appends at *used and keeps counting past size.
+static void appendText(char* text, const size_t size, size_t* used,
+	const char* format, ...)
+{
+	va_list args;
+	int length = 0;
+
+	va_start(args, format);
+	length = vsnprintf((*used < size) ? text + *used : NULL,
+		(*used < size) ? size - *used : 0, format, args);
+	va_end(args);
+	if (length > 0)
+		*used += (size_t)length;
+}
+//----------------------------------------------------------------------------
+// Function:	    void CountMetric(const int metric, const long long amount)
+//
+// Description:		Adds amount to one of this thread's METRIC_ counters.
+//
+// Parameters:	    const (int)       metric   METRIC_SOLVER_CALLS, ...
+//				    const (long long) amount   Value to add
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       solveInterestRate(), SolveInterestRates(),
+//					FillScheduleRows(), FlushScheduleWriter()
+// Calls:		    threadValues(), addCount()
+// History Log:     10/17/2026  added for the hot path metrics
+//				    10/17/2026  stored with StoreCounter()
+//----------------------------------------------------------------------------
+void CountMetric(const int metric, const long long amount)
+{
+	MetricBlock* block = NULL;
+
+	if (metricsEnabled && ((block = threadValues()) != NULL))
+		addCount(&block->counters[metric], (size_t)amount);
+}
+//----------------------------------------------------------------------------
+// Function:	    double StartMetricTimer(const int timer)
+//
+// Description:		Counts one calculation of a TIMER_ type and, for every
+//					METRIC_SAMPLE_EVERY'th one, reads the clock so that
+//					StopMetricTimer() can time it. The others cost no clock
+//					reads at all.
+//
+// Parameters:	    const (int) timer   TIMER_PAYMENT, ...
+//
+// Returns:		    (double) start   GetWallSeconds(), or 0 when this
+//					calculation is not timed
+// Date:            10/17/2026
+// Called By:       PriceLoanRecord(), BuildSchedule(), SaveTable()
+// Calls:		    threadValues(), addCount(), GetWallSeconds()
+// History Log:     10/17/2026  added for the hot path metrics
+//				    10/17/2026  stored with StoreCounter()
+//----------------------------------------------------------------------------
+double StartMetricTimer(const int timer)
+{
+	MetricBlock* block = NULL;
+	size_t calls = 0;
+
+	if (!metricsEnabled || ((block = threadValues()) == NULL))
+		return 0;
+	calls = block->calls[timer];
+	addCount(&block->calls[timer], 1);
+	if ((calls & (METRIC_SAMPLE_EVERY - 1)) != 0)
+		return 0;
+	return GetWallSeconds();
+}
+//----------------------------------------------------------------------------
+// Function:	    void StopMetricTimer(const int timer, const double start)
+//
+// Description:		Ends a calculation begun with StartMetricTimer(), adding
+//					its time if it was the one timed.
+//
+// Parameters:	    const (int)    timer   TIMER_PAYMENT, ...
+//				    const (double) start   Returned by StartMetricTimer()
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       PriceLoanRecord(), BuildSchedule(), SaveTable()
+// Calls:		    GetWallSeconds(), addCount()
+// History Log:     10/17/2026  added for the hot path metrics
+//				    10/17/2026  stored with StoreCounter()
+//----------------------------------------------------------------------------
+void StopMetricTimer(const int timer, const double start)
+{
+	if ((start > 0) && (threadBlock != NULL))
+	{
+		addCount(&threadBlock->timed[timer], 1);
+		addCount(&threadBlock->nanoseconds[timer],
+			(size_t)((GetWallSeconds() - start) * 1e9));
+	}
+}
+//----------------------------------------------------------------------------
+// Function:	    void SetMetricsEnabled(const int enabled)
+//
+// Description:		Turns counting on (the default) or off for all threads.
+//					Counts already made are kept.
+//
+// Parameters:	    const (int) enabled   1 to count, 0 to stop
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       main() of bench_metrics
+// History Log:     10/17/2026  added for the hot path metrics
+//----------------------------------------------------------------------------
+void SetMetricsEnabled(const int enabled)
+{
+	metricsEnabled = enabled;
+}
+//----------------------------------------------------------------------------
+// Function:	    int GetMetricsEnabled(void)
+//
+// Description:		Tells whether the counters are on.
+//
+// Parameters:	    none
+//
+// Returns:		    (int) 1 when counting, else 0
+// Date:            10/17/2026
+// Called By:       main() of bench_metrics
+// History Log:     10/17/2026  added for the hot path metrics
+//----------------------------------------------------------------------------
+int GetMetricsEnabled(void)
+{
+	return metricsEnabled;
+}
+//----------------------------------------------------------------------------
+// Function:	    void ReadMetrics(MetricValues* totals)
+//
+// Description:		Adds up the counters of every thread, running or ended.
+//					Running threads are not stopped; their counts are
+//					loaded with LoadCounter(), so a count they are making
+//					at that moment may be left for the next read.
+//
+// Parameters:	    (MetricValues*) totals   Receives the sums
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       FormatMetrics(), main() of bench_metrics
+// Calls:		    addValues()
+// History Log:     10/17/2026  added for the hot path metrics
+//				    10/17/2026  counts of running threads loaded atomically
+//----------------------------------------------------------------------------
+void ReadMetrics(MetricValues* totals)
+{
+	AcquireLock(&metricsLock);
+	*totals = retired;
+	for (MetricBlock* block = liveBlocks; block != NULL;
+		block = block->next)
+		addValues(totals, block);
+	ReleaseLock(&metricsLock);
+}
+//----------------------------------------------------------------------------
+// Function:	    void RetireThreadMetrics(void)
+//
+// Description:		Folds the counters of the calling thread into the
+//					retired totals and gives its block back. It is the
+//					thread exit hook, so it runs as a thread started by
+//					StartThread() ends; a thread that counts again
+//					afterwards claims a new block.
+//
+// Parameters:	    none
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       threadTrampoline() of amort_platform, as the exit hook
+// Calls:		    addValues()
+// History Log:     10/17/2026  added for the hot path metrics
+//				    10/17/2026  run as the thread exit hook
+//----------------------------------------------------------------------------
+void RetireThreadMetrics(void)
+{
+	MetricBlock** link = &liveBlocks;
+
+	if (threadBlock == NULL)
+		return;
+	AcquireLock(&metricsLock);
+	addValues(&retired, threadBlock);
+	while ((*link != NULL) && (*link != threadBlock))
+		link = &(*link)->next;
+	if (*link != NULL)
+		*link = threadBlock->next;
+	memset((void*)threadBlock, 0, sizeof(MetricBlock));
+	threadBlock->next = freeBlocks;
+	freeBlocks = threadBlock;
+	ReleaseLock(&metricsLock);
+	threadBlock = NULL;
+}
+//----------------------------------------------------------------------------
+// Function:	    int FormatMetrics(char* text, const size_t size,
+//						const int format)
+//
+// Description:		Writes the totals of ReadMetrics() as Prometheus text
+//					(METRICS_PROMETHEUS), ending with the OpenMetrics
+//					"# EOF" line, or as one line of JSON (METRICS_JSON).
+//					Every counter is an amort_*_total; calculations are
+//					amort_calculations_total and
+//					amort_calculation_seconds_total by type, the seconds
+//					estimated from the timed sample.
+//
+// Parameters:	    (char*)         text     Receives the text, NUL ended
+//				    const (size_t)  size     Bytes at text,
+//											 METRICS_TEXT_MAX is enough
+//				    const (int)     format   METRICS_PROMETHEUS or
+//											 METRICS_JSON
+//
+// Returns:		    (int) length   Length of the whole text, as snprintf()
+//					returns it; size or more means it was cut short
+// Date:            10/17/2026
+// Called By:       WriteMetrics(), sendMetrics()
+// Calls:		    ReadMetrics(), appendText(), timerSeconds()
+// History Log:     10/17/2026  added for the hot path metrics
+//----------------------------------------------------------------------------
+int FormatMetrics(char* text, const size_t size, const int format)
+{
+	MetricValues totals;
+	size_t used = 0;
+
+	ReadMetrics(&totals);
+	if (size > 0)
+		text[0] = '\0';
+	if (format == METRICS_JSON)
+	{
+		appendText(text, size, &used, "{");
+		for (int m = 0; m < METRIC_COUNTERS; m++)
+			appendText(text, size, &used, "\"%s\":%lld,", COUNTER_NAMES[m],
+				totals.counters[m]);
+		appendText(text, size, &used, "\"calculations\":{");
+		for (int t = 0; t < METRIC_TIMERS; t++)
+			appendText(text, size, &used, "%s\"%s\":{\"calls\":%lld,"
+				"\"timed\":%lld,\"seconds\":%.9lf}", (t > 0) ? "," : "",
+				TIMER_NAMES[t], totals.calls[t], totals.timed[t],
+				timerSeconds(&totals, t));
+		appendText(text, size, &used, "}}\n");
+		return (int)used;
+	}
+	for (int m = 0; m < METRIC_COUNTERS; m++)
+		appendText(text, size, &used, "# HELP amort_%s_total %s\n"
+			"# TYPE amort_%s_total counter\namort_%s_total %lld\n",
+			COUNTER_NAMES[m], COUNTER_HELP[m], COUNTER_NAMES[m],
+			COUNTER_NAMES[m], totals.counters[m]);
+	appendText(text, size, &used, "# HELP amort_calculations_total "
+		"Calculations made, by type\n"
+		"# TYPE amort_calculations_total counter\n");
+	for (int t = 0; t < METRIC_TIMERS; t++)
+		appendText(text, size, &used,
+			"amort_calculations_total{type=\"%s\"} %lld\n", TIMER_NAMES[t],
+			totals.calls[t]);
+	appendText(text, size, &used, "# HELP amort_calculation_seconds_total "
+		"Time spent in calculations, by type, estimated from 1 in %d\n"
+		"# TYPE amort_calculation_seconds_total counter\n",
+		METRIC_SAMPLE_EVERY);
+	for (int t = 0; t < METRIC_TIMERS; t++)
+		appendText(text, size, &used,
+			"amort_calculation_seconds_total{type=\"%s\"} %.9lf\n",
+			TIMER_NAMES[t], timerSeconds(&totals, t));
+	appendText(text, size, &used, "# EOF\n");
+	return (int)used;
+}
+//----------------------------------------------------------------------------
+// Function:	    int WriteMetrics(FILE* fp, const int format)
+//
+// Description:		Writes FormatMetrics() text to a stream.
+//
+// Parameters:	    (FILE*)       fp       Open stream
+//				    const (int)   format   METRICS_PROMETHEUS or METRICS_JSON
+//
+// Returns:		    (int) 1 on success, else 0
+// Date:            10/17/2026
+// Called By:       RunBatchMode(), RunServerMode()
+// Calls:		    FormatMetrics()
+// History Log:     10/17/2026  added for the hot path metrics
+//----------------------------------------------------------------------------
+int WriteMetrics(FILE* fp, const int format)
+{
+	char text[METRICS_TEXT_MAX];
+	int length = FormatMetrics(text, sizeof(text), format);
+
+	return (length < (int)sizeof(text)) && (fputs(text, fp) >= 0);
+}
@@ -0,0 +1,61 @@
+//----------------------------------------------------------------------------
+// File:			amort_metrics.h
+//
+// Description:     Header file for the hot path counters and timers
+//					(amort_metrics.c). Every thread adds to counters of its
+//					own, with no lock and only an atomic store;
+//					ReadMetrics() adds up the counters of all threads when
+//					asked, and FormatMetrics() writes the totals as
+//					Prometheus text or JSON. Counters are bumped once per
+//					call (a table, a solve, a buffer flush), never once per
+//					row, and only every METRIC_SAMPLE_EVERY'th calculation
+//					of a type is timed.
+//
+// History Log:    10/17/2026  added for the hot path metrics
+//				   10/17/2026  counts stored and loaded atomically
+//----------------------------------------------------------------------------
+
+#ifndef AMORT_METRICS_H
+#define AMORT_METRICS_H
+#include <stdio.h>
+
+#define METRIC_SOLVER_CALLS 0       // Interest rates searched for
+#define METRIC_SOLVER_ITERATIONS 1  // Steps of those searches
+#define METRIC_SOLVER_FAILURES 2    // No rate fits, or no convergence
+#define METRIC_ROWS 3               // Schedule rows generated
+#define METRIC_BYTES_FORMATTED 4    // Table text made by ScheduleWriter
+#define METRIC_BYTES_WRITTEN 5      // Of which reached the file
+#define METRIC_COUNTERS 6
+
+#define TIMER_PAYMENT 0             // PriceLoanRecord() by unknown
+#define TIMER_LOAN 1
+#define TIMER_MONTHS 2
+#define TIMER_RATE 3
+#define TIMER_SCHEDULE 4            // BuildSchedule()
+#define TIMER_SAVE 5                // SaveTable(), file name prompt excluded
+#define METRIC_TIMERS 6
+
+#define METRIC_SAMPLE_EVERY 16      // Calculations per timed one, power of 2
+#define METRICS_PROMETHEUS 0
+#define METRICS_JSON 1
+#define METRICS_TEXT_MAX 8192       // Longest FormatMetrics() text
+
+typedef struct
+{
+	long long counters[METRIC_COUNTERS];
+	long long calls[METRIC_TIMERS];     // Calculations of each type
+	long long timed[METRIC_TIMERS];     // Of which were timed
+	long long nanoseconds[METRIC_TIMERS];   // Time of the timed ones
+} MetricValues;
+
+void CountMetric(const int metric, const long long amount);
+double StartMetricTimer(const int timer);
+void StopMetricTimer(const int timer, const double start);
+void SetMetricsEnabled(const int enabled);
+int GetMetricsEnabled(void);
+void ReadMetrics(MetricValues* totals);
+void RetireThreadMetrics(void);
+int FormatMetrics(char* text, const size_t size, const int format);
+int WriteMetrics(FILE* fp, const int format);
+
+#endif
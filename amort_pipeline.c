@@ -0,0 +1,426 @@
+//----------------------------------------------------------------------------
+// File:			amort_pipeline.c
+//
+// Description      Staged batch pipeline for the Amort library. The calling
+//					thread parses records into blocks and deals them out in
+//					turn to the pricing threads, one SPSC ring each. The
+//					pricers push priced blocks into one MPSC ring for the
+//					formatting thread, which puts them back in input order,
+//					formats them and hands them over an SPSC ring to the
+//					writing thread. The writer returns each written block to
+//					the parser over a last SPSC ring; a stage that ends puts
+//					a NULL block in the ring after it. Every block is
+//					allocated once, so no stage allocates while it runs.
+//
+//					If the writing or formatting thread cannot be started
+//					the whole pipeline runs on the calling thread, one block
+//					at a time; if no pricer can, the parser prices too.
+//
+// Functions:	    long long RunPipeline(FILE* in, FILE* out, int workers,
+//						const int format, PipelineStats* stats)
+//					void WritePipelineStats(FILE* fp,
+//						const PipelineStats* stats)
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include "amort.h"
+#include "amort_batch.h"
+#include "amort_metrics.h"
+#include "amort_pipeline.h"
+#include "amort_platform.h"
+#include "amort_ring.h"
+
+#define BLOCK_ALIGNMENT 64          // Cache line
+
+typedef struct
+{
+	size_t sequence;                // Block number in input order
+	size_t count;                   // Records in the block
+	size_t length;                  // Bytes of output in text
+	LoanRecord records[PIPELINE_BLOCK];
+	char text[PIPELINE_BLOCK * BATCH_REPLY_MAX];
+} PipelineBlock;
+
+typedef struct
+{
+	double busySeconds;
+	long long fullWaits;
+	long long emptyWaits;
+	char gap[BLOCK_ALIGNMENT];      // Threads' counters apart
+} StageCounters;
+
+typedef struct Pipeline Pipeline;
+
+typedef struct
+{
+	Pipeline* pipeline;
+	int index;                      // Ring and counters of the pricer
+} PricerStart;
+
+struct Pipeline
+{
+	FILE* in;
+	FILE* out;
+	int format;
+	int workers;                    // Pricing threads running
+	int writeFailed;
+	long long records;
+	long long blocks;
+	PipelineBlock* memory;
+	AmortRing free;                 // Writer to parser: written blocks
+	AmortRing priced;               // Pricers to formatter (MPSC)
+	AmortRing formatted;            // Formatter to writer
+	AmortRing work[PIPELINE_MAX_WORKERS];   // Parser to each pricer
+	StageCounters parseStage;
+	StageCounters formatStage;
+	StageCounters writeStage;
+	StageCounters priceStage[PIPELINE_MAX_WORKERS];
+};
+
+// Fills a block with the next records. Returns 0 at the end of the input.
+static int parseBlock(Pipeline* pipeline, PipelineBlock* block)
+{
+	double start = GetWallSeconds();
+
+	block->count = 0;
+	while ((block->count < PIPELINE_BLOCK) &&
+		NextLoanRecord(pipeline->in, &block->records[block->count]))
+		block->count++;
+	pipeline->parseStage.busySeconds += GetWallSeconds() - start;
+	return block->count > 0;
+}
+
+static void priceBlock(PipelineBlock* block, StageCounters* counters)
+{
+	double start = GetWallSeconds();
+
+	for (size_t i = 0; i < block->count; i++)
+		PriceLoanRecord(&block->records[i]);
+	counters->busySeconds += GetWallSeconds() - start;
+}
+
+static void formatBlock(Pipeline* pipeline, PipelineBlock* block)
+{
+	double start = GetWallSeconds();
+	size_t length = 0;
+
+	for (size_t i = 0; i < block->count; i++)
+	{
+		const LoanRecord* record = &block->records[i];
+		PipelineResult result;
+
+		if (pipeline->format == PIPELINE_TEXT)
+		{
+			length += (size_t)FormatLoanRecord(block->text + length,
+				BATCH_REPLY_MAX, record);
+			continue;
+		}
+		memset(&result, 0, sizeof(result));
+		result.loanSize = record->loanSize;
+		result.paymentSize = record->paymentSize;
+		result.interestRate = record->interestRate;
+		result.months = record->months;
+		result.status = record->status;
+		memcpy(block->text + length, &result, sizeof(result));
+		length += sizeof(result);
+	}
+	block->length = length;
+	pipeline->formatStage.busySeconds += GetWallSeconds() - start;
+}
+
+static void writeBlock(Pipeline* pipeline, PipelineBlock* block)
+{
+	double start = GetWallSeconds();
+
+	if (fwrite(block->text, 1, block->length, pipeline->out) !=
+		block->length)
+		pipeline->writeFailed = 1;
+	CountMetric(METRIC_BYTES_WRITTEN, (long long)block->length);
+	pipeline->records += (long long)block->count;
+	pipeline->blocks++;
+	pipeline->writeStage.busySeconds += GetWallSeconds() - start;
+}
+
+// Thread: prices the blocks dealt to one pricer.
+static void runPricer(void* arg)
+{
+	PricerStart* start = (PricerStart*)arg;
+	Pipeline* pipeline = start->pipeline;
+	StageCounters* counters = &pipeline->priceStage[start->index];
+	PipelineBlock* block = NULL;
+
+	while ((block = (PipelineBlock*)PopRing(&pipeline->work[start->index],
+		&counters->emptyWaits)) != NULL)
+	{
+		priceBlock(block, counters);
+		PushRing(&pipeline->priced, block, 1, &counters->fullWaits);
+	}
+	PushRing(&pipeline->priced, NULL, 1, &counters->fullWaits);
+}
+
+// Thread: formats priced blocks in input order. The blocks in flight are
+// numbered next .. next + PIPELINE_BLOCKS - 1, so each has its own place
+// in waiting.
+static void runFormatter(void* arg)
+{
+	Pipeline* pipeline = (Pipeline*)arg;
+	PipelineBlock* waiting[PIPELINE_BLOCKS] = { NULL };
+	size_t next = 0;
+	int ended = 0;
+
+	for (;;)
+	{
+		PipelineBlock* block = (PipelineBlock*)PopRing(&pipeline->priced,
+			&pipeline->formatStage.emptyWaits);
+
+		if (block == NULL)
+		{
+			if (++ended >= ((pipeline->workers > 0) ? pipeline->workers : 1))
+				break;
+			continue;
+		}
+		waiting[block->sequence % PIPELINE_BLOCKS] = block;
+		while ((block = waiting[next % PIPELINE_BLOCKS]) != NULL)
+		{
+			waiting[next % PIPELINE_BLOCKS] = NULL;
+			formatBlock(pipeline, block);
+			PushRing(&pipeline->formatted, block, 0,
+				&pipeline->formatStage.fullWaits);
+			next++;
+		}
+	}
+	PushRing(&pipeline->formatted, NULL, 0,
+		&pipeline->formatStage.fullWaits);
+}
+
+// Thread: writes formatted blocks and hands them back to the parser.
+static void runWriter(void* arg)
+{
+	Pipeline* pipeline = (Pipeline*)arg;
+	PipelineBlock* block = NULL;
+
+	while ((block = (PipelineBlock*)PopRing(&pipeline->formatted,
+		&pipeline->writeStage.emptyWaits)) != NULL)
+	{
+		writeBlock(pipeline, block);
+		PushRing(&pipeline->free, block, 0,
+			&pipeline->writeStage.fullWaits);
+	}
+}
+
+// Parses blocks on this thread and feeds the pricers, or prices them here
+// when there are none, until the input ends.
+static void runParser(Pipeline* pipeline)
+{
+	StageCounters* counters = &pipeline->parseStage;
+	size_t sequence = 0;
+
+	for (;;)
+	{
+		PipelineBlock* block = (PipelineBlock*)PopRing(&pipeline->free,
+			&counters->emptyWaits);
+
+		if (!parseBlock(pipeline, block))
+			break;
+		block->sequence = sequence;
+		if (pipeline->workers > 0)
+			PushRing(&pipeline->work[sequence % (size_t)pipeline->workers],
+				block, 0, &counters->fullWaits);
+		else
+		{
+			priceBlock(block, &pipeline->priceStage[0]);
+			PushRing(&pipeline->priced, block, 1, &counters->fullWaits);
+		}
+		sequence++;
+	}
+	for (int w = 0; w < pipeline->workers; w++)
+		PushRing(&pipeline->work[w], NULL, 0, &counters->fullWaits);
+	if (pipeline->workers == 0)
+		PushRing(&pipeline->priced, NULL, 1, &counters->fullWaits);
+}
+
+// Adds up the counters of every thread of the run.
+static void collectStats(const Pipeline* pipeline, PipelineStats* stats)
+{
+	const StageCounters* stages[PIPELINE_STAGES] = { &pipeline->parseStage,
+		NULL, &pipeline->formatStage, &pipeline->writeStage };
+
+	stats->records = pipeline->records;
+	stats->blocks = pipeline->blocks;
+	stats->workers = pipeline->workers;
+	for (int s = 0; s < PIPELINE_STAGES; s++)
+	{
+		int threads = (s == STAGE_PRICE) ? pipeline->workers : 1;
+
+		stats->busySeconds[s] = 0;
+		stats->fullWaits[s] = 0;
+		stats->emptyWaits[s] = 0;
+		for (int t = 0; t < ((threads > 0) ? threads : 1); t++)
+		{
+			const StageCounters* counters = (s == STAGE_PRICE) ?
+				&pipeline->priceStage[t] : stages[s];
+
+			stats->busySeconds[s] += counters->busySeconds;
+			stats->fullWaits[s] += counters->fullWaits;
+			stats->emptyWaits[s] += counters->emptyWaits;
+		}
+	}
+}
+//----------------------------------------------------------------------------
+// Function:	    long long RunPipeline(FILE* in, FILE* out, int workers,
+//						const int format, PipelineStats* stats)
+//
+// Description:		Prices every loan record of in and writes the results to
+//					out in input order, with parsing, pricing, formatting
+//					and writing running side by side. Gives the same rows
+//					as RunBatch().
+//
+// Parameters:	    (FILE*)            in        Stream of loan records
+//				    (FILE*)            out       Stream for the results
+//				    (int)              workers   Pricing threads, 0 for one
+//												 per CPU left over by the
+//												 other three stages
+//				    const (int)        format    PIPELINE_TEXT or
+//												 PIPELINE_BINARY
+//				    (PipelineStats*)   stats     Receives the stage times
+//												 and waits, or NULL
+//
+// Returns:		    (long long) count   Number of records written, -1 if the
+//										blocks or rings could not be
+//										allocated or out could not be
+//										written
+// Date:            10/17/2026
+// Called By:       RunPipelineMode(), main() of bench_pipeline
+// Calls:		    runParser(), runPricer(), runFormatter(), runWriter(),
+//					InitRing(), PushRing(), FreeRing(), StartThread(),
+//					JoinThread(), GetCpuCount(), GetWallSeconds(),
+//					AlignedAlloc(), AlignedFree()
+// History Log:     10/17/2026  added for the batch pipeline
+//----------------------------------------------------------------------------
+long long RunPipeline(FILE* in, FILE* out, int workers, const int format,
+	PipelineStats* stats)
+{
+	Pipeline* pipeline = (Pipeline*)AlignedAlloc(sizeof(Pipeline),
+		BLOCK_ALIGNMENT);
+	AmortThread writer;
+	AmortThread formatter;
+	AmortThread pricers[PIPELINE_MAX_WORKERS];
+	PricerStart starts[PIPELINE_MAX_WORKERS];
+	int threaded = 0;
+	int failed = 0;
+	long long count = -1;
+	double start = GetWallSeconds();
+
+	if (workers <= 0)
+		workers = (GetCpuCount() > 4) ? GetCpuCount() - 3 : 1;
+	if (workers > PIPELINE_MAX_WORKERS)
+		workers = PIPELINE_MAX_WORKERS;
+	if (pipeline == NULL)
+		return -1;
+	memset(pipeline, 0, sizeof(Pipeline));
+	pipeline->in = in;
+	pipeline->out = out;
+	pipeline->format = format;
+	pipeline->memory = (PipelineBlock*)AlignedAlloc(sizeof(PipelineBlock) *
+		PIPELINE_BLOCKS, BLOCK_ALIGNMENT);
+	failed = (pipeline->memory == NULL) ||
+		!InitRing(&pipeline->free, PIPELINE_BLOCKS) ||
+		!InitRing(&pipeline->priced, PIPELINE_BLOCKS) ||
+		!InitRing(&pipeline->formatted, PIPELINE_BLOCKS);
+	for (int w = 0; (w < workers) && !failed; w++)
+		failed = !InitRing(&pipeline->work[w], PIPELINE_RING);
+
+	if (!failed)
+	{
+		for (int b = 0; b < PIPELINE_BLOCKS; b++)
+			PushRing(&pipeline->free, &pipeline->memory[b], 0, NULL);
+		threaded = StartThread(&writer, runWriter, pipeline);
+		if (threaded && !StartThread(&formatter, runFormatter, pipeline))
+		{
+			PushRing(&pipeline->formatted, NULL, 0, NULL);
+			JoinThread(writer);
+			threaded = 0;
+		}
+	}
+	if (!failed && threaded)
+	{
+		for (int w = 0; w < workers; w++)
+		{
+			starts[pipeline->workers].pipeline = pipeline;
+			starts[pipeline->workers].index = pipeline->workers;
+			if (StartThread(&pricers[pipeline->workers], runPricer,
+				&starts[pipeline->workers]))
+				pipeline->workers++;
+		}
+		runParser(pipeline);
+		for (int w = 0; w < pipeline->workers; w++)
+			JoinThread(pricers[w]);
+		JoinThread(formatter);
+		JoinThread(writer);
+	}
+	else if (!failed)
+	{
+		PipelineBlock* block = &pipeline->memory[0];
+
+		while (parseBlock(pipeline, block))
+		{
+			priceBlock(block, &pipeline->priceStage[0]);
+			formatBlock(pipeline, block);
+			writeBlock(pipeline, block);
+		}
+	}
+
+	if (!failed && !pipeline->writeFailed && (fflush(out) == 0))
+		count = pipeline->records;
+	if (stats != NULL)
+	{
+		collectStats(pipeline, stats);
+		stats->seconds = GetWallSeconds() - start;
+	}
+	FreeRing(&pipeline->free);
+	FreeRing(&pipeline->priced);
+	FreeRing(&pipeline->formatted);
+	for (int w = 0; w < workers; w++)
+		FreeRing(&pipeline->work[w]);
+	AlignedFree(pipeline->memory);
+	AlignedFree(pipeline);
+	return count;
+}
+//----------------------------------------------------------------------------
+// Function:	    void WritePipelineStats(FILE* fp,
+//						const PipelineStats* stats)
+//
+// Description:		Writes one line per stage: the time its threads spent
+//					working, that time per thread, and how often they
+//					waited for input or for room in the next stage. The
+//					stage with the most time per thread sets the pace.
+//
+// Parameters:	    (FILE*)                  fp      Output stream
+//				    const (PipelineStats*)   stats   From RunPipeline()
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       RunPipelineMode(), main() of bench_pipeline
+// Calls:		    fprintf()
+// History Log:     10/17/2026  added for the batch pipeline
+//----------------------------------------------------------------------------
+void WritePipelineStats(FILE* fp, const PipelineStats* stats)
+{
+	const char* names[PIPELINE_STAGES] = { "parse", "price", "format",
+		"write" };
+
+	fprintf(fp, "%lld records in %lld blocks, %d pricers, %.3lf s\n",
+		stats->records, stats->blocks, stats->workers, stats->seconds);
+	fprintf(fp, "%-8s %8s %8s %8s %12s %12s\n", "Stage", "Threads",
+		"Busy ms", "ms each", "Input waits", "Output waits");
+	for (int s = 0; s < PIPELINE_STAGES; s++)
+	{
+		int threads = ((s == STAGE_PRICE) && (stats->workers > 0)) ?
+			stats->workers : 1;
+
+		fprintf(fp, "%-8s %8d %8.1lf %8.1lf %12lld %12lld\n", names[s],
+			threads, stats->busySeconds[s] * 1e3,
+			stats->busySeconds[s] * 1e3 / threads, stats->emptyWaits[s],
+			stats->fullWaits[s]);
+	}
+}
@@ -0,0 +1,63 @@
+//----------------------------------------------------------------------------
+// File:			amort_pipeline.h
+//
+// Description:     Header file for the staged batch pipeline
+//					(amort_pipeline.c). Prices the same loan records as
+//					RunBatch() (see amort_batch.h), but parsing, pricing,
+//					formatting and writing run at the same time on threads
+//					of their own, joined by the lock-free rings of
+//					amort_ring.h. Records travel in blocks of
+//					PIPELINE_BLOCK; only PIPELINE_BLOCKS blocks exist, so a
+//					stage that falls behind holds up the stages before it
+//					instead of letting work pile up, and the run goes as
+//					fast as its slowest stage.
+//
+//					Results are written in input order, as the rows of
+//					FormatLoanRecord() or, with PIPELINE_BINARY, as
+//					PipelineResult structs in the byte order of the host.
+//
+// History Log:    10/17/2026  added for the batch pipeline
+//----------------------------------------------------------------------------
+
+#ifndef AMORT_PIPELINE_H
+#define AMORT_PIPELINE_H
+#include <stdio.h>
+
+#define PIPELINE_TEXT 0             // FormatLoanRecord() rows
+#define PIPELINE_BINARY 1           // PipelineResult structs
+#define PIPELINE_BLOCK 128          // Records per block
+#define PIPELINE_BLOCKS 32          // Blocks in flight, power of 2
+#define PIPELINE_RING 8             // Blocks waiting for one pricer
+#define PIPELINE_MAX_WORKERS 64
+
+#define STAGE_PARSE 0
+#define STAGE_PRICE 1
+#define STAGE_FORMAT 2
+#define STAGE_WRITE 3
+#define PIPELINE_STAGES 4
+
+typedef struct
+{
+	double loanSize;
+	double paymentSize;
+	double interestRate;
+	int months;
+	int status;                     // BATCH_OK, BATCH_BAD_RECORD, ...
+} PipelineResult;
+
+typedef struct
+{
+	long long records;              // Records written
+	long long blocks;
+	int workers;                    // Pricing threads, 0 if run on one thread
+	double seconds;                 // Whole run
+	double busySeconds[PIPELINE_STAGES];    // Summed over a stage's threads
+	long long fullWaits[PIPELINE_STAGES];   // Yields with the next stage full
+	long long emptyWaits[PIPELINE_STAGES];  // Yields with no input
+} PipelineStats;
+
+long long RunPipeline(FILE* in, FILE* out, int workers, const int format,
+	PipelineStats* stats);
+void WritePipelineStats(FILE* fp, const PipelineStats* stats);
+
+#endif
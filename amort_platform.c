@@ -0,0 +1,1001 @@
+//----------------------------------------------------------------------------
+// File:			amort_platform.c
+//
+// Description      Platform layer for the Amort library. Wraps the thread,
+//					lock, CPU count and timer calls that differ between
+//					Windows and POSIX systems. It knows nothing of the
+//					library above it: a module that keeps state per thread
+//					registers a hook with SetThreadExitHook() instead.
+//
+// Functions:	    int StartThread(AmortThread* thread, AmortThreadFunc func,
+//						void* arg)
+//					void SetThreadExitHook(AmortExitHook hook)
+//					void JoinThread(AmortThread thread)
+//					int GetCpuCount(void)
+//					double GetWallSeconds(void)
+//					void* AlignedAlloc(size_t size, size_t alignment)
+//					void AlignedFree(void* block)
+//					int OpenDirectFile(const char* filename)
+//					int WriteDirectFile(int file, const void* data,
+//						size_t size)
+//					int CloseDirectFile(int file)
+//					void AcquireLock(AmortLock* lock)
+//					void ReleaseLock(AmortLock* lock)
+//					void* LoadShared(void* volatile* slot)
+//					void StoreShared(void* volatile* slot, void* value)
+//					size_t LoadCounter(volatile size_t* counter)
+//					void StoreCounter(volatile size_t* counter,
+//						size_t value)
+//					int SwapCounter(volatile size_t* counter,
+//						size_t expected, size_t value)
+//					size_t AddCounter(volatile size_t* counter,
+//						size_t amount)
+//					void YieldThread(void)
+//					int MapFile(AmortMapping* mapping, const char* filename)
+//					void UnmapFile(AmortMapping* mapping)
+//					void WaitCondition(AmortCondition* condition,
+//						AmortLock* lock)
+//					void WakeCondition(AmortCondition* condition)
+//					AmortSocket ListenLocal(const char* endpoint)
+//					AmortSocket AcceptLocal(AmortSocket listener)
+//					AmortSocket ConnectLocal(const char* endpoint)
+//					long ReadSocket(AmortSocket socket, void* buffer,
+//						size_t size)
+//					int WriteSocket(AmortSocket socket, const void* data,
+//						size_t size)
+//					void ShutdownSocket(AmortSocket socket)
+//					void CloseSocket(AmortSocket socket)
+//----------------------------------------------------------------------------
+
+#include <stdlib.h>
+#include <string.h>
+#include "amort_platform.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <malloc.h>
+#include <io.h>
+#include <ws2tcpip.h>
+#else
+#include <errno.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#endif
+
+#define DIRECT_CHUNK (1 << 30)      // Largest single write() request
+#define LISTEN_BACKLOG 128
+
+typedef struct
+{
+	AmortThreadFunc func;
+	void* arg;
+} ThreadStart;
+
+static AmortLock exitHookLock = AMORT_LOCK_INIT;
+static AmortExitHook exitHook = NULL;   // Run by each StartThread() thread
+
+// Fills a 127.0.0.1 address for a "tcp:PORT" endpoint. Returns 0 if the
+// endpoint is not one.
+static int tcpAddress(const char* endpoint, struct sockaddr_in* address)
+{
+	const size_t prefix = strlen(AMORT_TCP_PREFIX);
+	char* end = NULL;
+	long port = 0;
+
+	if (strncmp(endpoint, AMORT_TCP_PREFIX, prefix) != 0)
+		return 0;
+	port = strtol(endpoint + prefix, &end, 10);
+	if ((*end != '\0') || (port < 1) || (port > 65535))
+		return 0;
+	memset(address, 0, sizeof(struct sockaddr_in));
+	address->sin_family = AF_INET;
+	address->sin_port = htons((unsigned short)port);
+	address->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	return 1;
+}
+
+// Opens a stream socket for endpoint and fills its address. Returns
+// AMORT_NO_SOCKET if the endpoint cannot be used on this system.
+static AmortSocket openSocket(const char* endpoint,
+	struct sockaddr_storage* address, int* length)
+{
+	AmortSocket socketFd = AMORT_NO_SOCKET;
+#ifdef _WIN32
+	static LONG started = 0;
+	WSADATA data;
+
+	if (InterlockedCompareExchange(&started, 1, 0) == 0)
+		WSAStartup(MAKEWORD(2, 2), &data);
+#endif
+	memset(address, 0, sizeof(struct sockaddr_storage));
+	if (tcpAddress(endpoint, (struct sockaddr_in*)address))
+	{
+		*length = (int)sizeof(struct sockaddr_in);
+		socketFd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	}
+#ifndef _WIN32
+	else
+	{
+		struct sockaddr_un* local = (struct sockaddr_un*)address;
+
+		if (strlen(endpoint) >= sizeof(local->sun_path))
+			return AMORT_NO_SOCKET;
+		local->sun_family = AF_UNIX;
+		strcpy(local->sun_path, endpoint);
+		*length = (int)sizeof(struct sockaddr_un);
+		socketFd = socket(AF_UNIX, SOCK_STREAM, 0);
+	}
+#endif
+	return socketFd;
+}
+
+// Turns off Nagle's delay on TCP sockets; requests are small and answered
+// one round trip at a time.
+static void setNoDelay(AmortSocket socketFd)
+{
+	int on = 1;
+
+	setsockopt(socketFd, IPPROTO_TCP, TCP_NODELAY, (const char*)&on,
+		sizeof(on));
+}
+
+#ifdef _WIN32
+static DWORD WINAPI threadTrampoline(LPVOID param)
+#else
+static void* threadTrampoline(void* param)
+#endif
+{
+	ThreadStart start = *(ThreadStart*)param;
+	AmortExitHook hook = NULL;
+
+	free(param);
+	start.func(start.arg);
+	AcquireLock(&exitHookLock);
+	hook = exitHook;
+	ReleaseLock(&exitHookLock);
+	if (hook != NULL)
+		hook();
+	return 0;
+}
+//----------------------------------------------------------------------------
+// Function:	    int StartThread(AmortThread* thread, AmortThreadFunc func,
+//									void* arg)
+//
+// Description:		Starts a new thread running func(arg). When func
+//					returns, the hook set by SetThreadExitHook(), if any,
+//					runs on the thread before it ends.
+//
+// Parameters:	    (AmortThread*)   thread   Receives the thread handle
+//				    (AmortThreadFunc) func    Function the thread runs
+//				    (void*)          arg      Argument passed to func
+//
+// Returns:		    (int) 1 when the thread was started, 0 on failure
+// Date:            10/17/2026
+// Called By:       RunBatch()
+// Calls:		    the thread exit hook as the thread ends
+// History Log:     10/17/2026  added for batch pricing mode
+//				    10/17/2026  threads retire their metrics
+//				    10/17/2026  threads run the exit hook instead
+//----------------------------------------------------------------------------
+int StartThread(AmortThread* thread, AmortThreadFunc func, void* arg)
+{
+	ThreadStart* start = (ThreadStart*)malloc(sizeof(ThreadStart));
+
+	if (start == NULL)
+		return 0;
+	start->func = func;
+	start->arg = arg;
+#ifdef _WIN32
+	*thread = CreateThread(NULL, 0, threadTrampoline, start, 0, NULL);
+	if (*thread == NULL)
+#else
+	if (pthread_create(thread, NULL, threadTrampoline, start) != 0)
+#endif
+	{
+		free(start);
+		return 0;
+	}
+	return 1;
+}
+//----------------------------------------------------------------------------
+// Function:	    void SetThreadExitHook(AmortExitHook hook)
+//
+// Description:		Sets the function every thread started by StartThread()
+//					calls as it ends, after its own function returns. There
+//					is one hook; setting it again replaces it, NULL clears
+//					it.
+//
+// Parameters:	    (AmortExitHook) hook   Function to run, or NULL
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       threadValues() of amort_metrics
+// History Log:     10/17/2026  added so the metrics need not be called
+//								from the platform layer
+//----------------------------------------------------------------------------
+void SetThreadExitHook(AmortExitHook hook)
+{
+	AcquireLock(&exitHookLock);
+	exitHook = hook;
+	ReleaseLock(&exitHookLock);
+}
+//----------------------------------------------------------------------------
+// Function:	    void JoinThread(AmortThread thread)
+//
+// Description:		Waits for a thread started by StartThread() to finish and
+//					releases its handle.
+//
+// Parameters:	    (AmortThread) thread   Handle returned by StartThread()
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       RunBatch()
+// History Log:     10/17/2026  added for batch pricing mode
+//----------------------------------------------------------------------------
+void JoinThread(AmortThread thread)
+{
+#ifdef _WIN32
+	WaitForSingleObject(thread, INFINITE);
+	CloseHandle(thread);
+#else
+	pthread_join(thread, NULL);
+#endif
+}
+//----------------------------------------------------------------------------
+// Function:	    int GetCpuCount(void)
+//
+// Description:		Returns the number of online logical processors (at
+//					least 1).
+//
+// Parameters:	    none
+//
+// Returns:		    (int) cpus   Number of logical processors
+// Date:            10/17/2026
+// Called By:       RunBatch()
+// History Log:     10/17/2026  added for batch pricing mode
+//----------------------------------------------------------------------------
+int GetCpuCount(void)
+{
+	long cpus = 1;
+#ifdef _WIN32
+	SYSTEM_INFO info;
+
+	GetSystemInfo(&info);
+	cpus = (long)info.dwNumberOfProcessors;
+#else
+	cpus = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+	return (cpus < 1) ? 1 : (int)cpus;
+}
+//----------------------------------------------------------------------------
+// Function:	    double GetWallSeconds(void)
+//
+// Description:		Returns a monotonic wall clock reading in seconds. Only
+//					the difference between two readings is meaningful.
+//
+// Parameters:	    none
+//
+// Returns:		    (double) seconds   Current monotonic time
+// Date:            10/17/2026
+// Called By:       RunBatch()
+// History Log:     10/17/2026  added for batch pricing mode
+//----------------------------------------------------------------------------
+double GetWallSeconds(void)
+{
+#ifdef _WIN32
+	LARGE_INTEGER counter;
+	LARGE_INTEGER frequency;
+
+	QueryPerformanceCounter(&counter);
+	QueryPerformanceFrequency(&frequency);
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+#endif
+}
+//----------------------------------------------------------------------------
+// Function:	    void* AlignedAlloc(size_t size, size_t alignment)
+//
+// Description:		Allocates a block whose address is a multiple of 
+//					alignment (a power of two), so SIMD loads never split a
+//					cache line. Release it with AlignedFree().
+//
+// Parameters:	    (size_t) size        Bytes to allocate
+//				    (size_t) alignment   Required alignment in bytes
+//
+// Returns:		    (void*) block   The block, or NULL when out of memory
+// Date:            10/17/2026
+// Called By:       AllocLoanColumns()
+// History Log:     10/17/2026  added for the SIMD amortization kernel
+//----------------------------------------------------------------------------
+void* AlignedAlloc(size_t size, size_t alignment)
+{
+	void* block = NULL;
+
+	if (size == 0)
+		size = alignment;
+#ifdef _WIN32
+	block = _aligned_malloc(size, alignment);
+#else
+	if (posix_memalign(&block, alignment, size) != 0)
+		block = NULL;
+#endif
+	return block;
+}
+//----------------------------------------------------------------------------
+// Function:	    void AlignedFree(void* block)
+//
+// Description:		Releases a block returned by AlignedAlloc().
+//
+// Parameters:	    (void*) block   Block to release (may be NULL)
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       FreeLoanColumns()
+// History Log:     10/17/2026  added for the SIMD amortization kernel
+//----------------------------------------------------------------------------
+void AlignedFree(void* block)
+{
+#ifdef _WIN32
+	_aligned_free(block);
+#else
+	free(block);
+#endif
+}
+//----------------------------------------------------------------------------
+// Function:	    int OpenDirectFile(const char* filename)
+//
+// Description:		Creates (or truncates) a file for unbuffered output with
+//					WriteDirectFile(). No stdio buffer or lock sits between
+//					the caller's buffer and the OS. On Windows the file is
+//					opened in text mode, so '\n' is written as CR LF just as
+//					fopen(filename, "w") would.
+//
+// Parameters:	    const (char*) filename   Name of the file
+//
+// Returns:		    (int) file   File descriptor, or -1 on failure
+// Date:            10/17/2026
+// Called By:       OpenScheduleWriter()
+// History Log:     10/17/2026  added for the buffered schedule writer
+//----------------------------------------------------------------------------
+int OpenDirectFile(const char* filename)
+{
+#ifdef _WIN32
+	return _open(filename, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_TEXT,
+		_S_IREAD | _S_IWRITE);
+#else
+	return open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+#endif
+}
+//----------------------------------------------------------------------------
+// Function:	    int WriteDirectFile(int file, const void* data, 
+//										size_t size)
+//
+// Description:		Writes all size bytes of data, retrying short writes.
+//
+// Parameters:	    (int)          file   Descriptor from OpenDirectFile()
+//				    const (void*)  data   Bytes to write
+//				    (size_t)       size   Number of bytes
+//
+// Returns:		    (int) 1 when everything was written, 0 on error
+// Date:            10/17/2026
+// Called By:       FlushScheduleWriter()
+// History Log:     10/17/2026  added for the buffered schedule writer
+//----------------------------------------------------------------------------
+int WriteDirectFile(int file, const void* data, size_t size)
+{
+	const char* next = (const char*)data;
+
+	while (size > 0)
+	{
+		size_t chunk = (size > DIRECT_CHUNK) ? DIRECT_CHUNK : size;
+#ifdef _WIN32
+		int written = _write(file, next, (unsigned int)chunk);
+
+		if (written <= 0)
+			return 0;
+#else
+		ssize_t written = write(file, next, chunk);
+
+		if ((written < 0) && (errno == EINTR))
+			continue;
+		if (written <= 0)
+			return 0;
+#endif
+		next += written;
+		size -= (size_t)written;
+	}
+	return 1;
+}
+//----------------------------------------------------------------------------
+// Function:	    int CloseDirectFile(int file)
+//
+// Description:		Closes a file opened by OpenDirectFile().
+//
+// Parameters:	    (int) file   Descriptor from OpenDirectFile()
+//
+// Returns:		    (int) 1 on success, 0 on error
+// Date:            10/17/2026
+// Called By:       CloseScheduleWriter()
+// History Log:     10/17/2026  added for the buffered schedule writer
+//----------------------------------------------------------------------------
+int CloseDirectFile(int file)
+{
+#ifdef _WIN32
+	return _close(file) == 0;
+#else
+	return close(file) == 0;
+#endif
+}
+//----------------------------------------------------------------------------
+// Function:	    void AcquireLock(AmortLock* lock)
+//
+// Description:		Waits for and takes a lock set up with AMORT_LOCK_INIT.
+//
+// Parameters:	    (AmortLock*) lock   Lock to take
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       GetAnnuityFactors()
+// History Log:     10/17/2026  added for the annuity factor tables
+//----------------------------------------------------------------------------
+void AcquireLock(AmortLock* lock)
+{
+#ifdef _WIN32
+	AcquireSRWLockExclusive(lock);
+#else
+	pthread_mutex_lock(lock);
+#endif
+}
+//----------------------------------------------------------------------------
+// Function:	    void ReleaseLock(AmortLock* lock)
+//
+// Description:		Releases a lock taken with AcquireLock().
+//
+// Parameters:	    (AmortLock*) lock   Lock to release
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       GetAnnuityFactors()
+// History Log:     10/17/2026  added for the annuity factor tables
+//----------------------------------------------------------------------------
+void ReleaseLock(AmortLock* lock)
+{
+#ifdef _WIN32
+	ReleaseSRWLockExclusive(lock);
+#else
+	pthread_mutex_unlock(lock);
+#endif
+}
+//----------------------------------------------------------------------------
+// Function:	    void* LoadShared(void* volatile* slot)
+//
+// Description:		Reads a pointer another thread may publish with
+//					StoreShared(). Once the pointer is seen, everything the
+//					other thread wrote before publishing it is seen too.
+//
+// Parameters:	    (void* volatile*) slot   Pointer to read
+//
+// Returns:		    (void*) value   The pointer
+// Date:            10/17/2026
+// Called By:       GetAnnuityFactors()
+// History Log:     10/17/2026  added for the annuity factor tables
+//----------------------------------------------------------------------------
+void* LoadShared(void* volatile* slot)
+{
+#ifdef _WIN32
+	return InterlockedCompareExchangePointer(slot, NULL, NULL);
+#else
+	return __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+#endif
+}
+//----------------------------------------------------------------------------
+// Function:	    void StoreShared(void* volatile* slot, void* value)
+//
+// Description:		Publishes a pointer for LoadShared(), after everything
+//					written to the memory it points to.
+//
+// Parameters:	    (void* volatile*) slot    Pointer to set
+//				    (void*)           value   Value to publish
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       GetAnnuityFactors()
+// History Log:     10/17/2026  added for the annuity factor tables
+//----------------------------------------------------------------------------
+void StoreShared(void* volatile* slot, void* value)
+{
+#ifdef _WIN32
+	InterlockedExchangePointer(slot, value);
+#else
+	__atomic_store_n(slot, value, __ATOMIC_RELEASE);
+#endif
+}
+//----------------------------------------------------------------------------
+// Function:	    size_t LoadCounter(volatile size_t* counter)
+//
+// Description:		Reads a counter another thread may set with
+//					StoreCounter() or SwapCounter(). Once the value is
+//					seen, everything the other thread wrote before setting
+//					it is seen too. size_t is pointer sized on Windows, so
+//					the pointer calls serve there.
+//
+// Parameters:	    (volatile size_t*) counter   Counter to read
+//
+// Returns:		    (size_t) value   The counter
+// Date:            10/17/2026
+// Called By:       TryPushRing(), TryPushRingShared(), TryPopRing(),
+//					GetSimdLevel()
+// History Log:     10/17/2026  added for the pipeline rings
+//----------------------------------------------------------------------------
+size_t LoadCounter(volatile size_t* counter)
+{
+#ifdef _WIN32
+	return (size_t)InterlockedCompareExchangePointer(
+		(void* volatile*)counter, NULL, NULL);
+#else
+	return __atomic_load_n(counter, __ATOMIC_ACQUIRE);
+#endif
+}
+//----------------------------------------------------------------------------
+// Function:	    void StoreCounter(volatile size_t* counter, size_t value)
+//
+// Description:		Sets a counter for LoadCounter(), after everything
+//					written before it.
+//
+// Parameters:	    (volatile size_t*) counter   Counter to set
+//				    (size_t)           value     Value to publish
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       TryPushRing(), TryPushRingShared(), TryPopRing(),
+//					GetSimdLevel(), SetSimdLevel()
+// History Log:     10/17/2026  added for the pipeline rings
+//----------------------------------------------------------------------------
+void StoreCounter(volatile size_t* counter, size_t value)
+{
+#ifdef _WIN32
+	InterlockedExchangePointer((void* volatile*)counter, (void*)value);
+#else
+	__atomic_store_n(counter, value, __ATOMIC_RELEASE);
+#endif
+}
+//----------------------------------------------------------------------------
+// Function:	    int SwapCounter(volatile size_t* counter, size_t expected,
+//						size_t value)
+//
+// Description:		Sets a counter to value if it still holds expected, as
+//					one step no other thread can come between.
+//
+// Parameters:	    (volatile size_t*) counter    Counter to set
+//				    (size_t)           expected   Value it must hold
+//				    (size_t)           value      New value
+//
+// Returns:		    (int) 1 if the counter was set, 0 if it had changed
+// Date:            10/17/2026
+// Called By:       TryPushRingShared()
+// History Log:     10/17/2026  added for the pipeline rings
+//----------------------------------------------------------------------------
+int SwapCounter(volatile size_t* counter, size_t expected, size_t value)
+{
+#ifdef _WIN32
+	return InterlockedCompareExchangePointer((void* volatile*)counter,
+		(void*)value, (void*)expected) == (void*)expected;
+#else
+	return __atomic_compare_exchange_n(counter, &expected, value, 0,
+		__ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#endif
+}
+//----------------------------------------------------------------------------
+// Function:	    size_t AddCounter(volatile size_t* counter, size_t amount)
+//
+// Description:		Adds amount to a counter other threads may add to at the
+//					same time; no addition is lost.
+//
+// Parameters:	    (volatile size_t*) counter   Counter to add to
+//				    (size_t)           amount    Amount to add
+//
+// Returns:		    (size_t) value   The counter after the addition
+// Date:            10/17/2026
+// Called By:       FillScheduleRows()
+// Calls:		    LoadCounter(), SwapCounter()
+// History Log:     10/17/2026  added for the cross-check count
+//----------------------------------------------------------------------------
+size_t AddCounter(volatile size_t* counter, size_t amount)
+{
+#ifdef _WIN32
+	size_t value = LoadCounter(counter);
+
+	while (!SwapCounter(counter, value, value + amount))
+		value = LoadCounter(counter);
+	return value + amount;
+#else
+	return __atomic_add_fetch(counter, amount, __ATOMIC_ACQ_REL);
+#endif
+}
+//----------------------------------------------------------------------------
+// Function:	    void YieldThread(void)
+//
+// Description:		Gives the rest of the thread's time slice to any other
+//					thread that is ready to run.
+//
+// Parameters:	    none
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       PushRing(), PopRing()
+// History Log:     10/17/2026  added for the pipeline rings
+//----------------------------------------------------------------------------
+void YieldThread(void)
+{
+#ifdef _WIN32
+	SwitchToThread();
+#else
+	sched_yield();
+#endif
+}
+//----------------------------------------------------------------------------
+// Function:	    int MapFile(AmortMapping* mapping, const char* filename)
+//
+// Description:		Maps a whole file read only into memory, so its bytes
+//					can be read in place without copying them. The view
+//					starts on a page boundary.
+//
+// Parameters:	    (AmortMapping*) mapping    Receives the view and size
+//				    const (char*)   filename   Name of the file
+//
+// Returns:		    (int) 1 on success, 0 if the file cannot be opened, is
+//					empty or cannot be mapped
+// Date:            10/17/2026
+// Called By:       OpenColumnFile()
+// History Log:     10/17/2026  added for the columnar schedule files
+//----------------------------------------------------------------------------
+int MapFile(AmortMapping* mapping, const char* filename)
+{
+#ifdef _WIN32
+	LARGE_INTEGER size;
+
+	memset(mapping, 0, sizeof(AmortMapping));
+	mapping->file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (mapping->file == INVALID_HANDLE_VALUE)
+		return 0;
+	if (GetFileSizeEx(mapping->file, &size) && (size.QuadPart > 0) &&
+		((unsigned long long)size.QuadPart <= (size_t)-1))
+	{
+		mapping->map = CreateFileMappingA(mapping->file, NULL, PAGE_READONLY,
+			0, 0, NULL);
+		if (mapping->map != NULL)
+			mapping->view = MapViewOfFile(mapping->map, FILE_MAP_READ, 0, 0,
+				0);
+		mapping->size = (size_t)size.QuadPart;
+	}
+	if (mapping->view == NULL)
+	{
+		UnmapFile(mapping);
+		return 0;
+	}
+	return 1;
+#else
+	struct stat info;
+	int file = open(filename, O_RDONLY);
+
+	memset(mapping, 0, sizeof(AmortMapping));
+	if (file < 0)
+		return 0;
+	if ((fstat(file, &info) == 0) && (info.st_size > 0) &&
+		((unsigned long long)info.st_size <= (size_t)-1))
+	{
+		mapping->view = mmap(NULL, (size_t)info.st_size, PROT_READ,
+			MAP_SHARED, file, 0);
+		if (mapping->view == MAP_FAILED)
+			mapping->view = NULL;
+		else
+			mapping->size = (size_t)info.st_size;
+	}
+	close(file);                        // The mapping keeps the file open
+	return mapping->view != NULL;
+#endif
+}
+//----------------------------------------------------------------------------
+// Function:	    void UnmapFile(AmortMapping* mapping)
+//
+// Description:		Releases a view made by MapFile(). Safe to call on a
+//					mapping that failed.
+//
+// Parameters:	    (AmortMapping*) mapping   Mapping to release
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       CloseColumnFile()
+// History Log:     10/17/2026  added for the columnar schedule files
+//----------------------------------------------------------------------------
+void UnmapFile(AmortMapping* mapping)
+{
+#ifdef _WIN32
+	if (mapping->view != NULL)
+		UnmapViewOfFile(mapping->view);
+	if (mapping->map != NULL)
+		CloseHandle(mapping->map);
+	if ((mapping->file != NULL) && (mapping->file != INVALID_HANDLE_VALUE))
+		CloseHandle(mapping->file);
+#else
+	if (mapping->view != NULL)
+		munmap(mapping->view, mapping->size);
+#endif
+	memset(mapping, 0, sizeof(AmortMapping));
+}
+//----------------------------------------------------------------------------
+// Function:	    void WaitCondition(AmortCondition* condition,
+//						AmortLock* lock)
+//
+// Description:		Releases lock, sleeps until the condition is woken and
+//					takes the lock again. As with any condition variable
+//					the caller checks its own state again on return.
+//
+// Parameters:	    (AmortCondition*) condition   Set up with
+//												  AMORT_CONDITION_INIT
+//				    (AmortLock*)      lock        Lock the caller holds
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       the calculation server
+// History Log:     10/17/2026  added for the calculation server
+//----------------------------------------------------------------------------
+void WaitCondition(AmortCondition* condition, AmortLock* lock)
+{
+#ifdef _WIN32
+	SleepConditionVariableSRW(condition, lock, INFINITE, 0);
+#else
+	pthread_cond_wait(condition, lock);
+#endif
+}
+//----------------------------------------------------------------------------
+// Function:	    void WakeCondition(AmortCondition* condition)
+//
+// Description:		Wakes every thread waiting on the condition.
+//
+// Parameters:	    (AmortCondition*) condition   Condition to wake
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       the calculation server
+// History Log:     10/17/2026  added for the calculation server
+//----------------------------------------------------------------------------
+void WakeCondition(AmortCondition* condition)
+{
+#ifdef _WIN32
+	WakeAllConditionVariable(condition);
+#else
+	pthread_cond_broadcast(condition);
+#endif
+}
+//----------------------------------------------------------------------------
+// Function:	    AmortSocket ListenLocal(const char* endpoint)
+//
+// Description:		Listens on a local endpoint: "tcp:PORT" for a TCP port
+//					on 127.0.0.1 only, anything else for the path of a Unix
+//					domain socket (not on Windows). A stale socket left at
+//					the path is removed first; any other file there is
+//					left alone and the endpoint refused.
+//
+// Parameters:	    const (char*) endpoint   "tcp:PORT" or a socket path
+//
+// Returns:		    (AmortSocket) listener, or AMORT_NO_SOCKET on failure
+// Date:            10/17/2026
+// Called By:       StartServer()
+// History Log:     10/17/2026  added for the calculation server
+//				    10/17/2026  only a socket is removed from the path
+//----------------------------------------------------------------------------
+AmortSocket ListenLocal(const char* endpoint)
+{
+	struct sockaddr_storage address;
+	int length = 0;
+	int on = 1;
+	AmortSocket listener = openSocket(endpoint, &address, &length);
+#ifndef _WIN32
+	struct stat status;
+#endif
+
+	if (listener == AMORT_NO_SOCKET)
+		return AMORT_NO_SOCKET;
+	if (address.ss_family == AF_INET)
+		setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, (const char*)&on,
+			sizeof(on));
+#ifndef _WIN32
+	else if (lstat(endpoint, &status) == 0)
+	{
+		if (!S_ISSOCK(status.st_mode) || (unlink(endpoint) != 0))
+		{
+			CloseSocket(listener);
+			return AMORT_NO_SOCKET;
+		}
+	}
+#endif
+	if ((bind(listener, (struct sockaddr*)&address, length) != 0) ||
+		(listen(listener, LISTEN_BACKLOG) != 0))
+	{
+		CloseSocket(listener);
+		return AMORT_NO_SOCKET;
+	}
+	return listener;
+}
+//----------------------------------------------------------------------------
+// Function:	    AmortSocket AcceptLocal(AmortSocket listener)
+//
+// Description:		Waits for and accepts the next connection.
+//
+// Parameters:	    (AmortSocket) listener   From ListenLocal()
+//
+// Returns:		    (AmortSocket) connection, or AMORT_NO_SOCKET once the
+//					listener is shut down or fails
+// Date:            10/17/2026
+// Called By:       the calculation server
+// History Log:     10/17/2026  added for the calculation server
+//----------------------------------------------------------------------------
+AmortSocket AcceptLocal(AmortSocket listener)
+{
+	AmortSocket connection = AMORT_NO_SOCKET;
+
+	do
+		connection = accept(listener, NULL, NULL);
+#ifdef _WIN32
+	while (0);
+#else
+	while ((connection < 0) && (errno == EINTR));
+#endif
+	if (connection != AMORT_NO_SOCKET)
+		setNoDelay(connection);
+	return connection;
+}
+//----------------------------------------------------------------------------
+// Function:	    AmortSocket ConnectLocal(const char* endpoint)
+//
+// Description:		Connects to a local endpoint, see ListenLocal().
+//
+// Parameters:	    const (char*) endpoint   "tcp:PORT" or a socket path
+//
+// Returns:		    (AmortSocket) connection, or AMORT_NO_SOCKET on failure
+// Date:            10/17/2026
+// Called By:       StopServer(), main() of serverload
+// History Log:     10/17/2026  added for the calculation server
+//----------------------------------------------------------------------------
+AmortSocket ConnectLocal(const char* endpoint)
+{
+	struct sockaddr_storage address;
+	int length = 0;
+	AmortSocket connection = openSocket(endpoint, &address, &length);
+
+	if (connection == AMORT_NO_SOCKET)
+		return AMORT_NO_SOCKET;
+	if (connect(connection, (struct sockaddr*)&address, length) != 0)
+	{
+		CloseSocket(connection);
+		return AMORT_NO_SOCKET;
+	}
+	if (address.ss_family == AF_INET)
+		setNoDelay(connection);
+	return connection;
+}
+//----------------------------------------------------------------------------
+// Function:	    long ReadSocket(AmortSocket socket, void* buffer,
+//						size_t size)
+//
+// Description:		Reads what has arrived, up to size bytes, waiting for
+//					at least one.
+//
+// Parameters:	    (AmortSocket) socket   Connected socket
+//				    (void*)       buffer   Receives the bytes
+//				    (size_t)      size     Room in buffer
+//
+// Returns:		    (long) bytes read, 0 once the other end has closed, -1
+//					on error
+// Date:            10/17/2026
+// Called By:       the calculation server, main() of serverload
+// History Log:     10/17/2026  added for the calculation server
+//----------------------------------------------------------------------------
+long ReadSocket(AmortSocket socket, void* buffer, size_t size)
+{
+	long got = 0;
+
+	if (size > DIRECT_CHUNK)
+		size = DIRECT_CHUNK;
+	do
+		got = (long)recv(socket, (char*)buffer, (int)size, 0);
+#ifdef _WIN32
+	while (0);
+#else
+	while ((got < 0) && (errno == EINTR));
+#endif
+	return (got < 0) ? -1 : got;
+}
+//----------------------------------------------------------------------------
+// Function:	    int WriteSocket(AmortSocket socket, const void* data,
+//						size_t size)
+//
+// Description:		Sends all size bytes of data, retrying short sends. A
+//					peer that has gone away is an error, not a signal.
+//
+// Parameters:	    (AmortSocket)  socket   Connected socket
+//				    const (void*)  data     Bytes to send
+//				    (size_t)       size     Number of bytes
+//
+// Returns:		    (int) 1 when everything was sent, 0 on error
+// Date:            10/17/2026
+// Called By:       the calculation server, main() of serverload
+// History Log:     10/17/2026  added for the calculation server
+//----------------------------------------------------------------------------
+int WriteSocket(AmortSocket socket, const void* data, size_t size)
+{
+	const char* next = (const char*)data;
+
+	while (size > 0)
+	{
+		size_t chunk = (size > DIRECT_CHUNK) ? DIRECT_CHUNK : size;
+#ifdef _WIN32
+		int sent = send(socket, next, (int)chunk, 0);
+#else
+		long sent = (long)send(socket, next, chunk, MSG_NOSIGNAL);
+
+		if ((sent < 0) && (errno == EINTR))
+			continue;
+#endif
+		if (sent <= 0)
+			return 0;
+		next += sent;
+		size -= (size_t)sent;
+	}
+	return 1;
+}
+//----------------------------------------------------------------------------
+// Function:	    void ShutdownSocket(AmortSocket socket)
+//
+// Description:		Shuts both directions of a socket, so a thread blocked
+//					reading it wakes up with end of input.
+//
+// Parameters:	    (AmortSocket) socket   Socket to shut
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       StopServer()
+// History Log:     10/17/2026  added for the calculation server
+//----------------------------------------------------------------------------
+void ShutdownSocket(AmortSocket socket)
+{
+#ifdef _WIN32
+	shutdown(socket, SD_BOTH);
+#else
+	shutdown(socket, SHUT_RDWR);
+#endif
+}
+//----------------------------------------------------------------------------
+// Function:	    void CloseSocket(AmortSocket socket)
+//
+// Description:		Closes a socket.
+//
+// Parameters:	    (AmortSocket) socket   Socket to close
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       the calculation server, main() of serverload
+// History Log:     10/17/2026  added for the calculation server
+//----------------------------------------------------------------------------
+void CloseSocket(AmortSocket socket)
+{
+#ifdef _WIN32
+	closesocket(socket);
+#else
+	close(socket);
+#endif
+}
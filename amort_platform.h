@@ -0,0 +1,105 @@
+//----------------------------------------------------------------------------
+// File:			amort_platform.h
+//
+// Description:     Header file for the thin platform layer (amort_platform.c)
+//					used by the Amort library: threads, locks, CPU count, a
+//					wall clock, aligned memory, unbuffered file output,
+//					read only file mapping and local sockets.
+//					Windows
+//					builds use the Win32 API and the CRT, everything else
+//					uses POSIX.
+//
+// History Log:    10/17/2026  added for batch pricing mode
+//				   10/17/2026  added direct file output for SaveTable()
+//				   10/17/2026  added locks and shared pointers for the lazily
+//							   built annuity tables
+//				   10/17/2026  added read only file mapping for the columnar
+//							   schedule files
+//				   10/17/2026  added condition variables and local sockets
+//							   for the calculation server
+//				   10/17/2026  added AMORT_THREAD_LOCAL; threads hand back
+//							   their metrics as they end
+//				   10/17/2026  added shared counters and YieldThread() for
+//							   the pipeline rings
+//				   10/17/2026  added AddCounter()
+//				   10/17/2026  threads run a registered exit hook instead
+//							   of calling into the metrics
+//----------------------------------------------------------------------------
+
+#ifndef AMORT_PLATFORM_H
+#define AMORT_PLATFORM_H
+
+#include <stddef.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <windows.h>
+typedef HANDLE AmortThread;
+typedef SRWLOCK AmortLock;
+typedef CONDITION_VARIABLE AmortCondition;
+typedef SOCKET AmortSocket;
+#define AMORT_LOCK_INIT SRWLOCK_INIT
+#define AMORT_CONDITION_INIT CONDITION_VARIABLE_INIT
+#define AMORT_NO_SOCKET INVALID_SOCKET
+#else
+#include <pthread.h>
+typedef pthread_t AmortThread;
+typedef pthread_mutex_t AmortLock;
+typedef pthread_cond_t AmortCondition;
+typedef int AmortSocket;
+#define AMORT_LOCK_INIT PTHREAD_MUTEX_INITIALIZER
+#define AMORT_CONDITION_INIT PTHREAD_COND_INITIALIZER
+#define AMORT_NO_SOCKET -1
+#endif
+#define AMORT_TCP_PREFIX "tcp:"     // "tcp:PORT" is 127.0.0.1:PORT
+#ifdef _MSC_VER
+#define AMORT_THREAD_LOCAL __declspec(thread)
+#else
+#define AMORT_THREAD_LOCAL __thread
+#endif
+
+typedef void (*AmortThreadFunc)(void* arg);
+typedef void (*AmortExitHook)(void);
+
+typedef struct
+{
+	void* view;                     // First byte of the file
+	size_t size;                    // Bytes in the file
+#ifdef _WIN32
+	HANDLE file;
+	HANDLE map;
+#endif
+} AmortMapping;
+
+int StartThread(AmortThread* thread, AmortThreadFunc func, void* arg);
+void SetThreadExitHook(AmortExitHook hook);
+void JoinThread(AmortThread thread);
+int GetCpuCount(void);
+double GetWallSeconds(void);
+void* AlignedAlloc(size_t size, size_t alignment);
+void AlignedFree(void* block);
+int OpenDirectFile(const char* filename);
+int WriteDirectFile(int file, const void* data, size_t size);
+int CloseDirectFile(int file);
+void AcquireLock(AmortLock* lock);
+void ReleaseLock(AmortLock* lock);
+void* LoadShared(void* volatile* slot);
+void StoreShared(void* volatile* slot, void* value);
+size_t LoadCounter(volatile size_t* counter);
+void StoreCounter(volatile size_t* counter, size_t value);
+int SwapCounter(volatile size_t* counter, size_t expected, size_t value);
+size_t AddCounter(volatile size_t* counter, size_t amount);
+void YieldThread(void);
+int MapFile(AmortMapping* mapping, const char* filename);
+void UnmapFile(AmortMapping* mapping);
+void WaitCondition(AmortCondition* condition, AmortLock* lock);
+void WakeCondition(AmortCondition* condition);
+AmortSocket ListenLocal(const char* endpoint);
+AmortSocket AcceptLocal(AmortSocket listener);
+AmortSocket ConnectLocal(const char* endpoint);
+long ReadSocket(AmortSocket socket, void* buffer, size_t size);
+int WriteSocket(AmortSocket socket, const void* data, size_t size);
+void ShutdownSocket(AmortSocket socket);
+void CloseSocket(AmortSocket socket);
+
+#endif
@@ -0,0 +1,274 @@
+//----------------------------------------------------------------------------
+// File:			amort_pool.c
+//
+// Description      Work-stealing task pool for the Amort library. The tasks
+//					are cut into one contiguous range per worker. A worker
+//					takes its own tasks from the back of its range, one at a
+//					time, and when the range is empty takes the front half
+//					of the first other range it finds that is not, which
+//					becomes its own range. Since no task is ever added once
+//					the pool starts, a worker that finds every range empty
+//					is done. Each range has a lock of its own; the owner
+//					and a thief only meet on it when both want the same
+//					range, and a task (a whole table or a rate search) is
+//					far longer than taking the lock. A worker whose thread
+//					cannot be started simply never runs: the others steal
+//					its range.
+//
+// Functions:	    int RunTaskPool(PoolTask* tasks, const size_t count,
+//						int threads, PoolWorkerStats* stats)
+//					void WritePoolStats(FILE* fp,
+//						const PoolWorkerStats* stats, const int workers)
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include "amort.h"
+#include "amort_arena.h"
+#include "amort_platform.h"
+#include "amort_pool.h"
+#include "amort_schedule.h"
+
+#define WORKER_ALIGNMENT 64         // Cache line: workers never share one
+
+static const AmortLock unlocked = AMORT_LOCK_INIT;
+
+typedef struct PoolWorker PoolWorker;
+
+typedef struct
+{
+	PoolTask* tasks;
+	PoolWorker** workers;
+	int count;                      // Workers
+} TaskPool;
+
+struct PoolWorker
+{
+	AmortLock lock;                 // Guards first and last
+	size_t first;                   // Tasks not yet taken: first .. last - 1
+	size_t last;
+	TaskPool* pool;
+	int id;
+	ScheduleArena arena;            // Rows of the table being built
+	PoolWorkerStats stats;
+};
+
+// Takes the last task of the worker's own range.
+static int takeTask(PoolWorker* self, size_t* index)
+{
+	int found = 0;
+
+	AcquireLock(&self->lock);
+	if (self->first < self->last)
+	{
+		*index = --self->last;
+		found = 1;
+	}
+	ReleaseLock(&self->lock);
+	return found;
+}
+
+// Moves the front half of another worker's range, rounded up, to the
+// worker's own, which is empty. Returns 0 if every other range is empty.
+static int stealTasks(PoolWorker* self)
+{
+	TaskPool* pool = self->pool;
+
+	for (int v = 1; v < pool->count; v++)
+	{
+		PoolWorker* victim = pool->workers[(self->id + v) % pool->count];
+		size_t first = 0;
+		size_t taken = 0;
+
+		AcquireLock(&victim->lock);
+		if (victim->first < victim->last)
+		{
+			first = victim->first;
+			taken = (victim->last - victim->first + 1) / 2;
+			victim->first += taken;
+		}
+		ReleaseLock(&victim->lock);
+		if (taken > 0)
+		{
+			AcquireLock(&self->lock);
+			self->first = first;
+			self->last = first + taken;
+			ReleaseLock(&self->lock);
+			self->stats.steals++;
+			self->stats.stolen += (long long)taken;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+// Runs one task, building any table in the worker's arena.
+static void runTask(PoolWorker* self, PoolTask* task)
+{
+	const PortfolioLoan* loan = &task->loan;
+	Schedule schedule;
+	double rate = 0;
+
+	switch (task->kind)
+	{
+	case POOL_SCHEDULE:
+		ResetArena(&self->arena);
+		task->solved = (char)BuildSchedule(&schedule, &self->arena,
+			loan->loanSize, loan->paymentSize, loan->interestRate,
+			loan->months);
+		task->steps = schedule.months;
+		task->totalPaid = schedule.totalPaid;
+		task->totalInterest = schedule.totalInterest;
+		self->stats.rows += schedule.months;
+		break;
+	case POOL_SOLVE_RATE:
+		rate = findInterestRate(loan->months, loan->loanSize,
+			loan->paymentSize, &task->steps);
+		task->solved = (rate != NO_RATE);
+		task->rate = rate;
+		break;
+	default:
+		task->solved = 0;
+		break;
+	}
+	self->stats.tasks++;
+}
+
+// Thread: runs the worker's own tasks, then stolen ones, until none are
+// left anywhere. Only runs of tasks are timed, not each task.
+static void runWorker(void* arg)
+{
+	PoolWorker* self = (PoolWorker*)arg;
+	size_t index = 0;
+
+	do
+	{
+		double start = GetWallSeconds();
+
+		while (takeTask(self, &index))
+			runTask(self, &self->pool->tasks[index]);
+		self->stats.busySeconds += GetWallSeconds() - start;
+	} while (stealTasks(self));
+}
+//----------------------------------------------------------------------------
+// Function:	    int RunTaskPool(PoolTask* tasks, const size_t count,
+//						int threads, PoolWorkerStats* stats)
+//
+// Description:		Runs every task on a pool of work-stealing workers and
+//					fills in its answer: a POOL_SCHEDULE task builds its
+//					loan's table with BuildSchedule() and keeps the totals,
+//					a POOL_SOLVE_RATE task searches for the rate with
+//					findInterestRate(). Worker 0 runs on this thread. The
+//					answers are the same as one thread running the tasks in
+//					order would give.
+//
+// Parameters:	    (PoolTask*)         tasks     Tasks to run
+//				    const (size_t)      count     Number of tasks
+//				    (int)               threads   Workers, 0 for one per CPU
+//				    (PoolWorkerStats*)  stats     Receives one entry per
+//												  worker, or NULL
+//
+// Returns:		    (int) workers used, or 0 if a worker's arena could not be
+//					allocated
+// Date:            10/17/2026
+// Called By:       main() of bench_pool
+// Calls:		    runWorker(), InitArena(), FreeArena(), StartThread(),
+//					JoinThread(), GetCpuCount(), GetWallSeconds(),
+//					AlignedAlloc(), AlignedFree()
+// History Log:     10/17/2026  added for the work-stealing task pool
+//----------------------------------------------------------------------------
+int RunTaskPool(PoolTask* tasks, const size_t count, int threads,
+	PoolWorkerStats* stats)
+{
+	PoolWorker* workers[POOL_MAX_THREADS];
+	AmortThread handles[POOL_MAX_THREADS];
+	int launched[POOL_MAX_THREADS] = { 0 };
+	TaskPool pool;
+	int used = 0;
+	int failed = 0;
+	double start = 0;
+
+	if (threads <= 0)
+		threads = GetCpuCount();
+	if (threads > POOL_MAX_THREADS)
+		threads = POOL_MAX_THREADS;
+	if ((size_t)threads > count)
+		threads = (count > 0) ? (int)count : 1;
+
+	pool.tasks = tasks;
+	pool.workers = workers;
+	for (used = 0; (used < threads) && !failed; used++)
+	{
+		PoolWorker* worker = (PoolWorker*)AlignedAlloc(sizeof(PoolWorker),
+			WORKER_ALIGNMENT);
+
+		workers[used] = worker;
+		if (worker == NULL)
+			failed = 1;
+		else
+		{
+			memset(worker, 0, sizeof(PoolWorker));
+			worker->lock = unlocked;
+			worker->first = count * (size_t)used / (size_t)threads;
+			worker->last = count * (size_t)(used + 1) / (size_t)threads;
+			worker->pool = &pool;
+			worker->id = used;
+			failed = !InitArena(&worker->arena, SCHEDULE_ARENA);
+		}
+	}
+	pool.count = used;
+
+	if (!failed)
+	{
+		start = GetWallSeconds();
+		for (int t = 1; t < used; t++)     // Worker 0 runs on this thread
+			launched[t] = StartThread(&handles[t], runWorker, workers[t]);
+		runWorker(workers[0]);
+		for (int t = 1; t < used; t++)
+			if (launched[t])
+				JoinThread(handles[t]);
+		for (int t = 0; t < used; t++)
+		{
+			workers[t]->stats.wallSeconds = GetWallSeconds() - start;
+			if (stats != NULL)
+				stats[t] = workers[t]->stats;
+		}
+	}
+	for (int t = 0; t < used; t++)
+	{
+		if (workers[t] != NULL)
+			FreeArena(&workers[t]->arena);
+		AlignedFree(workers[t]);
+	}
+	return failed ? 0 : used;
+}
+//----------------------------------------------------------------------------
+// Function:	    void WritePoolStats(FILE* fp,
+//						const PoolWorkerStats* stats, const int workers)
+//
+// Description:		Writes one line per worker: the tasks it ran, how many
+//					of them it stole and in how many steals, the rows it
+//					built, and its utilization, the share of the pool's run
+//					it spent running tasks rather than looking for them or
+//					waiting for the others to finish.
+//
+// Parameters:	    (FILE*)                    fp        Output stream
+//				    const (PoolWorkerStats*)   stats     From RunTaskPool()
+//				    const (int)                workers   Entries in stats
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       main() of bench_pool
+// Calls:		    fprintf()
+// History Log:     10/17/2026  added for the work-stealing task pool
+//----------------------------------------------------------------------------
+void WritePoolStats(FILE* fp, const PoolWorkerStats* stats,
+	const int workers)
+{
+	fprintf(fp, "%-8s %10s %10s %8s %12s %10s %8s\n", "Worker", "Tasks",
+		"Stolen", "Steals", "Rows", "Busy ms", "Util %");
+	for (int t = 0; t < workers; t++)
+		fprintf(fp, "%-8d %10lld %10lld %8lld %12lld %10.2lf %8.1lf\n", t,
+			stats[t].tasks, stats[t].stolen, stats[t].steals, stats[t].rows,
+			stats[t].busySeconds * 1e3, (stats[t].wallSeconds > 0) ?
+			stats[t].busySeconds * 100 / stats[t].wallSeconds : 0.0);
+}
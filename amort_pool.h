@@ -0,0 +1,52 @@
+//----------------------------------------------------------------------------
+// File:			amort_pool.h
+//
+// Description:     Header file for the work-stealing task pool
+//					(amort_pool.c). Runs a book of schedule and solver tasks
+//					on a number of workers. Each worker starts with an equal
+//					share of the tasks and, once its share is done, steals
+//					half of what is left of another worker's, so a worker
+//					that drew the long loans is helped rather than waited
+//					for. Every worker builds its tables in a bump arena of
+//					its own, reset between tasks, so running a task costs no
+//					malloc() and no free().
+//
+// History Log:    10/17/2026  added for the work-stealing task pool
+//----------------------------------------------------------------------------
+
+#ifndef AMORT_POOL_H
+#define AMORT_POOL_H
+#include <stdio.h>
+#include "amort_portfolio.h"
+
+#define POOL_SCHEDULE 'S'           // Build the loan's table and total it
+#define POOL_SOLVE_RATE 'I'         // Find the rate of loan, payment, months
+#define POOL_MAX_THREADS 256
+
+typedef struct
+{
+	PortfolioLoan loan;             // Inputs; interestRate unused by 'I'
+	char kind;                      // POOL_SCHEDULE or POOL_SOLVE_RATE
+	char solved;                    // 1 once answered, 0 if there is none
+	int steps;                      // Rows built or solver iterations
+	double rate;                    // Rate found by POOL_SOLVE_RATE
+	double totalPaid;               // Table totals of POOL_SCHEDULE
+	double totalInterest;
+} PoolTask;
+
+typedef struct
+{
+	long long tasks;                // Tasks run by the worker
+	long long stolen;               // Of which taken from other workers
+	long long steals;               // Times it found another's tasks
+	long long rows;                 // Schedule rows built
+	double busySeconds;             // Time spent running tasks
+	double wallSeconds;             // Time the whole pool ran
+} PoolWorkerStats;
+
+int RunTaskPool(PoolTask* tasks, const size_t count, int threads,
+	PoolWorkerStats* stats);
+void WritePoolStats(FILE* fp, const PoolWorkerStats* stats,
+	const int workers);
+
+#endif
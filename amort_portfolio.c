@@ -0,0 +1,263 @@
+//----------------------------------------------------------------------------
+// File:			amort_portfolio.c
+//
+// Description      Portfolio cash-flow engine for the Amort library. Steps
+//					loans through the amortization loop of FillScheduleRows()
+//					(PORTFOLIO_BLOCK at a time with the SIMD kernel, which
+//					gives the same rows) and adds every month straight into
+//					month totals, so no loan table is ever stored. Each
+//					thread fills its own PortfolioTotals and the parts are
+//					added together after the threads are joined: no locks
+//					and no shared writes while the loans are stepped.
+//
+// Functions:	    void ClearPortfolioTotals(PortfolioTotals* totals)
+//					void MergePortfolioTotals(PortfolioTotals* totals,
+//						const PortfolioTotals* part)
+//					int AggregatePortfolio(PortfolioTotals* totals,
+//						const PortfolioLoan* loans, const size_t count,
+//						int threads)
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include "amort.h"
+#include "amort_platform.h"
+#include "amort_portfolio.h"
+#include "amort_simd.h"
+
+#define PORTFOLIO_BLOCK 512         // Loans stepped together by a thread
+#define TOTALS_ALIGNMENT 64         // Cache line: parts never share one
+
+typedef struct
+{
+	const PortfolioLoan* loans;
+	size_t count;
+	PortfolioTotals* totals;
+	int failed;                     // Loan columns could not be allocated
+} PortfolioSlice;
+
+// ToCents() without the call to floor(), which the compiler can only
+// inline when it may use SSE4.1. Same result for every amount that fits.
+static Cents toCents(const double amount)
+{
+	double scaled = amount * HUNDRED + HALF;
+	Cents cents = (Cents)scaled;
+
+	return cents - (scaled < (double)cents);
+}
+
+static int longerTermFirst(const void* a, const void* b)
+{
+	const PortfolioLoan* first = *(const PortfolioLoan* const*)a;
+	const PortfolioLoan* second = *(const PortfolioLoan* const*)b;
+
+	return (second->months > first->months) -
+		(second->months < first->months);
+}
+
+// Steps up to PORTFOLIO_BLOCK loans together with the SIMD kernel, longest
+// term first, so each month only the loans still running are stepped.
+static void addBlock(PortfolioTotals* totals, LoanColumns* cols,
+	const PortfolioLoan* loans, const size_t count)
+{
+	const PortfolioLoan* order[PORTFOLIO_BLOCK];
+	size_t active = 0;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		if ((loans[i].months < 1) || (loans[i].months > PORTFOLIO_MONTHS))
+			totals->skipped++;
+		else
+			order[active++] = &loans[i];
+	}
+	if (active == 0)
+		return;
+	qsort(order, active, sizeof(order[0]), longerTermFirst);
+	for (size_t k = 0; k < active; k++)
+		SetLoanColumn(cols, k, order[k]->loanSize, order[k]->paymentSize,
+			order[k]->interestRate, order[k]->months);
+	totals->loans += (long long)active;
+	if (order[0]->months > totals->months)
+		totals->months = order[0]->months;
+
+	for (int month = 1; month <= order[0]->months; month++)
+	{
+		Cents paid = 0;
+		Cents principal = 0;
+		Cents interest = 0;
+		Cents balance = 0;
+
+		while (cols->months[active - 1] < month)
+			active--;
+		StepLoanRange(cols, 0, active, month);
+		for (size_t k = 0; k < active; k++)
+		{
+			paid += toCents(cols->paid[k]);
+			principal += toCents(cols->principal[k]);
+			interest += toCents(cols->interest[k]);
+			balance += toCents(cols->balance[k]);
+		}
+		totals->payment[month - 1] += paid;
+		totals->principal[month - 1] += principal;
+		totals->interest[month - 1] += interest;
+		totals->balance[month - 1] += balance;
+	}
+}
+
+static void addSlice(void* arg)
+{
+	PortfolioSlice* slice = (PortfolioSlice*)arg;
+	LoanColumns cols;
+
+	if (!AllocLoanColumns(&cols, PORTFOLIO_BLOCK))
+	{
+		slice->failed = 1;
+		return;
+	}
+	for (size_t first = 0; first < slice->count; first += PORTFOLIO_BLOCK)
+		addBlock(slice->totals, &cols, slice->loans + first,
+			(slice->count - first < PORTFOLIO_BLOCK) ?
+			slice->count - first : PORTFOLIO_BLOCK);
+	FreeLoanColumns(&cols);
+}
+//----------------------------------------------------------------------------
+// Function:	    void ClearPortfolioTotals(PortfolioTotals* totals)
+//
+// Description:		Sets every month total and count to zero.
+//
+// Parameters:	    (PortfolioTotals*) totals   Totals to clear
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       AggregatePortfolio()
+// History Log:     10/17/2026  added for portfolio cash-flow aggregation
+//----------------------------------------------------------------------------
+void ClearPortfolioTotals(PortfolioTotals* totals)
+{
+	memset(totals, 0, sizeof(PortfolioTotals));
+}
+//----------------------------------------------------------------------------
+// Function:	    void MergePortfolioTotals(PortfolioTotals* totals,
+//						const PortfolioTotals* part)
+//
+// Description:		Adds the month totals and counts of part into totals.
+//
+// Parameters:	    (PortfolioTotals*)        totals   Totals to add into
+//				    const (PortfolioTotals*)  part     Totals of some loans
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       AggregatePortfolio()
+// History Log:     10/17/2026  added for portfolio cash-flow aggregation
+//----------------------------------------------------------------------------
+void MergePortfolioTotals(PortfolioTotals* totals,
+	const PortfolioTotals* part)
+{
+	for (int i = 0; i < part->months; i++)
+	{
+		totals->payment[i] += part->payment[i];
+		totals->principal[i] += part->principal[i];
+		totals->interest[i] += part->interest[i];
+		totals->balance[i] += part->balance[i];
+	}
+	if (part->months > totals->months)
+		totals->months = part->months;
+	totals->loans += part->loans;
+	totals->skipped += part->skipped;
+}
+//----------------------------------------------------------------------------
+// Function:	    int AggregatePortfolio(PortfolioTotals* totals,
+//						const PortfolioLoan* loans, const size_t count,
+//						int threads)
+//
+// Description:		Sets totals to the month by month cash flows of a book
+//					of loans. The book is cut into one slice per thread
+//					holding about the same number of loan months (terms
+//					vary from 1 to PORTFOLIO_MONTHS), each slice is added
+//					into its own cache aligned PortfolioTotals, and the
+//					parts are merged on this thread once all are joined.
+//					Within a slice, blocks of loans are sorted longest term
+//					first and stepped together with StepLoanRange().
+//
+// Parameters:	    (PortfolioTotals*)      totals    Receives the totals
+//				    const (PortfolioLoan*)  loans     The book
+//				    const (size_t)          count     Number of loans
+//				    (int)                   threads   Worker threads, 0 for
+//													  one per CPU
+//
+// Returns:		    (int) 1 on success, 0 if the per-thread totals could not
+//					be allocated
+// Date:            10/17/2026
+// Called By:       main() of bench_portfolio
+// Calls:		    StepLoanRange(), MergePortfolioTotals(),
+//					ClearPortfolioTotals(), StartThread(), JoinThread(),
+//					GetCpuCount(), AlignedAlloc(), AlignedFree()
+// History Log:     10/17/2026  added for portfolio cash-flow aggregation
+//----------------------------------------------------------------------------
+int AggregatePortfolio(PortfolioTotals* totals, const PortfolioLoan* loans,
+	const size_t count, int threads)
+{
+	AmortThread handles[PORTFOLIO_MAX_THREADS];
+	int launched[PORTFOLIO_MAX_THREADS] = { 0 };
+	PortfolioSlice slices[PORTFOLIO_MAX_THREADS];
+	long long rows = 0;
+	long long taken = 0;
+	size_t first = 0;
+	int used = 0;
+	int failed = 0;
+
+	ClearPortfolioTotals(totals);
+	if (threads <= 0)
+		threads = GetCpuCount();
+	if (threads > PORTFOLIO_MAX_THREADS)
+		threads = PORTFOLIO_MAX_THREADS;
+	if ((size_t)threads > count)
+		threads = (count > 0) ? (int)count : 1;
+
+	for (size_t i = 0; i < count; i++)
+		rows += (loans[i].months > 0) ? loans[i].months : 1;
+	for (used = 0; (used < threads) && (first < count); used++)
+	{
+		long long target = rows * (used + 1) / threads;
+		size_t last = first;
+
+		while ((last < count) && ((taken < target) || (last == first) ||
+			(used == threads - 1)))
+		{
+			taken += (loans[last].months > 0) ? loans[last].months : 1;
+			last++;
+		}
+		slices[used].loans = loans + first;
+		slices[used].count = last - first;
+		slices[used].failed = 0;
+		slices[used].totals = (PortfolioTotals*)AlignedAlloc(
+			sizeof(PortfolioTotals), TOTALS_ALIGNMENT);
+		if (slices[used].totals == NULL)
+			failed = 1;
+		else
+			ClearPortfolioTotals(slices[used].totals);
+		first = last;
+	}
+
+	if (!failed)
+	{
+		for (int t = 1; t < used; t++)     // Slice 0 runs on this thread
+			launched[t] = StartThread(&handles[t], addSlice, &slices[t]);
+		if (used > 0)
+			addSlice(&slices[0]);
+		for (int t = 1; t < used; t++)
+		{
+			if (launched[t])
+				JoinThread(handles[t]);
+			else
+				addSlice(&slices[t]);
+		}
+		for (int t = 0; t < used; t++)
+		{
+			failed |= slices[t].failed;
+			MergePortfolioTotals(totals, slices[t].totals);
+		}
+	}
+	for (int t = 0; t < used; t++)
+		AlignedFree(slices[t].totals);
+	return !failed;
+}
@@ -0,0 +1,51 @@
+//----------------------------------------------------------------------------
+// File:			amort_portfolio.h
+//
+// Description:     Header file for the portfolio cash-flow engine
+//					(amort_portfolio.c). Adds up, month by month, the
+//					payment, principal, interest and outstanding balance of
+//					every loan in a book without building any loan's table.
+//					Totals are whole cents, so they are exact and the same
+//					for any number of threads, as long as every amount of
+//					every table fits in Cents.
+//
+// History Log:    10/17/2026  added for portfolio cash-flow aggregation
+//				   10/17/2026  AddPortfolioLoan() dropped; bench_portfolio
+//							   checks against BuildSchedule() tables
+//----------------------------------------------------------------------------
+
+#ifndef AMORT_PORTFOLIO_H
+#define AMORT_PORTFOLIO_H
+#include <stddef.h>
+#include "amort.h"
+#include "amort_cents.h"
+
+#define PORTFOLIO_MONTHS FIVE_HUNDRED_YEARS
+#define PORTFOLIO_MAX_THREADS 256
+
+typedef struct
+{
+	double loanSize;                // Total amount of loan
+	double paymentSize;             // Amount of one monthly payment
+	double interestRate;            // Annual interest rate
+	int months;                     // Number of monthly payments
+} PortfolioLoan;
+
+typedef struct
+{
+	int months;                     // Longest term added
+	long long loans;                // Loans added
+	long long skipped;              // Loans with a term out of range
+	Cents payment[PORTFOLIO_MONTHS];    // Month m totals are at [m - 1]
+	Cents principal[PORTFOLIO_MONTHS];
+	Cents interest[PORTFOLIO_MONTHS];
+	Cents balance[PORTFOLIO_MONTHS];    // Outstanding after the payment
+} PortfolioTotals;
+
+void ClearPortfolioTotals(PortfolioTotals* totals);
+void MergePortfolioTotals(PortfolioTotals* totals,
+	const PortfolioTotals* part);
+int AggregatePortfolio(PortfolioTotals* totals, const PortfolioLoan* loans,
+	const size_t count, int threads);
+
+#endif
@@ -0,0 +1,418 @@
+//----------------------------------------------------------------------------
+// File:			amort_prepay.c
+//
+// Description      Prepayment engine for the Amort library. Between two
+//					events the monthly amount is fixed, so the balance after
+//					k months has a closed form,
+//
+//						B(k) = B - (A - r * B) * ((1 + r)^k - 1) / r
+//
+//					for balance B, monthly amount A and monthly rate r, and
+//					the month it reaches zero comes from a logarithm.
+//					SimulatePrepayment() jumps from event to event with it,
+//					so a 6000 month loan with a handful of events costs a
+//					handful of steps; an extra paid every few months is a
+//					lump sum in each of its months and costs a step each
+//					time. The closed form does not round the
+//					interest to the cent each month, so its totals can be a
+//					few cents (and, when the last payment is tiny, the
+//					payoff a month) away from the table.
+//
+//					FillPrepaymentRows() is the month by month loop of
+//					FillScheduleRows() with the events added; with no events
+//					it gives the same rows.
+//
+// Functions:	    int SimulatePrepayment(PrepayResult* result,
+//						const double loanSize, const double paymentSize,
+//						const double interestRate, const int months,
+//						const PrepayEvent* events, const int count)
+//					int FillPrepaymentRows(ScheduleRow* rows,
+//						const double loanSize, const double paymentSize,
+//						const double interestRate, const int months,
+//						const PrepayEvent* events, const int count)
+//					double ClosedFormBalance(const double balance,
+//						const double amount, const double rate, const int k)
+//					int ClosedFormPayoff(const double balance,
+//						const double amount, const double rate, const int k)
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include "amort.h"
+#include "amort_prepay.h"
+
+typedef struct
+{
+	double balance;
+	double interest;                // Interest paid so far
+	double paid;                    // Everything paid so far
+	int month;                      // Months done
+	int paidOff;
+	int segments;
+} PrepayState;
+
+// Returns 1 if every event is one the engine understands.
+static int validEvents(const PrepayEvent* events, const int count)
+{
+	for (int i = 0; i < count; i++)
+	{
+		const PrepayEvent* e = &events[i];
+
+		if ((e->kind < PREPAY_LUMP_SUM) || (e->kind > PREPAY_NEW_PAYMENT) ||
+			(e->month < 1) || !(e->amount >= 0) || !isfinite(e->amount) ||
+			((e->kind == PREPAY_NEW_PAYMENT) && !(e->amount > 0)) ||
+			((e->kind == PREPAY_EXTRA) && (e->every < 1)))
+			return 0;
+	}
+	return 1;
+}
+
+// Last month a recurring extra is paid.
+static int lastExtraMonth(const PrepayEvent* e, const int months)
+{
+	return (e->lastMonth < e->month) ? months : e->lastMonth;
+}
+
+// The monthly amount of month m: the latest new payment (or paymentSize)
+// plus the extras paid every month.
+static double amountAt(const double paymentSize, const PrepayEvent* events,
+	const int count, const int m, const int months)
+{
+	double payment = paymentSize;
+	double extra = 0;
+	int from = 0;
+
+	for (int i = 0; i < count; i++)
+	{
+		const PrepayEvent* e = &events[i];
+
+		if ((e->kind == PREPAY_NEW_PAYMENT) && (e->month <= m) &&
+			(e->month >= from))
+		{
+			payment = e->amount;
+			from = e->month;
+		}
+		else if ((e->kind == PREPAY_EXTRA) && (e->every == 1) &&
+			(e->month <= m) && (m <= lastExtraMonth(e, months)))
+			extra += e->amount;
+	}
+	return payment + extra;
+}
+
+// Lump sums of month m, counting extras paid every few months.
+static double lumpAt(const PrepayEvent* events, const int count,
+	const int m, const int months)
+{
+	double lump = 0;
+
+	for (int i = 0; i < count; i++)
+	{
+		const PrepayEvent* e = &events[i];
+
+		if (((e->kind == PREPAY_LUMP_SUM) && (e->month == m)) ||
+			((e->kind == PREPAY_EXTRA) && (e->every > 1) &&
+			(e->month <= m) && (m <= lastExtraMonth(e, months)) &&
+			((m - e->month) % e->every == 0)))
+			lump += e->amount;
+	}
+	return lump;
+}
+
+// First month after m whose amountAt() may differ, or months + 1.
+static int nextChange(const PrepayEvent* events, const int count,
+	const int m, const int months)
+{
+	int next = months + 1;
+
+	for (int i = 0; i < count; i++)
+	{
+		const PrepayEvent* e = &events[i];
+		int last = lastExtraMonth(e, months);
+
+		if ((e->kind == PREPAY_LUMP_SUM) ||
+			((e->kind == PREPAY_EXTRA) && (e->every > 1)))
+			continue;
+		if ((e->month > m) && (e->month < next))
+			next = e->month;
+		if ((e->kind == PREPAY_EXTRA) && (last + 1 > m) && (last + 1 < next))
+			next = last + 1;
+	}
+	return next;
+}
+
+// First month from m on with a lump sum, or months + 1.
+static int nextLump(const PrepayEvent* events, const int count,
+	const int m, const int months)
+{
+	int next = months + 1;
+
+	for (int i = 0; i < count; i++)
+	{
+		const PrepayEvent* e = &events[i];
+		int month = e->month;
+
+		if ((e->kind == PREPAY_EXTRA) && (e->every > 1) && (month < m))
+			month += (m - month + e->every - 1) / e->every * e->every;
+		if ((e->kind == PREPAY_NEW_PAYMENT) ||
+			((e->kind == PREPAY_EXTRA) && ((e->every == 1) ||
+			(month > lastExtraMonth(e, months)))) || (month < m))
+			continue;
+		if (month < next)
+			next = month;
+	}
+	return next;
+}
+//----------------------------------------------------------------------------
+// Function:	    double ClosedFormBalance(const double balance,
+//						const double amount, const double rate, const int k)
+//
+// Description:		Balance left after k payments of amount at a monthly
+//					rate, from the closed form, with no cent rounding.
+//
+// Parameters:	    const (double)   balance   Balance before the payments
+//				    const (double)   amount    Monthly payment
+//				    const (double)   rate      Monthly rate, not percent
+//				    const (int)      k         Number of payments
+//
+// Returns:		    (double) balance   May be below zero
+// Date:            10/17/2026
+// Called By:       SimulatePrepayment(), PriceArm()
+// History Log:     10/17/2026  added for the prepayment engine
+//				    10/17/2026  shared with the ARM engine
+//----------------------------------------------------------------------------
+double ClosedFormBalance(const double balance, const double amount,
+	const double rate, const int k)
+{
+	if (rate == 0)
+		return balance - k * amount;
+	return balance - (amount - rate * balance) * expm1(k * log1p(rate)) /
+		rate;
+}
+//----------------------------------------------------------------------------
+// Function:	    int ClosedFormPayoff(const double balance,
+//						const double amount, const double rate, const int k)
+//
+// Description:		Number of payments of amount that bring balance to zero
+//					or below, from a logarithm checked against
+//					ClosedFormBalance() on either side.
+//
+// Parameters:	    const (double)   balance   Balance before the payments
+//				    const (double)   amount    Monthly payment
+//				    const (double)   rate      Monthly rate, not percent
+//				    const (int)      k         Most payments to look at
+//
+// Returns:		    (int) payments   1 to k, or k + 1 if it takes more
+// Date:            10/17/2026
+// Called By:       SimulatePrepayment(), PriceArm()
+// Calls:		    ClosedFormBalance()
+// History Log:     10/17/2026  added for the prepayment engine
+//				    10/17/2026  shared with the ARM engine
+//----------------------------------------------------------------------------
+int ClosedFormPayoff(const double balance, const double amount,
+	const double rate, const int k)
+{
+	double exact = 0;
+	int n = 0;
+
+	if (amount <= rate * balance)
+		return k + 1;                           // Interest eats the payment
+	exact = (rate == 0) ? balance / amount :
+		log1p(rate * balance / (amount - rate * balance)) / log1p(rate);
+	if (!(exact < k + ONE))
+		return k + 1;
+	n = (exact < ONE) ? 1 : (int)ceil(exact);
+	while ((n > 1) && (ClosedFormBalance(balance, amount, rate, n - 1) <= 0))
+		n--;
+	while ((n <= k) && (ClosedFormBalance(balance, amount, rate, n) > 0))
+		n++;
+	return n;
+}
+
+// Pays amount for k months, or until the loan is paid off, in one step.
+static void jump(PrepayState* state, const double amount, const double rate,
+	const int k)
+{
+	const int n = ClosedFormPayoff(state->balance, amount, rate, k);
+	double after = 0;
+
+	state->segments++;
+	if (n <= k)
+	{
+		double before = ClosedFormBalance(state->balance, amount, rate, n - 1);
+
+		state->interest += (n - 1) * amount - (state->balance - before) +
+			before * rate;
+		state->paid += (n - 1) * amount + before * (ONE + rate);
+		state->balance = 0;
+		state->month += n;
+		state->paidOff = 1;
+		return;
+	}
+	after = ClosedFormBalance(state->balance, amount, rate, k);
+	state->interest += k * amount - (state->balance - after);
+	state->paid += k * amount;
+	state->balance = after;
+	state->month += k;
+}
+
+// Runs a loan from event to event until it is paid off.
+static void simulate(PrepayState* state, const double loanSize,
+	const double paymentSize, const double rate, const int months,
+	const PrepayEvent* events, const int count)
+{
+	memset(state, 0, sizeof(PrepayState));
+	state->balance = loanSize;
+	state->paidOff = !(loanSize > 0);
+	while (!state->paidOff && (state->month < months))
+	{
+		const int first = state->month + 1;
+		const int change = nextChange(events, count, first, months);
+		const int lump = nextLump(events, count, first, months);
+		int end = (change - 1 < months) ? change - 1 : months;
+
+		if (lump < end)
+			end = lump;
+		jump(state, amountAt(paymentSize, events, count, first, months),
+			rate, end - state->month);
+		if (state->paidOff)
+			break;
+		if (end == lump)
+		{
+			double amount = fmin(lumpAt(events, count, end, months),
+				state->balance);
+
+			state->balance -= amount;
+			state->paid += amount;
+			state->paidOff = (state->balance <= 0);
+		}
+		if ((end == months) && !state->paidOff)   // Last payment takes the rest
+		{
+			state->paid += state->balance;
+			state->balance = 0;
+			state->paidOff = 1;
+		}
+	}
+}
+//----------------------------------------------------------------------------
+// Function:	    int SimulatePrepayment(PrepayResult* result,
+//						const double loanSize, const double paymentSize,
+//						const double interestRate, const int months,
+//						const PrepayEvent* events, const int count)
+//
+// Description:		Works out the payoff month and total interest of a loan
+//					with and without the events, jumping from one event to
+//					the next with the closed form balance. In each month the
+//					payment is made first and the month's lump sums after
+//					it; the loan ends when the balance reaches zero, or in
+//					month 'months', whose payment takes what is left, as in
+//					DisplayTable(). Totals are rounded to the cent.
+//
+// Parameters:	    (PrepayResult*)        result         Receives the totals
+//				    const double           loanSize       Total size of loan
+//				    const double           paymentSize    Monthly payment
+//				    const double           interestRate   Annual rate
+//				    const int              months         Number of payments
+//				    const (PrepayEvent*)   events         Events, any order
+//				    const int              count          Number of events
+//
+// Returns:		    (int) 1 on success, 0 if an event is not valid
+// Date:            10/17/2026
+// Calls:		    roundInterest(), RoundCents()
+// History Log:     10/17/2026  added for the prepayment engine
+//				    10/17/2026  totals rounded by the shared RoundCents()
+//----------------------------------------------------------------------------
+int SimulatePrepayment(PrepayResult* result, const double loanSize,
+	const double paymentSize, const double interestRate, const int months,
+	const PrepayEvent* events, const int count)
+{
+	const double rate = roundInterest(interestRate, 8) / MONTHLY_DIVISOR;
+	PrepayState scheduled;
+	PrepayState planned;
+
+	memset(result, 0, sizeof(PrepayResult));
+	if (!validEvents(events, count))
+		return 0;
+	simulate(&scheduled, loanSize, paymentSize, rate, months, NULL, 0);
+	simulate(&planned, loanSize, paymentSize, rate, months, events, count);
+	result->payoffMonth = planned.month;
+	result->scheduledMonths = scheduled.month;
+	result->totalInterest = RoundCents(planned.interest);
+	result->scheduledInterest = RoundCents(scheduled.interest);
+	result->interestSaved = RoundCents(scheduled.interest - planned.interest);
+	result->totalPaid = RoundCents(planned.paid);
+	result->segments = planned.segments;
+	return 1;
+}
+//----------------------------------------------------------------------------
+// Function:	    int FillPrepaymentRows(ScheduleRow* rows,
+//						const double loanSize, const double paymentSize,
+//						const double interestRate, const int months,
+//						const PrepayEvent* events, const int count)
+//
+// Description:		Works out the amortization table of a loan with events,
+//					month by month, with the interest of each month rounded
+//					to the cent as in FillScheduleRows(). A row's payment
+//					and principal include the extras and lump sums of its
+//					month. The table stops at the month the balance
+//					reaches zero.
+//
+// Parameters:	    (ScheduleRow*)         rows           Receives the rows,
+//														  room for months
+//				    const double           loanSize       Total size of loan
+//				    const double           paymentSize    Monthly payment
+//				    const double           interestRate   Annual rate
+//				    const int              months         Number of payments
+//				    const (PrepayEvent*)   events         Events, any order
+//				    const int              count          Number of events
+//
+// Returns:		    (int) rows   Rows written (the payoff month), 0 if an
+//								 event is not valid
+// Date:            10/17/2026
+// Calls:		    roundInterest(), MonthInterest()
+// History Log:     10/17/2026  added for the prepayment engine
+//				    10/17/2026  interest from the shared MonthInterest()
+//----------------------------------------------------------------------------
+int FillPrepaymentRows(ScheduleRow* rows, const double loanSize,
+	const double paymentSize, const double interestRate, const int months,
+	const PrepayEvent* events, const int count)
+{
+	double loanBalance = loanSize;
+	double roundedInterest = roundInterest(interestRate, 8);
+	double interestToDate = 0;
+
+	if (!validEvents(events, count))
+		return 0;
+	for (int i = 1; i <= months; i++)
+	{
+		double payment = amountAt(paymentSize, events, count, i, months);
+		double lump = lumpAt(events, count, i, months);
+		double interestPaid = MonthInterest(loanBalance, roundedInterest);
+		double principalPaid = payment - interestPaid;
+		ScheduleRow* row = &rows[i - 1];
+
+
+		loanBalance -= principalPaid;
+		if ((lump > 0) && (loanBalance > 0))
+		{
+			lump = fmin(lump, loanBalance);
+			payment += lump;
+			principalPaid += lump;
+			loanBalance -= lump;
+		}
+		if (((i == months) || (loanBalance < 0)) && (loanBalance != 0))
+		{
+			payment += loanBalance;             //adjust the last payment
+			principalPaid += loanBalance;
+			loanBalance -= loanBalance;
+		}
+		row->month = i;
+		row->payment = payment;
+		row->principal = principalPaid;
+		row->interest = interestPaid;
+		row->balance = loanBalance;
+		interestToDate += interestPaid;
+		row->interestToDate = interestToDate;
+		if ((loanBalance == 0) && (payment != 0))
+			return i;
+	}
+	return months;
+}
@@ -0,0 +1,58 @@
+//----------------------------------------------------------------------------
+// File:			amort_prepay.h
+//
+// Description:     Header file for the prepayment engine (amort_prepay.c).
+//					A loan as DisplayTable() takes it, plus a list of
+//					events: lump sums, recurring extra principal and new
+//					payment amounts. SimulatePrepayment() finds the payoff
+//					month and the interest saved by jumping from one event
+//					to the next with the closed form balance;
+//					FillPrepaymentRows() works out the table month by month,
+//					with cent rounding, when one is wanted.
+//
+// History Log:    10/17/2026  added for the prepayment engine
+//				   10/17/2026  closed form balance and payoff shared with
+//							   the ARM engine
+//----------------------------------------------------------------------------
+
+#ifndef AMORT_PREPAY_H
+#define AMORT_PREPAY_H
+#include "amort_schedule.h"
+
+#define PREPAY_LUMP_SUM 0           // amount paid once, in month
+#define PREPAY_EXTRA 1              // amount every 'every' months, month on
+#define PREPAY_NEW_PAYMENT 2        // Payment becomes amount, month on
+
+typedef struct
+{
+	int kind;                       // PREPAY_LUMP_SUM, PREPAY_EXTRA, ...
+	int month;                      // First month the event applies to
+	int lastMonth;                  // PREPAY_EXTRA: last month, or below
+									// month for the rest of the loan
+	int every;                      // PREPAY_EXTRA: months apart (1 or more)
+	double amount;
+} PrepayEvent;
+
+typedef struct
+{
+	int payoffMonth;                // Month of the last payment
+	int scheduledMonths;            // The same without the events
+	double totalInterest;           // Interest paid
+	double scheduledInterest;       // The same without the events
+	double interestSaved;           // scheduledInterest - totalInterest
+	double totalPaid;               // Payments, extras and lump sums
+	int segments;                   // Closed form jumps taken
+} PrepayResult;
+
+int SimulatePrepayment(PrepayResult* result, const double loanSize,
+	const double paymentSize, const double interestRate, const int months,
+	const PrepayEvent* events, const int count);
+int FillPrepaymentRows(ScheduleRow* rows, const double loanSize,
+	const double paymentSize, const double interestRate, const int months,
+	const PrepayEvent* events, const int count);
+double ClosedFormBalance(const double balance, const double amount,
+	const double rate, const int k);
+int ClosedFormPayoff(const double balance, const double amount,
+	const double rate, const int k);
+
+#endif
@@ -0,0 +1,229 @@
+//----------------------------------------------------------------------------
+// File:			amort_query.c
+//
+// Description      Random-access schedule queries for the Amort library.
+//					With monthly rate r and growth g = (1 + r)^k - 1 the
+//					balance after k payments is
+//
+//						B(k) = P + (P * r - payment) * g / r
+//
+//					and the interest paid in months a .. b is the payments
+//					made less the drop in balance,
+//
+//						(b - a + 1) * payment - (B(a - 1) - B(b)).
+//
+//					Both cost the same for month 6 as for month 6000. The
+//					table rounds each month's interest to the cent, and every
+//					half cent of rounding grows by (1 + r) a month after it,
+//					so the table's balance drifts from B(k): by cents on
+//					short loans, by dollars on a 30 year loan at a high rate
+//					(see bench/bench_query.c). These are estimates, rounded
+//					to the cent; the exact values of a built table come from
+//					ScheduleBalanceAt() and ScheduleInterestBetween().
+//
+// Functions:	    double EstimateBalanceAt(const double loanSize, 
+//						const double paymentSize, const double interestRate,
+//						const int months, const int month)
+//					double EstimateInterestBetween(const double loanSize,
+//						const double paymentSize, const double interestRate,
+//						const int months, const int first, const int last)
+//					int EstimateScheduleWindow(ScheduleRow* rows, 
+//						const double loanSize, const double paymentSize,
+//						const double interestRate, const int months,
+//						const int first, const int count)
+//					int EstimateScheduleTotals(ScheduleTotals* totals,
+//						const double loanSize, const double paymentSize,
+//						const double interestRate, const int months)
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include "amort.h"
+#include "amort_query.h"
+
+// B(k) before rounding and before the last payment is adjusted.
+static double closedBalance(const double loanSize, const double paymentSize,
+	const double rate, const int month)
+{
+	double growth = 0;
+
+	if (rate == 0)
+		return loanSize - paymentSize * month;
+	growth = expm1(month * log1p(rate));
+	return loanSize + (loanSize * rate - paymentSize) * growth / rate;
+}
+//----------------------------------------------------------------------------
+// Function:	    double EstimateBalanceAt(const double loanSize, 
+//						const double paymentSize, const double interestRate,
+//						const int months, const int month)
+//
+// Description:		Estimates the loan balance after payment 'month' without
+//					building the table. Month 0 is the loan size and the
+//					balance after the last payment is 0; in between the
+//					table may drift from it (see above).
+//
+// Parameters:	    const double  loanSize       Total size of loan
+//				    const double  paymentSize    Monthly payment amount
+//				    const double  interestRate   Annual interest rate
+//				    const int     months         Number of monthly payments
+//				    const int     month          Payments made
+//
+// Returns:		    (double) balance   Loan balance, rounded to the cent
+// Date:            10/17/2026
+// Called By:       EstimateScheduleWindow()
+// Calls:		    roundInterest()
+// History Log:     10/17/2026  added for random-access schedule queries
+//				    10/17/2026  renamed from GetBalanceAt(), as it is an
+//								estimate
+//----------------------------------------------------------------------------
+double EstimateBalanceAt(const double loanSize, const double paymentSize,
+	const double interestRate, const int months, const int month)
+{
+	double rate = roundInterest(interestRate, 8) / MONTHLY_DIVISOR;
+	double balance = 0;
+
+	if (month <= 0)
+		return loanSize;
+	if (month >= months)
+		return 0;
+	balance = closedBalance(loanSize, paymentSize, rate, month);
+	return floor(balance * HUNDRED + HALF) / HUNDRED;
+}
+//----------------------------------------------------------------------------
+// Function:	    double EstimateInterestBetween(const double loanSize,
+//						const double paymentSize, const double interestRate,
+//						const int months, const int first, const int last)
+//
+// Description:		Estimates the interest paid in months first .. last
+//					(inclusive, clipped to 1 .. months) without building the
+//					table. The last payment adjustment changes only the
+//					principal, so it needs no special case.
+//
+// Parameters:	    const double  loanSize       Total size of loan
+//				    const double  paymentSize    Monthly payment amount
+//				    const double  interestRate   Annual interest rate
+//				    const int     months         Number of monthly payments
+//				    const int     first          First month of the range
+//				    const int     last           Last month of the range
+//
+// Returns:		    (double) interest   Interest paid, rounded to the cent
+// Date:            10/17/2026
+// Calls:		    roundInterest()
+// History Log:     10/17/2026  added for random-access schedule queries
+//				    10/17/2026  renamed from GetInterestBetween(), as it is
+//								an estimate
+//----------------------------------------------------------------------------
+double EstimateInterestBetween(const double loanSize, const double paymentSize,
+	const double interestRate, const int months, const int first,
+	const int last)
+{
+	double rate = roundInterest(interestRate, 8) / MONTHLY_DIVISOR;
+	int from = (first < 1) ? 1 : first;
+	int to = (last > months) ? months : last;
+	double interest = 0;
+
+	if (to < from)
+		return 0;
+	interest = (to - from + ONE) * paymentSize -
+		(closedBalance(loanSize, paymentSize, rate, from - 1) -
+		closedBalance(loanSize, paymentSize, rate, to));
+	return floor(interest * HUNDRED + HALF) / HUNDRED;
+}
+//----------------------------------------------------------------------------
+// Function:	    int EstimateScheduleWindow(ScheduleRow* rows, 
+//						const double loanSize, const double paymentSize,
+//						const double interestRate, const int months,
+//						const int first, const int count)
+//
+// Description:		Estimates table rows first .. first + count - 1 without
+//					the rows before them: the loop starts from
+//					EstimateBalanceAt(first - 1), and interestToDate from
+//					EstimateInterestBetween(), so later rows carry their
+//					drift. A window that starts at month 1 is the table
+//					itself, bit for bit; the exact rows of a later window
+//					are those of GetSchedule().
+//
+// Parameters:	    (ScheduleRow*) rows           Receives up to count rows
+//				    const double   loanSize       Total size of loan
+//				    const double   paymentSize    Monthly payment amount
+//				    const double   interestRate   Annual interest rate
+//				    const int      months         Number of monthly payments
+//				    const int      first          First month wanted
+//				    const int      count          Number of rows wanted
+//
+// Returns:		    (int) rows   Number of rows written (fewer than count
+//								 when the window runs past the last month)
+// Date:            10/17/2026
+// Calls:		    EstimateBalanceAt(), EstimateInterestBetween(),
+//					FillScheduleRows()
+// History Log:     10/17/2026  added for random-access schedule queries
+//				    10/17/2026  renamed from GetScheduleWindow(), as its
+//								rows are estimates
+//----------------------------------------------------------------------------
+int EstimateScheduleWindow(ScheduleRow* rows, const double loanSize,
+	const double paymentSize, const double interestRate, const int months,
+	const int first, const int count)
+{
+	int from = (first < 1) ? 1 : first;
+	int filled = 0;
+	double before = 0;
+
+	if ((count <= 0) || (from > months))
+		return 0;
+	filled = FillScheduleRows(rows, EstimateBalanceAt(loanSize, paymentSize,
+		interestRate, months, from - 1), paymentSize, interestRate, months,
+		from, count);
+	if (from > 1)
+	{
+		before = EstimateInterestBetween(loanSize, paymentSize, interestRate,
+			months, 1, from - 1);
+		for (int i = 0; i < filled; i++)
+			rows[i].interestToDate += before;
+	}
+	return filled;
+}
+//----------------------------------------------------------------------------
+// Function:	    int EstimateScheduleTotals(ScheduleTotals* totals,
+//						const double loanSize, const double paymentSize,
+//						const double interestRate, const int months)
+//
+// Description:		Estimates the totals GetScheduleTotals() works out, in
+//					the same time for 6 months as for 6000. Every payment
+//					but the last is paymentSize and the last also pays off
+//					B(months), so
+//
+//						final = payment + B(months)
+//						paid  = (months - 1) * payment + final
+//
+//					the principal paid is the loan and the interest is the
+//					rest. The table's rounding drift (see above) moves the
+//					last payment and the interest by the same amount.
+//
+// Parameters:	    (ScheduleTotals*) totals         Receives the totals
+//				    const double      loanSize       Total size of loan
+//				    const double      paymentSize    Monthly payment amount
+//				    const double      interestRate   Annual interest rate
+//				    const int         months         Number of payments
+//
+// Returns:		    (int) months   Months summed, 0 if months <= 0
+// Date:            10/17/2026
+// Calls:		    roundInterest()
+// History Log:     10/17/2026  added to estimate totals without rows
+//----------------------------------------------------------------------------
+int EstimateScheduleTotals(ScheduleTotals* totals, const double loanSize,
+	const double paymentSize, const double interestRate, const int months)
+{
+	double rate = roundInterest(interestRate, 8) / MONTHLY_DIVISOR;
+	double finalPayment = 0;
+
+	memset(totals, 0, sizeof(ScheduleTotals));
+	if (months <= 0)
+		return 0;
+	finalPayment = paymentSize +
+		closedBalance(loanSize, paymentSize, rate, months);
+	totals->months = months;
+	totals->finalPayment = floor(finalPayment * HUNDRED + HALF) / HUNDRED;
+	totals->totalPaid = (months - 1) * paymentSize + totals->finalPayment;
+	totals->totalPrincipal = loanSize;
+	totals->totalInterest = totals->totalPaid - loanSize;
+	return months;
+}
@@ -0,0 +1,36 @@
+//----------------------------------------------------------------------------
+// File:			amort_query.h
+//
+// Description:     Header file for random-access schedule queries
+//					(amort_query.c). The balance after any payment and the
+//					interest paid over any run of months are estimated from
+//					the closed form of the annuity instead of the month by
+//					month loop, and any window of table rows can be
+//					estimated without the rows before it.
+//					EstimateScheduleTotals() estimates the totals of a table
+//					the same way. The table drifts from these by its
+//					rounding; its exact values come from GetSchedule(),
+//					ScheduleBalanceAt() and GetScheduleTotals().
+//
+// History Log:    10/17/2026  added for random-access schedule queries
+//				   10/17/2026  EstimateScheduleTotals()
+//				   10/17/2026  queries renamed Estimate*(), as the closed
+//							   form only estimates the table
+//----------------------------------------------------------------------------
+
+#ifndef AMORT_QUERY_H
+#define AMORT_QUERY_H
+#include "amort_schedule.h"
+
+double EstimateBalanceAt(const double loanSize, const double paymentSize,
+	const double interestRate, const int months, const int month);
+double EstimateInterestBetween(const double loanSize, const double paymentSize,
+	const double interestRate, const int months, const int first,
+	const int last);
+int EstimateScheduleWindow(ScheduleRow* rows, const double loanSize,
+	const double paymentSize, const double interestRate, const int months,
+	const int first, const int count);
+int EstimateScheduleTotals(ScheduleTotals* totals, const double loanSize,
+	const double paymentSize, const double interestRate, const int months);
+
+#endif
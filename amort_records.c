@@ -0,0 +1,152 @@
+//----------------------------------------------------------------------------
+// File:			amort_records.c
+//
+// Description      Mapped loan-record reader for the Amort library. Finds
+//					each line end with memchr() and hands the line, as a
+//					pointer and a length into the mapping, to
+//					ParseLoanText(). A record line longer than
+//					BATCH_LINE_MAX - 1 characters is bad, as it is for
+//					NextLoanRecord(), so both readers give the same records
+//					for the same file.
+//
+// Functions:	    int OpenRecordFile(RecordFile* file, const char* filename)
+//					int NextMappedRecord(RecordFile* file,
+//						LoanRecord* record)
+//					void ReportBadRecord(FILE* fp, const RecordFile* file)
+//					void CloseRecordFile(RecordFile* file)
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include "amort_records.h"
+
+//----------------------------------------------------------------------------
+// Function:	    int OpenRecordFile(RecordFile* file, const char* filename)
+//
+// Description:		Maps a file of loan records for NextMappedRecord(). An
+//					empty file opens, with no records.
+//
+// Parameters:	    (RecordFile*)   file       Receives the open file
+//				    const (char*)   filename   Name of the file
+//
+// Returns:		    (int) 1 on success, 0 if the file cannot be read
+// Date:            10/17/2026
+// Called By:       RunBatchMode(), main() of bench_records
+// Calls:		    MapFile()
+// History Log:     10/17/2026  added for the mapped record reader
+//----------------------------------------------------------------------------
+int OpenRecordFile(RecordFile* file, const char* filename)
+{
+	FILE* fp = NULL;
+	int empty = 0;
+
+	memset(file, 0, sizeof(RecordFile));
+	if (MapFile(&file->mapping, filename))
+		return 1;
+	if ((fp = fopen(filename, "rb")) == NULL)   // Not there, or empty?
+		return 0;
+	empty = (fgetc(fp) == EOF);
+	fclose(fp);
+	return empty;
+}
+//----------------------------------------------------------------------------
+// Function:	    int NextMappedRecord(RecordFile* file, LoanRecord* record)
+//
+// Description:		Parses the next line that holds a record, skipping
+//					blank and comment lines, and notes where it is. A
+//					record that breaks the input rules, or whose line is
+//					longer than BATCH_LINE_MAX - 1 characters, comes back
+//					with status BATCH_BAD_RECORD, see ReportBadRecord().
+//					Only the start of an over-long line is parsed, so one
+//					that starts with '#' is still a comment.
+//
+// Parameters:	    (RecordFile*)  file     File from OpenRecordFile()
+//				    (LoanRecord*)  record   Receives the parsed record
+//
+// Returns:		    (int) 1 if a record was read, 0 at the end of the file
+// Date:            10/17/2026
+// Called By:       RunBatchRecords(), main() of bench_records
+// Calls:		    ParseLoanText()
+// History Log:     10/17/2026  added for the mapped record reader
+//				    10/17/2026  over-long lines are bad records
+//----------------------------------------------------------------------------
+int NextMappedRecord(RecordFile* file, LoanRecord* record)
+{
+	const char* view = (const char*)file->mapping.view;
+	size_t size = file->mapping.size;
+
+	while (file->next < size)
+	{
+		const char* line = view + file->next;
+		const char* newline = (const char*)memchr(line, '\n',
+			size - file->next);
+		size_t length = (newline != NULL) ? (size_t)(newline - line) :
+			size - file->next;
+		size_t offset = file->next;
+
+		file->next = (newline != NULL) ? offset + length + 1 : size;
+		file->lines++;
+		if (ParseLoanText(line, (length > BATCH_LINE_MAX - 1) ?
+			BATCH_LINE_MAX - 1 : length, record))
+		{
+			if (length > BATCH_LINE_MAX - 1)
+				record->status = BATCH_BAD_RECORD;
+			file->offset = offset;
+			file->length = length;
+			file->line = file->lines;
+			return 1;
+		}
+	}
+	return 0;
+}
+//----------------------------------------------------------------------------
+// Function:	    void ReportBadRecord(FILE* fp, const RecordFile* file)
+//
+// Description:		Writes where the last record read is and its text:
+//
+//					    bad record at byte 1234 (line 56): 1000,abc,,6.5
+//
+//					Only the first BATCH_LINE_MAX - 1 characters of an
+//					over-long line are written, followed by "...".
+//
+// Parameters:	    (FILE*)               fp     Output stream
+//				    const (RecordFile*)   file   File the record came from
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       RunBatchRecords()
+// Calls:		    fprintf()
+// History Log:     10/17/2026  added for the mapped record reader
+//				    10/17/2026  over-long lines shortened
+//----------------------------------------------------------------------------
+void ReportBadRecord(FILE* fp, const RecordFile* file)
+{
+	size_t length = file->length;
+	const char* text = (const char*)file->mapping.view + file->offset;
+	int cut = (length > BATCH_LINE_MAX - 1);
+
+	if (cut)
+		length = BATCH_LINE_MAX - 1;
+	else if ((length > 0) && (text[length - 1] == '\r'))
+		length--;
+	fprintf(fp, "bad record at byte %llu (line %lld): %.*s%s\n",
+		(unsigned long long)file->offset, file->line, (int)length, text,
+		cut ? "..." : "");
+}
+//----------------------------------------------------------------------------
+// Function:	    void CloseRecordFile(RecordFile* file)
+//
+// Description:		Releases the mapping of a record file.
+//
+// Parameters:	    (RecordFile*) file   File to close
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       RunBatchMode(), main() of bench_records
+// Calls:		    UnmapFile()
+// History Log:     10/17/2026  added for the mapped record reader
+//----------------------------------------------------------------------------
+void CloseRecordFile(RecordFile* file)
+{
+	UnmapFile(&file->mapping);
+	memset(file, 0, sizeof(RecordFile));
+}
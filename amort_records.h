@@ -0,0 +1,39 @@
+//----------------------------------------------------------------------------
+// File:			amort_records.h
+//
+// Description:     Header file for the mapped loan-record reader
+//					(amort_records.c). Maps a CSV or TSV file of batch
+//					records (see amort_batch.h) and parses each line where
+//					it lies, with no copy and no stdio. Every record keeps
+//					the byte offset and number of its line, so a bad one is
+//					reported by where it is rather than asked for again.
+//					RunBatchRecords(), in amort_batch.c, prices such a file
+//					as RunBatch() prices a stream.
+//
+// History Log:    10/17/2026  added for the mapped record reader
+//----------------------------------------------------------------------------
+
+#ifndef AMORT_RECORDS_H
+#define AMORT_RECORDS_H
+#include <stdio.h>
+#include "amort_batch.h"
+#include "amort_platform.h"
+
+typedef struct
+{
+	AmortMapping mapping;           // Whole file; no view if it is empty
+	size_t next;                    // Offset of the next line to read
+	long long lines;                // Lines read so far
+	size_t offset;                  // Offset of the last record's line
+	size_t length;                  // Its length, without the line end
+	long long line;                 // Its line number, 1 based
+} RecordFile;
+
+int OpenRecordFile(RecordFile* file, const char* filename);
+int NextMappedRecord(RecordFile* file, LoanRecord* record);
+void ReportBadRecord(FILE* fp, const RecordFile* file);
+void CloseRecordFile(RecordFile* file);
+long long RunBatchRecords(RecordFile* file, FILE* out, int threads,
+	FILE* errors);                  // In amort_batch.c
+
+#endif
@@ -0,0 +1,225 @@
+//----------------------------------------------------------------------------
+// File:			amort_ring.c
+//
+// Description      Bounded lock-free rings for the Amort library. Slot
+//					position p of a ring is free for the push at position p
+//					when its sequence is p, and holds an item for the pop at
+//					position p when its sequence is p + 1; the pop then sets
+//					it to p + slots, handing the slot to the push one lap
+//					later. Producers sharing a ring claim positions by
+//					swapping the tail; a single producer or consumer owns
+//					its end outright.
+//
+// Functions:	    int InitRing(AmortRing* ring, size_t capacity)
+//					void FreeRing(AmortRing* ring)
+//					int TryPushRing(AmortRing* ring, void* item)
+//					int TryPushRingShared(AmortRing* ring, void* item)
+//					int TryPopRing(AmortRing* ring, void** item)
+//					void PushRing(AmortRing* ring, void* item,
+//						const int shared, long long* waits)
+//					void* PopRing(AmortRing* ring, long long* waits)
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include "amort_platform.h"
+#include "amort_ring.h"
+
+//----------------------------------------------------------------------------
+// Function:	    int InitRing(AmortRing* ring, size_t capacity)
+//
+// Description:		Allocates an empty ring of at least capacity slots,
+//					rounded up to a power of 2.
+//
+// Parameters:	    (AmortRing*) ring       Ring to set up
+//				    (size_t)     capacity   Items it must hold
+//
+// Returns:		    (int) 1 on success, 0 when out of memory
+// Date:            10/17/2026
+// Called By:       RunPipeline(), main() of bench_pipeline
+// Calls:		    AlignedAlloc()
+// History Log:     10/17/2026  added for the batch pipeline
+//----------------------------------------------------------------------------
+int InitRing(AmortRing* ring, size_t capacity)
+{
+	size_t slots = 1;
+
+	while (slots < capacity)
+		slots *= 2;
+	memset(ring, 0, sizeof(AmortRing));
+	ring->slots = (RingSlot*)AlignedAlloc(slots * sizeof(RingSlot),
+		RING_ALIGNMENT);
+	if (ring->slots == NULL)
+		return 0;
+	for (size_t i = 0; i < slots; i++)
+	{
+		ring->slots[i].sequence = i;
+		ring->slots[i].item = NULL;
+	}
+	ring->mask = slots - 1;
+	return 1;
+}
+//----------------------------------------------------------------------------
+// Function:	    void FreeRing(AmortRing* ring)
+//
+// Description:		Frees the slots of a ring. Items still in it are not
+//					touched.
+//
+// Parameters:	    (AmortRing*) ring   Ring to free
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       RunPipeline(), main() of bench_pipeline
+// Calls:		    AlignedFree()
+// History Log:     10/17/2026  added for the batch pipeline
+//----------------------------------------------------------------------------
+void FreeRing(AmortRing* ring)
+{
+	AlignedFree(ring->slots);
+	ring->slots = NULL;
+}
+//----------------------------------------------------------------------------
+// Function:	    int TryPushRing(AmortRing* ring, void* item)
+//
+// Description:		Adds an item for the consumer, for a ring with one
+//					producer.
+//
+// Parameters:	    (AmortRing*) ring   Ring to add to
+//				    (void*)      item   Item, which may be NULL
+//
+// Returns:		    (int) 1 if added, 0 if the ring is full
+// Date:            10/17/2026
+// Called By:       PushRing()
+// Calls:		    LoadCounter(), StoreCounter()
+// History Log:     10/17/2026  added for the batch pipeline
+//----------------------------------------------------------------------------
+int TryPushRing(AmortRing* ring, void* item)
+{
+	size_t tail = ring->tail;
+	RingSlot* slot = &ring->slots[tail & ring->mask];
+
+	if (LoadCounter(&slot->sequence) != tail)
+		return 0;
+	slot->item = item;
+	StoreCounter(&slot->sequence, tail + 1);
+	ring->tail = tail + 1;
+	return 1;
+}
+//----------------------------------------------------------------------------
+// Function:	    int TryPushRingShared(AmortRing* ring, void* item)
+//
+// Description:		Adds an item for the consumer, for a ring several
+//					producers push to at once. A producer that loses the
+//					race for a position tries the next one.
+//
+// Parameters:	    (AmortRing*) ring   Ring to add to
+//				    (void*)      item   Item, which may be NULL
+//
+// Returns:		    (int) 1 if added, 0 if the ring is full
+// Date:            10/17/2026
+// Called By:       PushRing()
+// Calls:		    LoadCounter(), StoreCounter(), SwapCounter()
+// History Log:     10/17/2026  added for the batch pipeline
+//----------------------------------------------------------------------------
+int TryPushRingShared(AmortRing* ring, void* item)
+{
+	for (;;)
+	{
+		size_t tail = LoadCounter(&ring->tail);
+		RingSlot* slot = &ring->slots[tail & ring->mask];
+		size_t sequence = LoadCounter(&slot->sequence);
+
+		if (sequence == tail)
+		{
+			if (SwapCounter(&ring->tail, tail, tail + 1))
+			{
+				slot->item = item;
+				StoreCounter(&slot->sequence, tail + 1);
+				return 1;
+			}
+		}
+		else if (sequence < tail)       // Not yet popped a lap ago: full
+			return 0;
+	}
+}
+//----------------------------------------------------------------------------
+// Function:	    int TryPopRing(AmortRing* ring, void** item)
+//
+// Description:		Takes the oldest item of a ring, for its one consumer.
+//
+// Parameters:	    (AmortRing*) ring   Ring to take from
+//				    (void**)     item   Receives the item
+//
+// Returns:		    (int) 1 if taken, 0 if the ring is empty
+// Date:            10/17/2026
+// Called By:       PopRing()
+// Calls:		    LoadCounter(), StoreCounter()
+// History Log:     10/17/2026  added for the batch pipeline
+//----------------------------------------------------------------------------
+int TryPopRing(AmortRing* ring, void** item)
+{
+	size_t head = ring->head;
+	RingSlot* slot = &ring->slots[head & ring->mask];
+
+	if (LoadCounter(&slot->sequence) != head + 1)
+		return 0;
+	*item = slot->item;
+	StoreCounter(&slot->sequence, head + ring->mask + 1);
+	ring->head = head + 1;
+	return 1;
+}
+//----------------------------------------------------------------------------
+// Function:	    void PushRing(AmortRing* ring, void* item,
+//						const int shared, long long* waits)
+//
+// Description:		Adds an item, yielding the CPU for as long as the ring
+//					is full.
+//
+// Parameters:	    (AmortRing*)  ring     Ring to add to
+//				    (void*)       item     Item, which may be NULL
+//				    const (int)   shared   1 if other producers push too
+//				    (long long*)  waits    Counts the yields, or NULL
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       RunPipeline() and its stages
+// Calls:		    TryPushRing(), TryPushRingShared(), YieldThread()
+// History Log:     10/17/2026  added for the batch pipeline
+//----------------------------------------------------------------------------
+void PushRing(AmortRing* ring, void* item, const int shared,
+	long long* waits)
+{
+	while (shared ? !TryPushRingShared(ring, item) :
+		!TryPushRing(ring, item))
+	{
+		if (waits != NULL)
+			(*waits)++;
+		YieldThread();
+	}
+}
+//----------------------------------------------------------------------------
+// Function:	    void* PopRing(AmortRing* ring, long long* waits)
+//
+// Description:		Takes the oldest item, yielding the CPU for as long as
+//					the ring is empty.
+//
+// Parameters:	    (AmortRing*)  ring    Ring to take from
+//				    (long long*)  waits   Counts the yields, or NULL
+//
+// Returns:		    (void*) item   The item
+// Date:            10/17/2026
+// Called By:       RunPipeline() and its stages
+// Calls:		    TryPopRing(), YieldThread()
+// History Log:     10/17/2026  added for the batch pipeline
+//----------------------------------------------------------------------------
+void* PopRing(AmortRing* ring, long long* waits)
+{
+	void* item = NULL;
+
+	while (!TryPopRing(ring, &item))
+	{
+		if (waits != NULL)
+			(*waits)++;
+		YieldThread();
+	}
+	return item;
+}
@@ -0,0 +1,50 @@
+//----------------------------------------------------------------------------
+// File:			amort_ring.h
+//
+// Description:     Header file for the bounded lock-free rings
+//					(amort_ring.c) that join the stages of the batch
+//					pipeline. A ring holds a power of 2 number of pointers.
+//					Every slot carries a sequence number that says whose
+//					turn it is, so a push and a pop never take a lock: one
+//					producer and one consumer (SPSC) use TryPushRing(), and
+//					several producers feeding one consumer (MPSC) use
+//					TryPushRingShared(). The two must not be mixed on one
+//					ring, and there is only ever one consumer. PushRing()
+//					and PopRing() wait, giving the CPU away, while the ring
+//					is full or empty: a full ring holds its producer back.
+//
+// History Log:    10/17/2026  added for the batch pipeline
+//----------------------------------------------------------------------------
+
+#ifndef AMORT_RING_H
+#define AMORT_RING_H
+#include <stddef.h>
+
+#define RING_ALIGNMENT 64           // Cache line
+
+typedef struct
+{
+	volatile size_t sequence;       // Position that may use the slot next
+	void* item;
+} RingSlot;
+
+typedef struct
+{
+	RingSlot* slots;
+	size_t mask;                    // Slots - 1
+	char gap1[RING_ALIGNMENT];      // Producers and consumer apart
+	volatile size_t tail;           // Next position to push
+	char gap2[RING_ALIGNMENT];
+	volatile size_t head;           // Next position to pop
+} AmortRing;
+
+int InitRing(AmortRing* ring, size_t capacity);
+void FreeRing(AmortRing* ring);
+int TryPushRing(AmortRing* ring, void* item);
+int TryPushRingShared(AmortRing* ring, void* item);
+int TryPopRing(AmortRing* ring, void** item);
+void PushRing(AmortRing* ring, void* item, const int shared,
+	long long* waits);
+void* PopRing(AmortRing* ring, long long* waits);
+
+#endif
@@ -0,0 +1,537 @@
+//----------------------------------------------------------------------------
+// File:			amort_schedule.c
+//
+// Description      Shared schedule generator for the Amort library. One
+//					loop builds every row of an amortization table into an
+//					arena. GetSchedule() keeps the last table it built, so
+//					showing a table and saving it work it out only once.
+//					GetScheduleTotals() gives the totals of a table, the
+//					same to the last bit, without building its rows.
+//
+// Functions:	    int FillScheduleRows(ScheduleRow* rows, double loanBalance,
+//						const double paymentSize, const double interestRate,
+//						const int months, const int first, const int count)
+//					int BuildSchedule(Schedule* schedule, ScheduleArena* arena,
+//						const double loanSize, const double paymentSize,
+//						const double interestRate, const int months)
+//					int GetScheduleTotals(ScheduleTotals* totals,
+//						const double loanSize, const double paymentSize,
+//						const double interestRate, const int months)
+//					const Schedule* GetSchedule(const double loanSize,
+//						const double paymentSize, const double interestRate,
+//						const int months)
+//					void ClearScheduleCache(void)
+//					int SetScheduleEngine(const int engine)
+//					int GetScheduleEngine(void)
+//					long long GetCrossCheckMismatches(void)
+//					double ScheduleBalanceAt(const Schedule* schedule,
+//						const int month)
+//					double ScheduleInterestBetween(const Schedule* schedule,
+//						const int first, const int last)
+//					double RoundCents(const double amount)
+//					double MonthInterest(const double loanBalance,
+//						const double roundedInterest)
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include "amort.h"
+#include "amort_cents.h"
+#include "amort_metrics.h"
+#include "amort_platform.h"
+#include "amort_schedule.h"
+
+#define CENTS_CHUNK 256             // Cents rows converted per pass
+
+static Schedule cachedSchedule;
+static ScheduleArena cacheArena;
+static int cacheValid = 0;
+static int scheduleEngine = ENGINE_DOUBLE;
+static volatile size_t crossCheckMismatches = 0;   // Added from any thread
+
+// FillScheduleRows() for ENGINE_CENTS: the rows of FillCentsRows() in dollars.
+// Like FillCentsRows() it may stop early, where the amounts or the interest
+// to date grow too large for whole cents.
+static int fillFromCents(ScheduleRow* rows, const double loanBalance,
+	const double paymentSize, const double interestRate, const int months,
+	const int first, const int count)
+{
+	CentsRow chunk[CENTS_CHUNK];
+	Cents balance = ToCents(loanBalance);
+	Cents payment = ToCents(paymentSize);
+	Cents interestToDate = 0;
+	int eighths = RateToEighths(interestRate);
+	int filled = 0;
+	int part = 0;
+
+	do
+	{
+		part = (count - filled < CENTS_CHUNK) ? count - filled : CENTS_CHUNK;
+		part = FillCentsRows(chunk, balance, payment, eighths, months,
+			first + filled, part);
+		for (int i = 0; i < part; i++)
+		{
+			ScheduleRow* row = &rows[filled + i];
+
+			if ((interestToDate > MAX_CENTS_TO_DATE) ||
+				(interestToDate < -MAX_CENTS_TO_DATE))
+				return filled + i;
+			interestToDate += chunk[i].interest;
+			row->month = chunk[i].month;
+			row->payment = (double)chunk[i].payment / HUNDRED;
+			row->principal = (double)chunk[i].principal / HUNDRED;
+			row->interest = (double)chunk[i].interest / HUNDRED;
+			row->balance = (double)chunk[i].balance / HUNDRED;
+			row->interestToDate = (double)interestToDate / HUNDRED;
+		}
+		if (part > 0)
+			balance = chunk[part - 1].balance;
+		filled += part;
+	} while (part == CENTS_CHUNK);
+	return filled;
+}
+
+// One month of the double loop: the interest on *loanBalance from
+// MonthInterest(), the rest of the payment off the balance and, in the last
+// month, whatever balance is left added to the payment. Fills row except for
+// interestToDate. FillScheduleRows() and GetScheduleTotals() both step
+// with it, so their sums match bit for bit.
+static inline void stepMonth(ScheduleRow* row, double* loanBalance,
+	double* payment, const double roundedInterest, const int month,
+	const int months)
+{
+	double interestPaid = MonthInterest(*loanBalance, roundedInterest);
+	double principalPaid = *payment - interestPaid;
+
+	*loanBalance -= principalPaid;
+	if ((month == months) && (*loanBalance != 0))   //adjust last payment
+	{
+		*payment += *loanBalance;
+		principalPaid += *loanBalance;
+		*loanBalance -= *loanBalance;
+	}
+	row->month = month;
+	row->payment = *payment;
+	row->principal = principalPaid;
+	row->interest = interestPaid;
+	row->balance = *loanBalance;
+}
+//----------------------------------------------------------------------------
+// Function:	    int FillScheduleRows(ScheduleRow* rows, double loanBalance,
+//						const double paymentSize, const double interestRate,
+//						const int months, const int first, const int count)
+//
+// Description:		The amortization loop. Works out rows first .. first +
+//					count - 1 (stopping after month 'months') of a loan whose
+//					balance before month 'first' is loanBalance. Monthly
+//					payment is broken down into interest (rounded to the
+//					cent) and principal, each row is subtracted from the
+//					running loan balance and the last payment takes up
+//					whatever balance is left. interestToDate counts from
+//					month 'first'. SetScheduleEngine() picks the double loop
+//					below or the integer cents engine; rates over
+//					MAX_CENTS_RATE and amounts CentsAmountFits() refuses
+//					always use the double loop and are not cross-checked.
+//
+// Parameters:	    (ScheduleRow*)  rows           Receives the rows
+//				    (double)        loanBalance    Balance before month first
+//				    const double    paymentSize    Monthly payment amount
+//				    const double    interestRate   Annual interest rate
+//				    const int       months         Number of monthly payments
+//				    const int       first          First month to work out
+//				    const int       count          Number of rows wanted
+//
+// Returns:		    (int) rows   Number of rows written
+// Date:            10/17/2026
+// Called By:       BuildSchedule(), EstimateScheduleWindow()
+// Calls:		    roundInterest(), stepMonth(), FillCentsRows(),
+//					CrossCheckRows(), CountMetric(), AddCounter(),
+//					CentsRateFits(), CentsAmountFits()
+// History Log:     10/17/2026  loop moved here from DisplayTable() and
+//								SaveTable()
+//				    10/17/2026  integer cents engine and cross-check
+//				    10/17/2026  counts the rows as METRIC_ROWS
+//				    10/17/2026  cross-check count added with AddCounter(),
+//								as worker threads build tables too
+//				    10/17/2026  cents engine only up to MAX_CENTS_RATE
+//				    10/17/2026  month worked out by stepMonth()
+//				    10/17/2026  cents engine only for amounts that fit
+//----------------------------------------------------------------------------
+int FillScheduleRows(ScheduleRow* rows, double loanBalance,
+	const double paymentSize, const double interestRate, const int months,
+	const int first, const int count)
+{
+	const double startBalance = loanBalance;
+	double payment = paymentSize;
+	double interestToDate = 0;
+	double roundedInterest = roundInterest(interestRate, 8);
+	int last = (count > months - first + 1) ? months : first + count - 1;
+	int filled = (last >= first) ? last - first + 1 : 0;
+	ScheduleRow* row = rows;
+	int cents = CentsRateFits(interestRate) &&
+		CentsAmountFits(loanBalance, paymentSize);
+	int done = 0;
+
+	if ((scheduleEngine == ENGINE_CENTS) && cents)
+	{
+		done = fillFromCents(rows, loanBalance, paymentSize, interestRate,
+			months, first, filled);
+		if (done > 0)           // The double loop goes on from there
+		{
+			loanBalance = rows[done - 1].balance;
+			interestToDate = rows[done - 1].interestToDate;
+			row += done;
+		}
+	}
+	for (int i = first + done; i <= last; i++, row++)
+	{
+		stepMonth(row, &loanBalance, &payment, roundedInterest, i, months);
+		interestToDate += row->interest;
+		row->interestToDate = interestToDate;
+	}
+	if ((scheduleEngine == ENGINE_CROSSCHECK) && cents && (filled > 0))
+		AddCounter(&crossCheckMismatches, (size_t)CrossCheckRows(rows,
+			filled, startBalance, paymentSize, interestRate, months));
+	CountMetric(METRIC_ROWS, filled);
+	return filled;
+}
+//----------------------------------------------------------------------------
+// Function:	    int BuildSchedule(Schedule* schedule, ScheduleArena* arena,
+//						const double loanSize, const double paymentSize,
+//						const double interestRate, const int months)
+//
+// Description:		Builds the whole amortization table of a loan with
+//					FillScheduleRows() and adds up its columns. The rows are
+//					allocated from arena; they stay valid until the arena is
+//					reset.
+//
+// Parameters:	    (Schedule*)      schedule       Receives the table
+//				    (ScheduleArena*) arena          Holds the rows
+//				    const double     loanSize       Total size of loan
+//				    const double     paymentSize    Monthly payment amount
+//				    const double     interestRate   Annual interest rate
+//				    const int        months         Number of monthly payments
+//
+// Returns:		    (int) 1 on success, 0 if arena has no room for the rows
+// Date:            10/17/2026
+// Called By:       GetSchedule()
+// Calls:		    FillScheduleRows(), ArenaAlloc(), StartMetricTimer(),
+//					StopMetricTimer()
+// History Log:     10/17/2026  added for the shared schedule generator
+//				    10/17/2026  timed as TIMER_SCHEDULE
+//----------------------------------------------------------------------------
+int BuildSchedule(Schedule* schedule, ScheduleArena* arena,
+	const double loanSize, const double paymentSize,
+	const double interestRate, const int months)
+{
+	double start = 0;
+
+	memset(schedule, 0, sizeof(Schedule));
+	schedule->loanSize = loanSize;
+	schedule->paymentSize = paymentSize;
+	schedule->interestRate = interestRate;
+	if (months <= 0)
+		return 1;
+	schedule->rows = 
+		(ScheduleRow*)ArenaAlloc(arena, (size_t)months * sizeof(ScheduleRow));
+	if (schedule->rows == NULL)
+		return 0;
+	start = StartMetricTimer(TIMER_SCHEDULE);
+	schedule->months = FillScheduleRows(schedule->rows, loanSize,
+		paymentSize, interestRate, months, 1, months);
+	for (int i = 0; i < months; i++)
+	{
+		schedule->totalPaid += schedule->rows[i].payment;
+		schedule->totalPrincipal += schedule->rows[i].principal;
+		schedule->totalInterest += schedule->rows[i].interest;
+	}
+	StopMetricTimer(TIMER_SCHEDULE, start);
+	return 1;
+}
+//----------------------------------------------------------------------------
+// Function:	    int GetScheduleTotals(ScheduleTotals* totals,
+//						const double loanSize, const double paymentSize,
+//						const double interestRate, const int months)
+//
+// Description:		Works out the total paid, principal and interest of a
+//					loan's table and its adjusted last payment with the
+//					arithmetic of FillScheduleRows() for the selected engine,
+//					so they match BuildSchedule() bit for bit, but keeps no
+//					rows: no arena, no cache and nothing written per month.
+//					Each month's interest is rounded to the cent and the
+//					rounding carries into every later month, so no closed
+//					form gives these exactly (see amort_query.c); this is
+//					the month by month loop with nothing else in it.
+//
+// Parameters:	    (ScheduleTotals*) totals         Receives the totals
+//				    const double      loanSize       Total size of loan
+//				    const double      paymentSize    Monthly payment amount
+//				    const double      interestRate   Annual interest rate
+//				    const int         months         Number of payments
+//
+// Returns:		    (int) months   Months summed, 0 if months <= 0
+// Date:            10/17/2026
+// Called By:       PrintResults()
+// Calls:		    stepMonth(), SumCentsRows(), roundInterest(),
+//					CentsRateFits(), CentsAmountFits()
+// History Log:     10/17/2026  added for exact totals without rows
+//				    10/17/2026  steps with FillScheduleRows()'s stepMonth()
+//								and the cents engine's SumCentsRows()
+//				    10/17/2026  cents engine only for amounts that fit
+//----------------------------------------------------------------------------
+int GetScheduleTotals(ScheduleTotals* totals, const double loanSize,
+	const double paymentSize, const double interestRate, const int months)
+{
+	double loanBalance = loanSize;
+	double payment = paymentSize;
+	double roundedInterest = roundInterest(interestRate, 8);
+	ScheduleRow row;
+	int done = 0;
+
+	memset(totals, 0, sizeof(ScheduleTotals));
+	if (months <= 0)
+		return 0;
+	totals->months = months;
+	if ((scheduleEngine == ENGINE_CENTS) && CentsRateFits(interestRate) &&
+		CentsAmountFits(loanSize, paymentSize))
+	{
+		Cents balance = ToCents(loanSize);
+
+		done = SumCentsRows(totals, &balance, ToCents(paymentSize),
+			RateToEighths(interestRate), months);
+		loanBalance = (double)balance / HUNDRED;    // Double loop goes on
+	}
+	for (int i = done + 1; i <= months; i++)
+	{
+		stepMonth(&row, &loanBalance, &payment, roundedInterest, i, months);
+		totals->totalPaid += row.payment;
+		totals->totalPrincipal += row.principal;
+		totals->totalInterest += row.interest;
+	}
+	if (done < months)
+		totals->finalPayment = payment;
+	return months;
+}
+//----------------------------------------------------------------------------
+// Function:	    const Schedule* GetSchedule(const double loanSize,
+//						const double paymentSize, const double interestRate,
+//						const int months)
+//
+// Description:		Returns the table of a loan, building it only if the last
+//					call was for a different loan. The table stays valid
+//					until the next call with other inputs. Not for use from
+//					more than one thread; give each thread its own arena and
+//					call BuildSchedule() instead.
+//
+// Parameters:	    const double  loanSize       Total size of loan
+//				    const double  paymentSize    Monthly payment amount
+//				    const double  interestRate   Annual interest rate
+//				    const int     months         Number of monthly payments
+//
+// Returns:		    (const Schedule*) schedule   The table, or NULL when out
+//												 of memory
+// Date:            10/17/2026
+// Called By:       DisplayTable(), SaveTable()
+// Calls:		    BuildSchedule(), InitArena(), ResetArena(), FreeArena()
+// History Log:     10/17/2026  added for the shared schedule generator
+//----------------------------------------------------------------------------
+const Schedule* GetSchedule(const double loanSize, const double paymentSize,
+	const double interestRate, const int months)
+{
+	size_t needed = (months > 0) ? (size_t)months * sizeof(ScheduleRow) : 0;
+
+	if (cacheValid && (cachedSchedule.loanSize == loanSize) &&
+		(cachedSchedule.paymentSize == paymentSize) &&
+		(cachedSchedule.interestRate == interestRate) &&
+		(cachedSchedule.months == ((months > 0) ? months : 0)))
+		return &cachedSchedule;
+
+	cacheValid = 0;
+	if (needed > cacheArena.size)
+	{
+		FreeArena(&cacheArena);
+		if (!InitArena(&cacheArena,
+			(needed > SCHEDULE_ARENA) ? needed : SCHEDULE_ARENA))
+			return NULL;
+	}
+	ResetArena(&cacheArena);
+	if (!BuildSchedule(&cachedSchedule, &cacheArena, loanSize, paymentSize,
+		interestRate, months))
+		return NULL;
+	cacheValid = 1;
+	return &cachedSchedule;
+}
+//----------------------------------------------------------------------------
+// Function:	    void ClearScheduleCache(void)
+//
+// Description:		Forgets the table kept by GetSchedule() and releases its
+//					arena.
+//
+// Parameters:	    none
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Calls:		    FreeArena()
+// History Log:     10/17/2026  added for the shared schedule generator
+//----------------------------------------------------------------------------
+void ClearScheduleCache(void)
+{
+	cacheValid = 0;
+	FreeArena(&cacheArena);
+	memset(&cachedSchedule, 0, sizeof(Schedule));
+}
+//----------------------------------------------------------------------------
+// Function:	    int SetScheduleEngine(const int engine)
+//
+// Description:		Picks how FillScheduleRows() works out rows from now on:
+//					ENGINE_DOUBLE (the double loop of version 1.0),
+//					ENGINE_CENTS (integer cents) or ENGINE_CROSSCHECK (the
+//					double loop, with every row compared against integer
+//					cents; see GetCrossCheckMismatches()). The table kept by
+//					GetSchedule() is dropped.
+//
+// Parameters:	    const (int) engine   ENGINE_DOUBLE, ENGINE_CENTS or
+//										 ENGINE_CROSSCHECK
+//
+// Returns:		    (int) engine   The engine now in use
+// Date:            10/17/2026
+// Called By:       main()
+// History Log:     10/17/2026  added for the integer cents engine
+//----------------------------------------------------------------------------
+int SetScheduleEngine(const int engine)
+{
+	if ((engine >= ENGINE_DOUBLE) && (engine <= ENGINE_CROSSCHECK))
+		scheduleEngine = engine;
+	StoreCounter(&crossCheckMismatches, 0);
+	cacheValid = 0;
+	return scheduleEngine;
+}
+//----------------------------------------------------------------------------
+// Function:	    int GetScheduleEngine(void)
+//
+// Description:		Returns the engine set by SetScheduleEngine().
+//
+// Parameters:	    none
+//
+// Returns:		    (int) engine   ENGINE_DOUBLE, ENGINE_CENTS or
+//								   ENGINE_CROSSCHECK
+// Date:            10/17/2026
+// History Log:     10/17/2026  added for the integer cents engine
+//----------------------------------------------------------------------------
+int GetScheduleEngine(void)
+{
+	return scheduleEngine;
+}
+//----------------------------------------------------------------------------
+// Function:	    long long GetCrossCheckMismatches(void)
+//
+// Description:		Returns how many rows built under ENGINE_CROSSCHECK
+//					differed from the integer cents engine by a cent or more
+//					since the engine was set.
+//
+// Parameters:	    none
+//
+// Returns:		    (long long) mismatches   Rows that differed
+// Date:            10/17/2026
+// Called By:       main()
+// Calls:		    LoadCounter()
+// History Log:     10/17/2026  added for the integer cents engine
+//----------------------------------------------------------------------------
+long long GetCrossCheckMismatches(void)
+{
+	return (long long)LoadCounter(&crossCheckMismatches);
+}
+//----------------------------------------------------------------------------
+// Function:	    double ScheduleBalanceAt(const Schedule* schedule,
+//											 const int month)
+//
+// Description:		Returns the balance after payment 'month' of a built
+//					table: exactly the table's value, in constant time.
+//
+// Parameters:	    const (Schedule*) schedule   Table from GetSchedule()
+//				    const (int)       month      Payments made
+//
+// Returns:		    (double) balance   Loan balance (the loan size for month
+//									   0, 0 past the last month)
+// Date:            10/17/2026
+// History Log:     10/17/2026  added for random-access schedule queries
+//----------------------------------------------------------------------------
+double ScheduleBalanceAt(const Schedule* schedule, const int month)
+{
+	if (month <= 0)
+		return schedule->loanSize;
+	if (month > schedule->months)
+		return 0;
+	return schedule->rows[month - 1].balance;
+}
+//----------------------------------------------------------------------------
+// Function:	    double ScheduleInterestBetween(const Schedule* schedule,
+//						const int first, const int last)
+//
+// Description:		Returns the interest paid in months first .. last of a
+//					built table (inclusive, clipped to the table) from the
+//					interestToDate column, in constant time.
+//
+// Parameters:	    const (Schedule*) schedule   Table from GetSchedule()
+//				    const (int)       first      First month of the range
+//				    const (int)       last       Last month of the range
+//
+// Returns:		    (double) interest   Interest paid, rounded to the cent
+// Date:            10/17/2026
+// History Log:     10/17/2026  added for random-access schedule queries
+//----------------------------------------------------------------------------
+double ScheduleInterestBetween(const Schedule* schedule, const int first,
+	const int last)
+{
+	int from = (first < 1) ? 1 : first;
+	int to = (last > schedule->months) ? schedule->months : last;
+	double interest = 0;
+
+	if (to < from)
+		return 0;
+	interest = schedule->rows[to - 1].interestToDate -
+		((from > 1) ? schedule->rows[from - 2].interestToDate : 0);
+	return RoundCents(interest);
+}
+//----------------------------------------------------------------------------
+// Function:	    double RoundCents(const double amount)
+//
+// Description:		Rounds an amount to the nearest cent, half a cent up.
+//
+// Parameters:	    const double  amount   Amount in dollars
+//
+// Returns:		    (double) amount   Rounded to the cent
+// Date:            10/17/2026
+// Called By:       MonthInterest(), ScheduleInterestBetween(),
+//					SimulatePrepayment(), PriceArm()
+// History Log:     10/17/2026  taken out of amort_prepay.c and amort_arm.c
+//----------------------------------------------------------------------------
+double RoundCents(const double amount)
+{
+	return floor(amount * HUNDRED + HALF) / HUNDRED;
+}
+//----------------------------------------------------------------------------
+// Function:	    double MonthInterest(const double loanBalance,
+//						const double roundedInterest)
+//
+// Description:		The interest of one month on loanBalance, rounded to
+//					the cent. Every double loop (FillScheduleRows(),
+//					GetScheduleTotals(), FillPrepaymentRows(),
+//					FillArmRows()) takes its interest from here, so with
+//					the same balance and rate they round alike; each keeps
+//					only its own payment, lump sum and reset handling.
+//
+// Parameters:	    const double  loanBalance       Balance before the month
+//				    const double  roundedInterest   Annual rate, rounded by
+//													roundInterest()
+//
+// Returns:		    (double) interest   Interest of the month
+// Date:            10/17/2026
+// Called By:       stepMonth(), FillPrepaymentRows(), FillArmRows()
+// Calls:		    RoundCents()
+// History Log:     10/17/2026  taken out of stepMonth() so the prepayment
+//								and ARM loops round the same way
+//----------------------------------------------------------------------------
+double MonthInterest(const double loanBalance, const double roundedInterest)
+{
+	return RoundCents(loanBalance * (roundedInterest / MONTHLY_DIVISOR));
+}
@@ -0,0 +1,80 @@
+//----------------------------------------------------------------------------
+// File:			amort_schedule.h
+//
+// Description:     Header file for the shared schedule generator
+//					(amort_schedule.c). The amortization loop that used to be
+//					copied into DisplayTable() and SaveTable() lives here and
+//					builds all rows of a loan once, into an arena. Screen
+//					output, file output and PrintResults() totals all read
+//					the same rows.
+//
+// History Log:    10/17/2026  added for the shared schedule generator
+//				   10/17/2026  FillScheduleRows() builds any run of rows
+//				   10/17/2026  integer cents engine selectable at run time
+//				   10/17/2026  GetScheduleTotals() sums a table without its
+//							   rows
+//				   10/17/2026  RoundCents() and MonthInterest() shared by
+//							   every double loop
+//----------------------------------------------------------------------------
+
+#ifndef AMORT_SCHEDULE_H
+#define AMORT_SCHEDULE_H
+#include "amort_arena.h"
+
+#define SCHEDULE_ARENA (FIVE_HUNDRED_YEARS * sizeof(ScheduleRow))
+#define ENGINE_DOUBLE 0             // The double loop of version 1.0
+#define ENGINE_CENTS 1              // Integer cents, see amort_cents.h
+#define ENGINE_CROSSCHECK 2         // Double loop, checked against cents
+
+typedef struct
+{
+	int month;                      // 1 based month number
+	double payment;                 // Payment made (last one adjusted)
+	double principal;               // Principal paid
+	double interest;                // Interest paid
+	double balance;                 // Loan balance after the payment
+	double interestToDate;          // Interest paid in months 1 .. month
+} ScheduleRow;
+
+typedef struct
+{
+	double loanSize;                // Inputs the rows were built from
+	double paymentSize;
+	double interestRate;
+	int months;
+	ScheduleRow* rows;              // rows[0] is month 1; months rows
+	double totalPaid;               // Sum of the row columns
+	double totalPrincipal;
+	double totalInterest;
+} Schedule;
+
+typedef struct
+{
+	int months;                     // Months summed
+	double totalPaid;               // As BuildSchedule() adds them up
+	double totalPrincipal;
+	double totalInterest;
+	double finalPayment;            // Last payment, adjusted
+} ScheduleTotals;
+
+int FillScheduleRows(ScheduleRow* rows, double loanBalance,
+	const double paymentSize, const double interestRate, const int months,
+	const int first, const int count);
+int BuildSchedule(Schedule* schedule, ScheduleArena* arena,
+	const double loanSize, const double paymentSize,
+	const double interestRate, const int months);
+int GetScheduleTotals(ScheduleTotals* totals, const double loanSize,
+	const double paymentSize, const double interestRate, const int months);
+const Schedule* GetSchedule(const double loanSize, const double paymentSize,
+	const double interestRate, const int months);
+void ClearScheduleCache(void);
+int SetScheduleEngine(const int engine);
+int GetScheduleEngine(void);
+long long GetCrossCheckMismatches(void);
+double ScheduleBalanceAt(const Schedule* schedule, const int month);
+double ScheduleInterestBetween(const Schedule* schedule, const int first,
+	const int last);
+double RoundCents(const double amount);
+double MonthInterest(const double loanBalance, const double roundedInterest);
+
+#endif
@@ -0,0 +1,643 @@
+//----------------------------------------------------------------------------
+// File:			amort_server.c
+//
+// Description      Local calculation server for the Amort library. One
+//					thread accepts connections and gives each its own
+//					thread, which reads request lines, queues the record
+//					lines and waits for their answers. Worker threads take
+//					whatever the connections have queued, up to
+//					SERVER_BATCH_MAX records at a time, solve the rate
+//					records of the batch together with SolveInterestRates()
+//					and the rest with PriceLoanRecord(). The time from
+//					queueing to answer of every record goes into a
+//					microsecond histogram for the STATS request.
+//
+// Functions:	    int StartServer(AmortServer* server,
+//						const char* endpoint, int workers)
+//					void StopServer(AmortServer* server)
+//					void GetServerStats(AmortServer* server,
+//						ServerStats* stats)
+//					int RunServer(const char* endpoint, int workers)
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include "amort.h"
+#include "amort_metrics.h"
+#include "amort_schedule.h"
+#include "amort_server.h"
+#include "amort_solver.h"
+#include "amort_writer.h"
+
+#define SERVER_LINE_MAX 512         // Longest reply line but a table row
+
+static const AmortLock unlocked = AMORT_LOCK_INIT;
+static const AmortCondition idle = AMORT_CONDITION_INIT;
+
+struct ServerClient
+{
+	AmortServer* server;
+	AmortSocket socket;             // AMORT_NO_SOCKET once closed
+	AmortThread thread;
+	int finished;                   // Thread is done, join it
+	AmortCondition answered;        // remaining went to 0
+	size_t remaining;               // Queued records not yet answered
+	size_t output;                  // Bytes waiting in reply
+	int open;                       // 0 after QUIT, SHUTDOWN or an error
+	ServerRequest requests[SERVER_PIPELINE];
+	char input[SERVER_BUFFER + 1];
+	char reply[SERVER_BUFFER];
+	ScheduleRow rows[FIVE_HUNDRED_YEARS];
+};
+
+typedef struct
+{
+	int months[SERVER_BATCH_MAX];   // Columns for SolveInterestRates()
+	double principal[SERVER_BATCH_MAX];
+	double payment[SERVER_BATCH_MAX];
+	double rates[SERVER_BATCH_MAX];
+	int status[SERVER_BATCH_MAX];
+	size_t index[SERVER_BATCH_MAX]; // Batch entry of each column entry
+} RateColumns;
+
+// Sends the buffered replies of a connection.
+static void flushReply(ServerClient* client)
+{
+	if ((client->output > 0) &&
+		!WriteSocket(client->socket, client->reply, client->output))
+		client->open = 0;
+	client->output = 0;
+}
+
+// Makes room for a reply of up to size bytes and returns where it goes.
+static char* replySpace(ServerClient* client, const size_t size)
+{
+	if (client->output + size > SERVER_BUFFER)
+		flushReply(client);
+	return client->reply + client->output;
+}
+
+// Prices one batch: the rate records together, the rest one at a time.
+static void priceBatch(ServerRequest** batch, const size_t count,
+	RateColumns* columns)
+{
+	size_t solving = 0;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		LoanRecord* record = &batch[i]->record;
+
+		if ((record->status == BATCH_OK) && (record->unknown == 'I'))
+		{
+			columns->index[solving] = i;
+			columns->months[solving] = record->months;
+			columns->principal[solving] = record->loanSize;
+			columns->payment[solving] = record->paymentSize;
+			solving++;
+		}
+		else
+			PriceLoanRecord(record);
+	}
+	if (solving == 0)
+		return;
+	SolveInterestRates(columns->months, columns->principal, columns->payment,
+		columns->rates, columns->status, NULL, solving, RATE_TOLERANCE);
+	for (size_t j = 0; j < solving; j++)
+	{
+		LoanRecord* record = &batch[columns->index[j]]->record;
+
+		if (columns->status[j] == RATE_SOLVED)
+			record->interestRate = columns->rates[j];
+		else
+			record->status = BATCH_NO_SOLUTION;
+	}
+}
+
+// Worker thread: answers queued records until the server stops.
+static void runWorker(void* arg)
+{
+	AmortServer* server = (AmortServer*)arg;
+	ServerRequest* batch[SERVER_BATCH_MAX];
+	RateColumns* columns = (RateColumns*)malloc(sizeof(RateColumns));
+
+	AcquireLock(&server->lock);
+	for (;;)
+	{
+		size_t count = 0;
+		double now = 0;
+
+		while (!server->stopWorkers && (server->queued == 0))
+			WaitCondition(&server->work, &server->lock);
+		if (server->queued == 0)
+			break;
+		count = (server->queued < SERVER_BATCH_MAX) ? server->queued :
+			SERVER_BATCH_MAX;
+		for (size_t i = 0; i < count; i++)
+			batch[i] = server->queue[(server->head + i) % SERVER_QUEUE];
+		server->head = (server->head + count) % SERVER_QUEUE;
+		server->queued -= count;
+		ReleaseLock(&server->lock);
+
+		if (columns != NULL)
+			priceBatch(batch, count, columns);
+		else
+			for (size_t i = 0; i < count; i++)
+				PriceLoanRecord(&batch[i]->record);
+		now = GetWallSeconds();
+
+		AcquireLock(&server->lock);
+		for (size_t i = 0; i < count; i++)
+		{
+			double waited = now - batch[i]->queued;
+			long long bucket = (long long)(waited * 1e6);
+
+			if (bucket >= SERVER_LATENCY_BUCKETS)
+				bucket = SERVER_LATENCY_BUCKETS - 1;
+			server->latency[(bucket < 0) ? 0 : bucket]++;
+			if (waited > server->slowest)
+				server->slowest = waited;
+			if (--batch[i]->owner->remaining == 0)
+				WakeCondition(&batch[i]->owner->answered);
+		}
+		server->requests += (long long)count;
+		server->batches++;
+	}
+	ReleaseLock(&server->lock);
+	free(columns);
+}
+
+// Queues the count records of a connection, waits for all of them to be
+// answered and buffers the answers in request order.
+static void submitRecords(ServerClient* client, const size_t count)
+{
+	AmortServer* server = client->server;
+	double now = GetWallSeconds();
+
+	if (count == 0)
+		return;
+	AcquireLock(&server->lock);
+	for (size_t i = 0; i < count; i++)
+	{
+		client->requests[i].queued = now;
+		client->requests[i].owner = client;
+		server->queue[(server->head + server->queued) % SERVER_QUEUE] =
+			&client->requests[i];
+		server->queued++;
+	}
+	client->remaining = count;
+	WakeCondition(&server->work);
+	while (client->remaining > 0)
+		WaitCondition(&client->answered, &server->lock);
+	ReleaseLock(&server->lock);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		char* text = replySpace(client, BATCH_REPLY_MAX);
+
+		client->output += (size_t)FormatLoanRecord(text, BATCH_REPLY_MAX,
+			&client->requests[i].record);
+	}
+}
+
+// Answers "S record": the priced record, its table and an END line.
+static void sendSchedule(ServerClient* client, const char* line)
+{
+	LoanRecord record;
+	int rows = 0;
+	char* text = NULL;
+
+	if (!ParseLoanRecord(line, &record))
+	{
+		record.status = BATCH_BAD_RECORD;
+		record.loanSize = record.paymentSize = record.interestRate = 0;
+		record.months = 0;
+	}
+	PriceLoanRecord(&record);
+	text = replySpace(client, BATCH_REPLY_MAX);
+	client->output += (size_t)FormatLoanRecord(text, BATCH_REPLY_MAX,
+		&record);
+	if ((record.status == BATCH_OK) && (record.months > 0) &&
+		(record.months <= FIVE_HUNDRED_YEARS))
+		rows = FillScheduleRows(client->rows, record.loanSize,
+			record.paymentSize, record.interestRate, record.months, 1,
+			record.months);
+	for (int i = 0; i < rows; i++)
+	{
+		char* row = replySpace(client, WRITER_ROW_MAX + 1);
+		int length = FormatCsvRow(row, &client->rows[i]);
+
+		row[length++] = '\n';
+		client->output += (size_t)length;
+	}
+	text = replySpace(client, SERVER_LINE_MAX);
+	client->output += (size_t)snprintf(text, SERVER_LINE_MAX, "END %d\n",
+		rows);
+
+	AcquireLock(&client->server->lock);
+	client->server->schedules++;
+	ReleaseLock(&client->server->lock);
+}
+
+// Writes the STATS line for stats. Returns its length.
+static int formatStats(char* text, const size_t size, const ServerStats* stats)
+{
+	return snprintf(text, size, "STATS requests=%lld batches=%lld "
+		"mean_batch=%.1lf schedules=%lld connections=%lld p50_us=%.0lf "
+		"p99_us=%.0lf max_us=%.0lf\n", stats->requests, stats->batches,
+		stats->meanBatch, stats->schedules, stats->connections, stats->p50,
+		stats->p99, stats->slowest);
+}
+
+// Answers STATS with one line of counters and latencies.
+static void sendStats(ServerClient* client)
+{
+	ServerStats stats;
+	char* text = replySpace(client, SERVER_LINE_MAX);
+
+	GetServerStats(client->server, &stats);
+	client->output += (size_t)formatStats(text, SERVER_LINE_MAX, &stats);
+}
+
+// Answers METRICS with the library metrics in the given format.
+static void sendMetrics(ServerClient* client, const int format)
+{
+	char* text = replySpace(client, METRICS_TEXT_MAX);
+	int length = FormatMetrics(text, METRICS_TEXT_MAX, format);
+
+	client->output += (size_t)((length < METRICS_TEXT_MAX) ? length : 0);
+}
+
+// Answers SHUTDOWN and wakes RunServer() to stop the server. The replies
+// are sent first, as stopping shuts the connection down.
+static void requestShutdown(ServerClient* client)
+{
+	char* text = replySpace(client, SERVER_LINE_MAX);
+
+	client->output += (size_t)snprintf(text, SERVER_LINE_MAX, "BYE\n");
+	flushReply(client);
+	AcquireLock(&client->server->lock);
+	client->server->shutdownRequested = 1;
+	WakeCondition(&client->server->shutdown);
+	ReleaseLock(&client->server->lock);
+}
+
+// Handles the complete lines in the first length bytes of input. Runs of
+// record lines are queued together, up to SERVER_PIPELINE at a time.
+// Returns the number of bytes used.
+static size_t handleLines(ServerClient* client, const size_t length)
+{
+	char* line = client->input;
+	char* newline = NULL;
+	size_t pending = 0;
+
+	client->input[length] = '\0';
+	while (client->open && ((newline = strchr(line, '\n')) != NULL))
+	{
+		*newline = '\0';
+		if ((newline > line) && (newline[-1] == '\r'))
+			newline[-1] = '\0';
+
+		if ((line[0] == 'S') && (line[1] == ' '))
+		{
+			submitRecords(client, pending);
+			pending = 0;
+			sendSchedule(client, line + 2);
+		}
+		else if (strcmp(line, "STATS") == 0)
+		{
+			submitRecords(client, pending);
+			pending = 0;
+			sendStats(client);
+		}
+		else if ((strcmp(line, "METRICS") == 0) ||
+			(strcmp(line, "METRICS JSON") == 0))
+		{
+			submitRecords(client, pending);
+			pending = 0;
+			sendMetrics(client, (line[7] == ' ') ? METRICS_JSON :
+				METRICS_PROMETHEUS);
+		}
+		else if ((strcmp(line, "QUIT") == 0) ||
+			(strcmp(line, "SHUTDOWN") == 0))
+		{
+			submitRecords(client, pending);
+			pending = 0;
+			client->open = 0;
+			if (line[0] == 'S')
+				requestShutdown(client);
+		}
+		else if (ParseLoanRecord(line, &client->requests[pending].record) &&
+			(++pending == SERVER_PIPELINE))
+		{
+			submitRecords(client, pending);
+			pending = 0;
+		}
+		line = newline + 1;
+	}
+	submitRecords(client, pending);
+	return (size_t)(line - client->input);
+}
+
+// Connection thread: reads and answers requests until the client leaves.
+static void serveClient(void* arg)
+{
+	ServerClient* client = (ServerClient*)arg;
+	AmortServer* server = client->server;
+	size_t have = 0;
+
+	while (client->open)
+	{
+		long got = ReadSocket(client->socket, client->input + have,
+			SERVER_BUFFER - have);
+		size_t used = 0;
+
+		if (got <= 0)
+			break;
+		have += (size_t)got;
+		used = handleLines(client, have);
+		if ((used == 0) && (have == SERVER_BUFFER))
+		{
+			char* text = replySpace(client, SERVER_LINE_MAX);
+
+			client->output += (size_t)snprintf(text, SERVER_LINE_MAX,
+				"BAD line longer than %d bytes\n", SERVER_BUFFER);
+			client->open = 0;
+		}
+		memmove(client->input, client->input + used, have - used);
+		have -= used;
+		flushReply(client);
+	}
+	flushReply(client);
+
+	AcquireLock(&server->lock);
+	CloseSocket(client->socket);
+	client->socket = AMORT_NO_SOCKET;
+	client->finished = 1;
+	ReleaseLock(&server->lock);
+}
+
+// Joins the thread of a connection slot and frees it. The server lock is
+// held, and the thread has finished or its socket is shut down.
+static void retireClient(AmortServer* server, const int slot)
+{
+	JoinThread(server->clients[slot]->thread);
+	free(server->clients[slot]);
+	server->clients[slot] = NULL;
+}
+
+// Accept thread: gives each new connection a slot and a thread.
+static void acceptClients(void* arg)
+{
+	AmortServer* server = (AmortServer*)arg;
+
+	for (;;)
+	{
+		AmortSocket connection = AcceptLocal(server->listener);
+		ServerClient* client = NULL;
+		int slot = -1;
+		int stopping = 0;
+
+		AcquireLock(&server->lock);
+		stopping = server->stopping;
+		for (int s = 0; !stopping && (s < SERVER_MAX_CLIENTS); s++)
+		{
+			if ((server->clients[s] != NULL) && server->clients[s]->finished)
+				retireClient(server, s);
+			if ((slot < 0) && (server->clients[s] == NULL))
+				slot = s;
+		}
+		ReleaseLock(&server->lock);
+		if (stopping)
+		{
+			if (connection != AMORT_NO_SOCKET)
+				CloseSocket(connection);
+			break;
+		}
+		if (connection == AMORT_NO_SOCKET)
+			continue;
+		if ((slot < 0) ||
+			((client = (ServerClient*)malloc(sizeof(ServerClient))) == NULL))
+		{
+			WriteSocket(connection, "BUSY\n", 5);
+			CloseSocket(connection);
+			continue;
+		}
+
+		memset(client, 0, offsetof(ServerClient, requests));
+		client->server = server;
+		client->socket = connection;
+		client->answered = idle;
+		client->open = 1;
+		AcquireLock(&server->lock);
+		server->clients[slot] = client;
+		server->connections++;
+		if (!StartThread(&client->thread, serveClient, client))
+		{
+			server->clients[slot] = NULL;
+			CloseSocket(connection);
+			free(client);
+		}
+		ReleaseLock(&server->lock);
+	}
+}
+
+// Value in microseconds below which fraction of the answers came.
+static double latencyPercentile(const long long* latency,
+	const long long total, const double fraction)
+{
+	long long rank = (long long)ceil(fraction * (double)total);
+	long long seen = 0;
+
+	if (total == 0)
+		return 0;
+	for (int b = 0; b < SERVER_LATENCY_BUCKETS; b++)
+	{
+		seen += latency[b];
+		if (seen >= rank)
+			return b + 1;
+	}
+	return SERVER_LATENCY_BUCKETS;
+}
+//----------------------------------------------------------------------------
+// Function:	    int StartServer(AmortServer* server, const char* endpoint,
+//						int workers)
+//
+// Description:		Listens on endpoint, a Unix domain socket path or
+//					"tcp:PORT" on 127.0.0.1, and starts the worker threads
+//					and the accept thread. The server struct is large (the
+//					queue and the histogram live in it), so give it static
+//					or heap storage, and keep it until StopServer().
+//
+// Parameters:	    (AmortServer*)  server     Receives the running server
+//				    const (char*)   endpoint   Where to listen
+//				    (int)           workers    Worker threads, 0 or less
+//											   for one per CPU
+//
+// Returns:		    (int) 1 when the server is running, 0 if the endpoint
+//					cannot be used or no thread could be started
+// Date:            10/17/2026
+// Called By:       RunServer(), main() of bench_server
+// Calls:		    ListenLocal(), StartThread()
+// History Log:     10/17/2026  added for the calculation server
+//				    10/17/2026  a socket path bound here is marked as owned
+//----------------------------------------------------------------------------
+int StartServer(AmortServer* server, const char* endpoint, int workers)
+{
+	memset(server, 0, sizeof(AmortServer));
+	server->lock = unlocked;
+	server->work = idle;
+	server->shutdown = idle;
+	if (strlen(endpoint) >= SERVER_ENDPOINT_MAX)
+		return 0;
+	strcpy(server->endpoint, endpoint);
+	if (workers <= 0)
+		workers = GetCpuCount();
+	if (workers > SERVER_MAX_WORKERS)
+		workers = SERVER_MAX_WORKERS;
+	if ((server->listener = ListenLocal(endpoint)) == AMORT_NO_SOCKET)
+		return 0;
+	server->ownsPath = (strncmp(endpoint, AMORT_TCP_PREFIX,
+		strlen(AMORT_TCP_PREFIX)) != 0);
+
+	for (int w = 0; w < workers; w++)
+		if (StartThread(&server->workerThreads[server->workers], runWorker,
+			server))
+			server->workers++;
+	if ((server->workers > 0) &&
+		StartThread(&server->acceptThread, acceptClients, server))
+		return 1;
+
+	AcquireLock(&server->lock);
+	server->stopWorkers = 1;
+	WakeCondition(&server->work);
+	ReleaseLock(&server->lock);
+	for (int w = 0; w < server->workers; w++)
+		JoinThread(server->workerThreads[w]);
+	CloseSocket(server->listener);
+	if (server->ownsPath)
+		remove(server->endpoint);
+	return 0;
+}
+//----------------------------------------------------------------------------
+// Function:	    void StopServer(AmortServer* server)
+//
+// Description:		Stops taking connections, shuts down the open ones,
+//					lets the workers answer what is queued and joins every
+//					thread. The Unix domain socket this server bound is
+//					removed from its path.
+//
+// Parameters:	    (AmortServer*) server   Server started by StartServer()
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       RunServer(), main() of bench_server
+// Calls:		    ShutdownSocket(), ConnectLocal(), JoinThread()
+// History Log:     10/17/2026  added for the calculation server
+//				    10/17/2026  only removes a path this server bound
+//----------------------------------------------------------------------------
+void StopServer(AmortServer* server)
+{
+	AmortSocket wake = AMORT_NO_SOCKET;
+
+	AcquireLock(&server->lock);
+	server->stopping = 1;
+	ReleaseLock(&server->lock);
+	ShutdownSocket(server->listener);
+	if ((wake = ConnectLocal(server->endpoint)) != AMORT_NO_SOCKET)
+		CloseSocket(wake);              // In case shutdown left accept() be
+	JoinThread(server->acceptThread);
+	CloseSocket(server->listener);
+
+	AcquireLock(&server->lock);
+	for (int s = 0; s < SERVER_MAX_CLIENTS; s++)
+		if ((server->clients[s] != NULL) &&
+			(server->clients[s]->socket != AMORT_NO_SOCKET))
+			ShutdownSocket(server->clients[s]->socket);
+	ReleaseLock(&server->lock);
+	for (int s = 0; s < SERVER_MAX_CLIENTS; s++)
+		if (server->clients[s] != NULL)
+		{
+			JoinThread(server->clients[s]->thread);
+			free(server->clients[s]);
+			server->clients[s] = NULL;
+		}
+
+	AcquireLock(&server->lock);
+	server->stopWorkers = 1;
+	WakeCondition(&server->work);
+	ReleaseLock(&server->lock);
+	for (int w = 0; w < server->workers; w++)
+		JoinThread(server->workerThreads[w]);
+	if (server->ownsPath)
+		remove(server->endpoint);
+}
+//----------------------------------------------------------------------------
+// Function:	    void GetServerStats(AmortServer* server, ServerStats* stats)
+//
+// Description:		Copies the counters of a running server and works out
+//					the median, 99th percentile and slowest time from
+//					queueing a record to its answer. The percentiles are
+//					the upper edge of their microsecond bucket.
+//
+// Parameters:	    (AmortServer*)  server   Running server
+//				    (ServerStats*)  stats    Receives the figures
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       sendStats(), RunServer(), main() of bench_server
+// Calls:		    latencyPercentile()
+// History Log:     10/17/2026  added for the calculation server
+//----------------------------------------------------------------------------
+void GetServerStats(AmortServer* server, ServerStats* stats)
+{
+	AcquireLock(&server->lock);
+	stats->requests = server->requests;
+	stats->batches = server->batches;
+	stats->schedules = server->schedules;
+	stats->connections = server->connections;
+	stats->meanBatch = (server->batches > 0) ?
+		(double)server->requests / (double)server->batches : 0;
+	stats->p50 = latencyPercentile(server->latency, server->requests, 0.50);
+	stats->p99 = latencyPercentile(server->latency, server->requests, 0.99);
+	stats->slowest = server->slowest * 1e6;
+	ReleaseLock(&server->lock);
+}
+//----------------------------------------------------------------------------
+// Function:	    int RunServer(const char* endpoint, int workers)
+//
+// Description:		Runs the calculation server until a client sends
+//					SHUTDOWN, then prints its STATS line to stdout.
+//
+// Parameters:	    const (char*)  endpoint   Where to listen
+//				    (int)          workers    Worker threads, 0 or less for
+//											  one per CPU
+//
+// Returns:		    (int) 1 after a clean shutdown, 0 if the server could
+//					not be started
+// Date:            10/17/2026
+// Called By:       RunServerMode()
+// Calls:		    StartServer(), StopServer(), GetServerStats()
+// History Log:     10/17/2026  added for the calculation server
+//----------------------------------------------------------------------------
+int RunServer(const char* endpoint, int workers)
+{
+	AmortServer* server = (AmortServer*)malloc(sizeof(AmortServer));
+	ServerStats stats;
+	char line[SERVER_LINE_MAX] = "";
+
+	if ((server == NULL) || !StartServer(server, endpoint, workers))
+	{
+		free(server);
+		return 0;
+	}
+	AcquireLock(&server->lock);
+	while (!server->shutdownRequested)
+		WaitCondition(&server->shutdown, &server->lock);
+	ReleaseLock(&server->lock);
+	StopServer(server);
+
+	GetServerStats(server, &stats);
+	formatStats(line, sizeof(line), &stats);
+	fputs(line, stdout);
+	free(server);
+	return 1;
+}
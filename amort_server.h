@@ -0,0 +1,98 @@
+//----------------------------------------------------------------------------
+// File:			amort_server.h
+//
+// Description:     Header file for the local calculation server
+//					(amort_server.c). Clients connect over a Unix domain
+//					socket, or "tcp:PORT" on 127.0.0.1, and send one request
+//					per line:
+//
+//					  250000,,360,6.5         a batch record (amort_batch.h);
+//											  the reply is its result row
+//					  S 250000,,360,6.5       the record, then its table as
+//											  month,payment,principal,
+//											  interest,balance rows and
+//											  an END line
+//					  STATS                   counters and latency
+//					  METRICS                 library metrics as
+//											  Prometheus text, ending
+//											  with "# EOF"
+//					  METRICS JSON            the same as one JSON line
+//					  QUIT                    closes the connection
+//					  SHUTDOWN                stops the server
+//
+//					Replies come back in request order. Record lines from
+//					all connections are queued together and priced by the
+//					worker threads in batches of up to SERVER_BATCH_MAX.
+//
+// History Log:    10/17/2026  added for the calculation server
+//				   10/17/2026  added METRICS
+//----------------------------------------------------------------------------
+
+#ifndef AMORT_SERVER_H
+#define AMORT_SERVER_H
+#include "amort_batch.h"
+#include "amort_platform.h"
+
+#define SERVER_MAX_CLIENTS 64
+#define SERVER_MAX_WORKERS 64
+#define SERVER_PIPELINE 256         // Records a connection has in flight
+#define SERVER_QUEUE (SERVER_MAX_CLIENTS * SERVER_PIPELINE)
+#define SERVER_BATCH_MAX 512        // Records priced per worker pass
+#define SERVER_BUFFER 65536         // Bytes per socket read and write
+#define SERVER_ENDPOINT_MAX 256
+#define SERVER_LATENCY_BUCKETS 100000   // One per microsecond, the last
+										// holds everything slower
+
+typedef struct ServerClient ServerClient;
+
+typedef struct
+{
+	LoanRecord record;
+	double queued;                  // GetWallSeconds() when queued
+	ServerClient* owner;            // Connection waiting for the answer
+} ServerRequest;
+
+typedef struct
+{
+	long long requests;             // Records answered
+	long long batches;              // Worker passes that answered them
+	long long schedules;            // Tables sent
+	long long connections;          // Connections accepted
+	double meanBatch;               // requests / batches
+	double p50;                     // Queue to answer, microseconds
+	double p99;
+	double slowest;
+} ServerStats;
+
+typedef struct
+{
+	char endpoint[SERVER_ENDPOINT_MAX];
+	int ownsPath;                   // Bound the socket at the endpoint path
+	AmortSocket listener;
+	AmortThread acceptThread;
+	AmortThread workerThreads[SERVER_MAX_WORKERS];
+	int workers;
+	AmortLock lock;                 // Guards everything below
+	AmortCondition work;            // Records were queued, or stopping
+	AmortCondition shutdown;        // A client sent SHUTDOWN
+	int stopping;                   // Accept and connection threads end
+	int stopWorkers;                // Workers end once the queue is empty
+	int shutdownRequested;
+	ServerClient* clients[SERVER_MAX_CLIENTS];  // NULL when the slot is free
+	ServerRequest* queue[SERVER_QUEUE];
+	size_t head;                    // First queued request
+	size_t queued;
+	long long latency[SERVER_LATENCY_BUCKETS];
+	long long requests;
+	long long batches;
+	long long schedules;
+	long long connections;
+	double slowest;                 // Seconds
+} AmortServer;
+
+int StartServer(AmortServer* server, const char* endpoint, int workers);
+void StopServer(AmortServer* server);
+void GetServerStats(AmortServer* server, ServerStats* stats);
+int RunServer(const char* endpoint, int workers);
+
+#endif
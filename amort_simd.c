@@ -0,0 +1,437 @@
+//----------------------------------------------------------------------------
+// File:			amort_simd.c
+//
+// Description      SIMD amortization kernel for the Amort library. Steps
+//					many loans one month at a time, four (AVX2) or eight
+//					(AVX-512) loans per instruction. Every lane does the same
+//					operations in the same order as DisplayTable() and
+//					SaveTable(), without fused multiply-adds, so the results
+//					match them bit for bit. A scalar loop is used on other
+//					CPUs, for the tail of each range, and can be forced with
+//					SetSimdLevel(SIMD_SCALAR).
+//
+// Functions:	    int AllocLoanColumns(LoanColumns* cols, size_t count)
+//					void FreeLoanColumns(LoanColumns* cols)
+//					void SetLoanColumn(LoanColumns* cols, size_t index,
+//						const double loanSize, const double paymentSize,
+//						const double interestRate, const int months)
+//					void StepLoanColumns(LoanColumns* cols, const int month)
+//					void StepLoanRange(LoanColumns* cols, size_t first,
+//						size_t count, const int month)
+//					int GetSimdLevel(void)
+//					int SetSimdLevel(int level)
+//----------------------------------------------------------------------------
+
+// x * HUNDRED + HALF must be rounded twice, as in the scalar loop. GCC would
+// otherwise fuse it into one FMA inside the AVX-512 code.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC optimize("fp-contract=off")
+#elif defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#endif
+
+#include <string.h>
+#include "amort.h"
+#include "amort_platform.h"
+#include "amort_simd.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || \
+	defined(_M_IX86)
+#define SIMD_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define TARGET_AVX2
+#define TARGET_AVX512
+#else
+#include <cpuid.h>
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#define TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+#endif
+
+#define AVX2_LANES 4
+#define AVX512_LANES 8
+#define UNKNOWN_LEVEL ((size_t)-1)
+
+// Read by pool and server threads, so it is set and read as a counter.
+static volatile size_t simdLevel = UNKNOWN_LEVEL;
+
+// One month of the DisplayTable() loop for loans first .. first + count - 1.
+static void stepScalar(LoanColumns* cols, size_t first, size_t count,
+	const int month)
+{
+	for (size_t i = first; i < first + count; i++)
+	{
+		double interestPaid = 0;
+		double principalPaid = 0;
+		double paymentSize = cols->payment[i];
+		double loanBalance = cols->balance[i];
+
+		if (month > cols->months[i])
+		{
+			cols->paid[i] = 0;
+			cols->principal[i] = 0;
+			cols->interest[i] = 0;
+			continue;
+		}
+		interestPaid = loanBalance * cols->rate[i];
+		interestPaid = floor(interestPaid * HUNDRED + HALF) / HUNDRED;
+		principalPaid = paymentSize - interestPaid;
+		loanBalance -= principalPaid;
+		if ((month == cols->months[i]) && (loanBalance != 0))
+		{
+			paymentSize += loanBalance;
+			principalPaid += loanBalance;
+			loanBalance -= loanBalance;
+		}
+		cols->balance[i] = loanBalance;
+		cols->paid[i] = paymentSize;
+		cols->principal[i] = principalPaid;
+		cols->interest[i] = interestPaid;
+	}
+}
+
+#ifdef SIMD_X86
+// Same as stepScalar(), four loans at a time. Returns the loans done.
+TARGET_AVX2
+static size_t stepAvx2(LoanColumns* cols, size_t first, size_t count,
+	const int month)
+{
+	const __m256d hundred = _mm256_set1_pd(HUNDRED);
+	const __m256d half = _mm256_set1_pd(HALF);
+	const __m256d zero = _mm256_setzero_pd();
+	const __m128i current = _mm_set1_epi32(month);
+	size_t done = 0;
+
+	for (; done + AVX2_LANES <= count; done += AVX2_LANES)
+	{
+		size_t i = first + done;
+		__m256d balance = _mm256_loadu_pd(cols->balance + i);
+		__m256d payment = _mm256_loadu_pd(cols->payment + i);
+		__m256d rate = _mm256_loadu_pd(cols->rate + i);
+		__m128i months = _mm_loadu_si128((const __m128i*)(cols->months + i));
+		__m256d active = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(
+			_mm_cmpgt_epi32(current, months)));
+		__m256d last = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(
+			_mm_cmpeq_epi32(current, months)));
+		__m256d interest = _mm256_mul_pd(balance, rate);
+		__m256d principal = zero;
+		__m256d adjust = zero;
+
+		active = _mm256_xor_pd(active,
+			_mm256_castsi256_pd(_mm256_set1_epi64x(-1)));  // month <= months
+		interest = _mm256_add_pd(_mm256_mul_pd(interest, hundred), half);
+		interest = _mm256_div_pd(_mm256_round_pd(interest,
+			_MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC), hundred);
+		principal = _mm256_sub_pd(payment, interest);
+		balance = _mm256_sub_pd(balance, principal);
+		adjust = _mm256_and_pd(last,
+			_mm256_cmp_pd(balance, zero, _CMP_NEQ_UQ));    // Last month
+		payment = _mm256_blendv_pd(payment,
+			_mm256_add_pd(payment, balance), adjust);
+		principal = _mm256_blendv_pd(principal,
+			_mm256_add_pd(principal, balance), adjust);
+		balance = _mm256_blendv_pd(balance,
+			_mm256_sub_pd(balance, balance), adjust);
+
+		_mm256_storeu_pd(cols->balance + i, _mm256_blendv_pd(
+			_mm256_loadu_pd(cols->balance + i), balance, active));
+		_mm256_storeu_pd(cols->paid + i, _mm256_and_pd(payment, active));
+		_mm256_storeu_pd(cols->principal + i, _mm256_and_pd(principal, active));
+		_mm256_storeu_pd(cols->interest + i, _mm256_and_pd(interest, active));
+	}
+	return done;
+}
+// Same as stepScalar(), eight loans at a time. Returns the loans done.
+TARGET_AVX512
+static size_t stepAvx512(LoanColumns* cols, size_t first, size_t count,
+	const int month)
+{
+	const __m512d hundred = _mm512_set1_pd(HUNDRED);
+	const __m512d half = _mm512_set1_pd(HALF);
+	const __m512d zero = _mm512_setzero_pd();
+	const __m256i current = _mm256_set1_epi32(month);
+	size_t done = 0;
+
+	for (; done + AVX512_LANES <= count; done += AVX512_LANES)
+	{
+		size_t i = first + done;
+		__m512d balance = _mm512_loadu_pd(cols->balance + i);
+		__m512d payment = _mm512_loadu_pd(cols->payment + i);
+		__m512d rate = _mm512_loadu_pd(cols->rate + i);
+		__m512i months = _mm512_cvtepi32_epi64(
+			_mm256_loadu_si256((const __m256i*)(cols->months + i)));
+		__m512i monthWide = _mm512_cvtepi32_epi64(current);
+		__mmask8 active = _mm512_cmple_epi64_mask(monthWide, months);
+		__mmask8 last = _mm512_cmpeq_epi64_mask(monthWide, months);
+		__m512d interest = _mm512_mul_pd(balance, rate);
+		__m512d principal = zero;
+		__mmask8 adjust = 0;
+
+		interest = _mm512_add_pd(_mm512_mul_pd(interest, hundred), half);
+		interest = _mm512_div_pd(_mm512_roundscale_pd(interest,
+			_MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC), hundred);
+		principal = _mm512_sub_pd(payment, interest);
+		balance = _mm512_sub_pd(balance, principal);
+		adjust = _mm512_mask_cmp_pd_mask(last, balance, zero, _CMP_NEQ_UQ);
+		payment = _mm512_mask_add_pd(payment, adjust, payment, balance);
+		principal = _mm512_mask_add_pd(principal, adjust, principal, balance);
+		balance = _mm512_mask_sub_pd(balance, adjust, balance, balance);
+
+		_mm512_mask_storeu_pd(cols->balance + i, active, balance);
+		_mm512_storeu_pd(cols->paid + i,
+			_mm512_maskz_mov_pd(active, payment));
+		_mm512_storeu_pd(cols->principal + i,
+			_mm512_maskz_mov_pd(active, principal));
+		_mm512_storeu_pd(cols->interest + i,
+			_mm512_maskz_mov_pd(active, interest));
+	}
+	return done;
+}
+// Returns the widest SIMD_* level both the CPU and the OS support.
+static int detectSimdLevel(void)
+{
+	int level = SIMD_SCALAR;
+	unsigned long long xcr0 = 0;
+#ifdef _MSC_VER
+	int regs[4] = { 0 };
+
+	__cpuid(regs, 0);
+	if (regs[0] < 7)
+		return SIMD_SCALAR;
+	__cpuid(regs, 1);
+	if (!(regs[2] & (1 << 27)))                   // OSXSAVE
+		return SIMD_SCALAR;
+	xcr0 = _xgetbv(0);
+	__cpuidex(regs, 7, 0);
+	if (((xcr0 & 0x6) == 0x6) && (regs[1] & (1 << 5)))
+		level = SIMD_AVX2;
+	if (((xcr0 & 0xe6) == 0xe6) && (regs[1] & (1 << 16)))
+		level = SIMD_AVX512;
+#else
+	unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+	unsigned int low = 0, high = 0;
+
+	if (__get_cpuid_max(0, NULL) < 7)
+		return SIMD_SCALAR;
+	__cpuid(1, eax, ebx, ecx, edx);
+	if (!(ecx & bit_OSXSAVE))
+		return SIMD_SCALAR;
+	__asm__("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+	xcr0 = ((unsigned long long)high << 32) | low;
+	__cpuid_count(7, 0, eax, ebx, ecx, edx);
+	if (((xcr0 & 0x6) == 0x6) && (ebx & bit_AVX2))
+		level = SIMD_AVX2;
+	if (((xcr0 & 0xe6) == 0xe6) && (ebx & bit_AVX512F))
+		level = SIMD_AVX512;
+#endif
+	return level;
+}
+#else
+static int detectSimdLevel(void)
+{
+	return SIMD_SCALAR;
+}
+#endif
+//----------------------------------------------------------------------------
+// Function:	    int GetSimdLevel(void)
+//
+// Description:		Returns the kernel StepLoanRange() uses. On the first call
+//					the CPU is asked which vector extensions it has. Threads
+//					that race on the first call all find the same level.
+//
+// Parameters:	    none
+//
+// Returns:		    (int) level   SIMD_SCALAR, SIMD_AVX2 or SIMD_AVX512
+// Date:            10/17/2026
+// Called By:       StepLoanRange(), SolveInterestRates()
+// Calls:		    LoadCounter(), StoreCounter()
+// History Log:     10/17/2026  added for the SIMD amortization kernel
+//				    10/17/2026  level published with StoreCounter()
+//----------------------------------------------------------------------------
+int GetSimdLevel(void)
+{
+	size_t level = LoadCounter(&simdLevel);
+
+	if (level == UNKNOWN_LEVEL)
+	{
+		level = (size_t)detectSimdLevel();
+		StoreCounter(&simdLevel, level);
+	}
+	return (int)level;
+}
+//----------------------------------------------------------------------------
+// Function:	    int SetSimdLevel(int level)
+//
+// Description:		Selects a narrower kernel, e.g. SIMD_SCALAR to compare
+//					against. Levels the CPU does not support are lowered to
+//					the widest one it does.
+//
+// Parameters:	    (int) level   SIMD_SCALAR, SIMD_AVX2 or SIMD_AVX512
+//
+// Returns:		    (int) level   The level now in use
+// Date:            10/17/2026
+// Calls:		    StoreCounter()
+// History Log:     10/17/2026  added for the SIMD amortization kernel
+//				    10/17/2026  level published with StoreCounter()
+//----------------------------------------------------------------------------
+int SetSimdLevel(int level)
+{
+	int supported = detectSimdLevel();
+
+	if (level < SIMD_SCALAR)
+		level = SIMD_SCALAR;
+	level = (level > supported) ? supported : level;
+	StoreCounter(&simdLevel, (size_t)level);
+	return level;
+}
+//----------------------------------------------------------------------------
+// Function:	    int AllocLoanColumns(LoanColumns* cols, size_t count)
+//
+// Description:		Allocates the columns for count loans, each aligned to
+//					SIMD_ALIGNMENT. Fill them with SetLoanColumn().
+//
+// Parameters:	    (LoanColumns*) cols    Columns to allocate
+//				    (size_t)       count   Number of loans
+//
+// Returns:		    (int) 1 on success, 0 when out of memory
+// Date:            10/17/2026
+// Calls:		    AlignedAlloc()
+// History Log:     10/17/2026  added for the SIMD amortization kernel
+//----------------------------------------------------------------------------
+int AllocLoanColumns(LoanColumns* cols, size_t count)
+{
+	size_t bytes = count * sizeof(double);
+
+	memset(cols, 0, sizeof(LoanColumns));
+	cols->count = count;
+	cols->balance = (double*)AlignedAlloc(bytes, SIMD_ALIGNMENT);
+	cols->rate = (double*)AlignedAlloc(bytes, SIMD_ALIGNMENT);
+	cols->payment = (double*)AlignedAlloc(bytes, SIMD_ALIGNMENT);
+	cols->months = (int*)AlignedAlloc(count * sizeof(int), SIMD_ALIGNMENT);
+	cols->paid = (double*)AlignedAlloc(bytes, SIMD_ALIGNMENT);
+	cols->principal = (double*)AlignedAlloc(bytes, SIMD_ALIGNMENT);
+	cols->interest = (double*)AlignedAlloc(bytes, SIMD_ALIGNMENT);
+	if ((cols->balance == NULL) || (cols->rate == NULL) ||
+		(cols->payment == NULL) || (cols->months == NULL) ||
+		(cols->paid == NULL) || (cols->principal == NULL) ||
+		(cols->interest == NULL))
+	{
+		FreeLoanColumns(cols);
+		return 0;
+	}
+	return 1;
+}
+//----------------------------------------------------------------------------
+// Function:	    void FreeLoanColumns(LoanColumns* cols)
+//
+// Description:		Releases columns allocated by AllocLoanColumns().
+//
+// Parameters:	    (LoanColumns*) cols   Columns to release
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Calls:		    AlignedFree()
+// History Log:     10/17/2026  added for the SIMD amortization kernel
+//----------------------------------------------------------------------------
+void FreeLoanColumns(LoanColumns* cols)
+{
+	AlignedFree(cols->balance);
+	AlignedFree(cols->rate);
+	AlignedFree(cols->payment);
+	AlignedFree(cols->months);
+	AlignedFree(cols->paid);
+	AlignedFree(cols->principal);
+	AlignedFree(cols->interest);
+	memset(cols, 0, sizeof(LoanColumns));
+}
+//----------------------------------------------------------------------------
+// Function:	    void SetLoanColumn(LoanColumns* cols, size_t index,
+//						const double loanSize, const double paymentSize,
+//						const double interestRate, const int months)
+//
+// Description:		Stores one loan, taking the same arguments as
+//					DisplayTable(). The rate is rounded to the nearest 1/8th
+//					percent and turned into a monthly rate here, once.
+//
+// Parameters:	    (LoanColumns*) cols           Columns to fill
+//				    (size_t)       index          Loan number
+//				    const double   loanSize       Total size of loan
+//				    const double   paymentSize    Monthly payment amount
+//				    const double   interestRate   Annual interest rate
+//				    const int      months         Number of monthly payments
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Calls:		    roundInterest()
+// History Log:     10/17/2026  added for the SIMD amortization kernel
+//----------------------------------------------------------------------------
+void SetLoanColumn(LoanColumns* cols, size_t index, const double loanSize,
+	const double paymentSize, const double interestRate, const int months)
+{
+	cols->balance[index] = loanSize;
+	cols->rate[index] = roundInterest(interestRate, 8) / MONTHLY_DIVISOR;
+	cols->payment[index] = paymentSize;
+	cols->months[index] = months;
+	cols->paid[index] = 0;
+	cols->principal[index] = 0;
+	cols->interest[index] = 0;
+}
+//----------------------------------------------------------------------------
+// Function:	    void StepLoanRange(LoanColumns* cols, size_t first,
+//						size_t count, const int month)
+//
+// Description:		Works out row 'month' (1 based) of the amortization table
+//					of loans first .. first + count - 1. paid, principal and
+//					interest receive the row and balance is updated. Loans
+//					with fewer than 'month' payments get a row of zeros and
+//					keep their balance. Call it for month 1, 2, 3, ... in
+//					order; separate ranges may run on separate threads.
+//
+// Parameters:	    (LoanColumns*) cols    Columns filled by SetLoanColumn()
+//				    (size_t)       first   First loan of the range
+//				    (size_t)       count   Number of loans in the range
+//				    const int      month   Month to work out
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       StepLoanColumns()
+// Calls:		    GetSimdLevel()
+// History Log:     10/17/2026  added for the SIMD amortization kernel
+//----------------------------------------------------------------------------
+void StepLoanRange(LoanColumns* cols, size_t first, size_t count,
+	const int month)
+{
+	size_t done = 0;
+
+#ifdef SIMD_X86
+	switch (GetSimdLevel())
+	{
+	case SIMD_AVX512:
+		done = stepAvx512(cols, first, count, month);
+		break;
+	case SIMD_AVX2:
+		done = stepAvx2(cols, first, count, month);
+		break;
+	}
+#endif
+	stepScalar(cols, first + done, count - done, month);
+}
+//----------------------------------------------------------------------------
+// Function:	    void StepLoanColumns(LoanColumns* cols, const int month)
+//
+// Description:		Works out row 'month' of every loan, see StepLoanRange().
+//
+// Parameters:	    (LoanColumns*) cols    Columns filled by SetLoanColumn()
+//				    const int      month   Month to work out (1 based)
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Calls:		    StepLoanRange()
+// History Log:     10/17/2026  added for the SIMD amortization kernel
+//----------------------------------------------------------------------------
+void StepLoanColumns(LoanColumns* cols, const int month)
+{
+	StepLoanRange(cols, 0, cols->count, month);
+}
@@ -0,0 +1,45 @@
+//----------------------------------------------------------------------------
+// File:			amort_simd.h
+//
+// Description:     Header file for the SIMD amortization kernel
+//					(amort_simd.c). Loans are stored as structure-of-arrays
+//					columns and stepped one month at a time, all loans in
+//					lockstep. Each step gives the same payment, principal,
+//					interest and balance, bit for bit, as the loop in
+//					DisplayTable() and SaveTable().
+//
+// History Log:    10/17/2026  added for the SIMD amortization kernel
+//----------------------------------------------------------------------------
+
+#ifndef AMORT_SIMD_H
+#define AMORT_SIMD_H
+#include <stddef.h>
+
+#define SIMD_SCALAR 0
+#define SIMD_AVX2 1
+#define SIMD_AVX512 2
+#define SIMD_ALIGNMENT 64
+
+typedef struct
+{
+	size_t count;          // Number of loans
+	double* balance;       // Running loan balance, updated by each step
+	double* rate;          // Monthly rate: roundInterest(rate, 8) / 1200
+	double* payment;       // Monthly payment
+	int* months;           // Number of monthly payments
+	double* paid;          // Out: payment made this month (last one adjusted)
+	double* principal;     // Out: principal paid this month
+	double* interest;      // Out: interest paid this month
+} LoanColumns;
+
+int AllocLoanColumns(LoanColumns* cols, size_t count);
+void FreeLoanColumns(LoanColumns* cols);
+void SetLoanColumn(LoanColumns* cols, size_t index, const double loanSize,
+	const double paymentSize, const double interestRate, const int months);
+void StepLoanColumns(LoanColumns* cols, const int month);
+void StepLoanRange(LoanColumns* cols, size_t first, size_t count,
+	const int month);
+int GetSimdLevel(void);
+int SetSimdLevel(int level);
+
+#endif
@@ -0,0 +1,458 @@
+//----------------------------------------------------------------------------
+// File:			amort_solver.c
+//
+// Description      Batch interest rate solver for the Amort library. Each
+//					offer takes the bracketed Newton search of
+//					solveInterestRate(), started from an approximation of
+//					the payment formula instead of its first order
+//					expansion. SOLVER_LANES offers are searched side by side;
+//					with AVX2 the payment formula of four lanes is worked
+//					out per instruction, with log1p() and expm1() done in
+//					vector registers. An offer leaves its lane as soon as it
+//					converges and the next offer takes the lane, so finished
+//					offers cost nothing while slow ones carry on. The search
+//					stops after MAX_RATE_ITERATIONS and says so.
+//
+//					The vector log1p() and expm1() are within a couple of
+//					units in the last place of the C library, so a rate may
+//					differ from solveInterestRate() by about the tolerance.
+//
+// Functions:	    size_t SolveInterestRates(const int* months,
+//						const double* principal, const double* payment,
+//						double* rates, int* status, int* iterations,
+//						const size_t count, const double tolerance)
+//----------------------------------------------------------------------------
+
+#include "amort.h"
+#include "amort_metrics.h"
+#include "amort_simd.h"
+#include "amort_solver.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || \
+	defined(_M_IX86)
+#define SOLVER_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#define TARGET_AVX2
+#else
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+#define AVX2_LANES 4
+#define MAX_EXPONENT 709.0          // e^709 is about the largest double
+#define LN2_HI 6.93147180369123816490e-01   // High bits of ln 2, exact * k
+#define LN2_LO 1.90821492927058770002e-10
+#define INV_LN2 1.44269504088896338700e+00
+#define SQRT2_MINUS_ONE 0.41421356237309504880
+#define EXPONENT_BIAS 1023
+#define TWO_52 4503599627370496.0
+#define ROUND_MAGIC 6755399441055744.0      // 1.5 * 2^52
+#define EXPM1_TERMS 12
+
+typedef struct
+{
+	const int* months;
+	const double* principal;
+	const double* payment;
+	double* rates;
+	int* status;
+	int* iterations;
+	size_t count;
+	size_t next;                    // First offer not yet given a lane
+	size_t solved;
+	long long steps;                // Iterations of all finished offers
+} RateOffers;
+
+typedef struct
+{
+	double rate[SOLVER_LANES];      // Monthly rate being refined
+	double low[SOLVER_LANES];       // Bracket around the answer
+	double high[SOLVER_LANES];
+	double months[SOLVER_LANES];
+	double principal[SOLVER_LANES];
+	double payment[SOLVER_LANES];
+	size_t offer[SOLVER_LANES];     // Offer searched in the lane
+	int count[SOLVER_LANES];        // Iterations so far
+	int busy[SOLVER_LANES];         // 0 once no offers are left
+} SolverLanes;
+
+#ifdef SOLVER_X86
+// Coefficients of log(1 + f) = f - f^2 / 2 + s * (f^2 / 2 + R(s^2)) with
+// s = f / (2 + f), as in the C library log1p().
+static const double LOG_TERMS[] = { 6.666666666666735130e-01,
+	3.999999999940941908e-01, 2.857142874366239149e-01,
+	2.222219843214978396e-01, 1.818357216161805012e-01,
+	1.531383769920937332e-01, 1.479819860511658591e-01 };
+
+// 1 / 2!, 1 / 3!, ... 1 / 13!: expm1(t) = t + t^2 / 2! + ... for |t| below
+// ln 2 / 2, to double precision.
+static const double EXPM1_COEFFICIENTS[EXPM1_TERMS] = { 1.0 / 2,
+	1.0 / 6, 1.0 / 24, 1.0 / 120, 1.0 / 720, 1.0 / 5040, 1.0 / 40320,
+	1.0 / 362880, 1.0 / 3628800, 1.0 / 39916800, 1.0 / 479001600,
+	1.0 / 6227020800.0 };
+#endif
+
+// Returns P * r * x / (x - 1) with x = (1 + r)^n, the payment formula of
+// getPaymentAmount() without rounding, and its slope with respect to r.
+// x is held below e^MAX_EXPONENT, where x / (x - 1) is 1 anyway.
+static double annuityPayment(const double months, const double principal,
+	const double rate, double* slope)
+{
+	double growth = 0;            // x - 1 = (1 + r)^n - 1
+	double factor = 0;            // x / (x - 1)
+
+	if (rate == 0)
+	{
+		*slope = principal * (months + ONE) / (2.0 * months);
+		return principal / months;
+	}
+	growth = expm1(fmin(months * log1p(rate), MAX_EXPONENT));
+	factor = (growth + ONE) / growth;
+	*slope = principal * (factor -
+		rate * months * factor / ((ONE + rate) * growth));
+	return principal * rate * factor;
+}
+
+// Starting monthly rate. With y = n * r the payment formula is close to
+// n * payment / principal = z = y / (1 - e^-y), whose answer is near
+// 2 * (z - 1) for small y and near z * (1 - e^-z) for large y; the smaller
+// of the two is within a few percent of it everywhere.
+static double startingRate(const int months, const double principal,
+	const double payment)
+{
+	const double high = payment / principal;
+	const double z = high * months;
+	double rate = fmin(2 * (z - ONE), -z * expm1(-z)) / months;
+
+	if (!(rate > 0) || !(rate < high))
+		rate = high / 2;
+	return rate;
+}
+
+// Records the result of an offer.
+static void finishOffer(RateOffers* offers, const size_t offer,
+	const double rate, const int status, const int count)
+{
+	offers->rates[offer] = rate;
+	offers->status[offer] = status;
+	if (offers->iterations != NULL)
+		offers->iterations[offer] = count;
+	offers->steps += count;
+	if (status == RATE_SOLVED)
+		offers->solved++;
+}
+
+// Puts the next offer that needs a search into a lane, finishing offers
+// that do not on the way. Returns 0 when no offers are left; the lane then
+// holds a harmless flat loan.
+static int fillLane(RateOffers* offers, SolverLanes* lanes, const int lane)
+{
+	while (offers->next < offers->count)
+	{
+		const size_t i = offers->next++;
+		const int months = offers->months[i];
+		const double principal = offers->principal[i];
+		const double payment = offers->payment[i];
+
+		if ((months <= 0) || !(principal > 0) || !(payment > 0) ||
+			!isfinite(principal) || !isfinite(payment))
+			finishOffer(offers, i, NO_RATE, RATE_BAD_INPUT, 0);
+		else if (payment * months < principal)
+			finishOffer(offers, i, NO_RATE, RATE_NO_SOLUTION, 0);
+		else if (payment * months == principal)
+			finishOffer(offers, i, 0, RATE_SOLVED, 0);
+		else
+		{
+			lanes->rate[lane] = startingRate(months, principal, payment);
+			lanes->low[lane] = 0;
+			lanes->high[lane] = payment / principal;
+			lanes->months[lane] = months;
+			lanes->principal[lane] = principal;
+			lanes->payment[lane] = payment;
+			lanes->offer[lane] = i;
+			lanes->count[lane] = 0;
+			lanes->busy[lane] = 1;
+			return 1;
+		}
+	}
+	lanes->rate[lane] = 0;
+	lanes->low[lane] = 0;
+	lanes->high[lane] = ONE;
+	lanes->months[lane] = ONE;
+	lanes->principal[lane] = ONE;
+	lanes->payment[lane] = ONE;
+	lanes->busy[lane] = 0;
+	return 0;
+}
+
+// Counts an iteration of a busy lane and, once its offer has converged or
+// run out of iterations, records it and refills the lane. Returns 1 while
+// the lane is busy.
+static int checkLane(RateOffers* offers, SolverLanes* lanes, const int lane,
+	const int converged)
+{
+	const int count = ++lanes->count[lane];
+	const double rate = lanes->rate[lane] * MONTHLY_DIVISOR;
+
+	if (converged)
+		finishOffer(offers, lanes->offer[lane], rate, RATE_SOLVED, count);
+	else if (count >= MAX_RATE_ITERATIONS)
+		finishOffer(offers, lanes->offer[lane], rate, RATE_NO_CONVERGENCE,
+			count);
+	else
+		return 1;
+	return fillLane(offers, lanes, lane);
+}
+
+// One step of the solveInterestRate() search in every busy lane. Returns a
+// bit per lane that has converged.
+static int stepScalar(SolverLanes* lanes, const double tolerance)
+{
+	int converged = 0;
+
+	for (int k = 0; k < SOLVER_LANES; k++)
+	{
+		double rate = lanes->rate[k];
+		double slope = 0;
+		double step = 0;
+		double error = 0;
+
+		if (!lanes->busy[k])
+			continue;
+		error = annuityPayment(lanes->months[k], lanes->principal[k], rate,
+			&slope) - lanes->payment[k];
+		if (error > 0)
+			lanes->high[k] = rate;
+		else
+			lanes->low[k] = rate;
+		step = (slope > 0) ? error / slope : 0;
+		if ((error != 0) && ((slope <= 0) ||
+			(rate - step <= lanes->low[k]) || (rate - step >= lanes->high[k])))
+			step = rate - (lanes->low[k] + lanes->high[k]) / 2;
+		lanes->rate[k] = rate - step;
+		if ((fabs(step) <= tolerance) ||
+			(lanes->high[k] - lanes->low[k] <= tolerance) || (error == 0))
+			converged |= 1 << k;
+	}
+	return converged;
+}
+
+#ifdef SOLVER_X86
+// log1p(r) of four rates, r >= 0, the C library way: r = 2^k * (1 + f) - 1
+// with 1 + f near 1, and c the rounding error of 1 + r.
+TARGET_AVX2
+static __m256d log1pAvx2(const __m256d r)
+{
+	const __m256d one = _mm256_set1_pd(ONE);
+	const __m256d u = _mm256_add_pd(one, r);
+	const __m256i bits = _mm256_add_epi64(_mm256_castpd_si256(u),
+		_mm256_set1_epi64x(0x95f619980c433LL));   // Moves sqrt(2) to 2
+	const __m256d small = _mm256_cmp_pd(r, _mm256_set1_pd(SQRT2_MINUS_ONE),
+		_CMP_LT_OQ);
+	__m256d k = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(
+		_mm256_srli_epi64(bits, 52), _mm256_castpd_si256(
+		_mm256_set1_pd(TWO_52)))), _mm256_set1_pd(TWO_52 + EXPONENT_BIAS));
+	__m256d f = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_add_epi64(
+		_mm256_and_si256(bits, _mm256_set1_epi64x(0xfffffffffffffLL)),
+		_mm256_set1_epi64x(0x3fe6a09e667f3bcdLL))), one);
+	__m256d c = _mm256_blendv_pd(_mm256_sub_pd(r, _mm256_sub_pd(u, one)),
+		_mm256_sub_pd(one, _mm256_sub_pd(u, r)),
+		_mm256_cmp_pd(k, _mm256_set1_pd(2), _CMP_GE_OQ));
+	__m256d s = _mm256_setzero_pd();
+	__m256d z = _mm256_setzero_pd();
+	__m256d w = _mm256_setzero_pd();
+	__m256d odd = _mm256_setzero_pd();
+	__m256d even = _mm256_setzero_pd();
+	__m256d hfsq = _mm256_setzero_pd();
+
+	c = _mm256_and_pd(_mm256_div_pd(c, u), _mm256_cmp_pd(k,
+		_mm256_set1_pd(54), _CMP_LT_OQ));
+	c = _mm256_andnot_pd(small, c);          // Small rates need no c or k
+	k = _mm256_andnot_pd(small, k);
+	f = _mm256_blendv_pd(f, r, small);
+	hfsq = _mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(HALF), f), f);
+	s = _mm256_div_pd(f, _mm256_add_pd(_mm256_set1_pd(2), f));
+	z = _mm256_mul_pd(s, s);
+	w = _mm256_mul_pd(z, z);
+	odd = _mm256_add_pd(_mm256_set1_pd(LOG_TERMS[4]),
+		_mm256_mul_pd(w, _mm256_set1_pd(LOG_TERMS[6])));
+	odd = _mm256_add_pd(_mm256_set1_pd(LOG_TERMS[2]), _mm256_mul_pd(w, odd));
+	odd = _mm256_mul_pd(z, _mm256_add_pd(_mm256_set1_pd(LOG_TERMS[0]),
+		_mm256_mul_pd(w, odd)));
+	even = _mm256_add_pd(_mm256_set1_pd(LOG_TERMS[3]),
+		_mm256_mul_pd(w, _mm256_set1_pd(LOG_TERMS[5])));
+	even = _mm256_mul_pd(w, _mm256_add_pd(_mm256_set1_pd(LOG_TERMS[1]),
+		_mm256_mul_pd(w, even)));
+	// s * (hfsq + R) + (k * LN2_LO + c) - hfsq + f + k * LN2_HI
+	s = _mm256_mul_pd(s, _mm256_add_pd(hfsq, _mm256_add_pd(odd, even)));
+	s = _mm256_add_pd(s, _mm256_add_pd(_mm256_mul_pd(k,
+		_mm256_set1_pd(LN2_LO)), c));
+	s = _mm256_add_pd(_mm256_sub_pd(s, hfsq), f);
+	return _mm256_add_pd(s, _mm256_mul_pd(k, _mm256_set1_pd(LN2_HI)));
+}
+
+// expm1(y) of four exponents: y = k * ln 2 + t with |t| <= ln 2 / 2, then
+// e^y - 1 = 2^k * expm1(t) + (2^k - 1), exact in t when k is 0.
+TARGET_AVX2
+static __m256d expm1Avx2(__m256d y)
+{
+	const __m256d magic = _mm256_set1_pd(ROUND_MAGIC);
+	__m256d k = _mm256_setzero_pd();
+	__m256d t = _mm256_setzero_pd();
+	__m256d e = _mm256_set1_pd(EXPM1_COEFFICIENTS[EXPM1_TERMS - 1]);
+	__m256d scale = _mm256_setzero_pd();
+
+	y = _mm256_max_pd(_mm256_min_pd(y, _mm256_set1_pd(MAX_EXPONENT)),
+		_mm256_set1_pd(-MAX_EXPONENT));
+	k = _mm256_round_pd(_mm256_mul_pd(y, _mm256_set1_pd(INV_LN2)),
+		_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+	t = _mm256_sub_pd(_mm256_sub_pd(y, _mm256_mul_pd(k,
+		_mm256_set1_pd(LN2_HI))), _mm256_mul_pd(k, _mm256_set1_pd(LN2_LO)));
+	for (int i = EXPM1_TERMS - 2; i >= 0; i--)
+		e = _mm256_add_pd(_mm256_set1_pd(EXPM1_COEFFICIENTS[i]),
+			_mm256_mul_pd(t, e));
+	e = _mm256_mul_pd(t, _mm256_add_pd(_mm256_set1_pd(ONE),
+		_mm256_mul_pd(t, e)));
+	scale = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_add_epi64(
+		_mm256_castpd_si256(_mm256_add_pd(k, magic)),
+		_mm256_set1_epi64x(EXPONENT_BIAS)), 52));          // 2^k
+	return _mm256_add_pd(_mm256_mul_pd(scale, e),
+		_mm256_sub_pd(scale, _mm256_set1_pd(ONE)));
+}
+
+// annuityPayment() of four lanes.
+TARGET_AVX2
+static __m256d annuityAvx2(const __m256d months, const __m256d principal,
+	const __m256d rate, __m256d* slope)
+{
+	const __m256d one = _mm256_set1_pd(ONE);
+	const __m256d flat = _mm256_cmp_pd(rate, _mm256_setzero_pd(), _CMP_EQ_OQ);
+	const __m256d growth = expm1Avx2(_mm256_mul_pd(months, log1pAvx2(rate)));
+	const __m256d factor = _mm256_div_pd(_mm256_add_pd(growth, one), growth);
+	__m256d change = _mm256_div_pd(_mm256_mul_pd(_mm256_mul_pd(rate, months),
+		factor), _mm256_mul_pd(_mm256_add_pd(one, rate), growth));
+
+	change = _mm256_mul_pd(principal, _mm256_sub_pd(factor, change));
+	*slope = _mm256_blendv_pd(change, _mm256_div_pd(_mm256_mul_pd(principal,
+		_mm256_add_pd(months, one)), _mm256_mul_pd(_mm256_set1_pd(2.0),
+		months)), flat);
+	return _mm256_blendv_pd(_mm256_mul_pd(_mm256_mul_pd(principal, rate),
+		factor), _mm256_div_pd(principal, months), flat);
+}
+
+// Same as stepScalar(), four lanes per instruction. Idle lanes are stepped
+// too; they hold a flat loan and are never checked.
+TARGET_AVX2
+static int stepAvx2(SolverLanes* lanes, const double tolerance)
+{
+	const __m256d zero = _mm256_setzero_pd();
+	const __m256d limit = _mm256_set1_pd(tolerance);
+	const __m256d sign = _mm256_set1_pd(-0.0);
+	int converged = 0;
+
+	for (int k = 0; k < SOLVER_LANES; k += AVX2_LANES)
+	{
+		__m256d rate = _mm256_loadu_pd(lanes->rate + k);
+		__m256d low = _mm256_loadu_pd(lanes->low + k);
+		__m256d high = _mm256_loadu_pd(lanes->high + k);
+		__m256d slope = zero;
+		__m256d error = _mm256_sub_pd(annuityAvx2(
+			_mm256_loadu_pd(lanes->months + k),
+			_mm256_loadu_pd(lanes->principal + k), rate, &slope),
+			_mm256_loadu_pd(lanes->payment + k));
+		__m256d above = _mm256_cmp_pd(error, zero, _CMP_GT_OQ);
+		__m256d step = zero;
+		__m256d bisect = zero;
+		__m256d done = zero;
+
+		high = _mm256_blendv_pd(high, rate, above);
+		low = _mm256_blendv_pd(rate, low, above);
+		step = _mm256_and_pd(_mm256_div_pd(error, slope),
+			_mm256_cmp_pd(slope, zero, _CMP_GT_OQ));
+		bisect = _mm256_or_pd(_mm256_cmp_pd(slope, zero, _CMP_LE_OQ),
+			_mm256_or_pd(_mm256_cmp_pd(_mm256_sub_pd(rate, step), low,
+			_CMP_LE_OQ), _mm256_cmp_pd(_mm256_sub_pd(rate, step), high,
+			_CMP_GE_OQ)));
+		bisect = _mm256_andnot_pd(_mm256_cmp_pd(error, zero, _CMP_EQ_OQ),
+			bisect);                              // Stay on an exact answer
+		step = _mm256_blendv_pd(step, _mm256_sub_pd(rate, _mm256_mul_pd(
+			_mm256_add_pd(low, high), _mm256_set1_pd(HALF))), bisect);
+		rate = _mm256_sub_pd(rate, step);
+		done = _mm256_or_pd(_mm256_cmp_pd(_mm256_andnot_pd(sign, step), limit,
+			_CMP_LE_OQ), _mm256_or_pd(_mm256_cmp_pd(_mm256_sub_pd(high, low),
+			limit, _CMP_LE_OQ), _mm256_cmp_pd(error, zero, _CMP_EQ_OQ)));
+
+		_mm256_storeu_pd(lanes->rate + k, rate);
+		_mm256_storeu_pd(lanes->low + k, low);
+		_mm256_storeu_pd(lanes->high + k, high);
+		converged |= _mm256_movemask_pd(done) << k;
+	}
+	return converged;
+}
+#endif
+//----------------------------------------------------------------------------
+// Function:	    size_t SolveInterestRates(const int* months,
+//						const double* principal, const double* payment,
+//						double* rates, int* status, int* iterations,
+//						const size_t count, const double tolerance)
+//
+// Description:		Solves the getPaymentAmount() formula for the interest
+//					rate of count offers, each given by months[i],
+//					principal[i] and payment[i]. Every offer gets a status:
+//					RATE_SOLVED with its rate, RATE_BAD_INPUT or
+//					RATE_NO_SOLUTION with NO_RATE, or RATE_NO_CONVERGENCE
+//					with the last estimate. Prints nothing.
+//
+// Parameters:	    const (int*)    months       Number of payments
+//				    const (double*) principal    Amount of each loan
+//				    const (double*) payment      Monthly payment of each loan
+//				    (double*)       rates        Receives annual rates
+//				    (int*)          status       Receives RATE_* codes
+//				    (int*)          iterations   Receives iterations per
+//												 offer (may be NULL)
+//				    const (size_t)  count        Number of offers
+//				    const (double)  tolerance    Accuracy of the annual rate
+//												 (in percent) to stop at
+//
+// Returns:		    (size_t) solved   Number of offers with RATE_SOLVED
+// Date:            10/17/2026
+// Calls:		    GetSimdLevel(), CountMetric()
+// History Log:     10/17/2026  added for the batch interest rate solver
+//				    10/17/2026  counts offers, iterations and failures
+//----------------------------------------------------------------------------
+size_t SolveInterestRates(const int* months, const double* principal,
+	const double* payment, double* rates, int* status, int* iterations,
+	const size_t count, const double tolerance)
+{
+	RateOffers offers = { months, principal, payment, rates, status,
+		iterations, count, 0, 0, 0 };
+	SolverLanes lanes;
+	const double monthlyTolerance = tolerance / MONTHLY_DIVISOR;
+#ifdef SOLVER_X86
+	const int vector = (GetSimdLevel() != SIMD_SCALAR);
+#endif
+	int busy = 0;
+
+	for (int k = 0; k < SOLVER_LANES; k++)
+		busy += fillLane(&offers, &lanes, k);
+	while (busy > 0)
+	{
+		int converged = 0;
+
+#ifdef SOLVER_X86
+		if (vector)
+			converged = stepAvx2(&lanes, monthlyTolerance);
+		else
+#endif
+			converged = stepScalar(&lanes, monthlyTolerance);
+		for (int k = 0; k < SOLVER_LANES; k++)
+			if (lanes.busy[k])
+				busy += checkLane(&offers, &lanes, k,
+					(converged >> k) & 1) - 1;
+	}
+	CountMetric(METRIC_SOLVER_CALLS, (long long)count);
+	CountMetric(METRIC_SOLVER_ITERATIONS, offers.steps);
+	CountMetric(METRIC_SOLVER_FAILURES, (long long)(count - offers.solved));
+	return offers.solved;
+}
@@ -0,0 +1,27 @@
+//----------------------------------------------------------------------------
+// File:			amort_solver.h
+//
+// Description:     Header file for the batch interest rate solver
+//					(amort_solver.c). Solves the getPaymentAmount() formula
+//					for the rate of many offers at once, given as columns of
+//					months, principal and payment, and reports for each one
+//					whether it was solved instead of searching forever.
+//
+// History Log:    10/17/2026  added for the batch interest rate solver
+//----------------------------------------------------------------------------
+
+#ifndef AMORT_SOLVER_H
+#define AMORT_SOLVER_H
+#include <stddef.h>
+
+#define RATE_SOLVED 0
+#define RATE_BAD_INPUT 1            // Months, principal or payment not > 0
+#define RATE_NO_SOLUTION 2          // payment * months is below principal
+#define RATE_NO_CONVERGENCE 3       // MAX_RATE_ITERATIONS reached
+#define SOLVER_LANES 8              // Offers in flight at a time
+
+size_t SolveInterestRates(const int* months, const double* principal,
+	const double* payment, double* rates, int* status, int* iterations,
+	const size_t count, const double tolerance);
+
+#endif
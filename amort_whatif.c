@@ -0,0 +1,360 @@
+//----------------------------------------------------------------------------
+// File:			amort_whatif.c
+//
+// Description      Incremental what-if tables for the Amort library. A
+//					change marks the first month it can reach and rows from
+//					there on are rebuilt with FillScheduleRows(), one run of
+//					months with the same payment and rate at a time,
+//					starting from the balance of the row before. Each new
+//					row is compared with the old one as it is stored, which
+//					gives the diff, and the running totals are extended from
+//					the row before, so the totals and every row match
+//					BuildSchedule() bit for bit when payment and rate do not
+//					change along the way.
+//
+// Functions:	    int StartWhatIf(WhatIfSchedule* whatIf,
+//						const double loanSize, const double paymentSize,
+//						const double interestRate, const int months)
+//					int ChangeWhatIf(WhatIfSchedule* whatIf,
+//						const char value, const double amount,
+//						const int fromMonth)
+//					void WriteWhatIfChanges(ScheduleWriter* writer,
+//						const WhatIfSchedule* whatIf)
+//					void FreeWhatIf(WhatIfSchedule* whatIf)
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include "amort.h"
+#include "amort_whatif.h"
+
+#define WHATIF_ARRAYS 6             // payments .. interestCents
+#define WHATIF_ARENA (FIVE_HUNDRED_YEARS * (sizeof(ScheduleRow) + \
+	sizeof(RowChange) + WHATIF_ARRAYS * sizeof(double)) + \
+	(WHATIF_ARRAYS + 2) * ARENA_ALIGNMENT)
+
+static int rowsDiffer(const ScheduleRow* first, const ScheduleRow* second)
+{
+	return (first->payment != second->payment) ||
+		(first->principal != second->principal) ||
+		(first->interest != second->interest) ||
+		(first->balance != second->balance) ||
+		(first->interestToDate != second->interestToDate);
+}
+
+static void addChange(WhatIfSchedule* whatIf, const int month,
+	const char kind, const ScheduleRow* before)
+{
+	RowChange* change = &whatIf->changes[whatIf->changeCount++];
+
+	change->month = month;
+	change->kind = kind;
+	if (before != NULL)
+		change->before = *before;
+	else
+		memset(&change->before, 0, sizeof(ScheduleRow));
+}
+
+// Rebuilds months first .. months and drops any rows after them. Each
+// rebuilt row is compared with the old one as it is stored over it, and
+// interestToDate and the running totals go on from the row before.
+static void recompute(WhatIfSchedule* whatIf, const int first,
+	const int months)
+{
+	Schedule* schedule = &whatIf->schedule;
+	ScheduleRow chunk[WHATIF_CHUNK];
+	int cents = (GetScheduleEngine() == ENGINE_CENTS);
+	int oldMonths = schedule->months;
+	int month = first;
+	int before = first - 2;         // Row the rebuilt ones go on from
+	double balance = (first > 1) ? schedule->rows[before].balance :
+		schedule->loanSize;
+	double interestToDate = (first > 1) ?
+		schedule->rows[before].interestToDate : 0;
+	double paid = (first > 1) ? whatIf->paidToDate[before] : 0;
+	double principal = (first > 1) ? whatIf->principalToDate[before] : 0;
+	double interest = (first > 1) ? whatIf->interestSum[before] : 0;
+	Cents interestCents = (first > 1) ? whatIf->interestCents[before] : 0;
+
+	whatIf->changeCount = 0;
+	whatIf->firstMonth = first;
+	whatIf->recomputed = 0;
+	while (month <= months)
+	{
+		double payment = whatIf->payments[month - 1];
+		double rate = whatIf->rates[month - 1];
+		int run = 1;
+		int filled = 0;
+		int whole = 0;
+		Cents runCents = 0;
+
+		while ((run < WHATIF_CHUNK) && (month + run <= months) &&
+			(whatIf->payments[month + run - 1] == payment) &&
+			(whatIf->rates[month + run - 1] == rate))
+			run++;
+		filled = FillScheduleRows(chunk, balance, payment, rate, months,
+			month, run);
+		whole = cents && CentsRateFits(rate);
+		for (int i = 0; i < filled; i++)
+		{
+			ScheduleRow* row = &chunk[i];
+			ScheduleRow* old = &schedule->rows[month + i - 1];
+
+			whole = whole &&                // Where FillScheduleRows() was
+				CentsAmountFits((i == 0) ? balance : chunk[i - 1].balance,
+				payment) && (runCents <= MAX_CENTS_TO_DATE) &&
+				(runCents >= -MAX_CENTS_TO_DATE) &&     // still on cents
+				(interestCents <= MAX_CENTS_TO_DATE) &&
+				(interestCents >= -MAX_CENTS_TO_DATE);
+			runCents += ToCents(row->interest);
+			if (whole)                      // Whole cents were added
+			{
+				interestCents += ToCents(row->interest);
+				interestToDate = (double)interestCents / HUNDRED;
+			}
+			else
+			{
+				interestToDate += row->interest;
+				interestCents = ToCents(interestToDate);
+			}
+			row->interestToDate = interestToDate;
+			whatIf->interestCents[month + i - 1] = interestCents;
+			whatIf->paidToDate[month + i - 1] = paid += row->payment;
+			whatIf->principalToDate[month + i - 1] =
+				principal += row->principal;
+			whatIf->interestSum[month + i - 1] = interest += row->interest;
+			if (month + i > oldMonths)
+				addChange(whatIf, month + i, ROW_ADDED, NULL);
+			else if (rowsDiffer(old, row))
+				addChange(whatIf, month + i, ROW_CHANGED, old);
+			*old = *row;
+		}
+		balance = chunk[filled - 1].balance;
+		whatIf->recomputed += filled;
+		month += filled;
+	}
+	for (month = months + 1; month <= oldMonths; month++)
+		addChange(whatIf, month, ROW_REMOVED, &schedule->rows[month - 1]);
+
+	schedule->months = months;
+	schedule->totalPaid = whatIf->paidToDate[months - 1];
+	schedule->totalPrincipal = whatIf->principalToDate[months - 1];
+	schedule->totalInterest = whatIf->interestSum[months - 1];
+}
+//----------------------------------------------------------------------------
+// Function:	    int StartWhatIf(WhatIfSchedule* whatIf,
+//						const double loanSize, const double paymentSize,
+//						const double interestRate, const int months)
+//
+// Description:		Builds the whole table of a loan to change later with
+//					ChangeWhatIf(). The diff it leaves is empty.
+//
+// Parameters:	    (WhatIfSchedule*) whatIf         What-if table to set up
+//				    const double      loanSize       Total size of loan
+//				    const double      paymentSize    Monthly payment amount
+//				    const double      interestRate   Annual interest rate
+//				    const int         months         Number of payments,
+//													 1 to FIVE_HUNDRED_YEARS
+//
+// Returns:		    (int) 1 on success, 0 for a bad term or no memory
+// Date:            10/17/2026
+// Called By:       WhatIfTable(), main() of bench_whatif
+// Calls:		    InitArena(), ArenaAlloc(), recompute()
+// History Log:     10/17/2026  added for incremental what-if tables
+//----------------------------------------------------------------------------
+int StartWhatIf(WhatIfSchedule* whatIf, const double loanSize,
+	const double paymentSize, const double interestRate, const int months)
+{
+	ScheduleArena* arena = &whatIf->arena;
+	const size_t amounts = FIVE_HUNDRED_YEARS * sizeof(double);
+
+	memset(whatIf, 0, sizeof(WhatIfSchedule));
+	if ((months < 1) || (months > FIVE_HUNDRED_YEARS) ||
+		!InitArena(arena, WHATIF_ARENA))
+		return 0;
+	whatIf->schedule.rows = (ScheduleRow*)ArenaAlloc(arena,
+		FIVE_HUNDRED_YEARS * sizeof(ScheduleRow));
+	whatIf->changes = (RowChange*)ArenaAlloc(arena,
+		FIVE_HUNDRED_YEARS * sizeof(RowChange));
+	whatIf->payments = (double*)ArenaAlloc(arena, amounts);
+	whatIf->rates = (double*)ArenaAlloc(arena, amounts);
+	whatIf->paidToDate = (double*)ArenaAlloc(arena, amounts);
+	whatIf->principalToDate = (double*)ArenaAlloc(arena, amounts);
+	whatIf->interestSum = (double*)ArenaAlloc(arena, amounts);
+	whatIf->interestCents = (Cents*)ArenaAlloc(arena,
+		FIVE_HUNDRED_YEARS * sizeof(Cents));
+	if (whatIf->interestCents == NULL)
+	{
+		FreeWhatIf(whatIf);
+		return 0;
+	}
+
+	whatIf->schedule.loanSize = loanSize;
+	whatIf->schedule.paymentSize = paymentSize;
+	whatIf->schedule.interestRate = interestRate;
+	for (int i = 0; i < months; i++)
+	{
+		whatIf->payments[i] = paymentSize;
+		whatIf->rates[i] = interestRate;
+	}
+	recompute(whatIf, 1, months);
+	whatIf->changeCount = 0;
+	return 1;
+}
+//----------------------------------------------------------------------------
+// Function:	    int ChangeWhatIf(WhatIfSchedule* whatIf,
+//						const char value, const double amount,
+//						const int fromMonth)
+//
+// Description:		Changes one value of a what-if table and rebuilds the
+//					rows it reaches:
+//
+//					    WHATIF_PAYMENT   payment from fromMonth on
+//					    WHATIF_RATE      rate from fromMonth on
+//					    WHATIF_TERM      number of payments; new months
+//										 keep the last month's payment
+//										 and rate
+//					    WHATIF_LOAN      loan size; every row
+//
+//					fromMonth is clipped to the term. A change that leaves
+//					every month's payment and 1/8th rounded rate as they
+//					were rebuilds nothing. whatIf->changes then lists the
+//					rows that differ, in month order: changed, added and
+//					removed.
+//
+// Parameters:	    (WhatIfSchedule*) whatIf      Table from StartWhatIf()
+//				    const char        value       Which value, see above
+//				    const double      amount      New value; the term as a
+//												  whole number of months
+//				    const int         fromMonth   First month to change,
+//												  for payment and rate
+//
+// Returns:		    (int) rows   Rows recomputed, -1 for an unknown value
+//								 or a term out of range
+// Date:            10/17/2026
+// Called By:       WhatIfTable(), main() of bench_whatif
+// Calls:		    recompute(), roundInterest()
+// History Log:     10/17/2026  added for incremental what-if tables
+//----------------------------------------------------------------------------
+int ChangeWhatIf(WhatIfSchedule* whatIf, const char value,
+	const double amount, const int fromMonth)
+{
+	Schedule* schedule = &whatIf->schedule;
+	int months = schedule->months;
+	int from = (fromMonth < 1) ? 1 : (fromMonth > months) ? months : fromMonth;
+	int changed = 0;
+
+	switch (value)
+	{
+	case WHATIF_PAYMENT:
+		for (int i = from - 1; i < months; i++)
+		{
+			changed |= (whatIf->payments[i] != amount);
+			whatIf->payments[i] = amount;
+		}
+		if (from == 1)
+			schedule->paymentSize = amount;
+		break;
+	case WHATIF_RATE:
+		for (int i = from - 1; i < months; i++)
+		{
+			changed |= (roundInterest(whatIf->rates[i], 8) !=
+				roundInterest(amount, 8));
+			whatIf->rates[i] = amount;
+		}
+		if (from == 1)
+			schedule->interestRate = amount;
+		break;
+	case WHATIF_LOAN:
+		from = 1;
+		changed = (schedule->loanSize != amount);
+		schedule->loanSize = amount;
+		break;
+	case WHATIF_TERM:
+		if ((amount != floor(amount)) || (amount < 1) ||
+			(amount > FIVE_HUNDRED_YEARS))
+			return -1;
+		for (int i = months; i < (int)amount; i++)
+		{
+			whatIf->payments[i] = whatIf->payments[months - 1];
+			whatIf->rates[i] = whatIf->rates[months - 1];
+		}
+		from = (months < (int)amount) ? months : (int)amount;
+		changed = ((int)amount != months);
+		months = (int)amount;
+		break;
+	default:
+		return -1;
+	}
+
+	if (!changed)
+	{
+		whatIf->changeCount = 0;
+		whatIf->firstMonth = from;
+		whatIf->recomputed = 0;
+		return 0;
+	}
+	recompute(whatIf, from, months);
+	return whatIf->recomputed;
+}
+//----------------------------------------------------------------------------
+// Function:	    void WriteWhatIfChanges(ScheduleWriter* writer,
+//						const WhatIfSchedule* whatIf)
+//
+// Description:		Writes the row diff of the last change as table rows,
+//					each marked at its end: a changed month as its old row
+//					("was") and its new row ("now"), an added month as its
+//					new row ("new") and a removed month as its old row
+//					("removed").
+//
+// Parameters:	    (ScheduleWriter*)       writer   Open writer
+//				    const (WhatIfSchedule*) whatIf   Table that changed
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       WhatIfTable()
+// Calls:		    WriteScheduleRow(), WriteScheduleText()
+// History Log:     10/17/2026  added for incremental what-if tables
+//----------------------------------------------------------------------------
+void WriteWhatIfChanges(ScheduleWriter* writer,
+	const WhatIfSchedule* whatIf)
+{
+	for (int i = 0; i < whatIf->changeCount; i++)
+	{
+		const RowChange* change = &whatIf->changes[i];
+		const ScheduleRow* row = &whatIf->schedule.rows[change->month - 1];
+
+		if (change->kind != ROW_ADDED)
+		{
+			WriteScheduleRow(writer, change->month, change->before.payment,
+				change->before.principal, change->before.interest,
+				change->before.balance);
+			WriteScheduleText(writer, (change->kind == ROW_REMOVED) ?
+				"   removed" : "   was");
+		}
+		if (change->kind != ROW_REMOVED)
+		{
+			WriteScheduleRow(writer, row->month, row->payment,
+				row->principal, row->interest, row->balance);
+			WriteScheduleText(writer, (change->kind == ROW_ADDED) ?
+				"   new" : "   now");
+		}
+	}
+}
+//----------------------------------------------------------------------------
+// Function:	    void FreeWhatIf(WhatIfSchedule* whatIf)
+//
+// Description:		Releases the rows and arrays of a what-if table.
+//
+// Parameters:	    (WhatIfSchedule*) whatIf   Table to free
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       StartWhatIf(), WhatIfTable(), main() of bench_whatif
+// Calls:		    FreeArena()
+// History Log:     10/17/2026  added for incremental what-if tables
+//----------------------------------------------------------------------------
+void FreeWhatIf(WhatIfSchedule* whatIf)
+{
+	FreeArena(&whatIf->arena);
+	memset(whatIf, 0, sizeof(WhatIfSchedule));
+}
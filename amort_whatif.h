@@ -0,0 +1,65 @@
+//----------------------------------------------------------------------------
+// File:			amort_whatif.h
+//
+// Description:     Header file for incremental what-if tables
+//					(amort_whatif.c). A what-if table keeps every row of a
+//					loan and the payment and rate of every month, so one
+//					value can be changed at a time: the payment or the rate
+//					from a given month on, the term, or the loan size. Only
+//					the rows the change can reach are worked out again; a
+//					new payment from month k leaves rows 1 .. k - 1 alone,
+//					and a longer term recomputes only the old last row and
+//					adds the new ones. Each change leaves a row diff behind
+//					for the screen.
+//
+// History Log:    10/17/2026  added for incremental what-if tables
+//----------------------------------------------------------------------------
+
+#ifndef AMORT_WHATIF_H
+#define AMORT_WHATIF_H
+#include "amort_cents.h"
+#include "amort_schedule.h"
+#include "amort_writer.h"
+
+#define WHATIF_CHUNK 256            // Rows recomputed per FillScheduleRows()
+#define WHATIF_PAYMENT 'P'          // Menu letters, as LoanRecord.unknown
+#define WHATIF_LOAN 'L'
+#define WHATIF_TERM 'N'
+#define WHATIF_RATE 'I'
+#define ROW_CHANGED 'C'
+#define ROW_ADDED 'A'
+#define ROW_REMOVED 'R'
+
+typedef struct
+{
+	int month;
+	char kind;                      // ROW_CHANGED, ROW_ADDED, ROW_REMOVED
+	ScheduleRow before;             // Row before the change, if there was one
+} RowChange;
+
+typedef struct
+{
+	Schedule schedule;              // Current rows and totals; paymentSize
+									// and interestRate are month 1's
+	double* payments;               // Payment of month m at [m - 1]
+	double* rates;                  // Annual rate of month m at [m - 1]
+	double* paidToDate;             // Running totals, as BuildSchedule()
+	double* principalToDate;        // adds them up
+	double* interestSum;
+	Cents* interestCents;           // interestToDate of the cents engine
+	RowChange* changes;             // Rows the last change touched
+	int changeCount;
+	int firstMonth;                 // First month the last change recomputed
+	int recomputed;                 // Rows it recomputed
+	ScheduleArena arena;            // Holds all of the above
+} WhatIfSchedule;
+
+int StartWhatIf(WhatIfSchedule* whatIf, const double loanSize,
+	const double paymentSize, const double interestRate, const int months);
+int ChangeWhatIf(WhatIfSchedule* whatIf, const char value,
+	const double amount, const int fromMonth);
+void WriteWhatIfChanges(ScheduleWriter* writer,
+	const WhatIfSchedule* whatIf);
+void FreeWhatIf(WhatIfSchedule* whatIf);
+
+#endif
@@ -0,0 +1,535 @@
+//----------------------------------------------------------------------------
+// File:			amort_writer.c
+//
+// Description      Buffered schedule writer for the Amort library. Rows are
+//					formatted without printf: money values take a fixed two
+//					decimal path that gives the same digits as "%.2lf" and
+//					only values printf might round differently (exact half
+//					cents, huge amounts, NaN) go through snprintf. The
+//					buffer is written in WRITER_BUFFER sized blocks.
+//
+// Functions:	    int OpenScheduleWriter(ScheduleWriter* writer,
+//						const char* filename, int mode)
+//					int AttachScheduleWriter(ScheduleWriter* writer, FILE* fp)
+//					void WriteScheduleText(ScheduleWriter* writer,
+//						const char* text)
+//					void WriteScheduleHeading(ScheduleWriter* writer,
+//						const double loanSize, const double interestRate,
+//						const int months)
+//					void WriteScheduleRow(ScheduleWriter* writer,
+//						const int month, const double payment,
+//						const double principal, const double interest,
+//						const double balance)
+//					void WriteSchedule(ScheduleWriter* writer,
+//						const Schedule* schedule)
+//					int FlushScheduleWriter(ScheduleWriter* writer)
+//					int CloseScheduleWriter(ScheduleWriter* writer)
+//					int FormatMoney(char* text, const double amount,
+//						const int width)
+//					int FormatCurrency(char* text, const size_t size,
+//						const double amount)
+//					int FormatCsvRow(char* text, const ScheduleRow* row)
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include "amort.h"
+#include "amort_metrics.h"
+#include "amort_platform.h"
+#include "amort_writer.h"
+
+#define FAST_MONEY_LIMIT 1e13       // Larger amounts go through snprintf
+#define TIE_TOLERANCE 4e-16         // Relative error of amount * HUNDRED
+#define MONTH_WIDTH 5
+#define MONEY_WIDTH 12
+
+// Writes value right justified in width columns, like "%*d".
+static int formatInt(char* text, int value, const int width)
+{
+	char digits[16];
+	int count = 0;
+	int length = 0;
+
+	if (value < 0)
+		return snprintf(text, 16, "%*d", width, value);
+	do
+	{
+		digits[count++] = (char)('0' + value % 10);
+		value /= 10;
+	} while (value > 0);
+	while (length < width - count)
+		text[length++] = ' ';
+	while (count > 0)
+		text[length++] = digits[--count];
+	text[length] = '\0';
+	return length;
+}
+// Rounds |amount| to whole cents as "%.2lf" would. Returns 0, leaving the
+// value to snprintf, if amount is FAST_MONEY_LIMIT or more, NaN, or so close
+// to half a cent that the rounding error of amount * HUNDRED could matter.
+static int toCents(const double amount, unsigned long long* cents)
+{
+	double scaled = fabs(amount) * HUNDRED;
+	double tie = 0;
+
+	if (!(fabs(amount) < FAST_MONEY_LIMIT))           // Also NaN
+		return 0;
+	tie = floor(scaled) + HALF;
+	if (fabs(scaled - tie) <= scaled * TIE_TOLERANCE)
+		return 0;
+	*cents = (unsigned long long)floor(scaled);
+	if (scaled > tie)
+		(*cents)++;
+	return 1;
+}
+//----------------------------------------------------------------------------
+// Function:	    int FormatMoney(char* text, const double amount,
+//									const int width)
+//
+// Description:		Writes amount with two decimals, right justified in
+//					width columns: the same text as sprintf(text, "%*.2lf",
+//					width, amount). The cents are worked out from
+//					amount * HUNDRED, unless that product lies so close to
+//					half a cent that its rounding error could change the
+//					answer; those values, and amounts of FAST_MONEY_LIMIT or
+//					more, are left to snprintf.
+//
+// Parameters:	    (char*)         text     Receives the text, at least
+//											 MONEY_TEXT_MAX bytes (and more
+//											 than width)
+//				    const (double)  amount   Value to write
+//				    const (int)     width    Minimum field width
+//
+// Returns:		    (int) length   Number of characters written
+// Date:            10/17/2026
+// Called By:       WriteScheduleRow()
+// Calls:		    toCents()
+// History Log:     10/17/2026  added for the buffered schedule writer
+//----------------------------------------------------------------------------
+int FormatMoney(char* text, const double amount, const int width)
+{
+	char digits[24];
+	int count = 0;
+	int length = 0;
+	int negative = signbit(amount) ? 1 : 0;
+	unsigned long long cents = 0;
+
+	if (!toCents(amount, &cents))
+		return snprintf(text, MONEY_TEXT_MAX, "%*.2lf", width, amount);
+	digits[count++] = (char)('0' + cents % 10);
+	digits[count++] = (char)('0' + (cents / 10) % 10);
+	digits[count++] = '.';
+	cents /= HUNDRED;
+	do
+	{
+		digits[count++] = (char)('0' + cents % 10);
+		cents /= 10;
+	} while (cents > 0);
+	if (negative)
+		digits[count++] = '-';
+	while (length < width - count)
+		text[length++] = ' ';
+	while (count > 0)
+		text[length++] = digits[--count];
+	text[length] = '\0';
+	return length;
+}
+//----------------------------------------------------------------------------
+// Function:	    int FormatCurrency(char* text, const size_t size,
+//									   const double amount)
+//
+// Description:		Writes amount as comma grouped dollars and cents, such
+//					as "$1,234,567.89" or "-$12.50", into a buffer of any
+//					size. The cents are rounded as "%.2lf" rounds them and
+//					amounts that round to zero lose their sign. Like
+//					snprintf(), at most size - 1 characters and a NUL are
+//					stored and the length of the whole text is returned, so
+//					a short buffer can be detected. Uses no heap and no
+//					locale: only huge amounts, NaN and near half cents go
+//					through snprintf, as in FormatMoney().
+//
+// Parameters:	    (char*)          text     Receives the text (may be NULL
+//											  if size is 0)
+//				    const (size_t)   size     Bytes available in text
+//				    const (double)   amount   Value to write
+//
+// Returns:		    (int) length   Characters in the whole text, not
+//								   counting the NUL
+// Date:            10/17/2026
+// Called By:       PrintCommas()
+// Calls:		    toCents()
+// History Log:     10/17/2026  replaces the branches of PrintCommas()
+//----------------------------------------------------------------------------
+int FormatCurrency(char* text, const size_t size, const double amount)
+{
+	char digits[CURRENCY_TEXT_MAX];
+	char plain[MONEY_TEXT_MAX];
+	char* end = digits + sizeof(digits);
+	char* first = end;
+	int zero = 0;
+	unsigned long long cents = 0;
+
+	if (toCents(amount, &cents))                      // Built right to left
+	{
+		unsigned long long dollars = cents / HUNDRED;
+		int fraction = (int)(cents % HUNDRED);
+
+		zero = (cents == 0);
+		*--first = (char)('0' + fraction % 10);
+		*--first = (char)('0' + fraction / 10);
+		*--first = '.';
+		while (dollars >= THOUSAND)
+		{
+			int group = (int)(dollars % THOUSAND);
+
+			first -= 4;
+			first[0] = ',';
+			first[1] = (char)('0' + group / 100);
+			first[2] = (char)('0' + group / 10 % 10);
+			first[3] = (char)('0' + group % 10);
+			dollars /= THOUSAND;
+		}
+		do
+		{
+			*--first = (char)('0' + dollars % 10);
+			dollars /= 10;
+		} while (dollars > 0);
+	}
+	else
+	{
+		int length = snprintf(plain, sizeof(plain), "%.2lf", fabs(amount));
+		int point = length;
+
+		while ((point > 0) && (plain[point - 1] != '.'))
+			point--;
+		if (point == 0)                               // inf or nan
+			point = length + 1;
+		for (int i = length - 1; i >= point - 1; i--)
+			*--first = plain[i];
+		for (int i = point - 2, n = 0; i >= 0; i--, n++)
+		{
+			if ((n > 0) && (n % 3 == 0))
+				*--first = ',';
+			*--first = plain[i];
+		}
+		zero = (strcmp(plain, "0.00") == 0);
+	}
+	*--first = '$';
+	if (signbit(amount) && !zero)
+		*--first = '-';
+
+	if (size > 0)
+	{
+		size_t stored = ((size_t)(end - first) < size) ?
+			(size_t)(end - first) : size - 1;
+
+		memcpy(text, first, stored);
+		text[stored] = '\0';
+	}
+	return (int)(end - first);
+}
+//----------------------------------------------------------------------------
+// Function:	    int OpenScheduleWriter(ScheduleWriter* writer,
+//						const char* filename, int mode)
+//
+// Description:		Creates filename and a writer for it. WRITER_DIRECT
+//					hands each full buffer straight to the OS; WRITER_STDIO
+//					goes through fopen() and fwrite().
+//
+// Parameters:	    (ScheduleWriter*) writer     Writer to set up
+//				    const (char*)     filename   File to create
+//				    (int)             mode       WRITER_STDIO or WRITER_DIRECT
+//
+// Returns:		    (int) 1 on success, 0 if the file could not be created
+//					or the buffer allocated
+// Date:            10/17/2026
+// Called By:       SaveTable()
+// Calls:		    OpenDirectFile()
+// History Log:     10/17/2026  added for the buffered schedule writer
+//----------------------------------------------------------------------------
+int OpenScheduleWriter(ScheduleWriter* writer, const char* filename,
+	int mode)
+{
+	memset(writer, 0, sizeof(ScheduleWriter));
+	writer->file = -1;
+	writer->mode = mode;
+	writer->buffer = (char*)malloc(WRITER_BUFFER);
+	if (writer->buffer == NULL)
+		return 0;
+	if (mode == WRITER_DIRECT)
+		writer->file = OpenDirectFile(filename);
+	else
+		writer->fp = fopen(filename, "w");
+	writer->closeStream = (writer->fp != NULL);
+	if ((writer->file < 0) && (writer->fp == NULL))
+	{
+		free(writer->buffer);
+		writer->buffer = NULL;
+		return 0;
+	}
+	return 1;
+}
+//----------------------------------------------------------------------------
+// Function:	    int AttachScheduleWriter(ScheduleWriter* writer, FILE* fp)
+//
+// Description:		Sets up a WRITER_STDIO writer on an open stream, e.g.
+//					stdout. CloseScheduleWriter() flushes but does not close
+//					the stream.
+//
+// Parameters:	    (ScheduleWriter*) writer   Writer to set up
+//				    (FILE*)           fp       Open output stream
+//
+// Returns:		    (int) 1 on success, 0 if the buffer cannot be allocated
+// Date:            10/17/2026
+// Called By:       DisplayTable()
+// History Log:     10/17/2026  added for the buffered schedule writer
+//----------------------------------------------------------------------------
+int AttachScheduleWriter(ScheduleWriter* writer, FILE* fp)
+{
+	memset(writer, 0, sizeof(ScheduleWriter));
+	writer->file = -1;
+	writer->mode = WRITER_STDIO;
+	writer->fp = fp;
+	writer->buffer = (char*)malloc(WRITER_BUFFER);
+	return writer->buffer != NULL;
+}
+//----------------------------------------------------------------------------
+// Function:	    int FlushScheduleWriter(ScheduleWriter* writer)
+//
+// Description:		Writes out everything waiting in the buffer. The
+//					bytes go to METRIC_BYTES_FORMATTED here, once per
+//					buffer rather than once per row, and to
+//					METRIC_BYTES_WRITTEN when the write succeeds.
+//
+// Parameters:	    (ScheduleWriter*) writer   Writer to flush
+//
+// Returns:		    (int) 1 if every write so far succeeded, else 0
+// Date:            10/17/2026
+// Called By:       WriteScheduleText(), WriteScheduleRow(),
+//					CloseScheduleWriter()
+// Calls:		    WriteDirectFile(), CountMetric()
+// History Log:     10/17/2026  added for the buffered schedule writer
+//				    10/17/2026  counts bytes formatted and written
+//----------------------------------------------------------------------------
+int FlushScheduleWriter(ScheduleWriter* writer)
+{
+	if (writer->used > 0)
+		CountMetric(METRIC_BYTES_FORMATTED, (long long)writer->used);
+	if ((writer->used > 0) && !writer->failed)
+	{
+		if (writer->mode == WRITER_DIRECT)
+			writer->failed = !WriteDirectFile(writer->file, writer->buffer,
+				writer->used);
+		else
+			writer->failed =
+				fwrite(writer->buffer, 1, writer->used, writer->fp) !=
+				writer->used;
+		if (!writer->failed)
+		{
+			writer->written += (long long)writer->used;
+			CountMetric(METRIC_BYTES_WRITTEN, (long long)writer->used);
+		}
+	}
+	writer->used = 0;
+	return !writer->failed;
+}
+//----------------------------------------------------------------------------
+// Function:	    int CloseScheduleWriter(ScheduleWriter* writer)
+//
+// Description:		Flushes the writer, closes a file it opened and releases
+//					its buffer.
+//
+// Parameters:	    (ScheduleWriter*) writer   Writer to close
+//
+// Returns:		    (int) 1 if all output was written, else 0
+// Date:            10/17/2026
+// Called By:       DisplayTable(), SaveTable()
+// Calls:		    FlushScheduleWriter(), CloseDirectFile()
+// History Log:     10/17/2026  added for the buffered schedule writer
+//----------------------------------------------------------------------------
+int CloseScheduleWriter(ScheduleWriter* writer)
+{
+	int ok = 0;
+
+	if (writer->buffer == NULL)
+		return 0;
+	ok = FlushScheduleWriter(writer);
+	if (writer->file >= 0)
+		ok = CloseDirectFile(writer->file) && ok;
+	else if (writer->closeStream)
+		ok = (fclose(writer->fp) == 0) && ok;
+	else
+		ok = (fflush(writer->fp) == 0) && ok;
+	free(writer->buffer);
+	memset(writer, 0, sizeof(ScheduleWriter));
+	writer->file = -1;
+	return ok;
+}
+//----------------------------------------------------------------------------
+// Function:	    void WriteScheduleText(ScheduleWriter* writer,
+//										   const char* text)
+//
+// Description:		Adds text, e.g. the table heading, to the output.
+//
+// Parameters:	    (ScheduleWriter*) writer   Open writer
+//				    const (char*)     text     Text to add
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       DisplayTable(), SaveTable()
+// Calls:		    FlushScheduleWriter()
+// History Log:     10/17/2026  added for the buffered schedule writer
+//----------------------------------------------------------------------------
+void WriteScheduleText(ScheduleWriter* writer, const char* text)
+{
+	size_t length = strlen(text);
+
+	while (length > 0)
+	{
+		size_t room = WRITER_BUFFER - writer->used;
+		size_t part = (length < room) ? length : room;
+
+		memcpy(writer->buffer + writer->used, text, part);
+		writer->used += part;
+		text += part;
+		length -= part;
+		if (writer->used == WRITER_BUFFER)
+			FlushScheduleWriter(writer);
+	}
+}
+//----------------------------------------------------------------------------
+// Function:	    void WriteScheduleHeading(ScheduleWriter* writer,
+//						const double loanSize, const double interestRate,
+//						const int months)
+//
+// Description:		Adds the heading SaveTable() puts above the rows: the
+//					loan, its rate rounded to 1/8th percent and its term,
+//					then the column titles.
+//
+// Parameters:	    (ScheduleWriter*) writer         Open writer
+//				    const (double)    loanSize       Total size of loan
+//				    const (double)    interestRate   Annual interest rate
+//				    const (int)       months         Number of payments
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       SaveTable(), WriteColumnText()
+// Calls:		    roundInterest(), WriteScheduleText()
+// History Log:     10/17/2026  taken out of SaveTable() for the columnar
+//							    schedule files
+//----------------------------------------------------------------------------
+void WriteScheduleHeading(ScheduleWriter* writer, const double loanSize,
+	const double interestRate, const int months)
+{
+	char heading[WRITER_ROW_MAX] = "";
+
+	snprintf(heading, sizeof(heading),
+		"Amortization Table for a: $%.2lf loan at: "
+		"%.3lf%c interest for %d months\n\n" HEAD HEAD2 "\n",
+		loanSize, roundInterest(interestRate, 8), PERCENT, months);
+	WriteScheduleText(writer, heading);
+}
+//----------------------------------------------------------------------------
+// Function:	    void WriteScheduleRow(ScheduleWriter* writer,
+//						const int month, const double payment,
+//						const double principal, const double interest,
+//						const double balance)
+//
+// Description:		Adds one table row, the same text as fprintf(fp, FORMAT,
+//					month, payment, principal, interest, balance).
+//
+// Parameters:	    (ScheduleWriter*) writer      Open writer
+//				    const (int)       month       Month number
+//				    const (double)    payment     Payment made that month
+//				    const (double)    principal   Principal paid
+//				    const (double)    interest    Interest paid
+//				    const (double)    balance     Loan balance after payment
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       WriteSchedule()
+// Calls:		    FormatMoney(), FlushScheduleWriter()
+// History Log:     10/17/2026  added for the buffered schedule writer
+//----------------------------------------------------------------------------
+void WriteScheduleRow(ScheduleWriter* writer, const int month,
+	const double payment, const double principal, const double interest,
+	const double balance)
+{
+	char* row = NULL;
+	size_t length = 0;
+
+	if (WRITER_BUFFER - writer->used < WRITER_ROW_MAX)
+		FlushScheduleWriter(writer);
+	row = writer->buffer + writer->used;
+	row[length++] = '\n';                  // FORMAT, piece by piece
+	length += formatInt(row + length, month, MONTH_WIDTH);
+	memcpy(row + length, "       $", 8);
+	length += 8;
+	length += FormatMoney(row + length, payment, MONEY_WIDTH);
+	memcpy(row + length, "   $", 4);
+	length += 4;
+	length += FormatMoney(row + length, principal, MONEY_WIDTH);
+	memcpy(row + length, "   $", 4);
+	length += 4;
+	length += FormatMoney(row + length, interest, MONEY_WIDTH);
+	memcpy(row + length, "   $", 4);
+	length += 4;
+	length += FormatMoney(row + length, balance, MONEY_WIDTH);
+	writer->used += length;
+}
+//----------------------------------------------------------------------------
+// Function:	    void WriteSchedule(ScheduleWriter* writer,
+//									   const Schedule* schedule)
+//
+// Description:		Adds every row of a table built by BuildSchedule() or
+//					GetSchedule().
+//
+// Parameters:	    (ScheduleWriter*)   writer     Open writer
+//				    const (Schedule*)   schedule   Table to write
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       DisplayTable(), SaveTable()
+// Calls:		    WriteScheduleRow()
+// History Log:     10/17/2026  added for the shared schedule generator
+//----------------------------------------------------------------------------
+void WriteSchedule(ScheduleWriter* writer, const Schedule* schedule)
+{
+	const ScheduleRow* row = schedule->rows;
+
+	for (int i = 0; i < schedule->months; i++, row++)
+		WriteScheduleRow(writer, row->month, row->payment, row->principal,
+			row->interest, row->balance);
+}
+//----------------------------------------------------------------------------
+// Function:	    int FormatCsvRow(char* text, const ScheduleRow* row)
+//
+// Description:		Writes one table row for programs rather than people:
+//					month,payment,principal,interest,balance with two
+//					decimals and no line end, the same text as
+//					sprintf(text, "%d,%.2lf,%.2lf,%.2lf,%.2lf", ...).
+//
+// Parameters:	    (char*)               text   Receives the text, at
+//												 least WRITER_ROW_MAX bytes
+//				    const (ScheduleRow*)  row    Row to write
+//
+// Returns:		    (int) length   Number of characters written
+// Date:            10/17/2026
+// Called By:       sendSchedule(), RunCalcMode()
+// Calls:		    formatInt(), FormatMoney()
+// History Log:     10/17/2026  added for the calculation server and the
+//								command line mode
+//----------------------------------------------------------------------------
+int FormatCsvRow(char* text, const ScheduleRow* row)
+{
+	int length = formatInt(text, row->month, 0);
+
+	text[length++] = ',';
+	length += FormatMoney(text + length, row->payment, 0);
+	text[length++] = ',';
+	length += FormatMoney(text + length, row->principal, 0);
+	text[length++] = ',';
+	length += FormatMoney(text + length, row->interest, 0);
+	text[length++] = ',';
+	length += FormatMoney(text + length, row->balance, 0);
+	return length;
+}
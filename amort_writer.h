@@ -0,0 +1,59 @@
+//----------------------------------------------------------------------------
+// File:			amort_writer.h
+//
+// Description:     Header file for the buffered schedule writer
+//					(amort_writer.c). Amortization rows are formatted into a
+//					large buffer with a fast fixed two-decimal path and
+//					written out in big blocks, either through a stdio stream
+//					or straight to a file descriptor. The text is byte for
+//					byte what fprintf(fp, FORMAT, ...) would write.
+//
+//					FormatCurrency() gives the comma grouped "$1,234.56" text
+//					of PrintCommas() for any buffer.
+//
+// History Log:    10/17/2026  added for the buffered schedule writer
+//				   10/17/2026  added WriteScheduleHeading()
+//				   10/17/2026  added FormatCsvRow()
+//----------------------------------------------------------------------------
+
+#ifndef AMORT_WRITER_H
+#define AMORT_WRITER_H
+#include <stdio.h>
+#include "amort_schedule.h"
+
+#define WRITER_BUFFER (256 * 1024)  // Bytes formatted before each write
+#define MONEY_TEXT_MAX 320          // Longest "%.2lf" of a double, plus NUL
+#define CURRENCY_TEXT_MAX (MONEY_TEXT_MAX * 4 / 3 + 4)  // With $ - and commas
+#define WRITER_ROW_MAX (4 * MONEY_TEXT_MAX + 32)  // Longest table row
+#define WRITER_STDIO 0              // Write blocks with fwrite()
+#define WRITER_DIRECT 1             // Write blocks with WriteDirectFile()
+
+typedef struct
+{
+	FILE* fp;                       // Stream for WRITER_STDIO
+	int file;                       // Descriptor for WRITER_DIRECT
+	int mode;                       // WRITER_STDIO or WRITER_DIRECT
+	int failed;                     // Set once any write fails
+	int closeStream;                // fp was opened by the writer
+	size_t used;                    // Bytes waiting in buffer
+	long long written;              // Bytes handed to the OS or stream
+	char* buffer;
+} ScheduleWriter;
+
+int OpenScheduleWriter(ScheduleWriter* writer, const char* filename,
+	int mode);
+int AttachScheduleWriter(ScheduleWriter* writer, FILE* fp);
+void WriteScheduleText(ScheduleWriter* writer, const char* text);
+void WriteScheduleHeading(ScheduleWriter* writer, const double loanSize,
+	const double interestRate, const int months);
+void WriteScheduleRow(ScheduleWriter* writer, const int month,
+	const double payment, const double principal, const double interest,
+	const double balance);
+void WriteSchedule(ScheduleWriter* writer, const Schedule* schedule);
+int FlushScheduleWriter(ScheduleWriter* writer);
+int CloseScheduleWriter(ScheduleWriter* writer);
+int FormatMoney(char* text, const double amount, const int width);
+int FormatCurrency(char* text, const size_t size, const double amount);
+int FormatCsvRow(char* text, const ScheduleRow* row);
+
+#endif
@@ -0,0 +1,331 @@
+//----------------------------------------------------------------------------
+// File:			bench_amort.c
+//
+// Description      Regression suite and microbenchmark of the amort library.
+//					First checks getPaymentAmount(), getLoanAmount(),
+//					getNumberOfMonths(), getInterestRate() and BuildSchedule()
+//					against known answers. Then times them, PrintCommas() and
+//					a full schedule over loans of 1 to 6000 months and
+//					principals up to TRILLION, keeping the best of REPEATS
+//					runs of each.
+//
+//					The times are compared with a baseline file of
+//					"name nanoseconds" lines. A time more than
+//					BASELINE_TOLERANCE slower than its baseline fails the
+//					run. The baseline is written when it does not exist yet
+//					or when --update is given:
+//
+//					bench_amort [baseline file] [--update]
+//
+//					PrintCommas() prints, so stdout is sent to the null
+//					device and the report goes to stderr.
+//
+//					cc -O2 bench/bench_amort.c amort*.c -lm -lpthread
+//
+// Functions:	    int main(int argc, char* argv[])
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include "../amort.h"
+#include "../amort_platform.h"
+#include "../amort_schedule.h"
+
+#define DEFAULT_BASELINE "bench_amort.baseline"
+#define BASELINE_TOLERANCE .5       // Fraction slower than baseline allowed
+#define BASELINE_SLACK 5            // Nanoseconds always allowed on top
+#define REPEATS 7
+#define MIN_SECONDS .02             // Shortest timed run
+#define NAME_MAX_LENGTH 32
+#define MAX_KERNELS 16
+
+#ifdef _WIN32
+#define NULL_DEVICE "NUL"
+#else
+#define NULL_DEVICE "/dev/null"
+#endif
+
+typedef struct
+{
+	int months;
+	double principal;
+	double interestRate;
+} BenchLoan;
+
+typedef struct
+{
+	double payment;
+	double loanSize;
+	int months;
+	double interestRate;
+} KnownAnswer;
+
+typedef struct
+{
+	char name[NAME_MAX_LENGTH];
+	double nanoseconds;
+} Timing;
+
+// Representative loans: 1 to 6000 months, one dollar to TRILLION.
+static const BenchLoan LOANS[] =
+{
+	{ 1, 1, 5 },
+	{ 12, 1000, 18 },
+	{ 60, 25000, 4.375 },
+	{ 180, 150000, 3.25 },
+	{ 360, 250000, 6 },
+	{ 360, 1000000, 7.125 },
+	{ 1200, 5000000, 2.5 },
+	{ 2400, 1e9, 9.875 },
+	{ 6000, 1e9, .125 },
+	{ 6000, (double)TRILLION, 12 },
+	{ 360, 100000, 0 },
+	{ 6000, (double)TRILLION, 0 }
+};
+
+#define LOAN_COUNT ((int)(sizeof(LOANS) / sizeof(LOANS[0])))
+
+// Answers of version 1.0 the library must keep giving.
+static const KnownAnswer ANSWERS[] =
+{
+	{ 599.56, 100000, 360, 6 },
+	{ 1498.88, 250000, 360, 6 },
+	{ 858.37, 10000, 12, 5.5 },
+	{ 1000, 120000, 120, 0 },
+	{ 471.79, 25000, 60, 5 }
+};
+
+#define ANSWER_COUNT ((int)(sizeof(ANSWERS) / sizeof(ANSWERS[0])))
+
+static Timing timings[MAX_KERNELS];
+static int timingCount = 0;
+static volatile double sink = 0;
+static ScheduleArena arena;
+
+static double paymentKernel(void)
+{
+	double sum = 0;
+
+	for (int i = 0; i < LOAN_COUNT; i++)
+		sum += getPaymentAmount(LOANS[i].months, LOANS[i].principal,
+			LOANS[i].interestRate);
+	return sum;
+}
+
+static double loanKernel(void)
+{
+	double sum = 0;
+
+	for (int i = 0; i < LOAN_COUNT; i++)
+		sum += getLoanAmount(LOANS[i].principal / 100, LOANS[i].months,
+			LOANS[i].interestRate);
+	return sum;
+}
+
+static double monthsKernel(void)
+{
+	double sum = 0;
+
+	for (int i = 0; i < LOAN_COUNT; i++)
+		sum += getNumberOfMonths(LOANS[i].principal / 100, LOANS[i].principal,
+			LOANS[i].interestRate);
+	return sum;
+}
+
+static double rateKernel(void)
+{
+	double sum = 0;
+
+	for (int i = 0; i < LOAN_COUNT; i++)
+		sum += getInterestRate(LOANS[i].months, LOANS[i].principal,
+			LOANS[i].principal / LOANS[i].months * 1.2);
+	return sum;
+}
+
+static double commasKernel(void)
+{
+	for (int i = 0; i < LOAN_COUNT; i++)
+		PrintCommas(LOANS[i].principal + .37);
+	return 1;
+}
+
+static double scheduleKernel(const int months)
+{
+	Schedule schedule;
+	double sum = 0;
+
+	for (int i = 0; i < LOAN_COUNT; i++)
+	{
+		const double payment = getPaymentAmount(months, LOANS[i].principal,
+			LOANS[i].interestRate);
+
+		ResetArena(&arena);
+		BuildSchedule(&schedule, &arena, LOANS[i].principal, payment,
+			LOANS[i].interestRate, months);
+		sum += schedule.totalPaid;
+	}
+	return sum;
+}
+
+static double schedule360Kernel(void)
+{
+	return scheduleKernel(360);
+}
+
+static double schedule6000Kernel(void)
+{
+	return scheduleKernel(FIVE_HUNDRED_YEARS);
+}
+
+// Best time of REPEATS runs of kernel, in nanoseconds per loan.
+static void timeKernel(const char* name, double (*kernel)(void))
+{
+	double best = 0;
+
+	for (int r = 0; r < REPEATS; r++)
+	{
+		double start = GetWallSeconds();
+		double elapsed = 0;
+		long long calls = 0;
+
+		do
+		{
+			sink += kernel();
+			calls += LOAN_COUNT;
+			elapsed = GetWallSeconds() - start;
+		} while (elapsed < MIN_SECONDS);
+		if ((r == 0) || (elapsed / calls < best))
+			best = elapsed / calls;
+	}
+	snprintf(timings[timingCount].name, NAME_MAX_LENGTH, "%s", name);
+	timings[timingCount].nanoseconds = best * 1e9;
+	timingCount++;
+}
+
+// Returns the number of known answers the library gets wrong.
+static int checkAnswers(void)
+{
+	Schedule schedule;
+	int failures = 0;
+
+	for (int i = 0; i < ANSWER_COUNT; i++)
+	{
+		const KnownAnswer* a = &ANSWERS[i];
+		double payment = getPaymentAmount(a->months, a->loanSize,
+			a->interestRate);
+		double loanSize = getLoanAmount(a->payment, a->months,
+			a->interestRate);
+		int months = getNumberOfMonths(a->payment, a->loanSize,
+			a->interestRate);
+		double rate = (a->interestRate > 0) ? roundInterest(getInterestRate(
+			a->months, a->loanSize, a->payment), 8) : a->interestRate;
+
+		ResetArena(&arena);
+		BuildSchedule(&schedule, &arena, a->loanSize, a->payment,
+			a->interestRate, a->months);
+		if ((payment != a->payment) ||
+			(fabs(loanSize - a->loanSize) > a->months * ONE_CENT) ||
+			(months != a->months) || (rate != a->interestRate) ||
+			(schedule.rows[a->months - 1].balance != 0) ||
+			(fabs(schedule.totalPrincipal - a->loanSize) >= ONE_CENT / 2))
+		{
+			fprintf(stderr, "Known answer %d wrong: payment %.2lf, loan "
+				"%.2lf, months %d, rate %.3lf\n", i, payment, loanSize,
+				months, rate);
+			failures++;
+		}
+	}
+	return failures;
+}
+
+// Reads the baseline time of name into nanoseconds. Returns 0 if absent.
+static int readBaseline(FILE* fp, const char* name, double* nanoseconds)
+{
+	char line[NAME_MAX_LENGTH * 2];
+	char lineName[NAME_MAX_LENGTH];
+
+	rewind(fp);
+	while (fgets(line, sizeof(line), fp) != NULL)
+		if ((sscanf(line, "%31s %lf", lineName, nanoseconds) == 2) &&
+			(strcmp(lineName, name) == 0))
+			return 1;
+	return 0;
+}
+
+static int writeBaseline(const char* path)
+{
+	FILE* fp = fopen(path, "w");
+
+	if (fp == NULL)
+		return 0;
+	for (int i = 0; i < timingCount; i++)
+		fprintf(fp, "%s %.1lf\n", timings[i].name, timings[i].nanoseconds);
+	return fclose(fp) == 0;
+}
+
+int main(int argc, char* argv[])
+{
+	const char* path = DEFAULT_BASELINE;
+	FILE* baseline = NULL;
+	int update = 0;
+	int failures = 0;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--update") == 0)
+			update = 1;
+		else
+			path = argv[i];
+	}
+	if (!InitArena(&arena, SCHEDULE_ARENA))
+		return EXIT_FAILURE;
+
+	failures = checkAnswers();
+	fprintf(stderr, "Known answers wrong: %d of %d\n", failures,
+		ANSWER_COUNT);
+
+	timeKernel("getPaymentAmount", paymentKernel);
+	timeKernel("getLoanAmount", loanKernel);
+	timeKernel("getNumberOfMonths", monthsKernel);
+	timeKernel("getInterestRate", rateKernel);
+	timeKernel("BuildSchedule360", schedule360Kernel);
+	timeKernel("BuildSchedule6000", schedule6000Kernel);
+	fflush(stdout);
+	if (freopen(NULL_DEVICE, "w", stdout) != NULL)
+		timeKernel("PrintCommas", commasKernel);
+
+	if (!update)
+		baseline = fopen(path, "r");
+	fprintf(stderr, "%-20s %14s %14s %8s\n", "function", "ns per loan",
+		"baseline", "change");
+	for (int i = 0; i < timingCount; i++)
+	{
+		double old = 0;
+
+		if ((baseline != NULL) &&
+			readBaseline(baseline, timings[i].name, &old) && (old > 0))
+		{
+			int slower = timings[i].nanoseconds >
+				old * (1 + BASELINE_TOLERANCE) + BASELINE_SLACK;
+
+			fprintf(stderr, "%-20s %14.1lf %14.1lf %7.1lf%%%s\n",
+				timings[i].name, timings[i].nanoseconds, old,
+				(timings[i].nanoseconds / old - 1) * HUNDRED,
+				slower ? " SLOWER" : "");
+			failures += slower;
+		}
+		else
+			fprintf(stderr, "%-20s %14.1lf %14s\n", timings[i].name,
+				timings[i].nanoseconds, "-");
+	}
+	if (baseline != NULL)
+		fclose(baseline);
+	else if (writeBaseline(path))
+		fprintf(stderr, "Baseline written to %s\n", path);
+	else
+	{
+		fprintf(stderr, "Could not write baseline %s\n", path);
+		failures++;
+	}
+	FreeArena(&arena);
+	return ((failures == 0) && (sink != 0)) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,137 @@
+//----------------------------------------------------------------------------
+// File:			bench_annuity.c
+//
+// Description      Benchmark of the annuity factor tables. Checks that
+//					getPaymentAmount() and getLoanAmount() give, for every
+//					1/8th percent rate up to ANNUITY_MAX_EIGHTHS and every
+//					term, the same results as the pow() formulas of version
+//					1.0 (kept here); that the budget limits the rows built;
+//					and that a saved table loads back unchanged. Then times
+//					both ways.
+//
+//					cc -O2 bench/bench_annuity.c amort*.c -lm -lpthread
+//
+// Functions:	    int main(void)
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include "../amort.h"
+#include "../amort_annuity.h"
+#include "../amort_platform.h"
+
+#define TABLE_FILE "bench_annuity.bin"
+#define SMALL_BUDGET_ROWS 3
+#define TIMED_CALLS 2000000
+
+static const double PRINCIPALS[] = { 1, 1234.56, 250000, 98765432.1, 1e12 };
+
+// getPaymentAmount() of version 1.0.
+static double oldPaymentAmount(const int months, const double principal,
+	const double interestRate)
+{
+	double monthlyInterest = interestRate / MONTHLY_DIVISOR;
+	double interestExp = pow(monthlyInterest + ONE, (double)months);
+	double payment =
+		(interestExp / (interestExp - ONE)) * principal * monthlyInterest;
+
+	return ceil(payment * HUNDRED) / HUNDRED;
+}
+
+// getLoanAmount() of version 1.0.
+static double oldLoanAmount(const double payment, const int months,
+	const double interestRate)
+{
+	double monthlyInterest = interestRate / MONTHLY_DIVISOR;
+	double interestExp = pow(monthlyInterest + ONE, (double)months);
+	double principal =
+		((interestExp - 1) / (monthlyInterest * interestExp)) * payment;
+
+	return round(principal * HUNDRED) / HUNDRED;
+}
+
+// Returns the number of grid cells where the library and version 1.0
+// disagree.
+static long long checkGrid(void)
+{
+	const int PRINCIPAL_COUNT = sizeof(PRINCIPALS) / sizeof(PRINCIPALS[0]);
+	long long mismatches = 0;
+
+	for (int e = 1; e <= ANNUITY_MAX_EIGHTHS; e++)
+		for (int n = 1; n <= FIVE_HUNDRED_YEARS; n++)
+		{
+			double rate = e / 8.0;
+			double principal = PRINCIPALS[(e + n) % PRINCIPAL_COUNT];
+			double payment = oldPaymentAmount(n, principal, rate);
+
+			if (getPaymentAmount(n, principal, rate) != payment)
+				mismatches++;
+			if (getLoanAmount(payment, n, rate) !=
+				oldLoanAmount(payment, n, rate))
+				mismatches++;
+		}
+	return mismatches;
+}
+
+int main(void)
+{
+	static double saved[SMALL_BUDGET_ROWS][ANNUITY_FACTORS];
+	long long mismatches = 0;
+	int failures = 0;
+	int count = 0;
+	double start = 0;
+	double oldTime = 0;
+	double newTime = 0;
+	volatile double sink = 0;
+
+	SetAnnuityBudget(ANNUITY_MAX_EIGHTHS * ANNUITY_ROW_BYTES);
+	mismatches = checkGrid();
+	printf("Grid cells differing from pow(): %lld of %d\n", mismatches,
+		2 * ANNUITY_MAX_EIGHTHS * FIVE_HUNDRED_YEARS);
+	printf("Table size with every rate     : %.1lf MB\n",
+		GetAnnuityBytes() / 1e6);
+	failures += (mismatches != 0);
+
+	ClearAnnuityTable();
+	SetAnnuityBudget(SMALL_BUDGET_ROWS * ANNUITY_ROW_BYTES);
+	for (int e = 1; e <= 2 * SMALL_BUDGET_ROWS; e++)
+	{
+		const double* factors = GetAnnuityFactors(e / 8.0, 360);
+
+		if ((factors == NULL) != (e > SMALL_BUDGET_ROWS))
+			failures++;
+		if (factors != NULL)
+			memcpy(saved[e - 1], factors, sizeof(saved[0]));
+	}
+	mismatches = checkGrid();
+	failures += (mismatches != 0) ||
+		(GetAnnuityBytes() != SMALL_BUDGET_ROWS * ANNUITY_ROW_BYTES);
+	printf("Budget of %d rows               : %s\n", SMALL_BUDGET_ROWS,
+		(mismatches == 0) ? "kept, results unchanged" : "FAILED");
+
+	count = SaveAnnuityTable(TABLE_FILE);
+	ClearAnnuityTable();
+	if ((count != SMALL_BUDGET_ROWS) ||
+		(LoadAnnuityTable(TABLE_FILE) != SMALL_BUDGET_ROWS))
+		failures++;
+	for (int e = 1; e <= SMALL_BUDGET_ROWS; e++)
+		if (memcmp(saved[e - 1], GetAnnuityFactors(e / 8.0, 360),
+			sizeof(saved[0])) != 0)
+			failures++;
+	printf("Saved and loaded rows          : %d\n", count);
+	remove(TABLE_FILE);
+
+	start = GetWallSeconds();
+	for (int i = 0; i < TIMED_CALLS; i++)
+		sink += oldPaymentAmount(1 + i % FIVE_HUNDRED_YEARS, 250000,
+			(1 + i % SMALL_BUDGET_ROWS) / 8.0);
+	oldTime = (GetWallSeconds() - start) / TIMED_CALLS;
+	start = GetWallSeconds();
+	for (int i = 0; i < TIMED_CALLS; i++)
+		sink += getPaymentAmount(1 + i % FIVE_HUNDRED_YEARS, 250000,
+			(1 + i % SMALL_BUDGET_ROWS) / 8.0);
+	newTime = (GetWallSeconds() - start) / TIMED_CALLS;
+	printf("getPaymentAmount() with pow()  : %.1lf ns\n", oldTime * 1e9);
+	printf("getPaymentAmount() with table  : %.1lf ns (%.1lfx)\n",
+		newTime * 1e9, oldTime / newTime);
+	return ((failures == 0) && (sink != 0)) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
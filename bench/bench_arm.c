@@ -0,0 +1,220 @@
+//----------------------------------------------------------------------------
+// File:			bench_arm.c
+//
+// Description      Benchmark of the adjustable rate engine. Checks that an
+//					ARM with no resets gives the rows of FillScheduleRows(),
+//					that PriceArm() agrees with the FillArmRows() table of
+//					each loan of a book of hybrid ARMs with yearly resets,
+//					caps and floors, and that every thread count prices the
+//					book the same. Loans of zero and rates that are not
+//					finite must be refused. The closed form may be a month
+//					off the table only when the table's last payment is
+//					under a dollar; its interest may be off by the cent
+//					rounding of the table and the cent its payments can
+//					differ by after a reset. Reports the time of the book with
+//					FillArmRows(), and with PriceArmBook() on one thread
+//					and on all of them.
+//
+//					bench_arm [loans]      (default BOOK_LOANS)
+//
+//					cc -O2 bench/bench_arm.c amort*.c -lm -lpthread
+//
+// Functions:	    int main(int argc, char* argv[])
+//----------------------------------------------------------------------------
+
+#include <math.h>
+#include <string.h>
+#include "../amort.h"
+#include "../amort_arm.h"
+#include "../amort_platform.h"
+#include "bench_util.h"
+
+#define BOOK_LOANS 10000
+#define PLAIN_LOANS 500
+#define MAX_RESETS 40
+#define CHECK_THREADS 3
+#define PAYMENT_CENT 0.01           // A reset payment a cent apart
+
+// Hybrid ARMs: fixed for 1 to 10 years, then reset every year to an index
+// that wanders by up to 1.5 percent, plus a margin, held to a 2 percent
+// periodic cap, a 5 percent lifetime cap over the start and a floor of the
+// margin.
+static void makeBook(ArmLoan* loans, RateReset* resets, const size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		ArmLoan* loan = &loans[i];
+		RateReset* own = resets + i * MAX_RESETS;
+		double margin = 2 + (nextRandom() % 9) / 4.0;
+		double index = 1 + (nextRandom() % 17) / 4.0;
+		int month = 12 * (1 + nextRandom() % 10) + 1;
+
+		loan->months = 12 * (10 + nextRandom() % 31);
+		loan->loanSize = 10000 + (nextRandom() % 100000000) / 100.0;
+		loan->interestRate = (nextRandom() % 49) / 8.0 + 1;
+		loan->limits.periodicCap = 2;
+		loan->limits.lifetimeCap = loan->interestRate + 5;
+		loan->limits.floor = margin;
+		loan->resets = own;
+		loan->count = 0;
+		for (; (month <= loan->months) && (loan->count < MAX_RESETS);
+			month += 12)
+		{
+			index = fmax(0, index + ((int)(nextRandom() % 13) - 6) / 4.0);
+			own[loan->count].month = month;
+			own[loan->count].rate = index + margin;
+			loan->count++;
+		}
+	}
+}
+
+// Loans with no resets against FillScheduleRows(), up to the month a table
+// paid off early goes below zero; returns the number that differ.
+static long long checkPlain(ScheduleRow* rows, ScheduleRow* plain)
+{
+	long long mismatches = 0;
+
+	for (int i = 0; i < PLAIN_LOANS; i++)
+	{
+		ArmLoan loan;
+		double payment = 0;
+		int count = 0;
+		int end = 0;
+		int same = 0;
+
+		memset(&loan, 0, sizeof(ArmLoan));
+		loan.months = 1 + nextRandom() % 480;
+		loan.loanSize = 1000 + (nextRandom() % 100000000) / 100.0;
+		loan.interestRate = (nextRandom() % 121) / 8.0;
+		payment = getPaymentAmount(loan.months, loan.loanSize,
+			loan.interestRate);
+		count = FillArmRows(rows, &loan);
+		FillScheduleRows(plain, loan.loanSize, payment, loan.interestRate,
+			loan.months, 1, loan.months);
+		while ((end < loan.months - 1) && (plain[end].balance >= 0))
+			end++;
+		same = (end < loan.months - 1) ? end : count;
+		if ((count != end + 1) ||
+			memcmp(rows, plain, sizeof(ScheduleRow) * same))
+			mismatches++;
+	}
+	return mismatches;
+}
+
+// Counts loans PriceArm() or FillArmRows() takes that they should refuse:
+// a loan of zero, and a start or reset rate that is not finite.
+static long long checkRefused(ScheduleRow* rows)
+{
+	RateReset reset = { 13, 5 };
+	ArmLoan loan = { 0, 5, 360, 1, &reset, { 2, 10, 1 } };
+	ArmResult result;
+	long long accepted = 0;
+
+	accepted += PriceArm(&result, NULL, &loan) + FillArmRows(rows, &loan);
+	loan.loanSize = 100000;
+	loan.interestRate = NAN;
+	accepted += PriceArm(&result, NULL, &loan) + FillArmRows(rows, &loan);
+	loan.interestRate = 5;
+	reset.rate = INFINITY;
+	accepted += PriceArm(&result, NULL, &loan) + FillArmRows(rows, &loan);
+	reset.rate = 5;
+	return accepted + !PriceArm(&result, NULL, &loan);
+}
+
+// Returns 1 if the closed form agrees with the table.
+static int agrees(const ArmLoan* loan, const ArmResult* result,
+	const ScheduleRow* rows, const int count)
+{
+	const double lastPayment = rows[count - 1].payment;
+	const double interest = rows[count - 1].interestToDate;
+	const double allowed = (ROUNDING_PER_MONTH + PAYMENT_CENT) * count +
+		0.01;
+
+	if ((result->payoffMonth != count) && ((lastPayment >= ONE) ||
+		(abs(result->payoffMonth - count) > 1)))
+		return 0;
+	return (fabs(result->totalInterest - interest) <= allowed + lastPayment) &&
+		(result->segments <= loan->count + 1);
+}
+
+int main(int argc, char* argv[])
+{
+	size_t count = (argc > 1) ? (size_t)atol(argv[1]) : BOOK_LOANS;
+	ArmLoan* loans = malloc(sizeof(ArmLoan) * (count ? count : 1));
+	RateReset* resets = malloc(sizeof(RateReset) * MAX_RESETS *
+		(count ? count : 1));
+	ArmResult* results = malloc(sizeof(ArmResult) * (count ? count : 1));
+	ArmResult* threaded = malloc(sizeof(ArmResult) * (count ? count : 1));
+	ScheduleRow* rows = malloc(sizeof(ScheduleRow) * FIVE_HUNDRED_YEARS);
+	ScheduleRow* plain = malloc(sizeof(ScheduleRow) * FIVE_HUNDRED_YEARS);
+	long long mismatches = 0;
+	long long disagreements = 0;
+	long long tableMonths = 0;
+	long long segments = 0;
+	double worstInterest = 0;
+	double tableTime = 0;
+	double oneTime = 0;
+	double allTime = 0;
+	double start = 0;
+	int threads = GetCpuCount();
+
+	if ((loans == NULL) || (resets == NULL) || (results == NULL) ||
+		(threaded == NULL) || (rows == NULL) || (plain == NULL))
+		return EXIT_FAILURE;
+	mismatches += checkPlain(rows, plain);
+	mismatches += checkRefused(rows);
+	makeBook(loans, resets, count);
+
+	if (PriceArmBook(results, loans, count, 1) != count)
+		mismatches++;
+	for (size_t i = 0; i < count; i++)
+	{
+		int months = FillArmRows(rows, &loans[i]);
+
+		if (months < 1)
+		{
+			mismatches++;
+			continue;
+		}
+		if (!agrees(&loans[i], &results[i], rows, months))
+			disagreements++;
+		worstInterest = fmax(worstInterest,
+			fabs(results[i].totalInterest - rows[months - 1].interestToDate));
+		segments += results[i].segments;
+	}
+	if ((PriceArmBook(threaded, loans, count, CHECK_THREADS) != count) ||
+		memcmp(results, threaded, sizeof(ArmResult) * count))
+		mismatches++;
+
+	start = GetWallSeconds();
+	for (size_t i = 0; i < count; i++)
+		tableMonths += FillArmRows(rows, &loans[i]);
+	tableTime = GetWallSeconds() - start;
+	start = GetWallSeconds();
+	PriceArmBook(results, loans, count, 1);
+	oneTime = GetWallSeconds() - start;
+	start = GetWallSeconds();
+	PriceArmBook(threaded, loans, count, 0);
+	allTime = GetWallSeconds() - start;
+
+	printf("%zu ARMs, %lld table months, %lld rate segments, %d threads\n",
+		count, tableMonths, segments, threads);
+	printf("%-26s %10s %12s %8s\n", "", "ms", "ns/loan", "speedup");
+	printf("%-26s %10.2lf %12.1lf %7.2lfx\n", "FillArmRows() book",
+		tableTime * 1e3, tableTime * 1e9 / count, 1.0);
+	printf("%-26s %10.2lf %12.1lf %7.2lfx\n", "PriceArmBook() 1 thread",
+		oneTime * 1e3, oneTime * 1e9 / count, tableTime / oneTime);
+	printf("%-26s %10.2lf %12.1lf %7.2lfx\n", "PriceArmBook() all",
+		allTime * 1e3, allTime * 1e9 / count, tableTime / allTime);
+	printf("Largest interest difference: %.2lf\n", worstInterest);
+	printf("Tables or results that differ: %lld\n", mismatches);
+	printf("Loans outside the allowance: %lld\n", disagreements);
+	free(loans);
+	free(resets);
+	free(results);
+	free(threaded);
+	free(rows);
+	free(plain);
+	return ((mismatches == 0) && (disagreements == 0)) ? EXIT_SUCCESS :
+		EXIT_FAILURE;
+}
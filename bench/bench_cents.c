@@ -0,0 +1,190 @@
+//----------------------------------------------------------------------------
+// File:			bench_cents.c
+//
+// Description      Benchmark of the integer cents engine. Builds the tables
+//					of random loans with the double loop and with whole
+//					cents, reports rows per second for each and how many
+//					double rows are a cent or more off the exact ones. The
+//					cross-check is then run again on CHECK_THREADS threads
+//					at once and must count the same rows. Above
+//					MAX_CENTS_RATE the cents engine must give the rows of
+//					the double loop. Negative amortization that runs past
+//					what 64-bit cents hold must carry on with the double
+//					loop, keeping the sign and size of its balances and
+//					totals; negative amortization that fits must end on the
+//					double loop's last payment to the cent.
+//
+//					cc -O2 bench/bench_cents.c amort*.c -lm -lpthread
+//
+// Functions:	    int main(void)
+//----------------------------------------------------------------------------
+
+#include "../amort.h"
+#include "../amort_cents.h"
+#include "../amort_platform.h"
+#include "bench_util.h"
+
+#define LOAN_COUNT 20000
+#define MAX_MONTHS 360
+#define CHECK_THREADS 4
+#define HIGH_RATE (MAX_CENTS_RATE + 300)
+#define RUNAWAY_LOAN 1e6            // A $1 payment at 10%: balance runs away
+#define GROWING_LOAN 100000         // A $500 payment at 9%: grows, but fits
+#define CLOSE_ENOUGH 1e-6           // Relative drift allowed the double loop
+
+typedef struct
+{
+	double loanSize;
+	double paymentSize;
+	double interestRate;
+	int months;
+} BenchLoan;
+
+static BenchLoan loans[LOAN_COUNT];
+
+// Thread: builds every CHECK_THREADS'th loan, from the one given, under
+// whatever engine is set.
+static void buildShare(void* arg)
+{
+	ScheduleRow rows[MAX_MONTHS];
+
+	for (size_t i = (size_t)arg; i < LOAN_COUNT; i += CHECK_THREADS)
+		FillScheduleRows(rows, loans[i].loanSize, loans[i].paymentSize,
+			loans[i].interestRate, loans[i].months, 1, loans[i].months);
+}
+
+// Counts ways the cents engine differs from the double loop on loans whose
+// payment is below the interest. The runaway one must go on with the double
+// loop, not wrap; the growing one must end on the same last payment.
+static long long checkNegativeAmortization(void)
+{
+	static ScheduleRow doubleRows[FIVE_HUNDRED_YEARS];
+	static ScheduleRow centsRows[FIVE_HUNDRED_YEARS];
+	ScheduleTotals doubleTotals;
+	ScheduleTotals centsTotals;
+	long long differ = 0;
+
+	SetScheduleEngine(ENGINE_DOUBLE);
+	FillScheduleRows(doubleRows, RUNAWAY_LOAN, 1, 10, FIVE_HUNDRED_YEARS, 1,
+		FIVE_HUNDRED_YEARS);
+	GetScheduleTotals(&doubleTotals, RUNAWAY_LOAN, 1, 10,
+		FIVE_HUNDRED_YEARS);
+	SetScheduleEngine(ENGINE_CENTS);
+	FillScheduleRows(centsRows, RUNAWAY_LOAN, 1, 10, FIVE_HUNDRED_YEARS, 1,
+		FIVE_HUNDRED_YEARS);
+	GetScheduleTotals(&centsTotals, RUNAWAY_LOAN, 1, 10,
+		FIVE_HUNDRED_YEARS);
+	for (int i = 0; i < FIVE_HUNDRED_YEARS - 1; i++)   // Same sign and size
+		differ += (centsRows[i].balance <= 0) || (fabs(centsRows[i].balance
+			- doubleRows[i].balance) > doubleRows[i].balance * CLOSE_ENOUGH);
+	differ += (centsTotals.finalPayment !=
+		centsRows[FIVE_HUNDRED_YEARS - 1].payment) ||
+		(fabs(centsTotals.totalPaid - doubleTotals.totalPaid) >
+		doubleTotals.totalPaid * CLOSE_ENOUGH);
+	SetScheduleEngine(ENGINE_CROSSCHECK);
+	FillScheduleRows(centsRows, RUNAWAY_LOAN, 1, 10, FIVE_HUNDRED_YEARS, 1,
+		FIVE_HUNDRED_YEARS);
+
+	SetScheduleEngine(ENGINE_DOUBLE);
+	GetScheduleTotals(&doubleTotals, GROWING_LOAN, 500, 9, MAX_MONTHS);
+	SetScheduleEngine(ENGINE_CENTS);
+	GetScheduleTotals(&centsTotals, GROWING_LOAN, 500, 9, MAX_MONTHS);
+	SetScheduleEngine(ENGINE_DOUBLE);
+	differ += (centsTotals.finalPayment <= GROWING_LOAN) ||
+		(fabs(centsTotals.finalPayment - doubleTotals.finalPayment) > 0.01);
+	return differ;
+}
+
+int main(void)
+{
+	static ScheduleRow rows[MAX_MONTHS];
+	static ScheduleRow centsOff[MAX_MONTHS];
+	AmortThread threads[CHECK_THREADS];
+	int launched[CHECK_THREADS] = { 0 };
+	long long threaded = 0;
+	long long highRate = 0;
+	long long negative = 0;
+	static CentsRow centsRows[MAX_MONTHS];
+	const char* ENGINE_NAMES[] = { "double", "cents", "crosscheck" };
+	double times[ENGINE_CROSSCHECK + 1] = { 0 };
+	long long mismatches = 0;
+	long long rowCount = 0;
+	volatile double sink = 0;
+
+	for (int i = 0; i < LOAN_COUNT; i++)
+	{
+		loans[i].months = 1 + (int)(nextRandom() % MAX_MONTHS);
+		loans[i].loanSize = (double)(nextRandom() % 100000000) / HUNDRED + 1;
+		loans[i].interestRate = (double)(nextRandom() % 160) / 8;
+		loans[i].paymentSize = getPaymentAmount(loans[i].months,
+			loans[i].loanSize, loans[i].interestRate);
+		rowCount += loans[i].months;
+	}
+
+	for (int engine = ENGINE_DOUBLE; engine <= ENGINE_CROSSCHECK; engine++)
+	{
+		double start = GetWallSeconds();
+
+		SetScheduleEngine(engine);
+		for (int i = 0; i < LOAN_COUNT; i++)
+		{
+			FillScheduleRows(rows, loans[i].loanSize, loans[i].paymentSize,
+				loans[i].interestRate, loans[i].months, 1, loans[i].months);
+			sink += rows[loans[i].months - 1].payment;
+		}
+		times[engine] = GetWallSeconds() - start;
+		if (engine == ENGINE_CROSSCHECK)
+			mismatches = GetCrossCheckMismatches();
+	}
+	SetScheduleEngine(ENGINE_CROSSCHECK);
+	for (size_t t = 0; t < CHECK_THREADS; t++)
+		launched[t] = StartThread(&threads[t], buildShare, (void*)t);
+	for (size_t t = 0; t < CHECK_THREADS; t++)
+		if (launched[t])
+			JoinThread(threads[t]);
+		else
+			buildShare((void*)t);
+	threaded = GetCrossCheckMismatches();
+
+	SetScheduleEngine(ENGINE_DOUBLE);
+	FillScheduleRows(rows, 1e12, 1e12, HIGH_RATE, MAX_MONTHS, 1, MAX_MONTHS);
+	SetScheduleEngine(ENGINE_CENTS);
+	FillScheduleRows(centsOff, 1e12, 1e12, HIGH_RATE, MAX_MONTHS, 1,
+		MAX_MONTHS);
+	SetScheduleEngine(ENGINE_DOUBLE);
+	for (int m = 0; m < MAX_MONTHS; m++)
+		highRate += (rows[m].balance != centsOff[m].balance) ||
+			(rows[m].interest != centsOff[m].interest);
+	negative = checkNegativeAmortization();
+
+	printf("%12s %12s %14s\n", "engine", "seconds", "rows/s");
+	for (int engine = ENGINE_DOUBLE; engine <= ENGINE_CROSSCHECK; engine++)
+		printf("%12s %12.4lf %14.0lf\n", ENGINE_NAMES[engine], times[engine],
+			rowCount / times[engine]);
+
+	{
+		double start = GetWallSeconds();
+		double elapsed = 0;
+
+		for (int i = 0; i < LOAN_COUNT; i++)
+		{
+			FillCentsRows(centsRows, ToCents(loans[i].loanSize),
+				ToCents(loans[i].paymentSize),
+				RateToEighths(loans[i].interestRate), loans[i].months, 1,
+				loans[i].months);
+			sink += (double)centsRows[loans[i].months - 1].payment;
+		}
+		elapsed = GetWallSeconds() - start;
+		printf("%12s %12.4lf %14.0lf\n", "cents rows", elapsed,
+			rowCount / elapsed);
+	}
+	printf("Double rows a cent or more off: %lld of %lld\n", mismatches,
+		rowCount);
+	printf("Counted on %d threads: %lld\n", CHECK_THREADS, threaded);
+	printf("Rows at %d%% unlike the double loop: %lld\n", HIGH_RATE,
+		highRate);
+	printf("Negative amortization unlike the double loop: %lld\n",
+		negative);
+	return ((sink != 0) && (threaded == mismatches) && (highRate == 0) &&
+		(negative == 0)) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,257 @@
+//----------------------------------------------------------------------------
+// File:			bench_cli.c
+//
+// Description      Benchmark of the command line mode, project3 -calc.
+//					Runs the program once for each kind of unknown, with and
+//					without -table and -json, and checks the text it prints
+//					and its exit code against the library. Then starts it
+//					again and again and times each run from the moment the
+//					process is created to the first byte of the result, and
+//					to its exit, against a CALC_TARGET budget.
+//
+//					bench_cli path/to/project3 [runs]   (default CALC_RUNS)
+//
+//					cc -O2 bench/bench_cli.c amort*.c -lm -lpthread
+//
+// Functions:	    int main(int argc, char* argv[])
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include "../amort.h"
+#include "../amort_batch.h"
+#include "../amort_platform.h"
+#include "../amort_schedule.h"
+#include "../amort_writer.h"
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#else
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#define CALC_RUNS 200
+#define CALC_TARGET 0.001           // Seconds from start to first result
+#define OUTPUT_MAX 65536
+#define TABLE_MONTHS 360
+
+typedef struct
+{
+	const char* args[10];           // After "-calc", NULL terminated
+	const char* expected;           // Whole output, or NULL for any
+	int exitCode;
+} CalcCase;
+
+static const CalcCase cases[] =
+{
+	{ { "-loan", "250000", "-months", "360", "-rate", "6.5", NULL },
+		"250000.00,1580.18,360,6.500,OK\n", EXIT_SUCCESS },
+	{ { "-payment", "1500", "-months", "360", "-rate", "6.5", NULL },
+		"237316.23,1500.00,360,6.500,OK\n", EXIT_SUCCESS },
+	{ { "-loan", "250000", "-payment", "2000", "-rate", "6.5", NULL },
+		"250000.00,2000.00,210,6.500,OK\n", EXIT_SUCCESS },
+	{ { "-loan", "250000", "-payment", "1580.17", "-months", "360", NULL },
+		"250000.00,1580.17,360,6.500,OK\n", EXIT_SUCCESS },
+	{ { "-json", "-loan", "1000", "-payment", "1", "-rate", "50", NULL },
+		"{\"loan\":1000.00,\"payment\":1.00,\"months\":0,\"rate\":50.000,"
+		"\"status\":\"NONE\"}\n", EXIT_FAILURE },
+	{ { "-json", "-loan", "nan", "-months", "360", "-rate", "5", NULL },
+		"{\"loan\":0.00,\"payment\":0.00,\"months\":0,\"rate\":0.000,"
+		"\"status\":\"BAD\"}\n", EXIT_FAILURE },
+	{ { "-loan", "1e12", "-payment", ".01", "-rate", "0", NULL },
+		"1000000000000.00,0.01,0,0.000,NONE\n", EXIT_FAILURE },
+	{ { "-loan", "250000", "-rate", "6.5", NULL }, NULL, EXIT_FAILURE },
+	{ { "-loan", "1,5", "-months", "12", "-rate", "6.5", NULL }, NULL,
+		EXIT_FAILURE },
+	{ { "-loan", "250000", "-months", "12", "-rate", NULL }, NULL,
+		EXIT_FAILURE },
+	{ { "-loan", "250000", "-months", "12", "-rate", "6.5", "-menu",
+		NULL }, NULL, EXIT_FAILURE },
+};
+
+// Runs project3 -calc with the given arguments. Fills in output and the
+// seconds to the first byte and to the exit. Returns the exit code, or -1.
+static int runCalc(const char* program, const char* const* args,
+	char* output, double* first, double* total)
+{
+	double start = GetWallSeconds();
+	size_t have = 0;
+	int status = -1;
+#ifdef _WIN32
+	char command[1024] = "";
+	FILE* fp = NULL;
+
+	snprintf(command, sizeof(command), "\"%s\" -calc", program);
+	for (int i = 0; args[i] != NULL; i++)
+		snprintf(command + strlen(command), sizeof(command) - strlen(command),
+			" %s", args[i]);
+	if ((fp = popen(command, "r")) == NULL)
+		return -1;
+	*first = 0;
+	while (have < OUTPUT_MAX - 1)
+	{
+		size_t got = fread(output + have, 1, OUTPUT_MAX - 1 - have, fp);
+
+		if (got == 0)
+			break;
+		if (have == 0)
+			*first = GetWallSeconds() - start;
+		have += got;
+	}
+	status = pclose(fp);
+#else
+	const char* argv[16] = { program, "-calc" };
+	int pipeEnds[2];
+	pid_t child = 0;
+
+	for (int i = 0; args[i] != NULL; i++)
+		argv[i + 2] = args[i];
+	if (pipe(pipeEnds) != 0)
+		return -1;
+	if ((child = fork()) == 0)
+	{
+		dup2(pipeEnds[1], STDOUT_FILENO);
+		close(pipeEnds[0]);
+		close(pipeEnds[1]);
+		execv(program, (char* const*)argv);
+		_exit(127);
+	}
+	close(pipeEnds[1]);
+	*first = 0;
+	while (child > 0)
+	{
+		ssize_t got = read(pipeEnds[0], output + have, OUTPUT_MAX - 1 - have);
+
+		if (got <= 0)
+			break;
+		if (have == 0)
+			*first = GetWallSeconds() - start;
+		have += (size_t)got;
+	}
+	close(pipeEnds[0]);
+	if ((child > 0) && (waitpid(child, &status, 0) == child) &&
+		WIFEXITED(status))
+		status = WEXITSTATUS(status);
+	else
+		status = -1;
+#endif
+	*total = GetWallSeconds() - start;
+	output[have] = '\0';
+	return status;
+}
+
+// Orders times for qsort().
+static int compareTimes(const void* a, const void* b)
+{
+	double x = *(const double*)a;
+	double y = *(const double*)b;
+
+	return (x > y) - (x < y);
+}
+
+// Checks -table and -table -json against the library's own rows.
+static int checkTable(const char* program, char* output)
+{
+	static const char* csvArgs[] = { "-loan", "250000", "-months", "360",
+		"-rate", "6.5", "-table", NULL };
+	static const char* jsonArgs[] = { "-json", "-loan", "250000", "-months",
+		"360", "-rate", "6.5", "-table", NULL };
+	ScheduleRow* rows = (ScheduleRow*)malloc(sizeof(ScheduleRow) *
+		TABLE_MONTHS);
+	char* expected = (char*)malloc(OUTPUT_MAX);
+	size_t csv = 0;
+	size_t json = 0;
+	double first = 0;
+	double total = 0;
+	int mismatches = 0;
+
+	if ((rows == NULL) || (expected == NULL))
+		return 1;
+	FillScheduleRows(rows, 250000, getPaymentAmount(TABLE_MONTHS, 250000,
+		6.5), 6.5, TABLE_MONTHS, 1, TABLE_MONTHS);
+
+	csv = (size_t)sprintf(expected, "250000.00,1580.18,360,6.500,OK\n");
+	for (int i = 0; i < TABLE_MONTHS; i++)
+	{
+		csv += (size_t)FormatCsvRow(expected + csv, &rows[i]);
+		expected[csv++] = '\n';
+	}
+	expected[csv] = '\0';
+	if ((runCalc(program, csvArgs, output, &first, &total) != EXIT_SUCCESS) ||
+		(strcmp(output, expected) != 0))
+		mismatches++;
+
+	json = (size_t)sprintf(expected, "{\"loan\":250000.00,\"payment\":1580.18,"
+		"\"months\":360,\"rate\":6.500,\"status\":\"OK\",\"rows\":[");
+	for (int i = 0; i < TABLE_MONTHS; i++)
+	{
+		expected[json++] = (i == 0) ? '[' : ',';
+		if (i > 0)
+			expected[json++] = '[';
+		json += (size_t)FormatCsvRow(expected + json, &rows[i]);
+		expected[json++] = ']';
+	}
+	strcpy(expected + json, "]}\n");
+	if ((runCalc(program, jsonArgs, output, &first, &total) != EXIT_SUCCESS) ||
+		(strcmp(output, expected) != 0))
+		mismatches++;
+	free(rows);
+	free(expected);
+	return mismatches;
+}
+
+int main(int argc, char* argv[])
+{
+	int runs = (argc > 2) ? atoi(argv[2]) : CALC_RUNS;
+	char* output = (char*)malloc(OUTPUT_MAX);
+	double* firsts = (double*)malloc(sizeof(double) * (size_t)(runs + 1));
+	double* totals = (double*)malloc(sizeof(double) * (size_t)(runs + 1));
+	int mismatches = 0;
+
+	if ((argc < 2) || (runs < 1) || (output == NULL) || (firsts == NULL) ||
+		(totals == NULL))
+	{
+		fputs("usage: bench_cli path/to/project3 [runs]\n", stderr);
+		return EXIT_FAILURE;
+	}
+	for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++)
+	{
+		int code = runCalc(argv[1], cases[c].args, output, &firsts[0],
+			&totals[0]);
+
+		if ((code != cases[c].exitCode) || ((cases[c].expected != NULL) &&
+			(strcmp(output, cases[c].expected) != 0)) ||
+			((cases[c].expected == NULL) && (output[0] != '\0') &&
+			(strstr(output, ",BAD\n") == NULL)))
+		{
+			printf("project3 -calc case %zu: exit %d, printed %s", c, code,
+				output);
+			mismatches++;
+		}
+	}
+	mismatches += checkTable(argv[1], output);
+
+	for (int r = 0; r < runs; r++)
+		if (runCalc(argv[1], cases[0].args, output, &firsts[r], &totals[r]) !=
+			EXIT_SUCCESS)
+			mismatches++;
+	qsort(firsts, (size_t)runs, sizeof(double), compareTimes);
+	qsort(totals, (size_t)runs, sizeof(double), compareTimes);
+
+	printf("%d runs of project3 -calc\n", runs);
+	printf("%-30s %10s %10s %10s\n", "", "p50 us", "p90 us", "min us");
+	printf("%-30s %10.1lf %10.1lf %10.1lf\n", "Start to first result",
+		firsts[(runs - 1) / 2] * 1e6, firsts[(runs - 1) * 9 / 10] * 1e6,
+		firsts[0] * 1e6);
+	printf("%-30s %10.1lf %10.1lf %10.1lf\n", "Start to exit",
+		totals[(runs - 1) / 2] * 1e6, totals[(runs - 1) * 9 / 10] * 1e6,
+		totals[0] * 1e6);
+	printf("Median start to first result %s the %.1lf ms target\n",
+		(firsts[(runs - 1) / 2] < CALC_TARGET) ? "within" : "OVER",
+		CALC_TARGET * 1e3);
+	printf("Outputs unlike the library: %d\n", mismatches);
+	free(output);
+	free(firsts);
+	free(totals);
+	return (mismatches == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,272 @@
+//----------------------------------------------------------------------------
+// File:			bench_columnar.c
+//
+// Description      Benchmark of the columnar schedule files. Builds a book
+//					of tables with BuildSchedule(), saves it with
+//					SaveScheduleColumns(), maps it back and checks every
+//					directory entry and every value of every column against
+//					the tables, checks that WriteColumnText() writes the
+//					same bytes as the SaveTable() heading and rows, and
+//					that a cut short file is refused. Then times scanning
+//					the mapped payment column against reading and parsing
+//					the same rows back from their text.
+//
+//					bench_columnar [loans]      (default BOOK_LOANS)
+//
+//					cc -O2 bench/bench_columnar.c amort*.c -lm -lpthread
+//
+// Functions:	    int main(int argc, char* argv[])
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include "../amort.h"
+#include "../amort_columnar.h"
+#include "../amort_platform.h"
+#include "bench_util.h"
+
+#define BOOK_LOANS 4000
+#define MAX_MONTHS 480
+#define TEXT_LOANS 20               // Loans checked as text
+#define COLUMN_FILE "bench_columnar.col"
+#define SHORT_FILE "bench_columnar_short.col"
+#define TEXT_FILE "bench_columnar.txt"
+#define EXPECTED_FILE "bench_columnar_expected.txt"
+
+// Reads a whole file into a malloc'd buffer. Returns NULL on failure.
+static char* readFile(const char* filename, long* size)
+{
+	FILE* fp = fopen(filename, "rb");
+	char* data = NULL;
+
+	if (fp == NULL)
+		return NULL;
+	fseek(fp, 0, SEEK_END);
+	*size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	data = malloc((size_t)*size + 1);
+	if ((data != NULL) &&
+		(fread(data, 1, (size_t)*size, fp) != (size_t)*size))
+	{
+		free(data);
+		data = NULL;
+	}
+	if (data != NULL)
+		data[*size] = '\0';
+	fclose(fp);
+	return data;
+}
+
+// Returns 1 if the two files hold the same bytes.
+static int sameFiles(const char* first, const char* second)
+{
+	long firstSize = 0;
+	long secondSize = 0;
+	char* a = readFile(first, &firstSize);
+	char* b = readFile(second, &secondSize);
+	int same = (a != NULL) && (b != NULL) && (firstSize == secondSize) &&
+		(memcmp(a, b, (size_t)firstSize) == 0);
+
+	free(a);
+	free(b);
+	return same;
+}
+
+// Number of directory entries and column values unlike the tables.
+static long long checkColumns(const ColumnFile* file,
+	const Schedule* schedules, const size_t count)
+{
+	long long mismatches = (file->loanCount != (long long)count);
+
+	for (size_t s = 0; (s < count) && (mismatches == 0); s++)
+	{
+		const ColumnLoan* loan = &file->loans[s];
+		const ScheduleRow* row = schedules[s].rows;
+
+		if ((loan->months != schedules[s].months) ||
+			(loan->loanSize != schedules[s].loanSize) ||
+			(loan->paymentSize != schedules[s].paymentSize) ||
+			(loan->interestRate != schedules[s].interestRate) ||
+			(loan->totalPaid != schedules[s].totalPaid) ||
+			(loan->totalPrincipal != schedules[s].totalPrincipal) ||
+			(loan->totalInterest != schedules[s].totalInterest))
+			mismatches++;
+		for (int i = 0; i < schedules[s].months; i++, row++)
+		{
+			int64_t r = loan->firstRow + i;
+
+			if ((file->month[r] != row->month) ||
+				memcmp(&file->payment[r], &row->payment, sizeof(double)) ||
+				memcmp(&file->principal[r], &row->principal,
+				sizeof(double)) ||
+				memcmp(&file->interest[r], &row->interest, sizeof(double)) ||
+				memcmp(&file->balance[r], &row->balance, sizeof(double)))
+				mismatches++;
+		}
+	}
+	return mismatches;
+}
+
+// Loans whose WriteColumnText() differs from the SaveTable() text.
+static long long checkText(const ColumnFile* file, const Schedule* schedules)
+{
+	long long mismatches = 0;
+
+	for (int s = 0; s < TEXT_LOANS; s++)
+	{
+		ScheduleWriter writer;
+
+		if (!OpenScheduleWriter(&writer, EXPECTED_FILE, WRITER_DIRECT))
+			return TEXT_LOANS;
+		WriteScheduleHeading(&writer, schedules[s].loanSize,
+			schedules[s].interestRate, schedules[s].months);
+		WriteSchedule(&writer, &schedules[s]);
+		CloseScheduleWriter(&writer);
+		if (!OpenScheduleWriter(&writer, TEXT_FILE, WRITER_DIRECT))
+			return TEXT_LOANS;
+		WriteColumnText(&writer, file, s);
+		CloseScheduleWriter(&writer);
+		if (!sameFiles(TEXT_FILE, EXPECTED_FILE))
+			mismatches++;
+	}
+	return mismatches;
+}
+
+// Returns 1 if a copy of the file cut short by one byte is refused.
+static int refusesShortFile(void)
+{
+	long size = 0;
+	char* data = readFile(COLUMN_FILE, &size);
+	FILE* fp = fopen(SHORT_FILE, "wb");
+	ColumnFile file;
+	int refused = 0;
+
+	if ((data != NULL) && (fp != NULL))
+		fwrite(data, 1, (size_t)size - 1, fp);
+	if (fp != NULL)
+		fclose(fp);
+	refused = (data != NULL) && !OpenColumnFile(&file, SHORT_FILE);
+	if (!refused)
+		CloseColumnFile(&file);
+	free(data);
+	remove(SHORT_FILE);
+	return refused;
+}
+
+// Sums the payment column parsed back from the text of every table.
+static double parseText(const char* text)
+{
+	double paid = 0;
+	const char* line = text;
+
+	while ((line != NULL) && (*line != '\0'))
+	{
+		char* end = NULL;
+		long month = ((*line == '\n') || (*line == '\r')) ? 0 :
+			strtol(line, &end, 10);
+
+		if ((month > 0) && (*end == ' '))     // A table row
+		{
+			double values[4];
+
+			for (int c = 0; (c < 4) && (end != NULL); c++)
+			{
+				const char* dollar = strchr(end, '$');
+
+				values[c] = (dollar != NULL) ? strtod(dollar + 1, &end) : 0;
+			}
+			paid += values[0];
+		}
+		line = strchr(line, '\n');
+		line = (line != NULL) ? line + 1 : NULL;
+	}
+	return paid;
+}
+
+int main(int argc, char* argv[])
+{
+	size_t count = (argc > 1) ? (size_t)atol(argv[1]) : BOOK_LOANS;
+	Schedule* schedules = malloc(sizeof(Schedule) * (count + TEXT_LOANS));
+	ScheduleArena arena;
+	ScheduleWriter writer;
+	ColumnFile file;
+	long long rows = 0;
+	long long mismatches = 0;
+	long textSize = 0;
+	char* text = NULL;
+	double scanned = 0;
+	double parsed = 0;
+	double saveTime = 0;
+	double scanTime = 0;
+	double parseTime = 0;
+	double buildTime = 0;
+	double start = 0;
+
+	count = (count < TEXT_LOANS) ? TEXT_LOANS : count;
+	if ((schedules == NULL) || !InitArena(&arena, count *
+		(MAX_MONTHS * sizeof(ScheduleRow) + ARENA_ALIGNMENT)))
+		return EXIT_FAILURE;
+	start = GetWallSeconds();
+	for (size_t s = 0; s < count; s++)
+	{
+		int months = 12 * (1 + nextRandom() % (MAX_MONTHS / 12));
+		double loanSize = 1000 + (nextRandom() % 100000000) / 100.0;
+		double rate = (nextRandom() % 121) / 8.0;
+
+		if (!BuildSchedule(&schedules[s], &arena, loanSize,
+			getPaymentAmount(months, loanSize, rate), rate, months))
+			return EXIT_FAILURE;
+		rows += months;
+	}
+	buildTime = GetWallSeconds() - start;
+
+	start = GetWallSeconds();
+	if (SaveScheduleColumns(COLUMN_FILE, schedules, count) != rows)
+		mismatches++;
+	saveTime = GetWallSeconds() - start;
+	if (!OpenColumnFile(&file, COLUMN_FILE))
+		return EXIT_FAILURE;
+	mismatches += checkColumns(&file, schedules, count);
+	mismatches += checkText(&file, schedules);
+	mismatches += !refusesShortFile();
+
+	if (!OpenScheduleWriter(&writer, TEXT_FILE, WRITER_DIRECT))
+		return EXIT_FAILURE;
+	for (size_t s = 0; s < count; s++)
+		WriteColumnText(&writer, &file, (long long)s);
+	CloseScheduleWriter(&writer);
+	CloseColumnFile(&file);
+
+	start = GetWallSeconds();
+	if (OpenColumnFile(&file, COLUMN_FILE))
+	{
+		for (long long r = 0; r < file.rows; r++)
+			scanned += file.payment[r];
+		CloseColumnFile(&file);
+	}
+	scanTime = GetWallSeconds() - start;
+	start = GetWallSeconds();
+	if ((text = readFile(TEXT_FILE, &textSize)) != NULL)
+		parsed = parseText(text);
+	parseTime = GetWallSeconds() - start;
+	if (fabs(scanned - parsed) > 0.005 * rows)
+		mismatches++;
+
+	printf("%zu loans, %lld rows\n", count, rows);
+	printf("%-30s %10s %12s\n", "", "ms", "ns/row");
+	printf("%-30s %10.2lf %12.2lf\n", "BuildSchedule()", buildTime * 1e3,
+		buildTime * 1e9 / rows);
+	printf("%-30s %10.2lf %12.2lf\n", "SaveScheduleColumns()",
+		saveTime * 1e3, saveTime * 1e9 / rows);
+	printf("%-30s %10.2lf %12.2lf\n", "Map and scan payment column",
+		scanTime * 1e3, scanTime * 1e9 / rows);
+	printf("%-30s %10.2lf %12.2lf\n", "Read and parse text",
+		parseTime * 1e3, parseTime * 1e9 / rows);
+	printf("Columnar file values unlike the tables: %lld\n", mismatches);
+	free(text);
+	free(schedules);
+	FreeArena(&arena);
+	remove(COLUMN_FILE);
+	remove(TEXT_FILE);
+	remove(EXPECTED_FILE);
+	return (mismatches == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
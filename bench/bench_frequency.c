@@ -0,0 +1,198 @@
+//----------------------------------------------------------------------------
+// File:			bench_frequency.c
+//
+// Description      Benchmark of the payment frequency engines. Checks that
+//					the Monthly copies match getPaymentAmount(),
+//					getLoanAmount(), getNumberOfMonths() and
+//					FillScheduleRows() exactly, and that for every frequency
+//					the payment pays the loan off, the term and loan size
+//					invert it and the table ends at zero. Then times each
+//					frequency's schedule loop against one loop, written like
+//					FillScheduleRows(), that reads the frequency at run time.
+//
+//					cc -O2 bench/bench_frequency.c amort*.c -lm -lpthread
+//
+// Functions:	    int main(void)
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include "../amort.h"
+#include "../amort_frequency.h"
+#include "../amort_platform.h"
+#include "bench_util.h"
+
+#define LOAN_COUNT 2000
+#define TERM_YEARS 30
+#define MAX_ROWS (MAX_TERM_YEARS * 52)
+#define TIMED_LOANS 200
+
+typedef struct
+{
+	double loanSize;
+	double interestRate;
+	int years;
+} BenchLoan;
+
+static const int COMPOUNDS[FREQUENCY_COUNT] = { 12, 52, 26, 24, 4,
+	DAYS_PER_YEAR };
+
+#ifdef _MSC_VER
+__declspec(noinline)
+#else
+__attribute__((noinline))
+#endif
+// The schedule loop with the frequency read at run time.
+static int runtimeRows(ScheduleRow* rows, double loanBalance,
+	const double paymentSize, const double interestRate, const int payments,
+	const int perYear, const int compounds)
+{
+	double rate = roundInterest(interestRate, 8);
+	double payment = paymentSize;
+	double interestPaid = 0;
+	double principalPaid = 0;
+	double interestToDate = 0;
+
+	rate = (compounds == perYear) ? rate / (HUNDRED * perYear) :
+		expm1((double)compounds / perYear * log1p(rate / (HUNDRED * compounds)));
+	for (int i = 1; i <= payments; i++)
+	{
+		interestPaid = loanBalance * rate;
+		interestPaid = floor(interestPaid * HUNDRED + HALF) / HUNDRED;
+		principalPaid = payment - interestPaid;
+		loanBalance -= principalPaid;
+		if ((i == payments) && (loanBalance != 0))
+		{
+			payment += loanBalance;
+			principalPaid += loanBalance;
+			loanBalance -= loanBalance;
+		}
+		rows[i - 1].month = i;
+		rows[i - 1].payment = payment;
+		rows[i - 1].principal = principalPaid;
+		rows[i - 1].interest = interestPaid;
+		rows[i - 1].balance = loanBalance;
+		interestToDate += interestPaid;
+		rows[i - 1].interestToDate = interestToDate;
+	}
+	return payments;
+}
+
+// Returns the number of Monthly results that differ from amort.c.
+static int checkMonthly(const BenchLoan* loans, ScheduleRow* rows,
+	ScheduleRow* expected)
+{
+	int mismatches = 0;
+
+	for (int i = 0; i < LOAN_COUNT; i++)
+	{
+		const BenchLoan* loan = &loans[i];
+		int months = loan->years * MONTHS_PER_YEAR;
+		double payment = getPaymentAmount(months, loan->loanSize,
+			loan->interestRate);
+
+		if ((getPaymentAmountMonthly(months, loan->loanSize,
+			loan->interestRate) != payment) ||
+			(getLoanAmountMonthly(payment, months, loan->interestRate) !=
+			getLoanAmount(payment, months, loan->interestRate)) ||
+			(getNumberOfPaymentsMonthly(payment, loan->loanSize,
+			loan->interestRate) != getNumberOfMonths(payment,
+			loan->loanSize, loan->interestRate)))
+			mismatches++;
+		FillScheduleRowsMonthly(rows, loan->loanSize, payment,
+			loan->interestRate, months);
+		FillScheduleRows(expected, loan->loanSize, payment,
+			loan->interestRate, months, 1, months);
+		if (memcmp(rows, expected, months * sizeof(ScheduleRow)) != 0)
+			mismatches++;
+	}
+	return mismatches;
+}
+
+// Returns the number of loans of a frequency that do not add up.
+static int checkFrequency(const int frequency, const BenchLoan* loans,
+	ScheduleRow* rows)
+{
+	int failures = 0;
+
+	for (int i = 0; i < LOAN_COUNT; i++)
+	{
+		const BenchLoan* loan = &loans[i];
+		int payments = loan->years * GetPaymentsPerYear(frequency);
+		double payment = GetFrequencyPayment(frequency, payments,
+			loan->loanSize, loan->interestRate);
+		double loanSize = GetFrequencyLoanAmount(frequency, payment,
+			payments, loan->interestRate);
+		int term = GetFrequencyPayments(frequency, payment, loan->loanSize,
+			loan->interestRate);
+		double principal = 0;
+
+		FillFrequencyRows(frequency, rows, loan->loanSize, payment,
+			loan->interestRate, payments);
+		for (int k = 0; k < payments; k++)
+			principal += rows[k].principal;
+		if ((term > payments) || (term < 1) ||
+			(loanSize < loan->loanSize - ONE_CENT) ||
+			(loanSize > loan->loanSize + payments * ONE_CENT) ||
+			(rows[payments - 1].balance != 0) ||
+			(rows[payments - 1].payment > payment + payments * ONE_CENT) ||
+			(fabs(principal - loan->loanSize) > ONE_CENT))
+			failures++;
+	}
+	return failures;
+}
+
+int main(void)
+{
+	static BenchLoan loans[LOAN_COUNT];
+	static ScheduleRow rows[MAX_ROWS];
+	static ScheduleRow expected[MAX_ROWS];
+	int failures = 0;
+	volatile double sink = 0;
+
+	for (int i = 0; i < LOAN_COUNT; i++)
+	{
+		loans[i].years = 1 + (int)(nextRandom() % TERM_YEARS);
+		loans[i].loanSize = (double)(nextRandom() % 100000000) / HUNDRED + 1;
+		loans[i].interestRate = (double)(1 + nextRandom() % 160) / 8;
+	}
+
+	failures = checkMonthly(loans, rows, expected);
+	printf("Monthly results differing from amort.c: %d\n", failures);
+	printf("%14s %9s %12s %12s %8s\n", "frequency", "failures",
+		"ns/row", "runtime", "speedup");
+	for (int f = 0; f < FREQUENCY_COUNT; f++)
+	{
+		int bad = checkFrequency(f, loans, rows);
+		int perYear = GetPaymentsPerYear(f);
+		long long rowCount = 0;
+		double specialized = 0;
+		double runtime = 0;
+		double start = GetWallSeconds();
+
+		for (int i = 0; i < TIMED_LOANS; i++)
+		{
+			int payments = loans[i].years * perYear;
+
+			rowCount += FillFrequencyRows(f, rows, loans[i].loanSize,
+				loans[i].loanSize / payments, loans[i].interestRate,
+				payments);
+			sink += rows[payments - 1].interestToDate;
+		}
+		specialized = (GetWallSeconds() - start) / rowCount;
+		start = GetWallSeconds();
+		for (int i = 0; i < TIMED_LOANS; i++)
+		{
+			int payments = loans[i].years * perYear;
+
+			runtimeRows(expected, loans[i].loanSize,
+				loans[i].loanSize / payments, loans[i].interestRate,
+				payments, perYear, COMPOUNDS[f]);
+			sink += expected[payments - 1].interestToDate;
+		}
+		runtime = (GetWallSeconds() - start) / rowCount;
+		printf("%14s %9d %12.2lf %12.2lf %7.2lfx\n", GetFrequencyName(f),
+			bad, specialized * 1e9, runtime * 1e9, runtime / specialized);
+		failures += bad;
+	}
+	return ((failures == 0) && (sink != 0)) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,132 @@
+//----------------------------------------------------------------------------
+// File:			bench_grid.c
+//
+// Description      Benchmark of the rate by term grid. Fills the grid of 0
+//					to 30% against 1 to 6000 months and checks every payment
+//					against getPaymentAmount(), then rescales it to a second
+//					principal and checks it again. Payments may be one cent
+//					apart where pow() is not correctly rounded; any other
+//					difference fails. Reports the time of a
+//					getPaymentAmount() call per cell (pow(), the annuity
+//					table turned off), of refilling the grid with
+//					FillRateGrid() and of RescaleRateGrid(), and writes both
+//					file formats.
+//
+//					cc -O2 bench/bench_grid.c amort*.c -lm -lpthread
+//
+// Functions:	    int main(void)
+//----------------------------------------------------------------------------
+
+#include "../amort_annuity.h"
+#include "../amort_grid.h"
+#include "../amort_platform.h"
+
+#define FIRST_PRINCIPAL 250000.0
+#define SECOND_PRINCIPAL 1234567.89
+#define CSV_FILE "bench_grid.csv"
+#define BINARY_FILE "bench_grid.bin"
+
+// Returns the number of cells more than a cent away from getPaymentAmount()
+// and adds those exactly one cent away to *nearMisses: the grid's power is
+// correctly rounded and pow() now and then is not.
+static long long checkGrid(const RateGrid* grid, long long* nearMisses)
+{
+	const Cents principalCents = ToCents(grid->principal);
+	long long mismatches = 0;
+
+	for (int row = 0; row < grid->rates; row++)
+	{
+		for (int n = 1; n <= grid->terms; n++)
+		{
+			size_t cell = (size_t)row * grid->terms + n - 1;
+			Cents payment = ToCents(getPaymentAmount(n, grid->principal,
+				row / 8.0));
+			Cents difference = grid->payment[cell] - payment;
+
+			if (grid->interest[cell] != grid->payment[cell] * n -
+				principalCents)
+				mismatches++;
+			else if ((difference == 1) || (difference == -1))
+				(*nearMisses)++;
+			else if (difference != 0)
+				mismatches++;
+		}
+	}
+	return mismatches;
+}
+
+// Seconds taken to price every cell with getPaymentAmount().
+static double timeCells(const RateGrid* grid, volatile double* sink)
+{
+	double start = GetWallSeconds();
+
+	for (int row = 0; row < grid->rates; row++)
+		for (int n = 1; n <= grid->terms; n++)
+			*sink += getPaymentAmount(n, grid->principal, row / 8.0);
+	return GetWallSeconds() - start;
+}
+
+int main(void)
+{
+	RateGrid grid;
+	long long mismatches = 0;
+	long long nearMisses = 0;
+	long long cells = 0;
+	double cellTime = 0;
+	double fillTime = 0;
+	double rescaleTime = 0;
+	double csvTime = 0;
+	double binaryTime = 0;
+	double start = 0;
+	int threads = GetCpuCount();
+	volatile double sink = 0;
+
+	if (!AllocRateGrid(&grid, GRID_MAX_EIGHTHS, GRID_TERMS))
+		return EXIT_FAILURE;
+	cells = (long long)grid.rates * grid.terms;
+
+	FillRateGrid(&grid, FIRST_PRINCIPAL, 0);      // Faults the pages in
+	start = GetWallSeconds();
+	FillRateGrid(&grid, FIRST_PRINCIPAL, 0);
+	fillTime = GetWallSeconds() - start;
+	mismatches += checkGrid(&grid, &nearMisses);
+
+	start = GetWallSeconds();
+	RescaleRateGrid(&grid, SECOND_PRINCIPAL, 0);
+	rescaleTime = GetWallSeconds() - start;
+	mismatches += checkGrid(&grid, &nearMisses);
+
+	SetAnnuityBudget(0);
+	ClearAnnuityTable();
+	cellTime = timeCells(&grid, &sink);
+	SetAnnuityBudget(ANNUITY_DEFAULT_BUDGET);
+
+	start = GetWallSeconds();
+	if (SaveRateGrid(&grid, CSV_FILE, GRID_CSV) != cells)
+		mismatches++;
+	csvTime = GetWallSeconds() - start;
+	start = GetWallSeconds();
+	if (SaveRateGrid(&grid, BINARY_FILE, GRID_BINARY) != cells)
+		mismatches++;
+	binaryTime = GetWallSeconds() - start;
+	remove(CSV_FILE);
+	remove(BINARY_FILE);
+
+	printf("%lld cells (%d rates x %d terms), %d threads\n", cells,
+		grid.rates, grid.terms, threads);
+	printf("%-26s %10s %12s %8s\n", "", "ms", "ns/cell", "speedup");
+	printf("%-26s %10.2lf %12.2lf %7.2lfx\n", "getPaymentAmount() cells",
+		cellTime * 1e3, cellTime * 1e9 / cells, 1.0);
+	printf("%-26s %10.2lf %12.2lf %7.2lfx\n", "FillRateGrid()",
+		fillTime * 1e3, fillTime * 1e9 / cells, cellTime / fillTime);
+	printf("%-26s %10.2lf %12.2lf %7.2lfx\n", "RescaleRateGrid()",
+		rescaleTime * 1e3, rescaleTime * 1e9 / cells, cellTime / rescaleTime);
+	printf("%-26s %10.2lf %12.2lf\n", "SaveRateGrid() CSV",
+		csvTime * 1e3, csvTime * 1e9 / cells);
+	printf("%-26s %10.2lf %12.2lf\n", "SaveRateGrid() binary",
+		binaryTime * 1e3, binaryTime * 1e9 / cells);
+	printf("Cells one cent from getPaymentAmount(): %lld\n", nearMisses);
+	printf("Cells further from getPaymentAmount(): %lld\n", mismatches);
+	FreeRateGrid(&grid);
+	return ((mismatches == 0) && (sink != 0)) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,300 @@
+//----------------------------------------------------------------------------
+// File:			bench_metrics.c
+//
+// Description      Benchmark of the hot path metrics. Checks that the
+//					counters match what the calls report themselves: the
+//					calls, iterations and failures of solveInterestRate()
+//					and SolveInterestRates(), the rows and calculations of
+//					tables built on threads that have since ended, the bytes
+//					a ScheduleWriter formatted and wrote, and the number of
+//					PriceLoanRecord() calculations of each type and of them
+//					timed. Checks the Prometheus and JSON text and that
+//					nothing is counted while the metrics are off. Then times
+//					pricing records with the metrics on and off.
+//
+//					bench_metrics [records]     (default PRICE_RECORDS)
+//
+//					cc -O2 bench/bench_metrics.c amort*.c -lm -lpthread
+//
+// Functions:	    int main(int argc, char* argv[])
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include "../amort.h"
+#include "../amort_batch.h"
+#include "../amort_metrics.h"
+#include "../amort_platform.h"
+#include "../amort_schedule.h"
+#include "../amort_solver.h"
+#include "../amort_writer.h"
+#define BENCH_SEED 2019
+#include "bench_util.h"
+
+#define PRICE_RECORDS 1000000
+#define PRICING_ROUNDS 3
+#define SOLVES 20000
+#define TABLE_THREADS 4
+#define TABLES_PER_THREAD 500
+#define MAX_MONTHS 480
+#define TEXT_FILE "bench_metrics.txt"
+
+typedef struct
+{
+	int tables;
+	long long rows;                 // Rows built, as BuildSchedule() says
+	int failed;
+} TableWork;
+
+// Thread: builds tables into an arena of its own.
+static void buildTables(void* arg)
+{
+	TableWork* work = (TableWork*)arg;
+	ScheduleArena arena;
+	Schedule schedule;
+	unsigned int state = (unsigned int)work->tables * 7919u;
+
+	if (!InitArena(&arena, SCHEDULE_ARENA))
+	{
+		work->failed = 1;
+		return;
+	}
+	for (int t = 0; t < work->tables; t++)
+	{
+		int months = 12 * (1 + (int)((state = state * 1103515245u + 12345u)
+			>> 16) % (MAX_MONTHS / 12));
+
+		ResetArena(&arena);
+		if (!BuildSchedule(&schedule, &arena, 200000, getPaymentAmount(
+			months, 200000, 6.25), 6.25, months))
+			work->failed = 1;
+		work->rows += schedule.months;
+	}
+	FreeArena(&arena);
+}
+
+// Counts differences between the change in a counter and what it should be.
+static long long checkDelta(const MetricValues* before,
+	const MetricValues* after, const int metric, const long long expected,
+	const char* name)
+{
+	long long delta = after->counters[metric] - before->counters[metric];
+
+	if (delta == expected)
+		return 0;
+	printf("%s: counted %lld, expected %lld\n", name, delta, expected);
+	return 1;
+}
+
+// Fills records that solve each unknown in turn.
+static void makeRecords(LoanRecord* records, const size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		LoanRecord* record = &records[i];
+
+		record->months = 12 * (1 + nextRandom() % 40);
+		record->loanSize = 1000 + (nextRandom() % 50000000) / 100.0;
+		record->interestRate = 1 + (nextRandom() % 1000) / 100.0;
+		record->paymentSize = ceil(getPaymentAmount(record->months,
+			record->loanSize, record->interestRate) * HUNDRED) / HUNDRED;
+		record->unknown = "PLNI"[i % 4];
+		record->status = BATCH_OK;
+	}
+}
+
+// Best of PRICING_ROUNDS times to price every record once.
+static double timePricing(LoanRecord* records, const LoanRecord* inputs,
+	const size_t count)
+{
+	double best = 0;
+
+	for (int r = 0; r < PRICING_ROUNDS; r++)
+	{
+		double start = 0;
+		double elapsed = 0;
+
+		memcpy(records, inputs, sizeof(LoanRecord) * count);
+		start = GetWallSeconds();
+		for (size_t i = 0; i < count; i++)
+			PriceLoanRecord(&records[i]);
+		elapsed = GetWallSeconds() - start;
+		best = ((r == 0) || (elapsed < best)) ? elapsed : best;
+	}
+	return best;
+}
+
+int main(int argc, char* argv[])
+{
+	size_t count = (argc > 1) ? (size_t)atol(argv[1]) : PRICE_RECORDS;
+	LoanRecord* inputs = (LoanRecord*)malloc(sizeof(LoanRecord) * count);
+	LoanRecord* records = (LoanRecord*)malloc(sizeof(LoanRecord) * count);
+	int* months = (int*)malloc(sizeof(int) * SOLVES);
+	double* principal = (double*)malloc(sizeof(double) * SOLVES);
+	double* payment = (double*)malloc(sizeof(double) * SOLVES);
+	double* rates = (double*)malloc(sizeof(double) * SOLVES);
+	int* status = (int*)malloc(sizeof(int) * SOLVES);
+	int* iterations = (int*)malloc(sizeof(int) * SOLVES);
+	TableWork work[TABLE_THREADS];
+	AmortThread threads[TABLE_THREADS];
+	MetricValues before;
+	MetricValues after;
+	ScheduleWriter writer;
+	ScheduleArena arena;
+	Schedule schedule;
+	char text[METRICS_TEXT_MAX] = "";
+	char expected[256] = "";
+	long long mismatches = 0;
+	long long steps = 0;
+	long long failures = 0;
+	long long rows = 0;
+	long long written = 0;
+	size_t solved = 0;
+	double onTime = 0;
+	double offTime = 0;
+
+	if ((inputs == NULL) || (records == NULL) || (months == NULL) ||
+		(principal == NULL) || (payment == NULL) || (rates == NULL) ||
+		(status == NULL) || (iterations == NULL) ||
+		!InitArena(&arena, SCHEDULE_ARENA))
+		return EXIT_FAILURE;
+	for (int i = 0; i < SOLVES; i++)
+	{
+		months[i] = 12 * (1 + nextRandom() % 40);
+		principal[i] = 1000 + (nextRandom() % 50000000) / 100.0;
+		payment[i] = getPaymentAmount(months[i], principal[i],
+			(nextRandom() % 2000) / 100.0);
+		if (i % 10 == 9)
+			payment[i] = principal[i] / months[i] / 2;   // No rate fits
+	}
+	SetMetricsEnabled(1);
+
+	ReadMetrics(&before);
+	for (int i = 0; i < SOLVES; i++)
+	{
+		int used = 0;
+
+		if (findInterestRate(months[i], principal[i], payment[i], &used) ==
+			NO_RATE)
+			failures++;
+		steps += used;
+	}
+	ReadMetrics(&after);
+	mismatches += checkDelta(&before, &after, METRIC_SOLVER_CALLS, SOLVES,
+		"solveInterestRate() calls");
+	mismatches += checkDelta(&before, &after, METRIC_SOLVER_ITERATIONS,
+		steps, "solveInterestRate() iterations");
+	mismatches += checkDelta(&before, &after, METRIC_SOLVER_FAILURES,
+		failures, "solveInterestRate() failures");
+
+	ReadMetrics(&before);
+	solved = SolveInterestRates(months, principal, payment, rates, status,
+		iterations, SOLVES, RATE_TOLERANCE);
+	steps = 0;
+	for (int i = 0; i < SOLVES; i++)
+		steps += iterations[i];
+	ReadMetrics(&after);
+	mismatches += checkDelta(&before, &after, METRIC_SOLVER_CALLS, SOLVES,
+		"SolveInterestRates() offers");
+	mismatches += checkDelta(&before, &after, METRIC_SOLVER_ITERATIONS,
+		steps, "SolveInterestRates() iterations");
+	mismatches += checkDelta(&before, &after, METRIC_SOLVER_FAILURES,
+		SOLVES - (long long)solved, "SolveInterestRates() failures");
+
+	ReadMetrics(&before);
+	for (int t = 0; t < TABLE_THREADS; t++)
+	{
+		memset(&work[t], 0, sizeof(TableWork));
+		work[t].tables = TABLES_PER_THREAD + t;
+		if (!StartThread(&threads[t], buildTables, &work[t]))
+			buildTables(&work[t]);
+		else
+			JoinThread(threads[t]);
+		rows += work[t].rows;
+		mismatches += work[t].failed;
+	}
+	ReadMetrics(&after);
+	mismatches += checkDelta(&before, &after, METRIC_ROWS, rows,
+		"Rows built on ended threads");
+	if (after.calls[TIMER_SCHEDULE] - before.calls[TIMER_SCHEDULE] !=
+		TABLE_THREADS * TABLES_PER_THREAD + TABLE_THREADS *
+		(TABLE_THREADS - 1) / 2)
+		mismatches++;
+
+	ReadMetrics(&before);
+	if (!OpenScheduleWriter(&writer, TEXT_FILE, WRITER_DIRECT) ||
+		!BuildSchedule(&schedule, &arena, 250000,
+		getPaymentAmount(360, 250000, 6.5), 6.5, 360))
+		return EXIT_FAILURE;
+	WriteScheduleHeading(&writer, 250000, 6.5, 360);
+	WriteSchedule(&writer, &schedule);
+	FlushScheduleWriter(&writer);
+	written = writer.written;
+	CloseScheduleWriter(&writer);
+	ReadMetrics(&after);
+	mismatches += checkDelta(&before, &after, METRIC_BYTES_FORMATTED,
+		written, "Bytes formatted");
+	mismatches += checkDelta(&before, &after, METRIC_BYTES_WRITTEN,
+		written, "Bytes written");
+	remove(TEXT_FILE);
+
+	makeRecords(inputs, count);
+	SetMetricsEnabled(0);
+	timePricing(records, inputs, count);        // Builds the lazy tables
+	SetMetricsEnabled(1);
+	ReadMetrics(&before);
+	onTime = timePricing(records, inputs, count);
+	ReadMetrics(&after);
+	for (int t = TIMER_PAYMENT; t <= TIMER_RATE; t++)
+	{
+		long long calls = after.calls[t] - before.calls[t];
+		long long timed = after.timed[t] - before.timed[t];
+
+		if ((calls != PRICING_ROUNDS *
+			(long long)(count / 4 + (count % 4 > (size_t)t))) ||
+			(timed < calls / METRIC_SAMPLE_EVERY) ||
+			(timed > calls / METRIC_SAMPLE_EVERY + 1))
+			mismatches++;
+	}
+
+	FormatMetrics(text, sizeof(text), METRICS_PROMETHEUS);
+	ReadMetrics(&after);
+	sprintf(expected, "\namort_schedule_rows_total %lld\n",
+		after.counters[METRIC_ROWS]);
+	if (!strstr(text, expected) ||
+		!strstr(text, "# TYPE amort_solver_calls_total counter\n") ||
+		!strstr(text, "amort_calculations_total{type=\"rate\"} ") ||
+		(strcmp(text + strlen(text) - 6, "# EOF\n") != 0))
+		mismatches++;
+	FormatMetrics(text, sizeof(text), METRICS_JSON);
+	sprintf(expected, "\"schedule_rows\":%lld,", after.counters[METRIC_ROWS]);
+	if ((text[0] != '{') || !strstr(text, expected) ||
+		!strstr(text, "\"calculations\":{\"payment\":{\"calls\":") ||
+		(strcmp(text + strlen(text) - 3, "}}\n") != 0))
+		mismatches++;
+
+	SetMetricsEnabled(0);
+	ReadMetrics(&before);
+	offTime = timePricing(records, inputs, count);
+	findInterestRate(360, 250000, 1600, NULL);
+	ReadMetrics(&after);
+	if (memcmp(&before, &after, sizeof(MetricValues)) != 0)
+		mismatches++;
+	SetMetricsEnabled(1);
+
+	printf("%zu records priced, best of %d\n", count, PRICING_ROUNDS);
+	printf("%-30s %12s\n", "", "ns/record");
+	printf("%-30s %12.2lf\n", "Metrics off", offTime * 1e9 / count);
+	printf("%-30s %12.2lf\n", "Metrics on", onTime * 1e9 / count);
+	printf("Overhead: %.1lf%%\n", (onTime - offTime) * 100 / offTime);
+	printf("Metrics unlike the calls they count: %lld\n", mismatches);
+	free(inputs);
+	free(records);
+	free(months);
+	free(principal);
+	free(payment);
+	free(rates);
+	free(status);
+	free(iterations);
+	FreeArena(&arena);
+	return (mismatches == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
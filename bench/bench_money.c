@@ -0,0 +1,214 @@
+//----------------------------------------------------------------------------
+// File:			bench_money.c
+//
+// Description      Benchmark of the comma grouped money formatter. Checks
+//					FormatCurrency() against "%.2lf" text grouped by hand,
+//					for random cents, random doubles and awkward values, and
+//					with every buffer size up to the whole text. Then times
+//					the PrintCommas() of version 1.0 (kept here), the new
+//					PrintCommas() and FormatCurrency() into a buffer.
+//
+//					The printing runs send stdout to the null device, so the
+//					report goes to stderr.
+//
+//					cc -O2 bench/bench_money.c amort*.c -lm -lpthread
+//
+// Functions:	    int main(void)
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include "../amort.h"
+#include "../amort_platform.h"
+#include "../amort_writer.h"
+#include "bench_util.h"
+
+#define CHECK_COUNT 4000000
+#define VALUE_COUNT 4096
+#define PRINT_VALUES 200000
+#define FORMAT_ROUNDS 2000
+
+#ifdef _WIN32
+#define NULL_DEVICE "NUL"
+#else
+#define NULL_DEVICE "/dev/null"
+#endif
+
+static const double EDGE_VALUES[] =
+{
+	0, -0.0, 0.005, -0.004, 0.015, 2.675, 999.995, 999.999, 1000, 999999.99,
+	1e12, 123456789012.345, 1e13, 98765432109876.54, -98765.4321, 1e300,
+	-1e300, 1.0 / 0.0, -1.0 / 0.0
+};
+
+// PrintCommas() of version 1.0.
+static void printCommasOld(const double amount)
+{
+	int commas = 0;
+	int thousands = 0;
+	int intRemainder = 0;
+	long int millions = 0;
+	long long int billions = 0;
+	long long int balance = 0;
+	long int divisor = 0;
+	long long int intAmount = (long long int)floor(amount);
+	double tempDouble = round((amount - intAmount) * HUNDRED) / HUNDRED;
+
+	intRemainder = (int)(round(tempDouble * 100));
+	if (amount < THOUSAND)
+	{
+		printf("$%lld.%02d\n", intAmount, intRemainder);
+		return;
+	}
+	balance = intAmount;
+	commas = ((amount >= THOUSAND) && (amount < MILLION)) ? 1 :
+		((amount >= MILLION) && (amount < BILLION)) ? 2 :
+		((amount >= BILLION) && (amount < TRILLION)) ? 3 : 4;
+	divisor = (commas == 1) ? THOUSAND :
+		(commas == 2) ? MILLION :
+		(commas == 3) ? BILLION : TRILLION;
+	if (commas == 1)
+	{
+		thousands = (int)floor(intAmount / divisor);
+		printf("$%d,", thousands);
+		balance -= (long long)thousands * divisor;
+		printf("%03lld.%02d\n", balance, intRemainder);
+	}
+	if (commas == 2)
+	{
+		millions = (long)balance / divisor;
+		printf("$%ld,", millions);
+		balance -= (long long)(millions * divisor);
+		thousands = (int)(balance / THOUSAND);
+		printf("%03d,", thousands);
+		balance -= thousands * THOUSAND;
+		printf("%03lld.%02d\n", balance, intRemainder);
+	}
+	if (commas == 3)
+	{
+		billions = (long long)floor(intAmount / divisor);
+		printf("$%lld,", billions);
+		balance -= (long long)(billions * divisor);
+		millions = (long)(balance / MILLION);
+		printf("%03ld,", millions);
+		balance -= (long long)(millions * MILLION);
+		thousands = (int)balance / THOUSAND;
+		printf("%03d,", thousands);
+		balance -= thousands * THOUSAND;
+		printf("%03lld.%02d\n", balance, intRemainder);
+	}
+	if (commas >= 4)
+		printf("$%.2lf\n", amount);
+}
+
+// The text FormatCurrency() should give, built from snprintf().
+static void expectedText(char* text, const double amount)
+{
+	char plain[MONEY_TEXT_MAX];
+	int length = snprintf(plain, sizeof(plain), "%.2lf", fabs(amount));
+	int digits = (int)strcspn(plain, ".");
+	int out = 0;
+
+	if (signbit(amount) && (strcmp(plain, "0.00") != 0))
+		text[out++] = '-';
+	text[out++] = '$';
+	for (int i = 0; i < length; i++)
+	{
+		if ((i > 0) && (i < digits) && ((digits - i) % 3 == 0))
+			text[out++] = ',';
+		text[out++] = plain[i];
+	}
+	text[out] = '\0';
+}
+
+// Returns 1 if FormatCurrency() gives the expected text for amount, and
+// the same text cut short for every smaller buffer.
+static int checkValue(const double amount, const int allSizes)
+{
+	char expected[CURRENCY_TEXT_MAX];
+	char text[CURRENCY_TEXT_MAX];
+	int length = 0;
+
+	expectedText(expected, amount);
+	length = FormatCurrency(text, sizeof(text), amount);
+	if ((length != (int)strlen(expected)) || (strcmp(text, expected) != 0))
+	{
+		fprintf(stderr, "%.17g: \"%s\" expected \"%s\"\n", amount, text,
+			expected);
+		return 0;
+	}
+	if (FormatCurrency(NULL, 0, amount) != length)
+		return 0;
+	for (int size = 1; allSizes && (size <= length); size++)
+	{
+		memset(text, '#', sizeof(text));
+		if ((FormatCurrency(text, size, amount) != length) ||
+			(strncmp(text, expected, size - 1) != 0) ||
+			(text[size - 1] != '\0') || (text[size] != '#'))
+			return 0;
+	}
+	return 1;
+}
+
+int main(void)
+{
+	const int EDGE_COUNT = sizeof(EDGE_VALUES) / sizeof(EDGE_VALUES[0]);
+	static double values[VALUE_COUNT];
+	char text[CURRENCY_TEXT_MAX];
+	long long failures = 0;
+	double oldTime = 0;
+	double newTime = 0;
+	double formatTime = 0;
+	double start = 0;
+	volatile long long sink = 0;
+
+	for (int e = 0; e < EDGE_COUNT; e++)
+		failures += !checkValue(EDGE_VALUES[e], 1);
+	failures += !checkValue(0.0 / 0.0, 1);
+	for (int i = 0; i < CHECK_COUNT; i++)
+	{
+		unsigned long long r = stepRandom(&seed) >> 11;
+		double amount = 0;
+
+		if (i % 2 == 0)                    // Whole cents below a trillion
+			amount = (double)(r % 100000000000000ULL) / HUNDRED;
+		else                               // Any double up to 1e17
+			amount = (double)r / (1ULL << 53) * pow(10, (int)(r % 18)) -
+				(double)(r & 1) * 1e3;
+		failures += !checkValue(amount, i < 1000);
+	}
+	fprintf(stderr, "FormatCurrency() wrong: %lld of %d values\n", failures,
+		CHECK_COUNT + EDGE_COUNT + 1);
+
+	for (int i = 0; i < VALUE_COUNT; i++)
+		values[i] = (double)((stepRandom(&seed) >> 11) %
+			100000000000000ULL) / HUNDRED;
+
+	fflush(stdout);
+	if (freopen(NULL_DEVICE, "w", stdout) == NULL)
+		return EXIT_FAILURE;
+	start = GetWallSeconds();
+	for (int i = 0; i < PRINT_VALUES; i++)
+		printCommasOld(values[i % VALUE_COUNT]);
+	fflush(stdout);
+	oldTime = (GetWallSeconds() - start) / PRINT_VALUES;
+	start = GetWallSeconds();
+	for (int i = 0; i < PRINT_VALUES; i++)
+		PrintCommas(values[i % VALUE_COUNT]);
+	fflush(stdout);
+	newTime = (GetWallSeconds() - start) / PRINT_VALUES;
+	start = GetWallSeconds();
+	for (int r = 0; r < FORMAT_ROUNDS; r++)
+		for (int i = 0; i < VALUE_COUNT; i++)
+			sink += FormatCurrency(text, sizeof(text), values[i]);
+	formatTime = (GetWallSeconds() - start) / FORMAT_ROUNDS / VALUE_COUNT;
+
+	fprintf(stderr, "%-28s %10s %14s\n", "formatter", "ns/value",
+		"values/s");
+	fprintf(stderr, "%-28s %10.1lf %14.0lf\n", "PrintCommas() version 1.0",
+		oldTime * 1e9, 1 / oldTime);
+	fprintf(stderr, "%-28s %10.1lf %14.0lf\n", "PrintCommas()",
+		newTime * 1e9, 1 / newTime);
+	fprintf(stderr, "%-28s %10.1lf %14.0lf\n", "FormatCurrency() to buffer",
+		formatTime * 1e9, 1 / formatTime);
+	return ((failures == 0) && (sink != 0)) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
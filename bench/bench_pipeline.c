@@ -0,0 +1,264 @@
+//----------------------------------------------------------------------------
+// File:			bench_pipeline.c
+//
+// Description      Benchmark of the staged batch pipeline. First checks an
+//					MPSC ring: several threads push numbered items at once
+//					through a small ring and the consumer must see every
+//					item once, each thread's in order. Then writes a file
+//					of random loan records (every unknown, some bad and
+//					blank lines), prices it with RunBatch() and with
+//					RunPipeline() for several pricer counts, and checks
+//					that the text output is the same byte for byte and the
+//					binary output holds the same results. Reports the time
+//					of each and the busy time of each pipeline stage: with
+//					a CPU for every thread the run takes about as long as
+//					the busiest stage, not all of them added up.
+//
+//					bench_pipeline [records]    (default BENCH_RECORDS)
+//
+//					cc -O2 bench/bench_pipeline.c amort*.c -lm -lpthread
+//
+// Functions:	    int main(int argc, char* argv[])
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include "../amort.h"
+#include "../amort_batch.h"
+#include "../amort_pipeline.h"
+#include "../amort_platform.h"
+#include "../amort_ring.h"
+#define BENCH_SEED 2022
+#include "bench_util.h"
+
+#define BENCH_RECORDS 300000
+#define RING_PRODUCERS 4
+#define RING_ITEMS 200000           // Per producer
+#define RING_SLOTS 16
+#define INPUT_FILE "bench_pipeline.in"
+#define BATCH_FILE "bench_pipeline.batch"
+#define OUTPUT_FILE "bench_pipeline.out"
+
+typedef struct
+{
+	AmortRing* ring;
+	size_t producer;
+} RingProducer;
+
+// Thread: pushes RING_ITEMS numbered items; item k of producer p is
+// k * RING_PRODUCERS + p + 1, never NULL.
+static void pushItems(void* arg)
+{
+	RingProducer* producer = (RingProducer*)arg;
+
+	for (size_t k = 0; k < RING_ITEMS; k++)
+		PushRing(producer->ring, (void*)(k * RING_PRODUCERS +
+			producer->producer + 1), 1, NULL);
+}
+
+// Pops every item of every producer and counts the ones out of order.
+static long long checkRing(void)
+{
+	AmortRing ring;
+	AmortThread threads[RING_PRODUCERS];
+	int launched[RING_PRODUCERS] = { 0 };
+	RingProducer producers[RING_PRODUCERS];
+	size_t expected[RING_PRODUCERS] = { 0 };
+	long long mismatches = 0;
+
+	if (!InitRing(&ring, RING_SLOTS))
+		return 1;
+	for (size_t p = 0; p < RING_PRODUCERS; p++)
+	{
+		producers[p].ring = &ring;
+		producers[p].producer = p;
+		launched[p] = StartThread(&threads[p], pushItems, &producers[p]);
+		mismatches += !launched[p];
+	}
+	for (size_t i = 0; i < RING_ITEMS * (size_t)RING_PRODUCERS; i++)
+	{
+		size_t item = (size_t)PopRing(&ring, NULL) - 1;
+		size_t p = item % RING_PRODUCERS;
+
+		if (!launched[p] || (item / RING_PRODUCERS != expected[p]++))
+		{
+			mismatches++;
+			break;
+		}
+	}
+	for (size_t p = 0; p < RING_PRODUCERS; p++)
+		if (launched[p])
+			JoinThread(threads[p]);
+	FreeRing(&ring);
+	return mismatches;
+}
+
+// Writes random records with the n'th unknown blank; every fiftieth is a
+// bad record and every thousandth line blank.
+static void makeInput(const char* name, const size_t count)
+{
+	FILE* fp = fopen(name, "w");
+
+	for (size_t n = 0; (fp != NULL) && (n < count); n++)
+	{
+		int months = 12 * (1 + nextRandom() % 40);
+		double loanSize = 1000 + (nextRandom() % 50000000) / 100.0;
+		double rate = (nextRandom() % 1201) / 100.0;
+		double payment = ceil(getPaymentAmount(months, loanSize, rate) *
+			HUNDRED) / HUNDRED;
+
+		if (n % 1000 == 999)
+			fputs("\n", fp);
+		if (n % 50 == 49)
+			fprintf(fp, "%.2lf,abc,,%.3lf\n", loanSize, rate);
+		else if (n % 4 == 0)
+			fprintf(fp, "%.2lf,,%d,%.3lf\n", loanSize, months, rate);
+		else if (n % 4 == 1)
+			fprintf(fp, ",%.2lf,%d,%.3lf\n", payment, months, rate);
+		else if (n % 4 == 2)
+			fprintf(fp, "%.2lf,%.2lf,,%.3lf\n", loanSize, payment, rate);
+		else
+			fprintf(fp, "%.2lf,%.2lf,%d,\n", loanSize, payment, months);
+	}
+	if (fp != NULL)
+		fclose(fp);
+}
+
+// Reads a whole file into memory. Returns NULL if it cannot.
+static char* readFile(const char* name, size_t* size)
+{
+	FILE* fp = fopen(name, "rb");
+	char* data = NULL;
+	long length = 0;
+
+	if (fp == NULL)
+		return NULL;
+	fseek(fp, 0, SEEK_END);
+	length = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	data = (char*)malloc((size_t)length + 1);
+	*size = (data == NULL) ? 0 : fread(data, 1, (size_t)length, fp);
+	fclose(fp);
+	return data;
+}
+
+// Runs a whole file through RunPipeline(). Returns the records written.
+static long long runFile(const int workers, const int format,
+	PipelineStats* stats)
+{
+	FILE* in = fopen(INPUT_FILE, "r");
+	FILE* out = fopen(OUTPUT_FILE, "wb");
+	long long count = -1;
+
+	if ((in != NULL) && (out != NULL))
+		count = RunPipeline(in, out, workers, format, stats);
+	if (in != NULL)
+		fclose(in);
+	if (out != NULL)
+		fclose(out);
+	return count;
+}
+
+// Counts binary results unlike the records priced one at a time.
+static long long checkBinary(const LoanRecord* records, const size_t count)
+{
+	size_t size = 0;
+	char* data = readFile(OUTPUT_FILE, &size);
+	long long mismatches = (data == NULL) ||
+		(size != count * sizeof(PipelineResult));
+
+	for (size_t i = 0; !mismatches && (i < count); i++)
+	{
+		PipelineResult result;
+
+		memcpy(&result, data + i * sizeof(PipelineResult), sizeof(result));
+		mismatches += (result.loanSize != records[i].loanSize) ||
+			(result.paymentSize != records[i].paymentSize) ||
+			(result.interestRate != records[i].interestRate) ||
+			(result.months != records[i].months) ||
+			(result.status != records[i].status);
+	}
+	free(data);
+	return mismatches;
+}
+
+int main(int argc, char* argv[])
+{
+	size_t count = (argc > 1) ? (size_t)atol(argv[1]) : BENCH_RECORDS;
+	const int workerCounts[] = { 1, 3, 0 };
+	LoanRecord* records = (LoanRecord*)malloc(sizeof(LoanRecord) * count);
+	PipelineStats stats;
+	FILE* in = NULL;
+	FILE* out = NULL;
+	char* expected = NULL;
+	char* output = NULL;
+	size_t expectedSize = 0;
+	size_t outputSize = 0;
+	size_t parsed = 0;
+	long long mismatches = checkRing();
+	double batchTime = 0;
+	double pipelineTime = 0;
+	double slowest = 0;
+	double total = 0;
+
+	if (records == NULL)
+		return EXIT_FAILURE;
+	makeInput(INPUT_FILE, count);
+	in = fopen(INPUT_FILE, "r");
+	while ((in != NULL) && (parsed < count) &&
+		NextLoanRecord(in, &records[parsed]))
+		PriceLoanRecord(&records[parsed++]);
+	if (in != NULL)
+		fclose(in);
+	mismatches += (parsed != count);
+
+	in = fopen(INPUT_FILE, "r");
+	out = fopen(BATCH_FILE, "wb");
+	if ((in == NULL) || (out == NULL))
+		return EXIT_FAILURE;
+	batchTime = GetWallSeconds();
+	mismatches += (RunBatch(in, out, 0) != (long long)count);
+	batchTime = GetWallSeconds() - batchTime;
+	fclose(in);
+	fclose(out);
+	expected = readFile(BATCH_FILE, &expectedSize);
+
+	for (size_t w = 0; w < sizeof(workerCounts) / sizeof(int); w++)
+	{
+		mismatches += (runFile(workerCounts[w], PIPELINE_TEXT, &stats) !=
+			(long long)count);
+		output = readFile(OUTPUT_FILE, &outputSize);
+		mismatches += (expected == NULL) || (output == NULL) ||
+			(outputSize != expectedSize) ||
+			(memcmp(output, expected, expectedSize) != 0);
+		free(output);
+		if ((w == 0) || (stats.seconds < pipelineTime))
+			pipelineTime = stats.seconds;
+	}
+	mismatches += (runFile(3, PIPELINE_BINARY, NULL) != (long long)count);
+	mismatches += checkBinary(records, count);
+
+	runFile(0, PIPELINE_TEXT, &stats);
+	for (int s = 0; s < PIPELINE_STAGES; s++)
+	{
+		double each = stats.busySeconds[s] /
+			(((s == STAGE_PRICE) && (stats.workers > 0)) ? stats.workers : 1);
+
+		total += stats.busySeconds[s];
+		slowest = (each > slowest) ? each : slowest;
+	}
+
+	printf("%zu records, %d CPUs\n", count, GetCpuCount());
+	printf("%-36s %10s\n", "", "ms");
+	printf("%-36s %10.1lf\n", "RunBatch()", batchTime * 1e3);
+	printf("%-36s %10.1lf\n", "RunPipeline(), best", pipelineTime * 1e3);
+	printf("%-36s %10.1lf\n", "Stage busy time added up", total * 1e3);
+	printf("%-36s %10.1lf\n", "Busiest stage, per thread", slowest * 1e3);
+	WritePipelineStats(stdout, &stats);
+	printf("Results unlike RunBatch(): %lld\n", mismatches);
+	free(records);
+	free(expected);
+	remove(INPUT_FILE);
+	remove(BATCH_FILE);
+	remove(OUTPUT_FILE);
+	return (mismatches == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
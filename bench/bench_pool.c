@@ -0,0 +1,191 @@
+//----------------------------------------------------------------------------
+// File:			bench_pool.c
+//
+// Description      Benchmark of the work-stealing task pool. Runs a book of
+//					schedule and rate tasks, sorted by term so that the last
+//					worker's share holds the longest loans, on several
+//					worker counts and checks every answer against the same
+//					tasks run in order on this thread, and that the workers
+//					ran each task once. Then times each worker's starting
+//					share on its own, which is how long a static split would
+//					take, against the pool, and prints the pool's per-worker
+//					utilization.
+//
+//					bench_pool [tasks] [threads]  (default BOOK_TASKS,
+//												   POOL_THREADS)
+//
+//					cc -O2 bench/bench_pool.c amort*.c -lm -lpthread
+//
+// Functions:	    int main(int argc, char* argv[])
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include "../amort.h"
+#include "../amort_arena.h"
+#include "../amort_platform.h"
+#include "../amort_pool.h"
+#include "../amort_schedule.h"
+#define BENCH_SEED 2021
+#include "bench_util.h"
+
+#define BOOK_TASKS 20000
+#define POOL_THREADS 4
+#define RATE_EVERY 4                // Every 4th task solves for the rate
+
+static int shorterTermFirst(const void* a, const void* b)
+{
+	const PoolTask* first = (const PoolTask*)a;
+	const PoolTask* second = (const PoolTask*)b;
+
+	return (first->loan.months > second->loan.months) -
+		(first->loan.months < second->loan.months);
+}
+
+// Mostly 15 and 30 year loans, the rest any term up to 500 years, in order
+// of term.
+static void makeBook(PoolTask* tasks, const size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		PortfolioLoan* loan = &tasks[i].loan;
+		unsigned int kind = nextRandom() % 4;
+
+		memset(&tasks[i], 0, sizeof(PoolTask));
+		loan->months = (kind == 0) ? 180 : (kind == 1) ? 360 :
+			1 + (int)(nextRandom() % FIVE_HUNDRED_YEARS);
+		loan->loanSize = (double)(nextRandom() % 100000000) / HUNDRED + 1;
+		loan->interestRate = (double)(nextRandom() %
+			((loan->months > 1200) ? 40 : 160)) / 8;
+		loan->paymentSize = getPaymentAmount(loan->months, loan->loanSize,
+			loan->interestRate);
+		tasks[i].kind = (i % RATE_EVERY == 0) ? POOL_SOLVE_RATE :
+			POOL_SCHEDULE;
+	}
+	qsort(tasks, count, sizeof(PoolTask), shorterTermFirst);
+}
+
+// Runs tasks first .. last - 1 in order with the library calls the pool
+// makes. Returns the rows built.
+static long long runInOrder(PoolTask* tasks, const size_t first,
+	const size_t last, ScheduleArena* arena)
+{
+	long long rows = 0;
+
+	for (size_t i = first; i < last; i++)
+	{
+		PoolTask* task = &tasks[i];
+		Schedule schedule;
+
+		if (task->kind == POOL_SOLVE_RATE)
+		{
+			task->rate = findInterestRate(task->loan.months,
+				task->loan.loanSize, task->loan.paymentSize, &task->steps);
+			task->solved = (task->rate != NO_RATE);
+			continue;
+		}
+		ResetArena(arena);
+		task->solved = (char)BuildSchedule(&schedule, arena,
+			task->loan.loanSize, task->loan.paymentSize,
+			task->loan.interestRate, task->loan.months);
+		task->steps = schedule.months;
+		task->totalPaid = schedule.totalPaid;
+		task->totalInterest = schedule.totalInterest;
+		rows += schedule.months;
+	}
+	return rows;
+}
+
+// Counts tasks whose answer differs from the one run in order.
+static long long countDifferences(const PoolTask* tasks,
+	const PoolTask* expected, const size_t count)
+{
+	long long differences = 0;
+
+	for (size_t i = 0; i < count; i++)
+		differences += (tasks[i].solved != expected[i].solved) ||
+			(tasks[i].steps != expected[i].steps) ||
+			(tasks[i].rate != expected[i].rate) ||
+			(tasks[i].totalPaid != expected[i].totalPaid) ||
+			(tasks[i].totalInterest != expected[i].totalInterest);
+	return differences;
+}
+
+int main(int argc, char* argv[])
+{
+	size_t count = (argc > 1) ? (size_t)atol(argv[1]) : BOOK_TASKS;
+	int threads = (argc > 2) ? atoi(argv[2]) : POOL_THREADS;
+	const int checkThreads[] = { 1, 3, 8 };
+	PoolTask* inputs = (PoolTask*)malloc(sizeof(PoolTask) * count);
+	PoolTask* expected = (PoolTask*)malloc(sizeof(PoolTask) * count);
+	PoolTask* tasks = (PoolTask*)malloc(sizeof(PoolTask) * count);
+	PoolWorkerStats stats[POOL_MAX_THREADS];
+	ScheduleArena arena;
+	long long mismatches = 0;
+	long long rows = 0;
+	double serialTime = 0;
+	double longestShare = 0;
+	double poolTime = 0;
+	int workers = 0;
+
+	if ((threads < 1) || (threads > POOL_MAX_THREADS))
+		threads = POOL_THREADS;
+	if ((inputs == NULL) || (expected == NULL) || (tasks == NULL) ||
+		!InitArena(&arena, SCHEDULE_ARENA))
+		return EXIT_FAILURE;
+	makeBook(inputs, count);
+	memcpy(expected, inputs, sizeof(PoolTask) * count);
+	rows = runInOrder(expected, 0, count, &arena);
+
+	for (size_t c = 0; c < sizeof(checkThreads) / sizeof(int); c++)
+	{
+		long long ran = 0;
+		long long built = 0;
+
+		memcpy(tasks, inputs, sizeof(PoolTask) * count);
+		workers = RunTaskPool(tasks, count, checkThreads[c], stats);
+		for (int t = 0; t < workers; t++)
+		{
+			ran += stats[t].tasks;
+			built += stats[t].rows;
+		}
+		if ((workers != checkThreads[c]) || (ran != (long long)count) ||
+			(built != rows))
+			mismatches++;
+		mismatches += countDifferences(tasks, expected, count);
+	}
+
+	for (int t = 0; t < threads; t++)     // The pool's starting shares
+	{
+		double start = GetWallSeconds();
+		double elapsed = 0;
+
+		memcpy(tasks, inputs, sizeof(PoolTask) * count);
+		runInOrder(tasks, count * (size_t)t / (size_t)threads,
+			count * (size_t)(t + 1) / (size_t)threads, &arena);
+		elapsed = GetWallSeconds() - start;
+		serialTime += elapsed;
+		longestShare = (elapsed > longestShare) ? elapsed : longestShare;
+	}
+	memcpy(tasks, inputs, sizeof(PoolTask) * count);
+	poolTime = GetWallSeconds();
+	workers = RunTaskPool(tasks, count, threads, stats);
+	poolTime = GetWallSeconds() - poolTime;
+	mismatches += countDifferences(tasks, expected, count);
+
+	printf("%zu tasks (1 in %d a rate search), %lld rows, %d workers, "
+		"%d CPUs\n", count, RATE_EVERY, rows, threads, GetCpuCount());
+	printf("%-36s %10s\n", "", "ms");
+	printf("%-36s %10.2lf\n", "All tasks on one thread", serialTime * 1e3);
+	printf("%-36s %10.2lf\n", "Static split, longest share",
+		longestShare * 1e3);
+	printf("%-36s %10.2lf\n", "Static split, shares balanced",
+		serialTime * 1e3 / threads);
+	printf("%-36s %10.2lf\n", "Work-stealing pool", poolTime * 1e3);
+	WritePoolStats(stdout, stats, workers);
+	printf("Answers unlike the tasks run in order: %lld\n", mismatches);
+	free(inputs);
+	free(expected);
+	free(tasks);
+	FreeArena(&arena);
+	return (mismatches == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,154 @@
+//----------------------------------------------------------------------------
+// File:			bench_portfolio.c
+//
+// Description      Benchmark of the portfolio cash-flow engine. Checks
+//					AggregatePortfolio() against the rows and counts of
+//					BuildSchedule() tables for a small book, checks that
+//					every thread count gives the same totals, and reports
+//					loans per second and the speedup over one thread for a
+//					book of random loans of 1 to 6000 months.
+//
+//					bench_portfolio [loans]      (default BOOK_LOANS)
+//
+//					cc -O2 bench/bench_portfolio.c amort*.c -lm -lpthread
+//
+// Functions:	    int main(int argc, char* argv[])
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include "../amort.h"
+#include "../amort_platform.h"
+#include "../amort_portfolio.h"
+#include "bench_util.h"
+
+#define BOOK_LOANS 20000
+#define CHECK_LOANS 2000
+#define CHECK_THREADS 3
+
+// Mostly 15 and 30 year loans, the rest any term up to 500 years. Terms
+// over 100 years get rates up to 5%: at higher rates the cent rounding of
+// the table grows with (1 + rate)^months past what Cents can hold.
+static void makeBook(PortfolioLoan* loans, const size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		unsigned int kind = nextRandom() % 4;
+
+		loans[i].months = (kind == 0) ? 180 : (kind == 1) ? 360 :
+			1 + (int)(nextRandom() % FIVE_HUNDRED_YEARS);
+		loans[i].loanSize = (double)(nextRandom() % 100000000) / HUNDRED + 1;
+		loans[i].interestRate = (double)(nextRandom() %
+			((loans[i].months > 1200) ? 40 : 160)) / 8;
+		loans[i].paymentSize = getPaymentAmount(loans[i].months,
+			loans[i].loanSize, loans[i].interestRate);
+	}
+}
+
+// Month totals and counts of the book added up from full BuildSchedule()
+// tables. Returns the months that differ, plus one if the counts do.
+static int checkAgainstTables(const PortfolioLoan* loans,
+	const PortfolioTotals* totals)
+{
+	static PortfolioTotals expected;
+	ScheduleArena arena;
+	Schedule schedule;
+	int mismatches = 0;
+
+	if (!InitArena(&arena, SCHEDULE_ARENA))
+		return 1;
+	memset(&expected, 0, sizeof(expected));
+	for (int i = 0; i < CHECK_LOANS; i++)
+	{
+		ResetArena(&arena);
+		BuildSchedule(&schedule, &arena, loans[i].loanSize,
+			loans[i].paymentSize, loans[i].interestRate, loans[i].months);
+		for (int m = 0; m < loans[i].months; m++)
+		{
+			expected.payment[m] += ToCents(schedule.rows[m].payment);
+			expected.principal[m] += ToCents(schedule.rows[m].principal);
+			expected.interest[m] += ToCents(schedule.rows[m].interest);
+			expected.balance[m] += ToCents(schedule.rows[m].balance);
+		}
+		if (loans[i].months > expected.months)
+			expected.months = loans[i].months;
+		expected.loans++;
+	}
+	mismatches += (expected.months != totals->months) ||
+		(expected.loans != totals->loans) || (totals->skipped != 0);
+	for (int m = 0; m < PORTFOLIO_MONTHS; m++)
+		if ((expected.payment[m] != totals->payment[m]) ||
+			(expected.principal[m] != totals->principal[m]) ||
+			(expected.interest[m] != totals->interest[m]) ||
+			(expected.balance[m] != totals->balance[m]))
+			mismatches++;
+	FreeArena(&arena);
+	return mismatches;
+}
+
+static int sameTotals(const PortfolioTotals* a, const PortfolioTotals* b)
+{
+	return (a->months == b->months) && (a->loans == b->loans) &&
+		(memcmp(a->payment, b->payment, sizeof(a->payment)) == 0) &&
+		(memcmp(a->principal, b->principal, sizeof(a->principal)) == 0) &&
+		(memcmp(a->interest, b->interest, sizeof(a->interest)) == 0) &&
+		(memcmp(a->balance, b->balance, sizeof(a->balance)) == 0);
+}
+
+int main(int argc, char* argv[])
+{
+	static PortfolioTotals totals;
+	static PortfolioTotals single;
+	size_t count = (argc > 1) ? (size_t)atoll(argv[1]) : BOOK_LOANS;
+	PortfolioLoan* loans = NULL;
+	long long rows = 0;
+	double singleTime = 0;
+	int failures = 0;
+	int cpus = GetCpuCount();
+
+	if (count < CHECK_LOANS)
+		count = CHECK_LOANS;
+	loans = (PortfolioLoan*)malloc(count * sizeof(PortfolioLoan));
+	if (loans == NULL)
+		return EXIT_FAILURE;
+	makeBook(loans, count);
+	for (size_t i = 0; i < count; i++)
+		rows += loans[i].months;
+
+	if (!AggregatePortfolio(&totals, loans, CHECK_LOANS, CHECK_THREADS))
+		return EXIT_FAILURE;
+	failures += checkAgainstTables(loans, &totals);
+	printf("Months differing from BuildSchedule() tables: %d\n", failures);
+
+	printf("%8s %12s %10s %14s %14s %8s %s\n", "threads", "loans",
+		"seconds", "loans/s", "rows/s", "speedup", "same");
+	for (int threads = 1; (threads <= cpus) || (threads <= 2); threads *= 2)
+	{
+		double start = GetWallSeconds();
+		double elapsed = 0;
+		int same = 1;
+
+		if (!AggregatePortfolio((threads == 1) ? &single : &totals, loans,
+			count, threads))
+			return EXIT_FAILURE;
+		elapsed = GetWallSeconds() - start;
+		if (threads == 1)
+			singleTime = elapsed;
+		else
+			same = sameTotals(&single, &totals);
+		failures += !same;
+		printf("%8d %12zu %10.3lf %14.0lf %14.0lf %7.2lfx %s\n", threads,
+			count, elapsed, count / elapsed, rows / elapsed,
+			singleTime / elapsed, same ? "yes" : "NO");
+	}
+
+	printf("Month 1: paid %.2lf, interest %.2lf, balance %.2lf\n",
+		single.payment[0] / (double)HUNDRED,
+		single.interest[0] / (double)HUNDRED,
+		single.balance[0] / (double)HUNDRED);
+	printf("Month 360: paid %.2lf, interest %.2lf, balance %.2lf\n",
+		single.payment[359] / (double)HUNDRED,
+		single.interest[359] / (double)HUNDRED,
+		single.balance[359] / (double)HUNDRED);
+	free(loans);
+	return (failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,207 @@
+//----------------------------------------------------------------------------
+// File:			bench_prepay.c
+//
+// Description      Benchmark of the prepayment engine. Checks that with no
+//					events FillPrepaymentRows() gives the rows of
+//					FillScheduleRows() exactly, up to the month a table
+//					paid off early goes below zero, then runs random loans of up
+//					to 6000 months with lump sums, recurring extras and new
+//					payments through both SimulatePrepayment() and
+//					FillPrepaymentRows(). The closed form may be a month
+//					off the table only when the table's last payment is
+//					under a dollar, and its interest may be off by the
+//					cent rounding the table does each month. Loans whose
+//					first payment retires under a dollar of principal are
+//					not compared: there the cent rounding decides the
+//					payoff. Reports the time of each.
+//
+//					cc -O2 bench/bench_prepay.c amort*.c -lm -lpthread
+//
+// Functions:	    int main(void)
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include "../amort.h"
+#include "../amort_platform.h"
+#include "../amort_prepay.h"
+#include "bench_util.h"
+
+#define PLAIN_LOANS 500
+#define SCENARIOS 2000
+#define MAX_EVENTS 6
+#define MIN_HEADROOM 1.0            // First month's principal to compare
+
+typedef struct
+{
+	double loanSize;
+	double paymentSize;
+	double interestRate;
+	int months;
+	int count;
+	PrepayEvent events[MAX_EVENTS];
+} Scenario;
+
+// A random loan with its payment; one in eight runs 6000 months, at no
+// more than 1 percent.
+static void randomLoan(Scenario* s)
+{
+	s->months = (nextRandom() % 8 == 0) ? FIVE_HUNDRED_YEARS :
+		12 * (1 + nextRandom() % 40);
+	s->interestRate = (nextRandom() % ((s->months == FIVE_HUNDRED_YEARS) ?
+		9 : 121)) / 8.0;
+	s->loanSize = 1000 + (nextRandom() % 100000000) / 100.0;
+	s->paymentSize = getPaymentAmount(s->months, s->loanSize,
+		s->interestRate);
+	s->count = 0;
+}
+
+// Adds random events sized against the loan's payment.
+static void randomEvents(Scenario* s)
+{
+	s->count = 1 + nextRandom() % MAX_EVENTS;
+	for (int i = 0; i < s->count; i++)
+	{
+		PrepayEvent* e = &s->events[i];
+
+		e->kind = nextRandom() % 3;
+		e->month = 1 + nextRandom() % s->months;
+		e->lastMonth = (nextRandom() % 2) ? 0 :
+			e->month + nextRandom() % s->months;
+		e->every = (nextRandom() % 2) ? 1 : 1 + nextRandom() % 12;
+		e->amount = (e->kind == PREPAY_LUMP_SUM) ?
+			(nextRandom() % 2000000) / 100.0 :
+			s->paymentSize * (nextRandom() % 150) / 100.0;
+		if (e->kind == PREPAY_NEW_PAYMENT)
+			e->amount = s->paymentSize * (100 + nextRandom() % 150) / 100.0;
+	}
+}
+
+// Returns 1 if the closed form agrees with the table.
+static int agrees(const Scenario* s, const PrepayResult* result,
+	const ScheduleRow* rows, const int count)
+{
+	const double lastPayment = rows[count - 1].payment;
+	const double interest = rows[count - 1].interestToDate;
+	const double allowed = ROUNDING_PER_MONTH * count + 0.01;
+
+	if ((result->payoffMonth != count) && ((lastPayment >= ONE) ||
+		(abs(result->payoffMonth - count) > 1)))
+		return 0;
+	if (fabs(result->totalInterest - interest) > allowed + lastPayment)
+		return 0;
+	return (s->count > 0) || (result->interestSaved == 0);
+}
+
+int main(void)
+{
+	static Scenario scenarios[SCENARIOS];
+	ScheduleRow* rows = malloc(sizeof(ScheduleRow) * FIVE_HUNDRED_YEARS);
+	ScheduleRow* plain = malloc(sizeof(ScheduleRow) * FIVE_HUNDRED_YEARS);
+	PrepayResult result;
+	long long mismatches = 0;
+	long long disagreements = 0;
+	long long segments = 0;
+	long long skipped = 0;
+	long long tableMonths = 0;
+	int monthOff = 0;
+	double worstInterest = 0;
+	double saved = 0;
+	double closedTime = 0;
+	double tableTime = 0;
+	double start = 0;
+
+	if ((rows == NULL) || (plain == NULL))
+		return EXIT_FAILURE;
+
+	for (int i = 0; i < PLAIN_LOANS; i++)
+	{
+		Scenario s;
+		int count = 0;
+		int end = 0;
+		int same = 0;
+
+		randomLoan(&s);
+		count = FillPrepaymentRows(rows, s.loanSize, s.paymentSize,
+			s.interestRate, s.months, NULL, 0);
+		FillScheduleRows(plain, s.loanSize, s.paymentSize, s.interestRate,
+			s.months, 1, s.months);
+		while ((end < s.months - 1) && (plain[end].balance >= 0))
+			end++;
+		same = (end < s.months - 1) ? end : count;    // Paid off early, the
+		if ((count != end + 1) ||                     // table stops there
+			memcmp(rows, plain, sizeof(ScheduleRow) * same))
+			mismatches++;
+	}
+
+	for (int i = 0; i < SCENARIOS; i++)
+	{
+		randomLoan(&scenarios[i]);
+		randomEvents(&scenarios[i]);
+	}
+	for (int i = 0; i < SCENARIOS; i++)
+	{
+		const Scenario* s = &scenarios[i];
+		int count = FillPrepaymentRows(rows, s->loanSize, s->paymentSize,
+			s->interestRate, s->months, s->events, s->count);
+
+		if ((count < 1) || !SimulatePrepayment(&result, s->loanSize,
+			s->paymentSize, s->interestRate, s->months, s->events, s->count))
+		{
+			mismatches++;
+			continue;
+		}
+		if (s->paymentSize - s->loanSize * roundInterest(s->interestRate, 8) /
+			MONTHLY_DIVISOR < MIN_HEADROOM)
+		{
+			skipped++;                  // The cent rounding decides these
+			continue;
+		}
+		if (!agrees(s, &result, rows, count))
+			disagreements++;
+		if (result.payoffMonth != count)
+			monthOff++;
+		worstInterest = fmax(worstInterest,
+			fabs(result.totalInterest - rows[count - 1].interestToDate));
+		saved += result.interestSaved;
+	}
+
+	start = GetWallSeconds();
+	for (int i = 0; i < SCENARIOS; i++)
+	{
+		const Scenario* s = &scenarios[i];
+
+		SimulatePrepayment(&result, s->loanSize, s->paymentSize,
+			s->interestRate, s->months, s->events, s->count);
+		segments += result.segments;
+	}
+	closedTime = GetWallSeconds() - start;
+	start = GetWallSeconds();
+	for (int i = 0; i < SCENARIOS; i++)
+	{
+		const Scenario* s = &scenarios[i];
+
+		tableMonths += FillPrepaymentRows(rows, s->loanSize, s->paymentSize,
+			s->interestRate, s->months, s->events, s->count);
+	}
+	tableTime = GetWallSeconds() - start;
+
+	printf("%d scenarios, %lld table months, %lld closed form jumps\n",
+		SCENARIOS, tableMonths, segments);
+	printf("%-24s %10s %14s %8s\n", "", "ms", "us/scenario", "speedup");
+	printf("%-24s %10.2lf %14.2lf %7.2lfx\n", "FillPrepaymentRows()",
+		tableTime * 1e3, tableTime * 1e6 / SCENARIOS, 1.0);
+	printf("%-24s %10.2lf %14.2lf %7.2lfx\n", "SimulatePrepayment()",
+		closedTime * 1e3, closedTime * 1e6 / SCENARIOS,
+		tableTime / closedTime);
+	printf("Interest saved: %.2lf in all\n", saved);
+	printf("Payoff a month from the table: %d\n", monthOff);
+	printf("Largest interest difference: %.2lf\n", worstInterest);
+	printf("Plain tables unlike FillScheduleRows(): %lld\n", mismatches);
+	printf("Scenarios not compared (under %.2lf of principal): %lld\n",
+		MIN_HEADROOM, skipped);
+	printf("Scenarios outside the allowance: %lld\n", disagreements);
+	free(rows);
+	free(plain);
+	return ((mismatches == 0) && (disagreements == 0)) ? EXIT_SUCCESS :
+		EXIT_FAILURE;
+}
@@ -0,0 +1,150 @@
+//----------------------------------------------------------------------------
+// File:			bench_query.c
+//
+// Description      Benchmark of the random-access schedule queries. For
+//					random loans of 1 to 6000 months it checks
+//					ScheduleBalanceAt() and ScheduleInterestBetween() against
+//					the rows of BuildSchedule() (they must agree exactly
+//					while the sums fit a double to the cent), reports how
+//					far the closed form estimates EstimateBalanceAt(),
+//					EstimateInterestBetween() and EstimateScheduleWindow()
+//					drift from the cent-rounded table by loan term, and
+//					times a query against building the whole table.
+//
+//					cc -O2 bench/bench_query.c amort*.c -lm -lpthread
+//
+// Functions:	    int main(void)
+//----------------------------------------------------------------------------
+
+#include "../amort.h"
+#include "../amort_platform.h"
+#include "../amort_query.h"
+#include "bench_util.h"
+
+#define LOAN_COUNT 3000
+#define WINDOW 12
+#define TERM_GROUPS 3
+#define MAX_EXACT 1e13              // Sums a double still holds to the cent
+
+typedef struct
+{
+	double loanSize;
+	double paymentSize;
+	double interestRate;
+	int months;
+} BenchLoan;
+
+static const int TERM_LIMITS[TERM_GROUPS] = { 360, 1200, FIVE_HUNDRED_YEARS };
+
+static void keepLargest(double* largest, const double value)
+{
+	if (fabs(value) > *largest)
+		*largest = fabs(value);
+}
+
+int main(void)
+{
+	static BenchLoan loans[LOAN_COUNT];
+	ScheduleRow window[WINDOW];
+	ScheduleArena arena;
+	Schedule schedule;
+	double balanceError[TERM_GROUPS] = { 0 };
+	double interestError[TERM_GROUPS] = { 0 };
+	double windowError[TERM_GROUPS] = { 0 };
+	long long exactMismatches = 0;
+	long long windowMismatches = 0;
+	double buildTime = 0;
+	double queryTime = 0;
+	double start = 0;
+	volatile double sink = 0;
+	long long queries = 0;
+
+	if (!InitArena(&arena, SCHEDULE_ARENA))
+		return EXIT_FAILURE;
+	for (int i = 0; i < LOAN_COUNT; i++)
+	{
+		loans[i].months = 1 + (int)(nextRandom() % TERM_LIMITS[i % 3]);
+		loans[i].loanSize = (double)(nextRandom() % 100000000) / HUNDRED + 1;
+		loans[i].interestRate = (double)(nextRandom() % 160) / 8;
+		loans[i].paymentSize = getPaymentAmount(loans[i].months,
+			loans[i].loanSize, loans[i].interestRate);
+	}
+
+	for (int i = 0; i < LOAN_COUNT; i++)
+	{
+		const BenchLoan* loan = &loans[i];
+		double interest = 0;
+		int group = 0;
+		int first = 0;
+		int last = 0;
+		int count = 0;
+
+		while (loan->months > TERM_LIMITS[group])
+			group++;
+		ResetArena(&arena);
+		start = GetWallSeconds();
+		BuildSchedule(&schedule, &arena, loan->loanSize, loan->paymentSize,
+			loan->interestRate, loan->months);
+		buildTime += GetWallSeconds() - start;
+
+		for (int k = 1; k <= loan->months; k++)
+		{
+			if (ScheduleBalanceAt(&schedule, k) != schedule.rows[k - 1].balance)
+				exactMismatches++;
+			keepLargest(&balanceError[group], EstimateBalanceAt(loan->loanSize,
+				loan->paymentSize, loan->interestRate, loan->months, k) -
+				schedule.rows[k - 1].balance);
+		}
+
+		first = 1 + (int)(nextRandom() % loan->months);
+		last = first + (int)(nextRandom() % (loan->months - first + 1));
+		for (int k = first; k <= last; k++)
+			interest += schedule.rows[k - 1].interest;
+		interest = floor(interest * HUNDRED + HALF) / HUNDRED;
+		if ((fabs(schedule.totalInterest) < MAX_EXACT) &&
+			(ScheduleInterestBetween(&schedule, first, last) != interest))
+			exactMismatches++;
+		keepLargest(&interestError[group], interest - EstimateInterestBetween(
+			loan->loanSize, loan->paymentSize, loan->interestRate,
+			loan->months, first, last));
+
+		count = EstimateScheduleWindow(window, loan->loanSize,
+			loan->paymentSize, loan->interestRate, loan->months, first,
+			WINDOW);
+		for (int k = 0; k < count; k++)
+			keepLargest(&windowError[group], window[k].balance -
+				schedule.rows[first + k - 1].balance);
+		count = EstimateScheduleWindow(window, loan->loanSize,
+			loan->paymentSize, loan->interestRate, loan->months, 1, WINDOW);
+		for (int k = 0; k < count; k++)
+			if ((window[k].balance != schedule.rows[k].balance) ||
+				(window[k].payment != schedule.rows[k].payment) ||
+				(window[k].interestToDate != schedule.rows[k].interestToDate))
+				windowMismatches++;
+
+		start = GetWallSeconds();
+		for (int k = 1; k <= loan->months; k += 37)
+		{
+			sink += EstimateBalanceAt(loan->loanSize, loan->paymentSize,
+				loan->interestRate, loan->months, k);
+			queries++;
+		}
+		queryTime += GetWallSeconds() - start;
+	}
+
+	printf("Closed form against the table, largest difference in dollars\n");
+	printf("%12s %14s %14s %14s\n", "term up to", "balance",
+		"interest", "window");
+	for (int g = 0; g < TERM_GROUPS; g++)
+		printf("%12d %14.4lg %14.4lg %14.4lg\n", TERM_LIMITS[g],
+			balanceError[g], interestError[g], windowError[g]);
+	printf("Schedule*() queries not exact      : %lld\n", exactMismatches);
+	printf("Month 1 window rows not bit for bit: %lld\n", windowMismatches);
+	printf("BuildSchedule() per loan           : %.3lf us\n",
+		buildTime / LOAN_COUNT * 1e6);
+	printf("EstimateBalanceAt() per query      : %.3lf us\n",
+		queryTime / queries * 1e6);
+	FreeArena(&arena);
+	return ((exactMismatches == 0) && (windowMismatches == 0) && (sink != 0))
+		? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,131 @@
+//----------------------------------------------------------------------------
+// File:			bench_rate.c
+//
+// Description      Benchmark of the interest rate search. Compares the 
+//					scanning loop of version 1.0 (kept here, without its 
+//					"Scan number" output) with solveInterestRate(): number of
+//					formula evaluations and time per call.
+//
+//					cc -O2 bench/bench_rate.c amort*.c -lm -lpthread
+//
+// Functions:	    int main(void)
+//----------------------------------------------------------------------------
+
+#include <limits.h>
+#include "../amort.h"
+#include "../amort_platform.h"
+
+#define MIN_SECONDS .2
+
+typedef struct
+{
+	int months;
+	double principal;
+	double payment;
+} RateCase;
+
+static const RateCase CASES[] =
+{
+	{ 12, 1000, 88 },
+	{ 60, 10000, 188.71 },
+	{ 360, 250000, 1580.18 },
+	{ 360, 2500000, 15801.80 },
+	{ 600, 100000, 700 },
+	{ 1200, 100000, 600 },
+	{ 360, 5000000000.0, 40000000 },
+};
+
+// getInterestRate() from version 1.0. *evaluations counts pow() calls.
+static double legacyInterestRate(const int months, const double principal, 
+	const double payment, long long* evaluations)
+{
+	double interestRate = 0;
+	long double testNumber = 0;
+	double range = .01; 
+	long long depth = 100;
+	const double MAX_PAYMENT = 1.01;
+	double rangeInterval = 0;
+	const int DEPTH_INTERVAL = 10;
+
+	*evaluations = 0;
+	rangeInterval = (principal > BILLION) ? HUNDRED :
+		(principal > MILLION) ? 10 : .001;
+	while (interestRate == 0)
+	{
+		for (long long j = 1; j <= LONG_MAX; j++)
+		{
+			long double monthlyInterest = 0;
+			long double interestExp = 0;
+
+			monthlyInterest = (long double)j / depth;
+			interestExp = (long double)pow(monthlyInterest + ONE, months);
+			(*evaluations)++;
+			testNumber = (long double)(interestExp / (interestExp - ONE)) 
+				* principal * monthlyInterest;
+			if ((testNumber <= (payment + range)) && 
+				(testNumber >= (payment - range)))
+			{   
+				interestRate = monthlyInterest * MONTHLY_DIVISOR;
+				break;
+			}
+			if (testNumber > (payment * MAX_PAYMENT)) 
+				break;
+		}
+		range += rangeInterval;
+		depth *= DEPTH_INTERVAL;
+	} 
+	return interestRate;
+}
+
+int main(void)
+{
+	const int CASE_COUNT = sizeof(CASES) / sizeof(CASES[0]);
+	volatile double sink = 0;
+
+	printf("%6s %14s %14s | %10s %12s %10s | %10s %5s %10s | %8s\n",
+		"months", "principal", "payment", "old rate", "evaluations", 
+		"old us", "new rate", "iter", "new us", "speedup");
+	for (int c = 0; c < CASE_COUNT; c++)
+	{
+		const RateCase* rc = &CASES[c];
+		long long evaluations = 0;
+		int iterations = 0;
+		long long calls = 0;
+		double oldRate = 0;
+		double newRate = 0;
+		double oldTime = 0;
+		double newTime = 0;
+		double start = 0;
+
+		start = GetWallSeconds();
+		do
+		{
+			oldRate = legacyInterestRate(rc->months, rc->principal,
+				rc->payment, &evaluations);
+			sink += oldRate;
+			calls++;
+		} while (GetWallSeconds() - start < MIN_SECONDS);
+		oldTime = (GetWallSeconds() - start) / calls;
+
+		calls = 0;
+		start = GetWallSeconds();
+		do
+		{
+			for (int i = 0; i < 1000; i++)
+			{
+				newRate = findInterestRate(rc->months, rc->principal,
+					rc->payment, &iterations);
+				sink += newRate;
+			}
+			calls += 1000;
+		} while (GetWallSeconds() - start < MIN_SECONDS);
+		newTime = (GetWallSeconds() - start) / calls;
+
+		printf("%6d %14.2lf %14.2lf | %10.5lf %12lld %10.2lf | "
+			"%10.5lf %5d %10.3lf | %7.0lfx\n",
+			rc->months, rc->principal, rc->payment, oldRate, evaluations,
+			oldTime * 1e6, newRate, iterations, newTime * 1e6, 
+			oldTime / newTime);
+	}
+	return (sink == 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,328 @@
+//----------------------------------------------------------------------------
+// File:			bench_records.c
+//
+// Description      Benchmark of the mapped loan-record reader. First reads
+//					a file of awkward lines (CRLF ends, blanks, comments,
+//					exponents, hex, inf, bad fields, lines longer than
+//					BATCH_LINE_MAX, no newline at the end) with
+//					NextMappedRecord() and with NextLoanRecord() and checks
+//					that every record is the same and that bad records are
+//					found on the right lines. Then checks that random
+//					decimal amounts parse to the cent strtod() gives, and
+//					times reading a large file of random records three
+//					ways: fgets() and strtod() alone, NextLoanRecord(), and
+//					NextMappedRecord(). RunBatchRecords() must write the
+//					same output as RunBatch().
+//
+//					bench_records [records]    (default BENCH_RECORDS)
+//
+//					cc -O2 bench/bench_records.c amort*.c -lm -lpthread
+//
+// Functions:	    int main(int argc, char* argv[])
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include "../amort.h"
+#include "../amort_batch.h"
+#include "../amort_platform.h"
+#include "../amort_records.h"
+#define BENCH_SEED 2023
+#include "bench_util.h"
+
+#define BENCH_RECORDS 500000
+#define NUMBER_CHECKS 1000000
+#define ODD_FILE "bench_records.odd"
+#define INPUT_FILE "bench_records.in"
+#define BATCH_FILE "bench_records.batch"
+#define OUTPUT_FILE "bench_records.out"
+#define BAD_LINES 13                // Bad records in the odd file
+#define BAD_LINE_SUM 265            // Their line numbers added up
+
+static const char* ODD_LINES[] =
+{
+	"250000,,360,6.5\r\n",
+	"\r\n",
+	"   \t\n",
+	"# a comment,,,\n",
+	"  ,1500,360,6.5\n",
+	"2.5e5,2000,,6.5\r\n",
+	"0x1p10,,12,5\n",                    // Hex, as strtod() reads it
+	"250000,1580.17,360,\n",
+	"250000.005,,360,6.4375\n",
+	"+250000,,+360,+6.5\n",
+	"-250000,,360,6.5\n",               // Bad: negative loan
+	"inf,,360,6.5\n",                   // Bad: not finite
+	"250000,,360.5,6.5\n",              // Bad: part months
+	"250000,abc,,6.5\n",                // Bad: not a number
+	"250000,,360\n",                    // Bad: three fields
+	"250000,,,6.5\n",                   // Bad: two unknowns
+	"250000,,360,6.5,\n",               // Bad: five fields
+	"1e400,,360,6.5\n",                 // Bad: not finite
+	"1e307,,360,6.5\n",                 // Bad: too large for cents
+	"nan,,360,6.5\n",                   // Bad: not finite
+	"0.1,,1,0\n",
+	"12345678901234567890123,,360,6\n", // More digits than the fast path
+	"100\t\t12\t3\n",
+	"1.,,12,.5\n",
+	".,,12,5\n",                        // Bad: a lone point
+	"100,,12,5 x\n",                    // Bad: trailing text
+	"100,,12,5 \n",
+	"100 , , 12 , 5\n",
+	NULL
+};
+
+// Writes ODD_LINES (lines 1 to 28), then two over-long records, which are
+// bad even where their start would parse, an over-long comment and a last
+// record with no newline.
+static void makeOddInput(const char* name)
+{
+	FILE* fp = fopen(name, "wb");
+
+	if (fp == NULL)
+		return;
+	for (int i = 0; ODD_LINES[i] != NULL; i++)
+		fputs(ODD_LINES[i], fp);
+	fputs("1000,,12,5", fp);            // Cut inside the padding
+	for (int i = 0; i < BATCH_LINE_MAX; i++)
+		fputc(' ', fp);
+	fputs("junk\n1000,,12", fp);        // Cut before the rate
+	for (int i = 0; i < BATCH_LINE_MAX; i++)
+		fputc(' ', fp);
+	fputs(",5\n#", fp);
+	for (int i = 0; i < BATCH_LINE_MAX; i++)
+		fputc('#', fp);
+	fputs("\n7000,,84,3.25", fp);
+	fclose(fp);
+}
+
+// Writes random records with the n'th unknown blank; every fiftieth is a
+// bad record and every thousandth line blank.
+static void makeInput(const char* name, const size_t count)
+{
+	FILE* fp = fopen(name, "w");
+
+	for (size_t n = 0; (fp != NULL) && (n < count); n++)
+	{
+		int months = 12 * (1 + nextRandom() % 40);
+		double loanSize = 1000 + (nextRandom() % 50000000) / 100.0;
+		double rate = (nextRandom() % 1201) / 100.0;
+		double payment = ceil(getPaymentAmount(months, loanSize, rate) *
+			HUNDRED) / HUNDRED;
+
+		if (n % 1000 == 999)
+			fputs("\n", fp);
+		if (n % 50 == 49)
+			fprintf(fp, "%.2lf,abc,,%.3lf\n", loanSize, rate);
+		else if (n % 4 == 0)
+			fprintf(fp, "%.2lf,,%d,%.3lf\n", loanSize, months, rate);
+		else if (n % 4 == 1)
+			fprintf(fp, ",%.2lf,%d,%.3lf\n", payment, months, rate);
+		else if (n % 4 == 2)
+			fprintf(fp, "%.2lf,%.2lf,,%.3lf\n", loanSize, payment, rate);
+		else
+			fprintf(fp, "%.2lf,%.2lf,%d,\n", loanSize, payment, months);
+	}
+	if (fp != NULL)
+		fclose(fp);
+}
+
+// Counts records of a file the two readers do not agree on. *bad receives
+// the bad records the mapped reader found and *lines their line numbers
+// added up.
+static long long compareReaders(const char* name, long long* bad,
+	long long* lines)
+{
+	RecordFile file;
+	FILE* in = fopen(name, "rb");
+	LoanRecord streamed;
+	LoanRecord mapped;
+	long long mismatches = 0;
+	int more = 1;
+
+	*bad = 0;
+	*lines = 0;
+	if ((in == NULL) || !OpenRecordFile(&file, name))
+		return 1;
+	while (more)
+	{
+		int gotStream = NextLoanRecord(in, &streamed);
+		int gotMapped = NextMappedRecord(&file, &mapped);
+
+		more = gotStream && gotMapped;
+		mismatches += (gotStream != gotMapped) || (more &&
+			(memcmp(&streamed, &mapped, sizeof(LoanRecord)) != 0));
+		if (more && (mapped.status == BATCH_BAD_RECORD))
+		{
+			(*bad)++;
+			*lines += file.line;
+		}
+	}
+	fclose(in);
+	CloseRecordFile(&file);
+	return mismatches;
+}
+
+// Counts random amounts ParseLoanText() rounds to another cent than
+// strtod() and the ReadLoanSize() rule do.
+static long long checkNumbers(void)
+{
+	long long mismatches = 0;
+
+	for (int i = 0; i < NUMBER_CHECKS; i++)
+	{
+		char line[BATCH_LINE_MAX];
+		char amount[64];
+		LoanRecord record;
+		unsigned long long whole = ((unsigned long long)nextRandom() << 20) %
+			(1ULL << (nextRandom() % 50 + 1));
+		int places = (int)(nextRandom() % 7);
+		unsigned int fraction = nextRandom() % 1000000;
+
+		if (places == 0)
+			snprintf(amount, sizeof(amount), "%llu", whole);
+		else
+			snprintf(amount, sizeof(amount), "%llu.%0*u", whole, places,
+				fraction % (unsigned int)pow(10, places));
+		snprintf(line, sizeof(line), "%s,,360,6.5", amount);
+		mismatches += !ParseLoanRecord(line, &record) ||
+			((record.status == BATCH_OK) && (record.loanSize !=
+			floor(strtod(amount, NULL) * HUNDRED + HALF) / HUNDRED));
+	}
+	return mismatches;
+}
+
+// Reads a file with fgets() and strtod() only, as the lower bound of a
+// stream reader. Returns the sum of the fields so the work is kept.
+static double readBaseline(const char* name)
+{
+	FILE* fp = fopen(name, "r");
+	char line[BATCH_LINE_MAX];
+	double sum = 0;
+
+	while ((fp != NULL) && (fgets(line, sizeof(line), fp) != NULL))
+	{
+		char* cursor = line;
+
+		for (int field = 0; field < 4; field++)
+		{
+			sum += strtod(cursor, &cursor);
+			cursor += (*cursor == ',');
+		}
+	}
+	if (fp != NULL)
+		fclose(fp);
+	return sum;
+}
+
+// Runs a whole file through RunBatch() or RunBatchRecords() into name.
+static long long priceFile(const char* name, const int mapped)
+{
+	RecordFile file;
+	FILE* in = NULL;
+	FILE* out = fopen(name, "wb");
+	long long count = -1;
+
+	if (out == NULL)
+		return -1;
+	if (mapped && OpenRecordFile(&file, INPUT_FILE))
+	{
+		count = RunBatchRecords(&file, out, 0, NULL);
+		CloseRecordFile(&file);
+	}
+	else if (!mapped && ((in = fopen(INPUT_FILE, "r")) != NULL))
+	{
+		count = RunBatch(in, out, 0);
+		fclose(in);
+	}
+	fclose(out);
+	return count;
+}
+
+// Counts the bytes of two files that differ, and any difference in size.
+static long long compareFiles(const char* first, const char* second)
+{
+	FILE* a = fopen(first, "rb");
+	FILE* b = fopen(second, "rb");
+	long long differences = (a == NULL) || (b == NULL);
+	int ca = 0;
+	int cb = 0;
+
+	while (!differences && ((ca != EOF) || (cb != EOF)))
+	{
+		ca = getc(a);
+		cb = getc(b);
+		differences += (ca != cb);
+	}
+	if (a != NULL)
+		fclose(a);
+	if (b != NULL)
+		fclose(b);
+	return differences;
+}
+
+int main(int argc, char* argv[])
+{
+	size_t count = (argc > 1) ? (size_t)atol(argv[1]) : BENCH_RECORDS;
+	RecordFile file;
+	LoanRecord record;
+	FILE* in = NULL;
+	long long bad = 0;
+	long long lines = 0;
+	long long read = 0;
+	long long mismatches = 0;
+	double sum = 0;
+	double baselineTime = 0;
+	double streamTime = 0;
+	double mappedTime = 0;
+
+	makeOddInput(ODD_FILE);
+	mismatches += compareReaders(ODD_FILE, &bad, &lines);
+	mismatches += (bad != BAD_LINES + 1) || (lines != BAD_LINE_SUM);
+	mismatches += OpenRecordFile(&file, "bench_records.none");
+	mismatches += checkNumbers();
+
+	makeInput(INPUT_FILE, count);
+	mismatches += compareReaders(INPUT_FILE, &bad, &lines);
+	baselineTime = GetWallSeconds();
+	sum = readBaseline(INPUT_FILE);
+	baselineTime = GetWallSeconds() - baselineTime;
+
+	streamTime = GetWallSeconds();
+	in = fopen(INPUT_FILE, "r");
+	while ((in != NULL) && NextLoanRecord(in, &record))
+		read++;
+	if (in != NULL)
+		fclose(in);
+	streamTime = GetWallSeconds() - streamTime;
+	mismatches += (read != (long long)count);
+
+	read = 0;
+	mappedTime = GetWallSeconds();
+	if (OpenRecordFile(&file, INPUT_FILE))
+	{
+		while (NextMappedRecord(&file, &record))
+			read++;
+		CloseRecordFile(&file);
+	}
+	mappedTime = GetWallSeconds() - mappedTime;
+	mismatches += (read != (long long)count);
+
+	mismatches += (priceFile(BATCH_FILE, 0) != (long long)count);
+	mismatches += (priceFile(OUTPUT_FILE, 1) != (long long)count);
+	mismatches += compareFiles(BATCH_FILE, OUTPUT_FILE);
+
+	printf("%zu records, %lld bad (checksum %.0lf)\n", count, bad, sum);
+	printf("%-36s %10s %12s\n", "", "ms", "records/s");
+	printf("%-36s %10.1lf %12.0lf\n", "fgets() and strtod() only",
+		baselineTime * 1e3, count / baselineTime);
+	printf("%-36s %10.1lf %12.0lf\n", "NextLoanRecord()",
+		streamTime * 1e3, count / streamTime);
+	printf("%-36s %10.1lf %12.0lf\n", "NextMappedRecord()",
+		mappedTime * 1e3, count / mappedTime);
+	printf("Records unlike NextLoanRecord(): %lld\n", mismatches);
+	remove(ODD_FILE);
+	remove(INPUT_FILE);
+	remove(BATCH_FILE);
+	remove(OUTPUT_FILE);
+	return (mismatches == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
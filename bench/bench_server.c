@@ -0,0 +1,369 @@
+//----------------------------------------------------------------------------
+// File:			bench_server.c
+//
+// Description      Benchmark of the local calculation server. Starts a
+//					server in this process, then has client threads send a
+//					mix of batch records (every unknown, and some bad
+//					lines), first one record per round trip and then
+//					pipelined, and checks every reply against
+//					PriceLoanRecord() and FormatLoanRecord() run here. Rate
+//					replies come from the batch solver, so their rate may
+//					differ in the last printed digit. Also checks a table
+//					request row by row against FillScheduleRows(), the
+//					STATS counters and SHUTDOWN, that stopping the server
+//					removes its socket, and that a server is refused a
+//					path that holds a file which is not a socket.
+//
+//					bench_server [records]      (default BENCH_RECORDS)
+//
+//					cc -O2 bench/bench_server.c amort*.c -lm -lpthread
+//
+// Functions:	    int main(int argc, char* argv[])
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include "../amort.h"
+#include "../amort_schedule.h"
+#include "../amort_server.h"
+#include "../amort_writer.h"
+#include "bench_util.h"
+
+#define BENCH_RECORDS 40000
+#define BENCH_CLIENTS 8
+#define SINGLE_RECORDS 2000         // Sent one per round trip
+#define PIPELINE 64
+#define RATE_SLACK 0.0011           // One printed digit, and rounding
+#ifdef _WIN32
+#define ENDPOINT "tcp:47917"
+#else
+#define ENDPOINT "bench_server.sock"
+#endif
+
+typedef struct
+{
+	char (*lines)[BATCH_LINE_MAX];  // Requests, each ending in '\n'
+	char (*expected)[BATCH_REPLY_MAX];
+	size_t count;
+	int pipeline;
+	long long mismatches;
+	double* samples;                // Round trip of each group, seconds
+	size_t groups;
+} BenchClient;
+
+// Writes one random request line with the n'th unknown blank; every
+// fiftieth is a bad record.
+static void makeRecord(char* text, const size_t n)
+{
+	int months = 12 * (1 + nextRandom() % 40);
+	double loanSize = 1000 + (nextRandom() % 50000000) / 100.0;
+	double rate = (nextRandom() % 1201) / 100.0;
+	double payment = ceil(getPaymentAmount(months, loanSize, rate) *
+		HUNDRED) / HUNDRED;
+
+	if (n % 50 == 49)
+		sprintf(text, "%.2lf,abc,,%.3lf\n", loanSize, rate);
+	else if (n % 4 == 0)
+		sprintf(text, "%.2lf,,%d,%.3lf\n", loanSize, months, rate);
+	else if (n % 4 == 1)
+		sprintf(text, ",%.2lf,%d,%.3lf\n", payment, months, rate);
+	else if (n % 4 == 2)
+		sprintf(text, "%.2lf,%.2lf,,%.3lf\n", loanSize, payment, rate);
+	else
+		sprintf(text, "%.2lf,%.2lf,%d,\n", loanSize,
+			(n % 100 == 3) ? payment / 2 : payment, months);
+}
+
+// Returns 1 if a reply matches the expected one: the same text, or the
+// same fields with the rate within RATE_SLACK.
+static int sameReply(const char* reply, const char* expected)
+{
+	double got[3] = { 0 };
+	double want[3] = { 0 };
+	int gotMonths = 0;
+	int wantMonths = 0;
+	char gotStatus[8] = "";
+	char wantStatus[8] = "";
+
+	if (strcmp(reply, expected) == 0)
+		return 1;
+	return (sscanf(reply, "%lf,%lf,%d,%lf,%7s", &got[0], &got[1],
+		&gotMonths, &got[2], gotStatus) == 5) &&
+		(sscanf(expected, "%lf,%lf,%d,%lf,%7s", &want[0], &want[1],
+		&wantMonths, &want[2], wantStatus) == 5) &&
+		(got[0] == want[0]) && (got[1] == want[1]) &&
+		(gotMonths == wantMonths) && (fabs(got[2] - want[2]) <= RATE_SLACK) &&
+		(strcmp(gotStatus, wantStatus) == 0);
+}
+
+// Sends text and reads replies until lines newlines have come. Returns the
+// number of bytes read into reply, or -1 if the connection failed.
+static long roundTrip(AmortSocket connection, const char* text,
+	const size_t length, char* reply, const size_t size, const int lines)
+{
+	size_t have = 0;
+	int seen = 0;
+
+	if (!WriteSocket(connection, text, length))
+		return -1;
+	while (seen < lines)
+	{
+		long got = ReadSocket(connection, reply + have, size - 1 - have);
+
+		if (got <= 0)
+			return -1;
+		for (long i = 0; i < got; i++)
+			seen += (reply[have + (size_t)i] == '\n');
+		have += (size_t)got;
+	}
+	reply[have] = '\0';
+	return (long)have;
+}
+
+// Client thread: sends its lines pipeline at a time and checks the replies.
+static void runClient(void* arg)
+{
+	BenchClient* client = (BenchClient*)arg;
+	size_t size = (size_t)client->pipeline * BATCH_REPLY_MAX;
+	char* request = (char*)malloc(size);
+	char* reply = (char*)malloc(size);
+	AmortSocket connection = ConnectLocal(ENDPOINT);
+
+	if ((request == NULL) || (reply == NULL) ||
+		(connection == AMORT_NO_SOCKET))
+		client->mismatches += (long long)client->count;
+	for (size_t first = 0; (connection != AMORT_NO_SOCKET) &&
+		(request != NULL) && (reply != NULL) && (first < client->count);
+		first += (size_t)client->pipeline)
+	{
+		size_t lines = client->count - first;
+		size_t length = 0;
+		double start = 0;
+		char* line = reply;
+
+		lines = (lines < (size_t)client->pipeline) ? lines :
+			(size_t)client->pipeline;
+		for (size_t i = 0; i < lines; i++)
+		{
+			strcpy(request + length, client->lines[first + i]);
+			length += strlen(client->lines[first + i]);
+		}
+		start = GetWallSeconds();
+		if (roundTrip(connection, request, length, reply, size,
+			(int)lines) < 0)
+		{
+			client->mismatches += (long long)(client->count - first);
+			break;
+		}
+		client->samples[client->groups++] = GetWallSeconds() - start;
+		for (size_t i = 0; i < lines; i++)
+		{
+			char* next = strchr(line, '\n') + 1;
+			char saved = *next;
+
+			*next = '\0';
+			if (!sameReply(line, client->expected[first + i]))
+				client->mismatches++;
+			*next = saved;
+			line = next;
+		}
+	}
+	if (connection != AMORT_NO_SOCKET)
+		CloseSocket(connection);
+	free(request);
+	free(reply);
+}
+
+// Orders round trip samples for qsort().
+static int compareSamples(const void* a, const void* b)
+{
+	double x = *(const double*)a;
+	double y = *(const double*)b;
+
+	return (x > y) - (x < y);
+}
+
+// Sends lines over BENCH_CLIENTS connections, pipeline lines per round
+// trip, and prints the throughput and round trip percentiles.
+static long long runClients(char (*lines)[BATCH_LINE_MAX],
+	char (*expected)[BATCH_REPLY_MAX], const size_t count,
+	const int pipeline, const char* label)
+{
+	BenchClient clients[BENCH_CLIENTS];
+	AmortThread threads[BENCH_CLIENTS];
+	int launched[BENCH_CLIENTS] = { 0 };
+	size_t per = (count + BENCH_CLIENTS - 1) / BENCH_CLIENTS;
+	double* samples = (double*)malloc(sizeof(double) * (count + 1));
+	size_t groups = 0;
+	long long mismatches = 0;
+	double start = 0;
+	double elapsed = 0;
+
+	if (samples == NULL)
+		return (long long)count;
+	for (int c = 0; c < BENCH_CLIENTS; c++)
+	{
+		size_t first = per * (size_t)c;
+
+		memset(&clients[c], 0, sizeof(BenchClient));
+		clients[c].lines = lines + first;
+		clients[c].expected = expected + first;
+		clients[c].count = (first >= count) ? 0 :
+			(count - first < per) ? count - first : per;
+		clients[c].pipeline = pipeline;
+		clients[c].samples = samples + first;
+	}
+	start = GetWallSeconds();
+	for (int c = 1; c < BENCH_CLIENTS; c++)
+		launched[c] = StartThread(&threads[c], runClient, &clients[c]);
+	runClient(&clients[0]);
+	for (int c = 1; c < BENCH_CLIENTS; c++)
+	{
+		if (launched[c])
+			JoinThread(threads[c]);
+		else
+			runClient(&clients[c]);
+	}
+	elapsed = GetWallSeconds() - start;
+
+	for (int c = 0; c < BENCH_CLIENTS; c++)
+	{
+		memmove(samples + groups, clients[c].samples,
+			sizeof(double) * clients[c].groups);
+		groups += clients[c].groups;
+		mismatches += clients[c].mismatches;
+	}
+	qsort(samples, groups, sizeof(double), compareSamples);
+	if (groups > 0)
+		printf("%-24s %12.0lf %10.1lf %10.1lf\n", label, count / elapsed,
+			samples[(groups - 1) / 2] * 1e6,
+			samples[(size_t)((groups - 1) * 0.99)] * 1e6);
+	free(samples);
+	return mismatches;
+}
+
+// Asks for a table and checks its rows. Returns the number of mismatches.
+static long long checkSchedule(AmortSocket connection, const char* request,
+	const double loanSize, const double rate, const int months)
+{
+	size_t size = (size_t)(months + 2) * WRITER_ROW_MAX;
+	char* reply = (char*)malloc(size);
+	ScheduleRow* rows = (ScheduleRow*)malloc(sizeof(ScheduleRow) *
+		(size_t)(months + 1));
+	double payment = getPaymentAmount(months, loanSize, rate);
+	long long mismatches = 0;
+	char expected[WRITER_ROW_MAX] = "";
+	char* line = reply;
+	int count = (months > 0) ? FillScheduleRows(rows, loanSize, payment,
+		rate, months, 1, months) : 0;
+
+	if ((reply == NULL) || (rows == NULL) ||
+		(roundTrip(connection, request, strlen(request), reply, size,
+		count + 2) < 0))
+		mismatches++;
+	for (int i = 0; (mismatches == 0) && (i < count); i++)
+	{
+		line = strchr(line, '\n') + 1;
+		sprintf(expected, "%d,%.2lf,%.2lf,%.2lf,%.2lf\n", rows[i].month,
+			rows[i].payment, rows[i].principal, rows[i].interest,
+			rows[i].balance);
+		mismatches += (strncmp(line, expected, strlen(expected)) != 0);
+	}
+	if (mismatches == 0)
+	{
+		line = strchr(line, '\n') + 1;
+		sprintf(expected, "END %d\n", count);
+		mismatches += (strcmp(line, expected) != 0);
+	}
+	free(reply);
+	free(rows);
+	return mismatches;
+}
+
+int main(int argc, char* argv[])
+{
+	size_t count = (argc > 1) ? (size_t)atol(argv[1]) : BENCH_RECORDS;
+	char (*lines)[BATCH_LINE_MAX] = NULL;
+	char (*expected)[BATCH_REPLY_MAX] = NULL;
+	AmortServer* server = (AmortServer*)malloc(sizeof(AmortServer));
+	AmortSocket connection = AMORT_NO_SOCKET;
+	ServerStats stats;
+	long long mismatches = 0;
+	char reply[BATCH_REPLY_MAX] = "";
+	FILE* fp = NULL;
+
+	count = (count < SINGLE_RECORDS) ? SINGLE_RECORDS : count;
+	lines = malloc(sizeof(*lines) * count);
+	expected = malloc(sizeof(*expected) * count);
+	if ((server == NULL) || (lines == NULL) || (expected == NULL))
+		return EXIT_FAILURE;
+	for (size_t i = 0; i < count; i++)
+	{
+		LoanRecord record;
+
+		makeRecord(lines[i], i);
+		ParseLoanRecord(lines[i], &record);
+		PriceLoanRecord(&record);
+		FormatLoanRecord(expected[i], BATCH_REPLY_MAX, &record);
+	}
+
+	if (!StartServer(server, ENDPOINT, 0))
+	{
+		printf("Cannot start the server on %s\n", ENDPOINT);
+		return EXIT_FAILURE;
+	}
+	printf("%zu records, %d clients, %d workers\n", count, BENCH_CLIENTS,
+		server->workers);
+	printf("%-24s %12s %10s %10s\n", "", "records/s", "p50 us", "p99 us");
+	mismatches += runClients(lines, expected, SINGLE_RECORDS, 1,
+		"One per round trip");
+	mismatches += runClients(lines, expected, count, PIPELINE,
+		"Pipelined");
+
+	if ((connection = ConnectLocal(ENDPOINT)) == AMORT_NO_SOCKET)
+		return EXIT_FAILURE;
+	mismatches += checkSchedule(connection, "S 250000,,360,6.5\n", 250000,
+		6.5, 360);
+	mismatches += checkSchedule(connection, "S 1000,,0,5\n", 1000, 5, 0);
+	GetServerStats(server, &stats);
+	if ((stats.requests != (long long)(SINGLE_RECORDS + count)) ||
+		(stats.schedules != 2) || (stats.batches < 1) || (stats.p50 <= 0) ||
+		(stats.p99 < stats.p50))
+		mismatches++;
+	if ((roundTrip(connection, "STATS\n", 6, reply, sizeof(reply), 1) < 0) ||
+		(strncmp(reply, "STATS requests=", 15) != 0) ||
+		(atoll(reply + 15) != stats.requests))
+		mismatches++;
+	if ((roundTrip(connection, "SHUTDOWN\n", 9, reply, sizeof(reply), 1) < 0) ||
+		(strcmp(reply, "BYE\n") != 0) || !server->shutdownRequested)
+		mismatches++;
+	CloseSocket(connection);
+	printf("Server: mean batch %.1lf records, p50 %.0lf us, p99 %.0lf us\n",
+		stats.meanBatch, stats.p50, stats.p99);
+
+	StopServer(server);
+#ifndef _WIN32
+	if ((fp = fopen(ENDPOINT, "r")) != NULL)
+	{
+		fclose(fp);
+		mismatches++;
+	}
+	if ((fp = fopen(ENDPOINT, "w")) == NULL)
+		return EXIT_FAILURE;
+	fclose(fp);
+	if (StartServer(server, ENDPOINT, 1))
+	{
+		StopServer(server);
+		mismatches++;
+	}
+	if ((fp = fopen(ENDPOINT, "r")) == NULL)
+		mismatches++;                   // The file was removed
+	else
+		fclose(fp);
+	remove(ENDPOINT);
+#endif
+	printf("Replies unlike PriceLoanRecord(): %lld\n", mismatches);
+	free(lines);
+	free(expected);
+	free(server);
+	return (mismatches == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
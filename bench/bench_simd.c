@@ -0,0 +1,133 @@
+//----------------------------------------------------------------------------
+// File:			bench_simd.c
+//
+// Description      Benchmark of the SIMD amortization kernel. Checks every
+//					row of every loan against the DisplayTable() loop, bit for
+//					bit, at each SIMD level the CPU has, then times a full
+//					schedule of LOAN_COUNT loans at each level.
+//
+//					cc -O2 bench/bench_simd.c amort*.c -lm -lpthread
+//
+// Functions:	    int main(void)
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include "../amort.h"
+#include "../amort_platform.h"
+#include "../amort_simd.h"
+#include "bench_util.h"
+
+#define LOAN_COUNT 100003           // Odd, so the scalar tail is used too
+#define MAX_MONTHS 360
+
+typedef struct
+{
+	double payment;
+	double balance;
+	double rate;
+	int months;
+} TableLoan;
+
+static const char* LEVEL_NAMES[] = { "scalar", "avx2", "avx512" };
+
+// Pseudo random number in [0, 1).
+static double nextFraction(void)
+{
+	return (double)(stepRandom(&seed) >> 11) / 9007199254740992.0;
+}
+
+// Row 'month' of the DisplayTable() loop. Returns 0 if the kernel differs.
+static int checkRow(TableLoan* loan, const LoanColumns* cols, size_t i,
+	const int month)
+{
+	double interestPaid = 0;
+	double principalPaid = 0;
+	double paymentSize = loan->payment;
+
+	if (month > loan->months)
+		return (cols->paid[i] == 0) && (cols->principal[i] == 0) &&
+			(cols->interest[i] == 0) &&
+			(memcmp(&cols->balance[i], &loan->balance, sizeof(double)) == 0);
+	interestPaid = loan->balance * (loan->rate / MONTHLY_DIVISOR);
+	interestPaid = floor(interestPaid * HUNDRED + HALF) / HUNDRED;
+	principalPaid = paymentSize - interestPaid;
+	loan->balance -= principalPaid;
+	if ((month == loan->months) && (loan->balance != 0))
+	{
+		paymentSize += loan->balance;
+		principalPaid += loan->balance;
+		loan->balance -= loan->balance;
+	}
+	return (memcmp(&cols->paid[i], &paymentSize, sizeof(double)) == 0) &&
+		(memcmp(&cols->principal[i], &principalPaid, sizeof(double)) == 0) &&
+		(memcmp(&cols->interest[i], &interestPaid, sizeof(double)) == 0) &&
+		(memcmp(&cols->balance[i], &loan->balance, sizeof(double)) == 0);
+}
+
+static void fillColumns(LoanColumns* cols, const TableLoan* loans)
+{
+	for (size_t i = 0; i < LOAN_COUNT; i++)
+		SetLoanColumn(cols, i, loans[i].balance, loans[i].payment,
+			loans[i].rate, loans[i].months);
+}
+
+int main(void)
+{
+	long long mismatches = 0;
+	double baseTime = 0;
+	int best = GetSimdLevel();
+	LoanColumns cols;
+	TableLoan* loans = (TableLoan*)malloc(LOAN_COUNT * sizeof(TableLoan));
+	TableLoan* check = (TableLoan*)malloc(LOAN_COUNT * sizeof(TableLoan));
+
+	if ((loans == NULL) || (check == NULL) ||
+		!AllocLoanColumns(&cols, LOAN_COUNT))
+	{
+		fprintf(stderr, "Out of memory\n");
+		return EXIT_FAILURE;
+	}
+	for (size_t i = 0; i < LOAN_COUNT; i++)
+	{
+		loans[i].months = 1 + (int)(nextFraction() * MAX_MONTHS);
+		loans[i].balance = floor(nextFraction() * 1e8) / HUNDRED + 100;
+		loans[i].rate = roundInterest(nextFraction() * 20, 8);
+		loans[i].payment = getPaymentAmount(loans[i].months,
+			loans[i].balance, loans[i].rate);
+	}
+
+	printf("%8s %10s %12s %14s %8s\n",
+		"level", "rows", "seconds", "rows/s", "speedup");
+	for (int level = SIMD_SCALAR; level <= best; level++)
+	{
+		double start = 0;
+		double elapsed = 0;
+		long long rows = (long long)LOAN_COUNT * MAX_MONTHS;
+
+		if (SetSimdLevel(level) != level)
+			continue;
+		memcpy(check, loans, LOAN_COUNT * sizeof(TableLoan));
+		fillColumns(&cols, loans);
+		for (int month = 1; month <= MAX_MONTHS; month++)
+		{
+			StepLoanColumns(&cols, month);
+			for (size_t i = 0; i < LOAN_COUNT; i++)
+				if (!checkRow(&check[i], &cols, i, month))
+					mismatches++;
+		}
+
+		fillColumns(&cols, loans);
+		start = GetWallSeconds();
+		for (int month = 1; month <= MAX_MONTHS; month++)
+			StepLoanColumns(&cols, month);
+		elapsed = GetWallSeconds() - start;
+		if (level == SIMD_SCALAR)
+			baseTime = elapsed;
+		printf("%8s %10lld %12.4lf %14.0lf %7.2lfx\n", LEVEL_NAMES[level],
+			rows, elapsed, rows / elapsed, baseTime / elapsed);
+	}
+	printf("Rows differing from DisplayTable(): %lld\n", mismatches);
+	FreeLoanColumns(&cols);
+	free(loans);
+	free(check);
+	return (mismatches == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,193 @@
+//----------------------------------------------------------------------------
+// File:			bench_solver.c
+//
+// Description      Benchmark of the batch interest rate solver. Prices a
+//					book of random offers with getPaymentAmount(), mixed
+//					with offers no rate fits and malformed ones, solves
+//					their rates with SolveInterestRates() and checks every
+//					status, and every rate against solveInterestRate().
+//					Then reports offers per second and iterations per offer
+//					for solveInterestRate() one offer at a time and for
+//					SolveInterestRates() with and without SIMD.
+//
+//					bench_solver [offers]      (default BOOK_OFFERS)
+//
+//					cc -O2 bench/bench_solver.c amort*.c -lm -lpthread
+//
+// Functions:	    int main(int argc, char* argv[])
+//----------------------------------------------------------------------------
+
+#include "../amort.h"
+#include "../amort_platform.h"
+#include "../amort_simd.h"
+#include "../amort_solver.h"
+#include "bench_util.h"
+
+#define BOOK_OFFERS 200000
+#define ODD_OFFERS 50               // One offer in ODD_OFFERS is not a loan
+#define RATE_LIMIT 1e-6             // Annual percent
+
+typedef struct
+{
+	int* months;
+	double* principal;
+	double* payment;
+	double* rates;
+	int* status;
+	int* iterations;
+	int* expected;                  // Status each offer should get
+} OfferBook;
+
+// Random loans of 1 to 6000 months at 0 to 20%, and every ODD_OFFERS-th
+// offer one that has no rate or is not a loan at all.
+static void makeBook(OfferBook* book, const size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		int months = (nextRandom() % 2) ? 360 :
+			1 + (int)(nextRandom() % FIVE_HUNDRED_YEARS);
+		double principal = (double)(nextRandom() % 100000000) / HUNDRED + 1;
+		double rate = (double)(nextRandom() % 161) / 8;
+
+		book->months[i] = months;
+		book->principal[i] = principal;
+		book->payment[i] = getPaymentAmount(months, principal, rate);
+		book->expected[i] = RATE_SOLVED;
+		if (i % ODD_OFFERS != 0)
+			continue;
+		switch (nextRandom() % 4)
+		{
+		case 0:
+			book->payment[i] = floor(principal / months) - ONE_CENT;
+			book->expected[i] = (book->payment[i] > 0) ? RATE_NO_SOLUTION :
+				RATE_BAD_INPUT;
+			break;
+		case 1:
+			book->months[i] = -months;
+			book->expected[i] = RATE_BAD_INPUT;
+			break;
+		case 2:
+			book->payment[i] = NAN;
+			book->expected[i] = RATE_BAD_INPUT;
+			break;
+		default:
+			book->months[i] = 4;
+			book->principal[i] = 1000;
+			book->payment[i] = 250;                 // Exactly 0%
+		}
+	}
+}
+
+// Returns the number of offers whose status or rate is wrong.
+static int checkBook(const OfferBook* book, const size_t count)
+{
+	int mismatches = 0;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		double rate = NO_RATE;
+
+		if (book->status[i] != book->expected[i])
+		{
+			mismatches++;
+			continue;
+		}
+		if (book->status[i] == RATE_BAD_INPUT)
+			continue;
+		rate = solveInterestRate(book->months[i], book->principal[i],
+			book->payment[i], RATE_TOLERANCE, NULL);
+		if (fabs(book->rates[i] - rate) > RATE_LIMIT)
+			mismatches++;
+	}
+	return mismatches;
+}
+
+// Solves the book once with SolveInterestRates(). Returns offers per second
+// and the mean number of iterations in *mean.
+static double timeBatch(OfferBook* book, const size_t count, double* mean)
+{
+	double start = GetWallSeconds();
+	double seconds = 0;
+	long long total = 0;
+
+	SolveInterestRates(book->months, book->principal, book->payment,
+		book->rates, book->status, book->iterations, count, RATE_TOLERANCE);
+	seconds = GetWallSeconds() - start;
+	for (size_t i = 0; i < count; i++)
+		total += book->iterations[i];
+	*mean = (double)total / count;
+	return count / seconds;
+}
+
+int main(int argc, char* argv[])
+{
+	size_t count = (argc > 1) ? (size_t)atol(argv[1]) : BOOK_OFFERS;
+	OfferBook book;
+	double start = 0;
+	double single = 0;
+	double vector = 0;
+	double scalar = 0;
+	double singleMean = 0;
+	double vectorMean = 0;
+	double scalarMean = 0;
+	long long total = 0;
+	int mismatches = 0;
+	int level = GetSimdLevel();
+	volatile double sink = 0;
+
+	if (count == 0)
+		count = BOOK_OFFERS;
+	book.months = (int*)malloc(count * sizeof(int));
+	book.principal = (double*)malloc(count * sizeof(double));
+	book.payment = (double*)malloc(count * sizeof(double));
+	book.rates = (double*)malloc(count * sizeof(double));
+	book.status = (int*)malloc(count * sizeof(int));
+	book.iterations = (int*)malloc(count * sizeof(int));
+	book.expected = (int*)malloc(count * sizeof(int));
+	if ((book.months == NULL) || (book.principal == NULL) ||
+		(book.payment == NULL) || (book.rates == NULL) ||
+		(book.status == NULL) || (book.iterations == NULL) ||
+		(book.expected == NULL))
+		return EXIT_FAILURE;
+	makeBook(&book, count);
+
+	start = GetWallSeconds();
+	for (size_t i = 0; i < count; i++)
+	{
+		int iterations = 0;
+
+		if (book.expected[i] == RATE_BAD_INPUT)
+			continue;
+		sink += solveInterestRate(book.months[i], book.principal[i],
+			book.payment[i], RATE_TOLERANCE, &iterations);
+		total += iterations;
+	}
+	single = count / (GetWallSeconds() - start);
+	singleMean = (double)total / count;
+
+	SetSimdLevel(SIMD_SCALAR);
+	scalar = timeBatch(&book, count, &scalarMean);
+	mismatches += checkBook(&book, count);
+	SetSimdLevel(level);
+	vector = timeBatch(&book, count, &vectorMean);
+	mismatches += checkBook(&book, count);
+
+	printf("%zu offers, SIMD level %d\n", count, level);
+	printf("%-28s %14s %12s %8s\n", "solver", "offers/s", "iterations",
+		"speedup");
+	printf("%-28s %14.0lf %12.2lf %7.2lfx\n", "solveInterestRate()", single,
+		singleMean, 1.0);
+	printf("%-28s %14.0lf %12.2lf %7.2lfx\n", "SolveInterestRates() scalar",
+		scalar, scalarMean, scalar / single);
+	printf("%-28s %14.0lf %12.2lf %7.2lfx\n", "SolveInterestRates() SIMD",
+		vector, vectorMean, vector / single);
+	printf("Offers with a wrong status or rate: %d\n", mismatches);
+	free(book.months);
+	free(book.principal);
+	free(book.payment);
+	free(book.rates);
+	free(book.status);
+	free(book.iterations);
+	free(book.expected);
+	return ((mismatches == 0) && (sink != 0)) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,148 @@
+//----------------------------------------------------------------------------
+// File:			bench_totals.c
+//
+// Description      Benchmark of loan totals without the table. For random
+//					loans of 1 to 6000 months, under the double and the
+//					integer cents engine, it checks that GetScheduleTotals()
+//					gives the total paid, principal and interest of
+//					BuildSchedule() bit for bit, and the last row's payment
+//					as the final payment. It reports how far the constant
+//					time EstimateScheduleTotals() drifts from the cents
+//					totals by loan term (while both fit a double to the
+//					cent), and times all three.
+//
+//					cc -O2 bench/bench_totals.c amort*.c -lm -lpthread
+//
+// Functions:	    int main(void)
+//----------------------------------------------------------------------------
+
+#include "../amort.h"
+#include "../amort_platform.h"
+#include "../amort_query.h"
+#define BENCH_SEED 2024
+#include "bench_util.h"
+
+#define LOAN_COUNT 3000
+#define TERM_GROUPS 3
+#define ENGINES 2
+#define MAX_EXACT 1e13              // Sums a double still holds to the cent
+
+typedef struct
+{
+	double loanSize;
+	double paymentSize;
+	double interestRate;
+	int months;
+} BenchLoan;
+
+static const int TERM_LIMITS[TERM_GROUPS] = { 360, 1200, FIVE_HUNDRED_YEARS };
+static const int ENGINE_LIST[ENGINES] = { ENGINE_DOUBLE, ENGINE_CENTS };
+static const char* ENGINE_NAMES[ENGINES] = { "double", "cents" };
+
+static void keepLargest(double* largest, const double value)
+{
+	if (fabs(value) > *largest)
+		*largest = fabs(value);
+}
+
+int main(void)
+{
+	static BenchLoan loans[LOAN_COUNT];
+	ScheduleArena arena;
+	Schedule schedule;
+	ScheduleTotals totals;
+	ScheduleTotals estimate;
+	double drift[TERM_GROUPS] = { 0 };
+	long long mismatches = 0;
+	double buildTime[ENGINES] = { 0 };
+	double totalsTime[ENGINES] = { 0 };
+	double estimateTime = 0;
+	double start = 0;
+	volatile double sink = 0;
+
+	if (!InitArena(&arena, SCHEDULE_ARENA))
+		return EXIT_FAILURE;
+	for (int i = 0; i < LOAN_COUNT; i++)
+	{
+		loans[i].months = 1 + (int)(nextRandom() % TERM_LIMITS[i % 3]);
+		loans[i].loanSize = (double)(nextRandom() % 100000000) / HUNDRED + 1;
+		loans[i].interestRate = (double)(nextRandom() % 160) / 8;
+		loans[i].paymentSize = ceil(getPaymentAmount(loans[i].months,
+			loans[i].loanSize, loans[i].interestRate) * HUNDRED) / HUNDRED;
+	}
+
+	for (int e = 0; e < ENGINES; e++)
+	{
+		SetScheduleEngine(ENGINE_LIST[e]);
+		for (int i = 0; i < LOAN_COUNT; i++)
+		{
+			const BenchLoan* loan = &loans[i];
+
+			ResetArena(&arena);
+			BuildSchedule(&schedule, &arena, loan->loanSize,
+				loan->paymentSize, loan->interestRate, loan->months);
+			GetScheduleTotals(&totals, loan->loanSize, loan->paymentSize,
+				loan->interestRate, loan->months);
+			mismatches += (totals.months != schedule.months) ||
+				(totals.totalPaid != schedule.totalPaid) ||
+				(totals.totalPrincipal != schedule.totalPrincipal) ||
+				(totals.totalInterest != schedule.totalInterest) ||
+				(totals.finalPayment !=
+				schedule.rows[schedule.months - 1].payment);
+			if ((ENGINE_LIST[e] != ENGINE_CENTS) ||
+				(fabs(totals.totalPaid) > MAX_EXACT))
+				continue;
+			EstimateScheduleTotals(&estimate, loan->loanSize,
+				loan->paymentSize, loan->interestRate, loan->months);
+			if (fabs(estimate.totalPaid) <= MAX_EXACT)
+				keepLargest(&drift[i % 3],
+					estimate.totalPaid - totals.totalPaid);
+		}
+
+		start = GetWallSeconds();
+		for (int i = 0; i < LOAN_COUNT; i++)
+		{
+			ResetArena(&arena);
+			BuildSchedule(&schedule, &arena, loans[i].loanSize,
+				loans[i].paymentSize, loans[i].interestRate, loans[i].months);
+			sink += schedule.totalPaid;
+		}
+		buildTime[e] = GetWallSeconds() - start;
+		start = GetWallSeconds();
+		for (int i = 0; i < LOAN_COUNT; i++)
+		{
+			GetScheduleTotals(&totals, loans[i].loanSize,
+				loans[i].paymentSize, loans[i].interestRate, loans[i].months);
+			sink += totals.totalPaid;
+		}
+		totalsTime[e] = GetWallSeconds() - start;
+	}
+	SetScheduleEngine(ENGINE_DOUBLE);
+
+	start = GetWallSeconds();
+	for (int i = 0; i < LOAN_COUNT; i++)
+	{
+		EstimateScheduleTotals(&estimate, loans[i].loanSize,
+			loans[i].paymentSize, loans[i].interestRate, loans[i].months);
+		sink += estimate.totalPaid;
+	}
+	estimateTime = GetWallSeconds() - start;
+
+	printf("%d loans\n", LOAN_COUNT);
+	printf("%-34s %12s\n", "", "us per loan");
+	for (int e = 0; e < ENGINES; e++)
+	{
+		printf("BuildSchedule(), %-17s %12.3lf\n", ENGINE_NAMES[e],
+			buildTime[e] * 1e6 / LOAN_COUNT);
+		printf("GetScheduleTotals(), %-13s %12.3lf\n", ENGINE_NAMES[e],
+			totalsTime[e] * 1e6 / LOAN_COUNT);
+	}
+	printf("%-34s %12.3lf\n", "EstimateScheduleTotals()",
+		estimateTime * 1e6 / LOAN_COUNT);
+	for (int g = 0; g < TERM_GROUPS; g++)
+		printf("Estimate drift, terms up to %4d months: $%.2lf\n",
+			TERM_LIMITS[g], drift[g]);
+	printf("Totals unlike BuildSchedule(): %lld\n", mismatches);
+	FreeArena(&arena);
+	return (mismatches == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
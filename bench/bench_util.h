@@ -0,0 +1,39 @@
+//----------------------------------------------------------------------------
+// File:			bench_util.h
+//
+// Description:     Helpers shared by the benches: the 64-bit linear
+//					congruential generator they draw random loans from, and
+//					tolerances more than one bench checks against. Each
+//					bench is one file, so the generator state is a static
+//					here. A bench that wants its own stream defines
+//					BENCH_SEED before it includes this file.
+//
+// History Log:    10/17/2026  taken out of the benches that each had a copy
+//----------------------------------------------------------------------------
+
+#ifndef BENCH_UTIL_H
+#define BENCH_UTIL_H
+
+#define LCG_MULTIPLIER 6364136223846793005ULL
+#define LCG_INCREMENT 1442695040888963407ULL
+#define ROUNDING_PER_MONTH 0.005    // Most cent rounding can move a month
+#ifndef BENCH_SEED
+#define BENCH_SEED 2016
+#endif
+
+static unsigned long long seed = BENCH_SEED;
+
+// Steps a generator state and returns all 64 bits of it.
+static inline unsigned long long stepRandom(unsigned long long* state)
+{
+	*state = *state * LCG_MULTIPLIER + LCG_INCREMENT;
+	return *state;
+}
+
+// Next 31 random bits of the bench's stream.
+static inline unsigned int nextRandom(void)
+{
+	return (unsigned int)(stepRandom(&seed) >> 33);
+}
+
+#endif
@@ -0,0 +1,269 @@
+//----------------------------------------------------------------------------
+// File:			bench_whatif.c
+//
+// Description      Benchmark of incremental what-if tables. Applies runs of
+//					random changes (payment or rate from a random month on,
+//					term, loan size) to random loans and after every change
+//					checks the table against a month by month loop over the
+//					payment and rate of each month, and the row diff
+//					against the rows before and after the change. Under the
+//					integer cents engine, changes from month 1 must give
+//					BuildSchedule() of the new loan bit for bit while its
+//					amounts fit a double to the cent. Then times a change
+//					against building the whole table again.
+//
+//					cc -O2 bench/bench_whatif.c amort*.c -lm -lpthread
+//
+// Functions:	    int main(void)
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include "../amort.h"
+#include "../amort_platform.h"
+#include "../amort_whatif.h"
+#define BENCH_SEED 2025
+#include "bench_util.h"
+
+#define LOAN_COUNT 200
+#define CHANGES_PER_LOAN 20
+#define TIMED_CHANGES 20000
+#define MAX_EXACT 1e13              // Amounts a double still holds to the cent
+
+// Payments and rates of every month, as the bench last set them.
+static double payments[FIVE_HUNDRED_YEARS];
+static double rates[FIVE_HUNDRED_YEARS];
+static ScheduleRow expected[FIVE_HUNDRED_YEARS];
+static ScheduleRow previous[FIVE_HUNDRED_YEARS];
+
+static int rowsDiffer(const ScheduleRow* first, const ScheduleRow* second)
+{
+	return (first->month != second->month) ||
+		(first->payment != second->payment) ||
+		(first->principal != second->principal) ||
+		(first->interest != second->interest) ||
+		(first->balance != second->balance) ||
+		(first->interestToDate != second->interestToDate);
+}
+
+// The loop of FillScheduleRows() written out with a payment and rate per
+// month. Fills expected[] and the totals.
+static void buildExpected(const double loanSize, const int months,
+	double totals[3])
+{
+	double balance = loanSize;
+	double interestToDate = 0;
+
+	totals[0] = totals[1] = totals[2] = 0;
+	for (int m = 1; m <= months; m++)
+	{
+		double payment = payments[m - 1];
+		double interest = balance *
+			(roundInterest(rates[m - 1], 8) / MONTHLY_DIVISOR);
+		double principal = 0;
+
+		interest = floor(interest * HUNDRED + HALF) / HUNDRED;
+		principal = payment - interest;
+		balance -= principal;
+		if ((m == months) && (balance != 0))
+		{
+			payment += balance;
+			principal += balance;
+			balance -= balance;
+		}
+		interestToDate += interest;
+		expected[m - 1].month = m;
+		expected[m - 1].payment = payment;
+		expected[m - 1].principal = principal;
+		expected[m - 1].interest = interest;
+		expected[m - 1].balance = balance;
+		expected[m - 1].interestToDate = interestToDate;
+		totals[0] += payment;
+		totals[1] += principal;
+		totals[2] += interest;
+	}
+}
+
+// Counts differences between the diff a change left and the one previous[]
+// and expected[] give.
+static long long checkDiff(const WhatIfSchedule* whatIf,
+	const int oldMonths, const int months)
+{
+	long long mismatches = 0;
+	int next = 0;
+	int last = (oldMonths > months) ? oldMonths : months;
+
+	for (int m = 1; m <= last; m++)
+	{
+		char kind = (m > oldMonths) ? ROW_ADDED : (m > months) ? ROW_REMOVED :
+			rowsDiffer(&previous[m - 1], &expected[m - 1]) ? ROW_CHANGED : 0;
+		const RowChange* change = &whatIf->changes[next];
+
+		if (kind == 0)
+			continue;
+		if ((next >= whatIf->changeCount) || (change->month != m) ||
+			(change->kind != kind) || ((kind != ROW_ADDED) &&
+			rowsDiffer(&change->before, &previous[m - 1])))
+			return mismatches + 1;
+		next++;
+	}
+	return mismatches + (next != whatIf->changeCount);
+}
+
+// Makes a random change to whatIf and the bench's own payments[] and
+// rates[]. fromStart makes payment and rate changes start at month 1.
+static int randomChange(WhatIfSchedule* whatIf, const int fromStart,
+	double* loanSize)
+{
+	int months = whatIf->schedule.months;
+	int pick = (int)(nextRandom() % 20);
+	int from = fromStart ? 1 : 1 + (int)(nextRandom() % months);
+	double amount = 0;
+
+	if (pick < 8)
+	{
+		amount = floor(payments[from - 1] *
+			(90 + nextRandom() % 31)) / HUNDRED;
+		for (int i = from - 1; i < months; i++)
+			payments[i] = amount;
+		return ChangeWhatIf(whatIf, WHATIF_PAYMENT, amount, from);
+	}
+	if (pick < 16)
+	{
+		amount = (double)(nextRandom() % 121) / 8;
+		for (int i = from - 1; i < months; i++)
+			rates[i] = amount;
+		return ChangeWhatIf(whatIf, WHATIF_RATE, amount, from);
+	}
+	if (pick < 19)
+	{
+		amount = months + (int)(nextRandom() % 121) - 60;
+		amount = (amount < 1) ? 1 : (amount > FIVE_HUNDRED_YEARS) ?
+			FIVE_HUNDRED_YEARS : amount;
+		for (int i = months; i < (int)amount; i++)
+		{
+			payments[i] = payments[months - 1];
+			rates[i] = rates[months - 1];
+		}
+		return ChangeWhatIf(whatIf, WHATIF_TERM, amount, from);
+	}
+	*loanSize = floor(*loanSize * (95 + nextRandom() % 11)) / HUNDRED;
+	return ChangeWhatIf(whatIf, WHATIF_LOAN, *loanSize, from);
+}
+
+// Random loan of up to 6000 months, with payments[] and rates[] set.
+static int randomLoan(WhatIfSchedule* whatIf, double* loanSize)
+{
+	int months = 1 + (int)(nextRandom() % FIVE_HUNDRED_YEARS);
+	double rate = (double)(nextRandom() % 121) / 8;
+	double payment = 0;
+
+	*loanSize = (double)(nextRandom() % 100000000) / HUNDRED + 1;
+	payment = ceil(getPaymentAmount(months, *loanSize, rate) * HUNDRED) /
+		HUNDRED;
+	for (int i = 0; i < months; i++)
+	{
+		payments[i] = payment;
+		rates[i] = rate;
+	}
+	return StartWhatIf(whatIf, *loanSize, payment, rate, months);
+}
+
+int main(void)
+{
+	WhatIfSchedule whatIf;
+	ScheduleArena arena;
+	Schedule schedule;
+	double totals[3] = { 0 };
+	double loanSize = 0;
+	long long mismatches = 0;
+	long long recomputed = 0;
+	long long rebuilt = 0;
+	long long skipped = 0;
+	double changeTime = 0;
+	double buildTime = 0;
+	double start = 0;
+
+	if (!InitArena(&arena, SCHEDULE_ARENA))
+		return EXIT_FAILURE;
+	for (int loan = 0; loan < LOAN_COUNT; loan++)
+	{
+		mismatches += !randomLoan(&whatIf, &loanSize);
+		for (int c = 0; c < CHANGES_PER_LOAN; c++)
+		{
+			int oldMonths = whatIf.schedule.months;
+
+			memcpy(previous, whatIf.schedule.rows,
+				sizeof(ScheduleRow) * (size_t)oldMonths);
+			mismatches += (randomChange(&whatIf, 0, &loanSize) < 0);
+			buildExpected(loanSize, whatIf.schedule.months, totals);
+			for (int m = 0; m < whatIf.schedule.months; m++)
+				mismatches += rowsDiffer(&whatIf.schedule.rows[m],
+					&expected[m]);
+			mismatches += (whatIf.schedule.totalPaid != totals[0]) ||
+				(whatIf.schedule.totalPrincipal != totals[1]) ||
+				(whatIf.schedule.totalInterest != totals[2]);
+			mismatches += checkDiff(&whatIf, oldMonths,
+				whatIf.schedule.months);
+		}
+		FreeWhatIf(&whatIf);
+	}
+
+	SetScheduleEngine(ENGINE_CENTS);
+	for (int loan = 0; loan < LOAN_COUNT / 4; loan++)
+	{
+		mismatches += !randomLoan(&whatIf, &loanSize);
+		for (int c = 0; c < CHANGES_PER_LOAN; c++)
+		{
+			const Schedule* current = &whatIf.schedule;
+			long long differ = 0;
+			double largest = 0;
+
+			mismatches += (randomChange(&whatIf, 1, &loanSize) < 0);
+			ResetArena(&arena);
+			BuildSchedule(&schedule, &arena, loanSize, payments[0], rates[0],
+				current->months);
+			differ += (schedule.totalPaid != current->totalPaid) ||
+				(schedule.totalPrincipal != current->totalPrincipal) ||
+				(schedule.totalInterest != current->totalInterest);
+			for (int m = 0; m < current->months; m++)
+			{
+				differ += rowsDiffer(&schedule.rows[m], &current->rows[m]);
+				largest = fmax(largest, fabs(schedule.rows[m].balance));
+				largest = fmax(largest, fabs(schedule.rows[m].interestToDate));
+			}
+			if (largest <= MAX_EXACT)
+				mismatches += differ;
+			else
+				skipped++;
+		}
+		FreeWhatIf(&whatIf);
+	}
+	SetScheduleEngine(ENGINE_DOUBLE);
+
+	mismatches += !randomLoan(&whatIf, &loanSize);
+	for (int c = 0; c < TIMED_CHANGES; c++)
+	{
+		start = GetWallSeconds();
+		recomputed += randomChange(&whatIf, 0, &loanSize);
+		changeTime += GetWallSeconds() - start;
+
+		start = GetWallSeconds();
+		ResetArena(&arena);
+		BuildSchedule(&schedule, &arena, loanSize, payments[0], rates[0],
+			whatIf.schedule.months);
+		buildTime += GetWallSeconds() - start;
+		rebuilt += schedule.months;
+	}
+	FreeWhatIf(&whatIf);
+	FreeArena(&arena);
+
+	printf("%d loans, %d changes each\n", LOAN_COUNT, CHANGES_PER_LOAN);
+	printf("%-34s %12s %12s\n", "", "us/change", "rows/change");
+	printf("%-34s %12.3lf %12.1lf\n", "ChangeWhatIf()",
+		changeTime * 1e6 / TIMED_CHANGES, (double)recomputed / TIMED_CHANGES);
+	printf("%-34s %12.3lf %12.1lf\n", "BuildSchedule(), whole table",
+		buildTime * 1e6 / TIMED_CHANGES, (double)rebuilt / TIMED_CHANGES);
+	printf("Cents tables too large to compare: %lld\n", skipped);
+	printf("Rows or diffs unlike the full loop: %lld\n", mismatches);
+	return (mismatches == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,171 @@
+//----------------------------------------------------------------------------
+// File:			bench_writer.c
+//
+// Description      Benchmark of the buffered schedule writer. Writes the
+//					same tables with the fprintf(fp, FORMAT, ...) loop of
+//					SaveTable() version 1.0 and with ScheduleWriter (stdio
+//					and direct modes), checks that the files are identical
+//					and reports rows per second.
+//
+//					cc -O2 bench/bench_writer.c amort*.c -lm -lpthread
+//
+// Functions:	    int main(void)
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include "../amort.h"
+#include "../amort_platform.h"
+#include "../amort_writer.h"
+#include "bench_util.h"
+
+#define LOAN_COUNT 200
+#define OLD_FILE "bench_writer_old.txt"
+#define NEW_FILE "bench_writer_new.txt"
+
+// Awkward values for the formatter: signs, half cents, huge, not a number.
+static const double EDGE_VALUES[] =
+{
+	0, -0.0, 0.005, 0.015, 0.125, -0.125, 2.675, 1.005, -0.004, 0.994999,
+	99999999.995, 1e13, 123456789012.345, -98765.4321, 1e300, 1.0 / 0.0
+};
+
+typedef struct
+{
+	double loanSize;
+	double paymentSize;
+	double interestRate;
+	int months;
+} BenchLoan;
+
+// One SaveTable() loop. Writes with fprintf if writer is NULL.
+static long long writeTable(FILE* fp, ScheduleWriter* writer,
+	const BenchLoan* loan)
+{
+	double interestPaid = 0;
+	double principalPaid = 0;
+	double paymentSize = loan->paymentSize;
+	double loanBalance = loan->loanSize;
+	double roundedInterest = roundInterest(loan->interestRate, 8);
+
+	for (int i = 1; i <= loan->months; i++)
+	{
+		interestPaid = loanBalance * (roundedInterest / MONTHLY_DIVISOR);
+		interestPaid = floor(interestPaid * HUNDRED + HALF) / HUNDRED;
+		principalPaid = paymentSize - interestPaid;
+		loanBalance -= principalPaid;
+		if ((i == loan->months) && (loanBalance != 0))
+		{
+			paymentSize += loanBalance;
+			principalPaid += loanBalance;
+			loanBalance -= loanBalance;
+		}
+		if (writer == NULL)
+			fprintf(fp, FORMAT, i, paymentSize, principalPaid, interestPaid,
+				loanBalance);
+		else
+			WriteScheduleRow(writer, i, paymentSize, principalPaid,
+				interestPaid, loanBalance);
+	}
+	return loan->months;
+}
+
+static void writeEdges(FILE* fp, ScheduleWriter* writer)
+{
+	const int EDGE_COUNT = sizeof(EDGE_VALUES) / sizeof(EDGE_VALUES[0]);
+
+	for (int e = 0; e < EDGE_COUNT; e++)
+	{
+		double v = EDGE_VALUES[e];
+
+		if (writer == NULL)
+			fprintf(fp, FORMAT, e, v, -v, v / 3, v * 7);
+		else
+			WriteScheduleRow(writer, e, v, -v, v / 3, v * 7);
+	}
+}
+
+// Returns 1 if both files hold the same bytes.
+static int sameFiles(const char* first, const char* second)
+{
+	FILE* a = fopen(first, "rb");
+	FILE* b = fopen(second, "rb");
+	int same = (a != NULL) && (b != NULL);
+	int ca = 0;
+	int cb = 0;
+
+	while (same)
+	{
+		ca = getc(a);
+		cb = getc(b);
+		same = (ca == cb);
+		if (ca == EOF)
+			break;
+	}
+	if (a != NULL)
+		fclose(a);
+	if (b != NULL)
+		fclose(b);
+	return same;
+}
+
+int main(void)
+{
+	const char* MODE_NAMES[] = { "stdio", "direct" };
+	BenchLoan loans[LOAN_COUNT];
+	long long rows = 0;
+	double oldTime = 0;
+	double start = 0;
+	int failures = 0;
+	FILE* fp = NULL;
+
+	for (int i = 0; i < LOAN_COUNT; i++)
+	{
+		unsigned long long state = stepRandom(&seed);
+
+		loans[i].months = 1 + (int)((state >> 33) % FIVE_HUNDRED_YEARS);
+		loans[i].loanSize = (double)((state >> 20) % 100000000) / HUNDRED + 1;
+		loans[i].interestRate = (double)((state >> 8) % 160) / 8;
+		loans[i].paymentSize = getPaymentAmount(loans[i].months,
+			loans[i].loanSize, loans[i].interestRate);
+	}
+
+	start = GetWallSeconds();
+	fp = fopen(OLD_FILE, "w");
+	if (fp == NULL)
+		return EXIT_FAILURE;
+	for (int i = 0; i < LOAN_COUNT; i++)
+		rows += writeTable(fp, NULL, &loans[i]);
+	writeEdges(fp, NULL);
+	fclose(fp);
+	oldTime = GetWallSeconds() - start;
+	printf("%8s %10s %10s %14s %8s %s\n",
+		"writer", "rows", "seconds", "rows/s", "speedup", "same");
+	printf("%8s %10lld %10.4lf %14.0lf %7.2lfx\n",
+		"fprintf", rows, oldTime, rows / oldTime, 1.0);
+
+	for (int mode = WRITER_STDIO; mode <= WRITER_DIRECT; mode++)
+	{
+		ScheduleWriter writer;
+		double elapsed = 0;
+		int same = 0;
+
+		start = GetWallSeconds();
+		if (!OpenScheduleWriter(&writer, NEW_FILE, mode))
+			return EXIT_FAILURE;
+		for (int i = 0; i < LOAN_COUNT; i++)
+			writeTable(NULL, &writer, &loans[i]);
+		writeEdges(NULL, &writer);
+		if (!CloseScheduleWriter(&writer))
+			failures++;
+		elapsed = GetWallSeconds() - start;
+		same = sameFiles(OLD_FILE, NEW_FILE);
+		if (!same)
+			failures++;
+		printf("%8s %10lld %10.4lf %14.0lf %7.2lfx %s\n", MODE_NAMES[mode],
+			rows, elapsed, rows / elapsed, oldTime / elapsed,
+			same ? "yes" : "NO");
+	}
+	remove(OLD_FILE);
+	remove(NEW_FILE);
+	return (failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,132 @@
+//----------------------------------------------------------------------------
+// File:            columndump.c
+//
+// Description:     Reader and dumper for columnar schedule files (see
+//					amort_columnar.h). With only a file name it scans the
+//					mapped columns in place and prints the number of loans
+//					and rows and the column totals; given a loan number, or
+//					"all", it writes those tables as the text SaveTable()
+//					writes, to stdout or to a file. One table written to a
+//					file is byte for byte the file SaveTable() would save.
+//
+//					columndump file [loan|all [textfile]]
+//
+// Functions:       main()
+//					ScanColumns()
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include "amort.h"
+#include "amort_columnar.h"
+
+#define USAGE "usage: columndump file [loan|all [textfile]]\n"
+
+void ScanColumns(const ColumnFile* file);
+//----------------------------------------------------------------------------
+// Function:        int main(int argc, char* argv[])
+//
+// Description:		Opens the columnar file named on the command line and
+//					either scans it or writes tables from it as text.
+//
+// Parameters:	    (int)    argc     Number of command line arguments
+//					(char**) argv     file [loan|all [textfile]]
+//
+// Returns:		    EXIT_SUCCESS, or EXIT_FAILURE if the file cannot be
+//					read, the loan does not exist or the text cannot be
+//					written
+// Date:            10/17/2026
+// Calls:		    OpenColumnFile(), CloseColumnFile(), ScanColumns(),
+//					OpenScheduleWriter(), AttachScheduleWriter(),
+//					WriteColumnText(), CloseScheduleWriter()
+// History Log:     10/17/2026  added for the columnar schedule files
+//----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+	ColumnFile file;
+	ScheduleWriter writer;
+	long long first = 0;
+	long long last = 0;
+	char* end = NULL;
+	int ok = 1;
+
+	if ((argc < 2) || (argc > 4))
+	{
+		fprintf(stderr, USAGE);
+		return EXIT_FAILURE;
+	}
+	if (!OpenColumnFile(&file, argv[1]))
+	{
+		fprintf(stderr, "Not a columnar schedule file: %s\n", argv[1]);
+		return EXIT_FAILURE;
+	}
+	if (argc == 2)
+	{
+		ScanColumns(&file);
+		CloseColumnFile(&file);
+		return EXIT_SUCCESS;
+	}
+
+	if (strcmp(argv[2], "all") == 0)
+		last = file.loanCount - 1;
+	else
+	{
+		first = last = strtoll(argv[2], &end, 10);
+		if ((*end != '\0') || (first < 0) || (first >= file.loanCount))
+		{
+			fprintf(stderr, "No loan %s in %s (%lld loans)\n", argv[2],
+				argv[1], file.loanCount);
+			CloseColumnFile(&file);
+			return EXIT_FAILURE;
+		}
+	}
+	if (!((argc == 4) ? OpenScheduleWriter(&writer, argv[3], WRITER_DIRECT) :
+		AttachScheduleWriter(&writer, stdout)))
+	{
+		fprintf(stderr, "Cannot create file: %s\n", argv[3]);
+		CloseColumnFile(&file);
+		return EXIT_FAILURE;
+	}
+	for (long long loan = first; loan <= last; loan++)
+	{
+		if (loan > first)
+			WriteScheduleText(&writer, "\n\n");
+		ok = WriteColumnText(&writer, &file, loan) && ok;
+	}
+	if (argc == 3)
+		WriteScheduleText(&writer, "\n");
+	ok = CloseScheduleWriter(&writer) && ok;
+	CloseColumnFile(&file);
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+//----------------------------------------------------------------------------
+// Function:        void ScanColumns(const ColumnFile* file)
+//
+// Description:		Adds up the payment, principal and interest columns of
+//					every row where they lie in the mapping, and prints the
+//					totals with the loan and row counts.
+//
+// Parameters:	    const (ColumnFile*) file   Open columnar file
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       main()
+// History Log:     10/17/2026  added for the columnar schedule files
+//----------------------------------------------------------------------------
+void ScanColumns(const ColumnFile* file)
+{
+	double paid = 0;
+	double principal = 0;
+	double interest = 0;
+
+	for (long long r = 0; r < file->rows; r++)
+	{
+		paid += file->payment[r];
+		principal += file->principal[r];
+		interest += file->interest[r];
+	}
+	printf("Loans:           %lld\n", file->loanCount);
+	printf("Rows:            %lld\n", file->rows);
+	printf("Total paid:      %.2lf\n", paid);
+	printf("Total principal: %.2lf\n", principal);
+	printf("Total interest:  %.2lf\n", interest);
+}
@@ -3,9 +3,22 @@
 // Functions:       main()
 //					PrintMenu()
 //					PrintSubMenu()
+//					RunBatchMode()
+//					RunServerMode()
+//					RunCalcMode()
+//					RunPipelineMode()
 //----------------------------------------------------------------------------
 
+#include <string.h>
 #include "amort.h"
+#include "amort_batch.h"
+#include "amort_metrics.h"
+#include "amort_pipeline.h"
+#include "amort_platform.h"
+#include "amort_records.h"
+#include "amort_schedule.h"
+#include "amort_server.h"
+#include "amort_writer.h"
 
 #define SUMMARY_PROMPT "Press enter to display loan summary:"
 #define DISPLAY_PAYMENTSIZE "The monthly payment amount is: "
@@ -13,11 +26,18 @@
 #define DISPLAY_LOANSIZE "The total amount of loan is: "
 #define MAXIMUM_MONTHS "The maximum allowed number of monthly payments is: %d\n"
 #define EIGHTY_PERCENT .8
+#define CROSSCHECK_REPORT "Cross-check: %lld rows differ from integer cents\n"
+#define CALC_USAGE "-calc [-loan X] [-payment X] [-months N] [-rate X] " \
+	"[-table] [-json]"
 
 void PrintMenu(void);
 void PrintSubMenu(void);
+int RunBatchMode(int argc, char* argv[]);
+int RunServerMode(int argc, char* argv[]);
+int RunCalcMode(int argc, char* argv[]);
+int RunPipelineMode(int argc, char* argv[]);
 //----------------------------------------------------------------------------
-// Function:        int main(void)
+// Function:        int main(int argc, char* argv[])
 //
 // Title:           Loan Calculator
 // Version:			1.0
@@ -27,9 +47,18 @@ void PrintSubMenu(void);
 //					number of months or the	interest rate.  The results are 
 //					displayed to the screen and the	user may print an 
 //				    amortization table to screen or save to file. 
-//											
+//					Started with -batch the program runs headless instead,
+//					see RunBatchMode(), with -serve as a local
+//					calculation server, see RunServerMode(), or with -calc
+//					answers one calculation given on the command line, see
+//					RunCalcMode(). -pipeline is -batch with its stages on
+//					threads of their own, see RunPipelineMode(). -cents
+//					builds tables with the integer cents engine and
+//					-crosscheck checks every table row of the double engine
+//					against it.
 //
-// Parameters:	    none
+// Parameters:	    (int)    argc     Number of command line arguments
+//					(char**) argv     Command line arguments
 // Input:		    User selects from the 4 loan calculation options, or to 
 //					quit. Then user is prompted to enter amounts used in the 
 //				    calculations. Interest rate, loan amount, months, and/or 
@@ -52,18 +81,27 @@ void PrintSubMenu(void);
 //                  Software: MS Windows 10. Compiles under Microsoft Visual 
 //							  C++.Net 2015 
 //
-// Calls:			Local functions: PrintMenu(), PrintSubMenu()
+// Calls:			Local functions: PrintMenu(), PrintSubMenu(),
+//					RunBatchMode(), RunServerMode(), RunCalcMode(),
+//					RunPipelineMode()
 //
 //					Amort library functions:  ReadInterestRate(), ReadLoanSize()
 //					ReadPaymentSize(), ReadMonths(), CleanBuffer(), 
 //					PrintResults(), GetNumberOfMonths(), GetPaymentAmount(),
 //					GetLoanAmount(), GetInterestRate(), PrintTable(),
-//					SaveTable()
+//					SaveTable(), WhatIfTable(), SetScheduleEngine(),
+//					GetScheduleEngine(), GetCrossCheckMismatches()
 //  
 // History Log:    11/04/2016  JR completed version 1.0
+//				   10/17/2026  added -batch mode
+//				   10/17/2026  added -cents and -crosscheck
+//				   10/17/2026  added -serve mode
+//				   10/17/2026  added -calc mode
+//				   10/17/2026  added -pipeline mode
+//				   10/17/2026  added 'W' what-if table changes
 //----------------------------------------------------------------------------
 
-int main(void)
+int main(int argc, char* argv[])
 {
 	char ch;
 	int months = 0;
@@ -77,6 +115,18 @@ int main(void)
 	double minPaymentSize = 0;       // Min payment size for option 3
 	const int HUNDRED_YEARS = 1200;  // Max length of loan in months for option 4
 	
+	if ((argc > 1) && (strcmp(argv[1], "-batch") == 0))
+		return RunBatchMode(argc, argv);
+	if ((argc > 1) && (strcmp(argv[1], "-serve") == 0))
+		return RunServerMode(argc, argv);
+	if ((argc > 1) && (strcmp(argv[1], "-calc") == 0))
+		return RunCalcMode(argc, argv);
+	if ((argc > 1) && (strcmp(argv[1], "-pipeline") == 0))
+		return RunPipelineMode(argc, argv);
+	if ((argc > 1) && (strcmp(argv[1], "-cents") == 0))
+		SetScheduleEngine(ENGINE_CENTS);
+	if ((argc > 1) && (strcmp(argv[1], "-crosscheck") == 0))
+		SetScheduleEngine(ENGINE_CROSSCHECK);
 		
 	PrintMenu();
 	while(ch = getchar())
@@ -96,7 +146,7 @@ int main(void)
 			puts(SUMMARY_PROMPT);
 			while (getchar() == '\n')
 			{
-				system("cls");
+				system(CLEAR_SCREEN);
 				PrintResults(loanSize, paymentSize, interestRate, months);
 				break;
 			}
@@ -116,7 +166,7 @@ int main(void)
 			puts(SUMMARY_PROMPT);
 			while (getchar() == '\n')
 			{
-				system("cls");
+				system(CLEAR_SCREEN);
 				PrintResults(loanSize, paymentSize, interestRate, months);
 				break;
 			}
@@ -144,7 +194,7 @@ int main(void)
 			puts(SUMMARY_PROMPT);
 			while (getchar() == '\n')
 			{
-				system("cls");
+				system(CLEAR_SCREEN);
 				PrintResults(loanSize, paymentSize, interestRate, months);
 				break;
 			}
@@ -182,16 +232,25 @@ int main(void)
 		case 't':;    //Display table
 		case 'T': 
 			DisplayTable(loanSize, paymentSize, interestRate, months);
+			if (GetScheduleEngine() == ENGINE_CROSSCHECK)
+				printf("\n" CROSSCHECK_REPORT, GetCrossCheckMismatches());
 			PrintSubMenu();
 			break;
 		case 's' :;   //Save table to file
 		case 'S' : 
 			SaveTable(loanSize, paymentSize, interestRate, months);
+			if (GetScheduleEngine() == ENGINE_CROSSCHECK)
+				printf(CROSSCHECK_REPORT, GetCrossCheckMismatches());
+			PrintSubMenu();
+			break;
+		case 'w':;    //What-if change to the table
+		case 'W': 
+			WhatIfTable(loanSize, paymentSize, interestRate, months);
 			PrintSubMenu();
 			break;
 		case 'r':;    //Restart
 		case 'R': 
-			system("cls");
+			system(CLEAR_SCREEN);
 			PrintMenu();
 			interestRate = 0;
 			paymentSize = 0;
@@ -323,14 +382,337 @@ void PrintMenu(void)
 //				   ReadLoanSize()
 // Calls:          
 // History Log:    11/14/2016  JR completed version 1.0
+//				   10/17/2026  added 'W' what-if option
 //----------------------------------------------------------------------------
 void PrintSubMenu(void)
 {
 	puts("\n"LINE "\n");
 	puts("Press 'T' to create and display table");
+	puts("Press 'W' to change one value and see what-if table rows");
 	puts("Press 'S' to Save table to file. \nPress 'R' when done to Restart \n");
 	puts("Press 'Q' to quit");
 	puts(LINE);
 }
 
 
+//----------------------------------------------------------------------------
+// Function: int RunBatchMode(int argc, char* argv[])
+//												  
+// Description:  Runs the headless batch pricing mode:
+//
+//				     project3 -batch [input] [output] [threads] [metrics]
+//
+//				 input and output default to stdin and stdout ("-" also
+//				 selects them). A named input file is mapped and parsed in
+//				 place, and its bad records are reported on stderr with
+//				 their byte offset and line. threads defaults to one per
+//				 CPU. Elapsed time
+//				 and throughput in records/second are reported on stderr.
+//				 Given a metrics file, the library metrics are saved to it
+//				 afterwards, as JSON if its name ends in .json and as
+//				 Prometheus text otherwise.
+//				 		 				  	     			
+// Parameters:	  (int)    argc     Number of command line arguments
+//				  (char**) argv     Command line arguments
+// Returns:       EXIT_SUCCESS or EXIT_FAILURE
+// Date:          10/17/2026  
+//
+// Input:          Loan records, see amort_batch.h
+// Output:         One result row per record
+// Called By:      main()
+// Calls:          RunBatch(), RunBatchRecords(), OpenRecordFile(),
+//				   CloseRecordFile(), GetWallSeconds(), WriteMetrics()
+// History Log:    10/17/2026  added for batch pricing mode
+//				   10/17/2026  metrics file argument
+//				   10/17/2026  input file mapped, bad records reported
+//				   10/17/2026  output and metrics write errors reported
+//----------------------------------------------------------------------------
+int RunBatchMode(int argc, char* argv[])
+{
+	RecordFile file;
+	int mapped = (argc > 2) && (strcmp(argv[2], "-") != 0);
+	FILE* out = stdout;
+	FILE* metrics = NULL;
+	int threads = 0;
+	int closed = 0;
+	long long count = 0;
+	double start = 0;
+	double elapsed = 0;
+
+	if (mapped && !OpenRecordFile(&file, argv[2]))
+	{
+		fprintf(stderr, "Cannot open input file: %s\n", argv[2]);
+		return EXIT_FAILURE;
+	}
+	if ((argc > 3) && (strcmp(argv[3], "-") != 0) &&
+		((out = fopen(argv[3], "w")) == NULL))
+	{
+		fprintf(stderr, "Cannot open output file: %s\n", argv[3]);
+		if (mapped)
+			CloseRecordFile(&file);
+		return EXIT_FAILURE;
+	}
+	if (argc > 4)
+		threads = atoi(argv[4]);
+
+	start = GetWallSeconds();
+	count = mapped ? RunBatchRecords(&file, out, threads, stderr) :
+		RunBatch(stdin, out, threads);
+	elapsed = GetWallSeconds() - start;
+	if (mapped)
+		CloseRecordFile(&file);
+	closed = (out != stdout) ? (fclose(out) == 0) : (fflush(out) == 0);
+	if ((count < 0) || !closed)
+	{
+		fprintf(stderr, "Out of memory, or output could not be written\n");
+		return EXIT_FAILURE;
+	}
+	fprintf(stderr, "Priced %lld records in %.3lf s (%.0lf records/s)\n",
+		count, elapsed, (elapsed > 0) ? count / elapsed : 0.0);
+	if (argc > 5)
+	{
+		size_t length = strlen(argv[5]);
+		int json = (length >= 5) &&
+			(strcmp(argv[5] + length - 5, ".json") == 0);
+
+		if (((metrics = fopen(argv[5], "w")) == NULL) ||
+			!WriteMetrics(metrics, json ? METRICS_JSON : METRICS_PROMETHEUS))
+		{
+			fprintf(stderr, "Cannot write metrics file: %s\n", argv[5]);
+			if (metrics != NULL)
+				fclose(metrics);
+			return EXIT_FAILURE;
+		}
+		if (fclose(metrics) != 0)
+		{
+			fprintf(stderr, "Cannot write metrics file: %s\n", argv[5]);
+			return EXIT_FAILURE;
+		}
+	}
+	return EXIT_SUCCESS;
+}
+//----------------------------------------------------------------------------
+// Function: int RunServerMode(int argc, char* argv[])
+//												  
+// Description:  Runs the local calculation server in place of the menus:
+//
+//				     project3 -serve endpoint [workers]
+//
+//				 endpoint is a Unix domain socket path, or tcp:PORT to
+//				 listen on 127.0.0.1. workers defaults to one per CPU. The
+//				 server answers until a client sends SHUTDOWN, then prints
+//				 its counters and latencies. The requests are listed in
+//				 amort_server.h; serverload drives it.
+//				 		 				  	     			
+// Parameters:	  (int)    argc     Number of command line arguments
+//				  (char**) argv     Command line arguments
+// Returns:       EXIT_SUCCESS or EXIT_FAILURE
+// Date:          10/17/2026  
+//
+// Called By:      main()
+// Calls:          RunServer()
+// History Log:    10/17/2026  added for the calculation server
+//----------------------------------------------------------------------------
+int RunServerMode(int argc, char* argv[])
+{
+	int workers = (argc > 3) ? atoi(argv[3]) : 0;
+
+	if (argc < 3)
+	{
+		fprintf(stderr, "Usage: %s -serve endpoint [workers]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+	fprintf(stderr, "Serving on %s\n", argv[2]);
+	if (!RunServer(argv[2], workers))
+	{
+		fprintf(stderr, "Cannot serve on %s\n", argv[2]);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+//----------------------------------------------------------------------------
+// Function: int RunCalcMode(int argc, char* argv[])
+//												  
+// Description:  Answers one loan calculation from the command line, for
+//				 scripts and pipelines:
+//
+//				     project3 -calc [-loan X] [-payment X] [-months N]
+//				                    [-rate X] [-table] [-json]
+//
+//				 Exactly one of the four values is left out and is solved
+//				 for. The values are checked by the batch record rules
+//				 (see amort_batch.h) and the result is printed as one
+//				 batch result row, loan,payment,months,rate,status, or
+//				 with -json as one JSON object. -table adds the
+//				 amortization table, one month,payment,principal,interest,
+//				 balance row per month, or a "rows" array with -json. No
+//				 menu is drawn, nothing is read from stdin and the
+//				 screen is never cleared, so the first result is ready as
+//				 soon as the process has started.
+//				 		 				  	     			
+// Parameters:	  (int)    argc     Number of command line arguments
+//				  (char**) argv     Command line arguments
+// Returns:       EXIT_SUCCESS if the status is OK and the result was
+//				  written, else EXIT_FAILURE
+// Date:          10/17/2026  
+//
+// Output:         Result row or JSON object on stdout, errors on stderr
+// Called By:      main()
+// Calls:          ParseLoanRecord(), PriceLoanRecord(), FormatLoanRecord(),
+//				   FillScheduleRows(), FormatCsvRow()
+// History Log:    10/17/2026  added for the command line mode
+//				   10/17/2026  stdout write errors reported
+//----------------------------------------------------------------------------
+int RunCalcMode(int argc, char* argv[])
+{
+	const char* values[4] = { "", "", "", "" };  // Loan, payment, months, rate
+	const char* names[4] = { "-loan", "-payment", "-months", "-rate" };
+	int table = 0;
+	int json = 0;
+	int rows = 0;
+	char line[BATCH_LINE_MAX] = "";
+	char text[BATCH_REPLY_MAX] = "";
+	ScheduleRow* schedule = NULL;
+	LoanRecord record;
+
+	for (int i = 2; i < argc; i++)
+	{
+		int v = 0;
+
+		while ((v < 4) && (strcmp(argv[i], names[v]) != 0))
+			v++;
+		if ((v < 4) && (i + 1 < argc) &&
+			(strcspn(argv[i + 1], ",\t\r\n") == strlen(argv[i + 1])))
+			values[v] = argv[++i];              // No field separators
+		else if (strcmp(argv[i], "-table") == 0)
+			table = 1;
+		else if (strcmp(argv[i], "-json") == 0)
+			json = 1;
+		else
+		{
+			fprintf(stderr, "Usage: %s " CALC_USAGE "\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+	if ((snprintf(line, sizeof(line), "%s,%s,%s,%s\n", values[0],
+		values[1], values[2], values[3]) >= (int)sizeof(line)) ||
+		!ParseLoanRecord(line, &record))
+	{
+		fprintf(stderr, "Give exactly three of -loan, -payment, -months "
+			"and -rate, as the batch records take them\n");
+		return EXIT_FAILURE;
+	}
+	PriceLoanRecord(&record);
+
+	if (table && (record.status == BATCH_OK) && (record.months > 0) &&
+		(record.months <= FIVE_HUNDRED_YEARS) &&
+		((schedule = (ScheduleRow*)malloc(sizeof(ScheduleRow) *
+		(size_t)record.months)) != NULL))
+		rows = FillScheduleRows(schedule, record.loanSize,
+			record.paymentSize, record.interestRate, record.months, 1,
+			record.months);
+	if (!json)
+	{
+		FormatLoanRecord(text, sizeof(text), &record);
+		fputs(text, stdout);
+		for (int i = 0; i < rows; i++)
+		{
+			int length = FormatCsvRow(text, &schedule[i]);
+
+			text[length++] = '\n';
+			fwrite(text, 1, (size_t)length, stdout);
+		}
+	}
+	else
+	{
+		printf("{\"loan\":%.2lf,\"payment\":%.2lf,\"months\":%d,"
+			"\"rate\":%.3lf,\"status\":\"%s\"", record.loanSize,
+			record.paymentSize, record.months, record.interestRate,
+			(record.status == BATCH_OK) ? "OK" :
+			(record.status == BATCH_NO_SOLUTION) ? "NONE" : "BAD");
+		if (table)
+			fputs(",\"rows\":[", stdout);
+		for (int i = 0; i < rows; i++)
+		{
+			int length = FormatCsvRow(text + 2, &schedule[i]) + 2;
+
+			text[0] = ',';
+			text[1] = '[';
+			text[length++] = ']';
+			fwrite(text + (i == 0), 1, (size_t)(length - (i == 0)), stdout);
+		}
+		fputs(table ? "]}\n" : "}\n", stdout);
+	}
+	free(schedule);
+	if ((fflush(stdout) != 0) || ferror(stdout))
+	{
+		fprintf(stderr, "Output could not be written\n");
+		return EXIT_FAILURE;
+	}
+	return (record.status == BATCH_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+//----------------------------------------------------------------------------
+// Function: int RunPipelineMode(int argc, char* argv[])
+//												  
+// Description:  Runs the batch pricing mode as a staged pipeline:
+//
+//				     project3 -pipeline [input] [output] [workers] [binary]
+//
+//				 input and output are as for -batch. Parsing, pricing,
+//				 formatting and writing run side by side; workers is the
+//				 number of pricing threads, by default one per CPU the
+//				 other stages leave. Given "binary", results are written as
+//				 PipelineResult structs rather than text rows. The time of
+//				 each stage is reported on stderr.
+//				 		 				  	     			
+// Parameters:	  (int)    argc     Number of command line arguments
+//				  (char**) argv     Command line arguments
+// Returns:       EXIT_SUCCESS or EXIT_FAILURE
+// Date:          10/17/2026  
+//
+// Input:          Loan records, see amort_batch.h
+// Output:         One result per record, see amort_pipeline.h
+// Called By:      main()
+// Calls:          RunPipeline(), WritePipelineStats()
+// History Log:    10/17/2026  added for the batch pipeline
+//				   10/17/2026  output that cannot be closed is a failure
+//----------------------------------------------------------------------------
+int RunPipelineMode(int argc, char* argv[])
+{
+	FILE* in = stdin;
+	FILE* out = stdout;
+	int workers = (argc > 4) ? atoi(argv[4]) : 0;
+	int format = ((argc > 5) && (strcmp(argv[5], "binary") == 0)) ?
+		PIPELINE_BINARY : PIPELINE_TEXT;
+	long long count = 0;
+	int closed = 0;
+	PipelineStats stats;
+
+	if ((argc > 2) && (strcmp(argv[2], "-") != 0) &&
+		((in = fopen(argv[2], "r")) == NULL))
+	{
+		fprintf(stderr, "Cannot open input file: %s\n", argv[2]);
+		return EXIT_FAILURE;
+	}
+	if ((argc > 3) && (strcmp(argv[3], "-") != 0) &&
+		((out = fopen(argv[3], (format == PIPELINE_BINARY) ? "wb" : "w")) ==
+		NULL))
+	{
+		fprintf(stderr, "Cannot open output file: %s\n", argv[3]);
+		if (in != stdin)
+			fclose(in);
+		return EXIT_FAILURE;
+	}
+
+	count = RunPipeline(in, out, workers, format, &stats);
+	if (in != stdin)
+		fclose(in);
+	closed = (out != stdout) ? (fclose(out) == 0) : (fflush(out) == 0);
+	if ((count < 0) || !closed)
+	{
+		fprintf(stderr, "Out of memory, or output could not be written\n");
+		return EXIT_FAILURE;
+	}
+	WritePipelineStats(stderr, &stats);
+	return EXIT_SUCCESS;
+}
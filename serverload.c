@@ -0,0 +1,265 @@
+//----------------------------------------------------------------------------
+// File:            serverload.c
+//
+// Description:     Load test client for the calculation server (see
+//					amort_server.h). Starts a number of client threads, each
+//					with its own connection, that send random batch records
+//					(solving payment, loan size, months and rate in turn) in
+//					groups of pipeline lines and wait for the group's
+//					replies before sending the next. Prints the throughput,
+//					the p50, p99 and slowest round trip of a group seen by
+//					the clients, and the server's own STATS line.
+//
+//					serverload endpoint [clients [requests [pipeline]]]
+//
+//					requests is per client.
+//
+// Functions:       main()
+//					RunLoadClient()
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include "amort.h"
+#include "amort_batch.h"
+#include "amort_platform.h"
+
+#define USAGE "usage: serverload endpoint [clients [requests [pipeline]]]\n"
+#define DEFAULT_CLIENTS 8
+#define DEFAULT_REQUESTS 20000
+#define DEFAULT_PIPELINE 32
+#define MAX_CLIENTS 64              // SERVER_MAX_CLIENTS
+#define MAX_PIPELINE 4096
+
+typedef struct
+{
+	const char* endpoint;
+	int requests;
+	int pipeline;
+	unsigned long long seed;
+	double* samples;                // Round trip of each group, seconds
+	int groups;
+	long long answered;
+	long long bad;                  // Replies with status BAD
+	int failed;                     // Connection lost
+} LoadClient;
+
+void RunLoadClient(void* arg);
+
+// Returns the next pseudo random number of a client.
+static unsigned int nextRandom(unsigned long long* seed)
+{
+	*seed = *seed * 6364136223846793005ULL + 1442695040888963407ULL;
+	return (unsigned int)(*seed >> 33);
+}
+
+// Writes one random record with the n'th unknown blank. Returns its length.
+static int makeRecord(char* text, unsigned long long* seed, const int n)
+{
+	int months = 12 * (1 + nextRandom(seed) % 40);
+	double loanSize = 1000 + (nextRandom(seed) % 50000000) / 100.0;
+	double rate = 1 + (nextRandom(seed) % 1000) / 100.0;
+	double payment = ceil(getPaymentAmount(months, loanSize, rate) *
+		HUNDRED) / HUNDRED;
+
+	switch (n % 4)
+	{
+	case 0:
+		return sprintf(text, "%.2lf,,%d,%.3lf\n", loanSize, months, rate);
+	case 1:
+		return sprintf(text, ",%.2lf,%d,%.3lf\n", payment, months, rate);
+	case 2:
+		return sprintf(text, "%.2lf,%.2lf,,%.3lf\n", loanSize, payment, rate);
+	default:
+		return sprintf(text, "%.2lf,%.2lf,%d,\n", loanSize, payment, months);
+	}
+}
+
+// Orders round trip samples for qsort().
+static int compareSamples(const void* a, const void* b)
+{
+	double x = *(const double*)a;
+	double y = *(const double*)b;
+
+	return (x > y) - (x < y);
+}
+//----------------------------------------------------------------------------
+// Function:        int main(int argc, char* argv[])
+//
+// Description:		Runs the client threads against the server named on the
+//					command line and reports what they saw.
+//
+// Parameters:	    (int)    argc     Number of command line arguments
+//					(char**) argv     endpoint [clients [requests
+//									  [pipeline]]]
+//
+// Returns:		    EXIT_SUCCESS, or EXIT_FAILURE if a connection failed or
+//					a reply was not OK or NONE
+// Date:            10/17/2026
+// Calls:		    RunLoadClient(), StartThread(), JoinThread(),
+//					ConnectLocal(), WriteSocket(), ReadSocket()
+// History Log:     10/17/2026  added for the calculation server
+//----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+	int clients = (argc > 2) ? atoi(argv[2]) : DEFAULT_CLIENTS;
+	int requests = (argc > 3) ? atoi(argv[3]) : DEFAULT_REQUESTS;
+	int pipeline = (argc > 4) ? atoi(argv[4]) : DEFAULT_PIPELINE;
+	LoadClient load[MAX_CLIENTS];
+	AmortThread threads[MAX_CLIENTS];
+	int launched[MAX_CLIENTS] = { 0 };
+	double* samples = NULL;
+	long long answered = 0;
+	long long bad = 0;
+	int failed = 0;
+	int count = 0;
+	double start = 0;
+	double elapsed = 0;
+	char stats[BATCH_REPLY_MAX] = "";
+	AmortSocket connection = AMORT_NO_SOCKET;
+	long got = 0;
+
+	if ((argc < 2) || (clients < 1) || (clients > MAX_CLIENTS) ||
+		(requests < 1) || (pipeline < 1) || (pipeline > MAX_PIPELINE))
+	{
+		fputs(USAGE, stderr);
+		return EXIT_FAILURE;
+	}
+	for (int c = 0; c < clients; c++)
+	{
+		memset(&load[c], 0, sizeof(LoadClient));
+		load[c].endpoint = argv[1];
+		load[c].requests = requests;
+		load[c].pipeline = pipeline;
+		load[c].seed = 2016 + (unsigned long long)c;
+		load[c].samples = (double*)malloc(sizeof(double) *
+			((size_t)requests / (size_t)pipeline + 1));
+		if (load[c].samples == NULL)
+			return EXIT_FAILURE;
+	}
+
+	start = GetWallSeconds();
+	for (int c = 1; c < clients; c++)      // Client 0 runs on this thread
+		launched[c] = StartThread(&threads[c], RunLoadClient, &load[c]);
+	RunLoadClient(&load[0]);
+	for (int c = 1; c < clients; c++)
+	{
+		if (launched[c])
+			JoinThread(threads[c]);
+		else
+			RunLoadClient(&load[c]);
+	}
+	elapsed = GetWallSeconds() - start;
+
+	samples = (double*)malloc(sizeof(double) * (size_t)clients *
+		((size_t)requests / (size_t)pipeline + 1));
+	for (int c = 0; c < clients; c++)
+	{
+		if (samples != NULL)
+			memcpy(samples + count, load[c].samples,
+				sizeof(double) * (size_t)load[c].groups);
+		count += load[c].groups;
+		answered += load[c].answered;
+		bad += load[c].bad;
+		failed += load[c].failed;
+		free(load[c].samples);
+	}
+	if (samples != NULL)
+		qsort(samples, (size_t)count, sizeof(double), compareSamples);
+
+	printf("%d clients, %d requests each, %d per round trip\n", clients,
+		requests, pipeline);
+	printf("%lld replies in %.3lf s: %.0lf requests/s\n", answered, elapsed,
+		(elapsed > 0) ? answered / elapsed : 0.0);
+	if ((samples != NULL) && (count > 0))
+		printf("Round trip us: p50 %.1lf  p99 %.1lf  max %.1lf\n",
+			samples[(count - 1) / 2] * 1e6,
+			samples[(int)((count - 1) * 0.99)] * 1e6,
+			samples[count - 1] * 1e6);
+	printf("BAD replies: %lld, failed connections: %d\n", bad, failed);
+	free(samples);
+
+	if ((connection = ConnectLocal(argv[1])) != AMORT_NO_SOCKET)
+	{
+		if (WriteSocket(connection, "STATS\nQUIT\n", 11) &&
+			((got = ReadSocket(connection, stats, sizeof(stats) - 1)) > 0))
+		{
+			stats[got] = '\0';
+			fputs(stats, stdout);
+		}
+		CloseSocket(connection);
+	}
+	return ((failed == 0) && (bad == 0)) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+//----------------------------------------------------------------------------
+// Function:        void RunLoadClient(void* arg)
+//
+// Description:		One client: connects, then sends its requests in groups
+//					of pipeline records, timing each group from the first
+//					byte sent to the last reply read.
+//
+// Parameters:	    (void*) arg   LoadClient to run and fill in
+//
+// Returns:		    none
+// Date:            10/17/2026
+// Called By:       main()
+// Calls:		    ConnectLocal(), WriteSocket(), ReadSocket(),
+//					CloseSocket(), makeRecord()
+// History Log:     10/17/2026  added for the calculation server
+//----------------------------------------------------------------------------
+void RunLoadClient(void* arg)
+{
+	LoadClient* client = (LoadClient*)arg;
+	size_t size = (size_t)client->pipeline * BATCH_REPLY_MAX;
+	char* request = (char*)malloc(size);
+	char* reply = (char*)malloc(size + 1);
+	AmortSocket connection = ConnectLocal(client->endpoint);
+	int sent = 0;
+
+	client->failed = (request == NULL) || (reply == NULL) ||
+		(connection == AMORT_NO_SOCKET);
+	while (!client->failed && (sent < client->requests))
+	{
+		int lines = client->requests - sent;
+		size_t length = 0;
+		size_t have = 0;
+		int seen = 0;
+		double start = 0;
+
+		lines = (lines < client->pipeline) ? lines : client->pipeline;
+		for (int i = 0; i < lines; i++)
+			length += (size_t)makeRecord(request + length, &client->seed,
+				sent + i);
+
+		start = GetWallSeconds();
+		if (!WriteSocket(connection, request, length))
+			client->failed = 1;
+		while (!client->failed && (seen < lines))
+		{
+			long got = ReadSocket(connection, reply + have, size - have);
+
+			if (got <= 0)
+			{
+				client->failed = 1;
+				break;
+			}
+			for (long i = 0; i < got; i++)
+				seen += (reply[have + (size_t)i] == '\n');
+			have += (size_t)got;
+		}
+		client->samples[client->groups++] = GetWallSeconds() - start;
+
+		reply[have] = '\0';
+		for (char* line = strstr(reply, "BAD"); line != NULL;
+			line = strstr(line + 1, "BAD"))
+			client->bad++;
+		client->answered += seen;
+		sent += lines;
+	}
+	if (connection != AMORT_NO_SOCKET)
+	{
+		WriteSocket(connection, "QUIT\n", 5);
+		CloseSocket(connection);
+	}
+	free(request);
+	free(reply);
+}